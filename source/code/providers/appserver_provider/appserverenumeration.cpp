@@ -44,9 +44,7 @@ namespace SCXSystemLib
     */
     vector<SCXHandle<ProcessInstance> > AppServerPALDependencies::Find(const wstring& name)
     {
-        SCXHandle<ProcessEnumeration> enumProc =  SCXHandle<ProcessEnumeration>(new ProcessEnumeration());
-        enumProc->SampleData();
-        return enumProc->Find(name);
+        return ProcessEnumeration::FindByName(name);
     }
     
     /**
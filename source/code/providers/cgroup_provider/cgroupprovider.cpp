@@ -0,0 +1,343 @@
+/*------------------------------------------------------------------------------
+    Copyright (c) Microsoft Corporation.  All rights reserved.
+
+*/
+/**
+    \file
+
+    \brief     Main implementation file for Control Group Provider
+
+    \date      2026-10-18 10:00:00
+
+*/
+/*----------------------------------------------------------------------------*/
+
+#include <scxcorelib/scxcmn.h>
+#include <scxcorelib/scxexception.h>
+#include <scxcorelib/scxlog.h>
+#include <scxcorelib/scxmath.h>
+#include <scxcorelib/stringaid.h>
+
+#include <scxproviderlib/scxprovidercapabilities.h>
+
+#include "../meta_provider/startuplog.h"
+
+#include "cgroupprovider.h"
+
+#include <scxsystemlib/cgroupenumeration.h>
+#include <scxsystemlib/cgroupinstance.h>
+
+using namespace SCXProviderLib;
+using namespace SCXSystemLib;
+using namespace SCXCoreLib;
+
+namespace SCXCore {
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Provide CMPI interface for this class
+
+       The class implementation (concrete class) is CGroupProvider and the name of the
+       provider in CIM registration terms is SCX_CGroupProvider.
+
+    */
+    SCXProviderDef(CGroupProvider, SCX_CGroupProvider)
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Default constructor
+
+       The Singleton thread lock will be held during this call.
+
+    */
+    CGroupProvider::CGroupProvider() :
+        BaseProvider(L"scx.core.providers.cgroupprovider"), m_cgroups(NULL)
+    {
+        LogStartup();
+        SCX_LOGTRACE(m_log, L"CGroupProvider constructor");
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Destructor
+    */
+    CGroupProvider::~CGroupProvider()
+    {
+        // Do not log here since when this destructor is called the objects neccesary for logging might no longer be alive
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Registration of supported capabilities
+
+       Callback from the BaseProvider in which the provider registers the supported
+       classes and methods. The registrations should match the contents of the
+       MOF files exactly.
+
+    */
+    void CGroupProvider::DoInit()
+    {
+        SCX_LOGTRACE(m_log, L"CGroupProvider::DoInit");
+
+        if (m_cgroups != NULL)
+        {
+            SCXASSERTFAIL(L"DoInit() called multiple times without a call to DoCleanup() between");
+            DoCleanup();
+        }
+
+        m_ProviderCapabilities.RegisterCimClass(eSCX_CGroupStatisticalInformation,
+                                                L"SCX_CGroupStatisticalInformation");
+
+        m_cgroups = new CGroupEnumeration();
+        m_cgroups->Init();
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+        Provide a way for pal layer to do cleanup. Stop all threads etc.
+    */
+    void CGroupProvider::DoCleanup()
+    {
+        SCX_LOGTRACE(m_log, L"CGroupProvider::DoCleanup");
+
+        m_ProviderCapabilities.Clear();
+
+        if (m_cgroups != NULL)
+        {
+            m_cgroups->CleanUp();
+            m_cgroups = NULL;
+        }
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Set the keys of the SCXInstance object from the information in the entity instance
+
+       \param[in]       cginst    Internal instance representation to get data from
+       \param[out]      inst      Instance to add keys to
+
+       \throws          SCXInvalidArgumentException  The instance can not be converted to a cgroup instance
+
+       The key is the control group path relative to the cgroup root.
+
+    */
+    void CGroupProvider::AddKeys(SCXCoreLib::SCXHandle<SCXSystemLib::CGroupInstance> cginst, SCXInstance &inst) const // private
+    {
+        SCX_LOGTRACE(m_log, L"CGroupProvider::AddKeys()");
+
+        if (cginst == NULL)
+        {
+            throw SCXInvalidArgumentException(L"einst", L"Not a CGroupInstance", SCXSRCLOCATION);
+        }
+
+        SCXProperty name_prop(L"Name", cginst->GetId());
+        inst.AddKey(name_prop);
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+        Set all properties of the SCXInstance from the information in the EntityInstance
+
+        \param[in]       cginst   Internal instance representation to get data from
+        \param[out]      inst     Instance to populate
+
+        \throws          SCXInvalidArgumentException The instance can not be converted to a cgroup instance
+
+    */
+    void CGroupProvider::AddProperties(SCXCoreLib::SCXHandle<SCXSystemLib::CGroupInstance> cginst, SCXInstance &inst) const // private
+    {
+        scxulong data = 0;
+        scxulong limit = 0;
+
+        SCX_LOGTRACE(m_log, L"CGroupProvider::AddProperties()");
+
+        if (cginst == NULL)
+        {
+            throw SCXInvalidArgumentException(L"einst", L"Not a CGroupInstance", SCXSRCLOCATION);
+        }
+
+        SCXProperty total_prop(L"IsAggregate", cginst->IsTotal());
+        inst.AddProperty(total_prop);
+
+        SCXProperty version_prop(L"CGroupVersion", static_cast<unsigned int>(m_cgroups->GetVersion()));
+        inst.AddProperty(version_prop);
+
+        if (cginst->GetPercentProcessorTime(data))
+        {
+            SCXProperty data_prop(L"PercentProcessorTime", static_cast<unsigned int>(data));
+            inst.AddProperty(data_prop);
+        }
+        if (cginst->GetPercentUserTime(data))
+        {
+            SCXProperty data_prop(L"PercentUserTime", static_cast<unsigned int>(data));
+            inst.AddProperty(data_prop);
+        }
+        if (cginst->GetPercentPrivilegedTime(data))
+        {
+            SCXProperty data_prop(L"PercentPrivilegedTime", static_cast<unsigned int>(data));
+            inst.AddProperty(data_prop);
+        }
+
+        bool hasLimit = cginst->GetMemoryLimit(limit);
+        if (hasLimit)
+        {
+            SCXProperty data_prop(L"MemoryLimit", limit);
+            inst.AddProperty(data_prop);
+        }
+        if (cginst->GetUsedMemory(data))
+        {
+            SCXProperty data_prop(L"UsedMemory", data);
+            inst.AddProperty(data_prop);
+
+            if (hasLimit && limit > 0)
+            {
+                unsigned char percent = static_cast<unsigned char> (GetPercentage(0, data, 0, limit));
+                SCXProperty data_prop2(L"PercentUsedMemory", percent);
+                inst.AddProperty(data_prop2);
+            }
+        }
+
+        if (cginst->GetProcessCount(data))
+        {
+            SCXProperty data_prop(L"ProcessCount", static_cast<unsigned int>(data));
+            inst.AddProperty(data_prop);
+        }
+
+        if (cginst->GetReadBytesPerSecond(data))
+        {
+            SCXProperty data_prop(L"ReadBytesPerSecond", data);
+            inst.AddProperty(data_prop);
+        }
+        if (cginst->GetWriteBytesPerSecond(data))
+        {
+            SCXProperty data_prop(L"WriteBytesPerSecond", data);
+            inst.AddProperty(data_prop);
+        }
+        if (cginst->GetReadOperationsPerSecond(data))
+        {
+            SCXProperty data_prop(L"ReadOperationsPerSecond", data);
+            inst.AddProperty(data_prop);
+        }
+        if (cginst->GetWriteOperationsPerSecond(data))
+        {
+            SCXProperty data_prop(L"WriteOperationsPerSecond", data);
+            inst.AddProperty(data_prop);
+        }
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+      Lookup the instance representation, given keys provided from CIMOM
+
+      \param[in]    keys   SCXInstance with property keys set
+      \returns             Pointer to located instance
+
+      \throws              SCXCIMInstanceNotFound   The instance with given keys cannot be found
+
+      The enumeration lock must be held by the caller.
+
+    */
+    SCXCoreLib::SCXHandle<SCXSystemLib::CGroupInstance> CGroupProvider::FindInstance(const SCXInstance& keys) const // private
+    {
+        const SCXProperty& nameprop = GetKeyRef(L"Name", keys);
+
+        SCXCoreLib::SCXHandle<SCXSystemLib::CGroupInstance> testinst = m_cgroups->GetInstance(nameprop.GetStrValue());
+        if (NULL == testinst)
+        {
+            throw SCXCIMInstanceNotFound(keys.DumpString(), SCXSRCLOCATION);
+        }
+
+        return testinst;
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Enumerate instance names
+
+       \param[in]   callContext Context details of this request
+       \param[out]  names       Collection of instances with key properties
+
+    */
+    void CGroupProvider::DoEnumInstanceNames(const SCXCallContext& /* callContext */,
+                                             SCXInstanceCollection &names)
+    {
+        SCX_LOGTRACE(m_log, L"CGroupProvider DoEnumInstanceNames");
+
+        SCXCoreLib::SCXThreadLock lock(m_cgroups->GetLockHandle());
+
+        m_cgroups->UpdateNoLock(lock, false);
+
+        SCX_LOGTRACE(m_log, StrAppend(L"Number of control groups = ", m_cgroups->Size()));
+
+        for (size_t i=0; i<m_cgroups->Size(); i++)
+        {
+            SCXInstance inst;
+            AddKeys(m_cgroups->GetInstance(i), inst);
+            names.AddInstance(inst);
+        }
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Enumerate instances
+
+       \param[in]     callContext Details of the client request
+       \param[out]    instances   Collection of instances
+
+    */
+    void CGroupProvider::DoEnumInstances(const SCXCallContext& /* callContext */,
+                                         SCXInstanceCollection &instances)
+    {
+        SCX_LOGTRACE(m_log, L"CGroupProvider DoEnumInstances");
+
+        SCXCoreLib::SCXThreadLock lock(m_cgroups->GetLockHandle());
+
+        m_cgroups->UpdateNoLock(lock);
+
+        for (size_t i=0; i<m_cgroups->Size(); i++)
+        {
+            SCXInstance inst;
+            AddKeys(m_cgroups->GetInstance(i), inst);
+            AddProperties(m_cgroups->GetInstance(i), inst);
+            instances.AddInstance(inst);
+        }
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Get an instance
+
+       \param[in]   callContext Context of the original request, indicating which instance to retrieve.
+       \param[out]  instance    The returned instance
+
+       \throws      SCXInvalidArgumentException  If no Name property in keys
+       \throws      SCXCIMInstanceNotFound       If the control group does not exist
+    */
+    void CGroupProvider::DoGetInstance(const SCXCallContext& callContext, SCXInstance& instance)
+    {
+        SCX_LOGTRACE(m_log, L"CGroupProvider::DoGetInstance()");
+
+        SCXCoreLib::SCXThreadLock lock(m_cgroups->GetLockHandle());
+
+        m_cgroups->UpdateNoLock(lock);
+
+        SCXCoreLib::SCXHandle<SCXSystemLib::CGroupInstance> testinst = FindInstance(callContext.GetObjectPath());
+
+        AddKeys(testinst, instance);
+        AddProperties(testinst, instance);
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+        Dump object as string (for logging).
+
+        \returns       The object represented as a string suitable for logging.
+
+    */
+    const std::wstring CGroupProvider::DumpString() const
+    {
+        return L"CGroupProvider";
+    }
+}
+
+/*----------------------------E-N-D---O-F---F-I-L-E---------------------------*/
@@ -0,0 +1,75 @@
+/*------------------------------------------------------------------------------
+    Copyright (c) Microsoft Corporation.  All rights reserved.
+
+*/
+/**
+    \file
+
+    \brief     Control group provider header file
+
+    \date      2026-10-18 10:00:00
+
+*/
+/*----------------------------------------------------------------------------*/
+#ifndef CGROUPPROVIDER_H
+#define CGROUPPROVIDER_H
+
+#include <string>
+
+#include <scxproviderlib/cmpibase.h>
+#include <scxsystemlib/cgroupenumeration.h>
+#include <scxsystemlib/cgroupinstance.h>
+#include <scxcorelib/scxlog.h>
+
+namespace SCXCore
+{
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Control group provider
+
+       Concrete instance of the CMPI BaseProvider delivering CIM
+       information about Linux control groups (containers, systemd
+       slices and services) on current host.
+
+       A provider-specific thread lock will be held at each call to
+       the Do* methods, so this implementation class does not need
+       to worry about that.
+
+    */
+    class CGroupProvider : public SCXProviderLib::BaseProvider
+    {
+    public:
+        CGroupProvider();
+        ~CGroupProvider();
+
+        virtual const std::wstring DumpString() const;
+
+    protected:
+        //! The set of CIM classes this provider supports
+        enum SupportedCimClasses {
+            eSCX_CGroupStatisticalInformation
+        };
+
+        // Overrides from the base class with relevant implementations
+        virtual void DoInit();
+        virtual void DoEnumInstanceNames(const SCXProviderLib::SCXCallContext& callContext,
+                                         SCXProviderLib::SCXInstanceCollection &names);
+        virtual void DoEnumInstances(const SCXProviderLib::SCXCallContext& callContext,
+                                     SCXProviderLib::SCXInstanceCollection &instances);
+        virtual void DoGetInstance(const SCXProviderLib::SCXCallContext& callContext,
+                                   SCXProviderLib::SCXInstance& instance);
+        virtual void DoCleanup();
+
+    private:
+        void AddKeys(SCXCoreLib::SCXHandle<SCXSystemLib::CGroupInstance> cginst, SCXProviderLib::SCXInstance& inst) const;
+        void AddProperties(SCXCoreLib::SCXHandle<SCXSystemLib::CGroupInstance> cginst, SCXProviderLib::SCXInstance& inst) const;
+        SCXCoreLib::SCXHandle<SCXSystemLib::CGroupInstance> FindInstance(const SCXProviderLib::SCXInstance& keys) const;
+
+        //! PAL implementation retrieving control group information for local host
+        SCXCoreLib::SCXHandle<SCXSystemLib::CGroupEnumeration> m_cgroups;
+    };
+}
+
+#endif /* CGROUPPROVIDER_H */
+/*----------------------------E-N-D---O-F---F-I-L-E---------------------------*/
@@ -82,6 +82,8 @@ namespace SCXCore {
 
         m_ProviderCapabilities.RegisterCimClass(eSCX_ProcessorStatisticalInformation,
                                                 L"SCX_ProcessorStatisticalInformation");
+        m_ProviderCapabilities.RegisterCimClass(eSCX_SystemStatisticalInformation,
+                                                L"SCX_SystemStatisticalInformation");
 
         m_cpus = new CPUEnumeration();
         m_cpus->Init();
@@ -153,9 +155,30 @@ namespace SCXCore {
 
         SCX_LOGTRACE(m_log, L"CPUProvider AddPropeties()");
 
-        SCXProperty total_prop(L"IsAggregate", cpuinst->IsTotal());
+        SCXProperty total_prop(L"IsAggregate", SCXSystemLib::eCPUGroupingProcessor != cpuinst->GetGrouping());
         inst.AddProperty(total_prop);
 
+        const wchar_t* grouping = L"Processor";
+        switch (cpuinst->GetGrouping())
+        {
+        case SCXSystemLib::eCPUGroupingCore:
+            grouping = L"Core";
+            break;
+        case SCXSystemLib::eCPUGroupingSocket:
+            grouping = L"Socket";
+            break;
+        case SCXSystemLib::eCPUGroupingNode:
+            grouping = L"NUMANode";
+            break;
+        case SCXSystemLib::eCPUGroupingTotal:
+            grouping = L"Total";
+            break;
+        case SCXSystemLib::eCPUGroupingProcessor:
+            break;
+        }
+        SCXProperty grouping_prop(L"ProcessorGrouping", grouping);
+        inst.AddProperty(grouping_prop);
+
         if (cpuinst->GetProcessorTime(data))
         {
             SCXProperty data_prop(L"PercentProcessorTime", static_cast<unsigned char> (data));
@@ -204,6 +227,18 @@ namespace SCXCore {
             inst.AddProperty(data_prop);
         }
 
+        if (cpuinst->GetStealTime(data))
+        {
+            SCXProperty data_prop(L"PercentStealTime", static_cast<unsigned char> (data));
+            inst.AddProperty(data_prop);
+        }
+
+        if (cpuinst->GetGuestTime(data))
+        {
+            SCXProperty data_prop(L"PercentGuestTime", static_cast<unsigned char> (data));
+            inst.AddProperty(data_prop);
+        }
+
     }
 
     /*----------------------------------------------------------------------------*/
@@ -238,6 +273,16 @@ namespace SCXCore {
             }
         }
 
+        for(size_t i=0; i<m_cpus->GetGroupCount(); i++)
+        {
+            SCXCoreLib::SCXHandle<SCXSystemLib::CPUInstance> testinst = m_cpus->GetGroupInstance(i);
+
+            if (testinst->GetProcName() == nameprop.GetStrValue())
+            {
+                return testinst;
+            }
+        }
+
         // As last resort, check if we the request is for the _Total instance
         if (m_cpus->GetTotalInstance() != 0 )
         {
@@ -252,6 +297,82 @@ namespace SCXCore {
         throw SCXCIMInstanceNotFound(keys.DumpString(), SCXSRCLOCATION);
     }
 
+    /*----------------------------------------------------------------------------*/
+    /**
+       Add the key properties of the scheduler counters to an SCXInstance
+
+       \param[in]   schedinst  Scheduler instance to get data from
+       \param[out]  inst       Instance to add keys to
+
+       \throws      SCXInvalidArgumentException - The instance is NULL
+    */
+    void CPUProvider::AddSchedulerKeys(SCXCoreLib::SCXHandle<SCXSystemLib::SchedulerInstance> schedinst, SCXInstance &inst) // private
+    {
+        SCX_LOGTRACE(m_log, L"CPUProvider AddSchedulerKeys()");
+
+        if (schedinst == NULL)
+        {
+            throw SCXInvalidArgumentException(L"schedinst", L"Not a SchedulerInstance", SCXSRCLOCATION);
+        }
+
+        SCXProperty name_prop(L"Name", schedinst->GetId());
+        inst.AddKey(name_prop);
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Set all properties from the SchedulerInstance in the SCXInstance
+
+       \param[in]  schedinst - Scheduler instance to get data from
+       \param[in]  inst      - Instance to populate
+
+       \throws      SCXInvalidArgumentException - The instance is NULL
+    */
+    void CPUProvider::AddSchedulerProperties(SCXCoreLib::SCXHandle<SCXSystemLib::SchedulerInstance> schedinst, SCXInstance &inst) // private
+    {
+        scxulong data;
+
+        if (schedinst == NULL)
+        {
+            throw SCXInvalidArgumentException(L"schedinst", L"Not a SchedulerInstance", SCXSRCLOCATION);
+        }
+
+        SCX_LOGTRACE(m_log, L"CPUProvider AddSchedulerProperties()");
+
+        SCXProperty total_prop(L"IsAggregate", schedinst->IsTotal());
+        inst.AddProperty(total_prop);
+
+        if (schedinst->GetContextSwitchesPerSecond(data))
+        {
+            SCXProperty data_prop(L"ContextSwitchesPerSecond", data);
+            inst.AddProperty(data_prop);
+        }
+
+        if (schedinst->GetInterruptsPerSecond(data))
+        {
+            SCXProperty data_prop(L"InterruptsPerSecond", data);
+            inst.AddProperty(data_prop);
+        }
+
+        if (schedinst->GetProcessesCreatedPerSecond(data))
+        {
+            SCXProperty data_prop(L"ProcessesCreatedPerSecond", data);
+            inst.AddProperty(data_prop);
+        }
+
+        if (schedinst->GetRunQueueLength(data))
+        {
+            SCXProperty data_prop(L"RunQueueLength", static_cast<unsigned int> (data));
+            inst.AddProperty(data_prop);
+        }
+
+        if (schedinst->GetBlockedQueueLength(data))
+        {
+            SCXProperty data_prop(L"BlockedQueueLength", static_cast<unsigned int> (data));
+            inst.AddProperty(data_prop);
+        }
+    }
+
 
     /*----------------------------------------------------------------------------*/
     /**
@@ -261,11 +382,21 @@ namespace SCXCore {
        \param[out]  names       Collection of instances with key properties
 
     */
-    void CPUProvider::DoEnumInstanceNames(const SCXCallContext& /* callContext */,
+    void CPUProvider::DoEnumInstanceNames(const SCXCallContext& callContext,
                                           SCXInstanceCollection &names)
     {
         SCX_LOGTRACE(m_log, L"CPUProvider DoEnumInstanceNames");
 
+        SupportedCimClasses cimtype = static_cast<SupportedCimClasses>(m_ProviderCapabilities.GetCimClassId(callContext.GetObjectPath()));
+
+        if (eSCX_SystemStatisticalInformation == cimtype)
+        {
+            SCXInstance inst;
+            AddSchedulerKeys(m_cpus->GetSchedulerInstance(), inst);
+            names.AddInstance(inst);
+            return;
+        }
+
         m_cpus->Update(false);
 
         SCX_LOGTRACE(m_log, StrAppend(L"Number of CPUs = ", m_cpus->Size()));
@@ -279,6 +410,14 @@ namespace SCXCore {
             names.AddInstance(inst);
         }
 
+        for(size_t i=0; i<m_cpus->GetGroupCount(); i++)
+        {
+            // Core, socket and NUMA node aggregates
+            SCXInstance inst;
+            AddKeys(m_cpus->GetGroupInstance(i), inst);
+            names.AddInstance(inst);
+        }
+
         if (m_cpus->GetTotalInstance() != 0 )
         {
             // There will always be one total instance
@@ -297,15 +436,26 @@ namespace SCXCore {
        \param[out]  instances   Collection of instances
 
     */
-    void CPUProvider::DoEnumInstances(const SCXCallContext& /* callContext */,
+    void CPUProvider::DoEnumInstances(const SCXCallContext& callContext,
                                       SCXInstanceCollection &instances)
     {
         SCX_LOGTRACE(m_log, L"CPUProvider DoEnumInstances");
 
+        SupportedCimClasses cimtype = static_cast<SupportedCimClasses>(m_ProviderCapabilities.GetCimClassId(callContext.GetObjectPath()));
+
         // Update CPU PAL instance. This is both update of number of CPUs and
         // current statistics for each CPU.
         m_cpus->Update();
 
+        if (eSCX_SystemStatisticalInformation == cimtype)
+        {
+            SCXInstance inst;
+            AddSchedulerKeys(m_cpus->GetSchedulerInstance(), inst);
+            AddSchedulerProperties(m_cpus->GetSchedulerInstance(), inst);
+            instances.AddInstance(inst);
+            return;
+        }
+
         SCX_LOGTRACE(m_log, StrAppend(L"Number of CPUs = ", m_cpus->Size()));
 
         for(size_t i=0; i<m_cpus->Size(); i++)
@@ -316,6 +466,14 @@ namespace SCXCore {
             instances.AddInstance(inst);
         }
 
+        for(size_t i=0; i<m_cpus->GetGroupCount(); i++)
+        {
+            SCXInstance inst;
+            AddKeys(m_cpus->GetGroupInstance(i), inst);
+            AddProperties(m_cpus->GetGroupInstance(i), inst);
+            instances.AddInstance(inst);
+        }
+
         if (m_cpus->GetTotalInstance() != 0 )
         {
             SCXInstance inst;
@@ -339,9 +497,24 @@ namespace SCXCore {
     {
         SCX_LOGTRACE(m_log, L"CPUProvider::DoGetInstance()");
 
+        SupportedCimClasses cimtype = static_cast<SupportedCimClasses>(m_ProviderCapabilities.GetCimClassId(callContext.GetObjectPath()));
+
         // Refresh the collection (both keys and current data)
         m_cpus->Update();
 
+        if (eSCX_SystemStatisticalInformation == cimtype)
+        {
+            SCXCoreLib::SCXHandle<SCXSystemLib::SchedulerInstance> schedinst = m_cpus->GetSchedulerInstance();
+            const SCXProperty& nameprop = GetKeyRef(L"Name", callContext.GetObjectPath());
+            if (nameprop.GetStrValue() != schedinst->GetId())
+            {
+                throw SCXCIMInstanceNotFound(callContext.GetObjectPath().DumpString(), SCXSRCLOCATION);
+            }
+            AddSchedulerKeys(schedinst, instance);
+            AddSchedulerProperties(schedinst, instance);
+            return;
+        }
+
         SCXCoreLib::SCXHandle<SCXSystemLib::CPUInstance> testinst = FindInstance(callContext.GetObjectPath());
 
         // If we get here whithout exception we got a match - set keys and properties,
@@ -45,7 +45,8 @@ namespace SCXCore
     protected:
         //! The set of CIM classes this provider supports
         enum SupportedCimClasses {
-            eSCX_ProcessorStatisticalInformation
+            eSCX_ProcessorStatisticalInformation,
+            eSCX_SystemStatisticalInformation
         };
 
         // Overrides from the base class with relevant implementations
@@ -62,6 +63,8 @@ namespace SCXCore
         void AddKeys(SCXCoreLib::SCXHandle<SCXSystemLib::CPUInstance> cpuinst, SCXProviderLib::SCXInstance& inst);
         void AddProperties(SCXCoreLib::SCXHandle<SCXSystemLib::CPUInstance> cpuinst, SCXProviderLib::SCXInstance& inst);
         SCXCoreLib::SCXHandle<SCXSystemLib::CPUInstance> FindInstance(const SCXProviderLib::SCXInstance& keys) const;
+        void AddSchedulerKeys(SCXCoreLib::SCXHandle<SCXSystemLib::SchedulerInstance> schedinst, SCXProviderLib::SCXInstance& inst);
+        void AddSchedulerProperties(SCXCoreLib::SCXHandle<SCXSystemLib::SchedulerInstance> schedinst, SCXProviderLib::SCXInstance& inst);
         
         //! PAL implementation retrieving CPU information for local host
         SCXCoreLib::SCXHandle<SCXSystemLib::CPUEnumeration> m_cpus;
@@ -168,6 +168,28 @@ namespace SCXCore {
                 SCXProperty prop1(L"AverageDiskQueueLength", ddata1);
                 inst.AddProperty(prop1);
             }
+
+            std::vector<scxulong> histogram;
+            if (diskinst->GetLatencyHistogram(histogram))
+            {
+                std::vector<scxulong> bounds;
+                StatisticalDiskInstance::GetLatencyHistogramBounds(bounds);
+
+                std::vector<SCXProperty> counts;
+                for (size_t i = 0; i < histogram.size(); i++)
+                {
+                    counts.push_back(SCXProperty(L"", histogram[i]));
+                }
+                std::vector<SCXProperty> limits;
+                for (size_t i = 0; i < bounds.size(); i++)
+                {
+                    limits.push_back(SCXProperty(L"", static_cast<unsigned int>(bounds[i])));
+                }
+                SCXProperty prop1(L"LatencyHistogram", counts);
+                SCXProperty prop2(L"LatencyHistogramBounds", limits);
+                inst.AddProperty(prop1);
+                inst.AddProperty(prop2);
+            }
         }
 
         /*----------------------------------------------------------------------------*/
@@ -373,6 +395,25 @@ namespace SCXCore {
                 inst.AddProperty(prop4);
             }
 
+            bool stale;
+            if (diskinst->GetSpaceStale(stale))
+            {
+                SCXProperty prop(L"IsSpaceStale", stale);
+                inst.AddProperty(prop);
+            }
+
+            if (diskinst->GetGrowthRate(ddata1))
+            {
+                SCXProperty prop(L"GrowthMegabytesPerHour", ddata1);
+                inst.AddProperty(prop);
+            }
+
+            if (diskinst->GetTimeToFull(data1))
+            {
+                SCXProperty prop(L"TimeToFullSeconds", data1);
+                inst.AddProperty(prop);
+            }
+
 			// Report percentages for inodes even if inode data is not known
             {
 	            if (!diskinst->GetInodeUsage(data1, data2))
@@ -393,6 +434,32 @@ namespace SCXCore {
                 inst.AddProperty(prop2);
             }
 
+            if (diskinst->GetInodeUsage(data1, data2))
+            {
+                SCXProperty prop1(L"TotalInodes", data1);
+                SCXProperty prop2(L"FreeInodes", data2);
+                inst.AddProperty(prop1);
+                inst.AddProperty(prop2);
+            }
+
+            if (diskinst->GetInodesAvailable(data1))
+            {
+                SCXProperty prop(L"AvailableInodes", data1);
+                inst.AddProperty(prop);
+            }
+
+            if (diskinst->GetInodeConsumption(ddata1))
+            {
+                SCXProperty prop(L"InodesConsumedPerSecond", ddata1);
+                inst.AddProperty(prop);
+            }
+
+            if (diskinst->GetReservedSpace(data1))
+            {
+                SCXProperty prop(L"ReservedMegabytes", data1);
+                inst.AddProperty(prop);
+            }
+
             if (diskinst->GetDiskQueueLength(ddata1))
             {
                 SCXProperty prop1(L"AverageDiskQueueLength", ddata1);
@@ -600,6 +667,19 @@ namespace SCXCore {
                 SCXProperty prop(L"TotalSectors", data);
                 inst.AddProperty(prop);
             }
+
+            bool flag;
+            if (diskinst->GetIsRotational(flag))
+            {
+                SCXProperty prop(L"IsRotational", flag);
+                inst.AddProperty(prop);
+            }
+
+            if (diskinst->GetIsRemovable(flag))
+            {
+                SCXProperty prop(L"IsRemovable", flag);
+                inst.AddProperty(prop);
+            }
         }
 
         /*----------------------------------------------------------------------------*/
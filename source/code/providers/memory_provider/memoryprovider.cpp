@@ -14,9 +14,12 @@
 /*----------------------------------------------------------------------------*/
 
 #include <scxcorelib/scxcmn.h>
+#include <scxcorelib/scxconfigfile.h>
 #include <scxcorelib/scxexception.h>
+#include <scxcorelib/scxfile.h>
 #include <scxcorelib/scxlog.h>
 #include <scxcorelib/scxmath.h>
+#include <scxcorelib/stringaid.h>
 
 #include <scxproviderlib/scxprovidercapabilities.h>
 
@@ -26,6 +29,8 @@
 
 #include <scxsystemlib/memoryenumeration.h>
 #include <scxsystemlib/memoryinstance.h>
+#include <scxsystemlib/vmstatenumeration.h>
+#include <scxsystemlib/vmstatinstance.h>
 
 using namespace SCXProviderLib;
 using namespace SCXSystemLib;
@@ -51,7 +56,7 @@ namespace SCXCore {
 
     */
     MemoryProvider::MemoryProvider() :
-        BaseProvider(L"scx.core.providers.memoryprovider"), m_memEnum(NULL)
+        BaseProvider(L"scx.core.providers.memoryprovider"), m_memEnum(NULL), m_vmstatEnum(NULL)
     {
         LogStartup();
         SCX_LOGTRACE(m_log, L"MemoryProvider constructor");
@@ -87,9 +92,66 @@ namespace SCXCore {
 
         m_ProviderCapabilities.RegisterCimClass(eSCX_MemoryStatisticalInformation,
                                                 L"SCX_MemoryStatisticalInformation");
+        m_ProviderCapabilities.RegisterCimClass(eSCX_MemoryNodeStatisticalInformation,
+                                                L"SCX_MemoryNodeStatisticalInformation");
+        m_ProviderCapabilities.RegisterCimClass(eSCX_MemoryCounterStatisticalInformation,
+                                                L"SCX_MemoryCounterStatisticalInformation");
 
         m_memEnum = new MemoryEnumeration();
         m_memEnum->Init();
+
+        m_vmstatEnum = new VMStatEnumeration();
+        ConfigureVMStat();
+        m_vmstatEnum->Init();
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Select the /proc/vmstat counters that are sampled
+
+       The selection is read from /etc/opt/microsoft/scx/conf/scxmemory.conf
+       with the keys VMStatCounters (comma separated counter names, where a
+       trailing '*' matches all counters with that prefix) and
+       VMStatSampleSeconds. If the file is missing the default counters are
+       sampled every ten seconds.
+    */
+    void MemoryProvider::ConfigureVMStat() // private
+    {
+        ConfigurationFileParser parser(L"/etc/opt/microsoft/scx/conf/scxmemory.conf");
+        if ( ! SCXFile::Exists(SCXFilePath(L"/etc/opt/microsoft/scx/conf/scxmemory.conf")))
+        {
+            // The file is optional, so there is nothing to warn about
+            return;
+        }
+        parser.Parse();
+
+        ConfigurationFileParser::const_iterator iter = parser.find(L"VMStatCounters");
+        if (iter != parser.end())
+        {
+            std::vector<std::wstring> tokens;
+            StrTokenize(iter->second, tokens, L",");
+
+            std::vector<std::string> names;
+            for (size_t i=0; i<tokens.size(); i++)
+            {
+                names.push_back(StrToMultibyte(tokens[i]));
+            }
+            SCX_LOGINFO(m_log, StrAppend(L"Sampling configured vmstat counters: ", iter->second));
+            m_vmstatEnum->SetCounters(names);
+        }
+
+        iter = parser.find(L"VMStatSampleSeconds");
+        if (iter != parser.end())
+        {
+            try
+            {
+                m_vmstatEnum->SetSampleInterval(StrToUInt(iter->second));
+            }
+            catch (SCXCoreLib::SCXNotSupportedException&)
+            {
+                SCX_LOGWARNING(m_log, StrAppend(L"Ignoring invalid VMStatSampleSeconds: ", iter->second));
+            }
+        }
     }
 
 
@@ -108,6 +170,12 @@ namespace SCXCore {
             m_memEnum->CleanUp();
             m_memEnum = NULL;
         }
+
+        if (m_vmstatEnum != NULL)
+        {
+            m_vmstatEnum->CleanUp();
+            m_vmstatEnum = NULL;
+        }
     }
 
     /*----------------------------------------------------------------------------*/
@@ -245,8 +313,218 @@ namespace SCXCore {
                 inst.AddProperty(data_prop2);
             }
         }
+
+        if (meminst->GetHugePagesTotal(data))
+        {
+            SCXProperty data_prop(L"HugePagesTotal", data);
+            inst.AddProperty(data_prop);
+        }
+        if (meminst->GetHugePagesFree(data))
+        {
+            SCXProperty data_prop(L"HugePagesFree", data);
+            inst.AddProperty(data_prop);
+        }
+        if (meminst->GetHugePageSize(data))
+        {
+            SCXProperty data_prop(L"HugePageSize", data);
+            inst.AddProperty(data_prop);
+        }
+        if (meminst->GetSlabMemory(data))
+        {
+            SCXProperty data_prop(L"SlabMemory", data);
+            inst.AddProperty(data_prop);
+        }
+        if (meminst->GetSlabReclaimableMemory(data))
+        {
+            SCXProperty data_prop(L"SlabReclaimableMemory", data);
+            inst.AddProperty(data_prop);
+        }
+        if (meminst->GetSharedMemory(data))
+        {
+            SCXProperty data_prop(L"SharedMemory", data);
+            inst.AddProperty(data_prop);
+        }
+        if (meminst->GetDirtyMemory(data))
+        {
+            SCXProperty data_prop(L"DirtyMemory", data);
+            inst.AddProperty(data_prop);
+        }
+        if (meminst->GetWritebackMemory(data))
+        {
+            SCXProperty data_prop(L"WritebackMemory", data);
+            inst.AddProperty(data_prop);
+        }
+
+        double trend = 0.0;
+        if (meminst->GetDirtyMemoryTrend(trend))
+        {
+            SCXProperty data_prop(L"DirtyMemoryTrend", trend);
+            inst.AddProperty(data_prop);
+        }
+        if (meminst->GetWritebackMemoryTrend(trend))
+        {
+            SCXProperty data_prop(L"WritebackMemoryTrend", trend);
+            inst.AddProperty(data_prop);
+        }
     }
 
+    /*----------------------------------------------------------------------------*/
+    /**
+       Gets the name of a NUMA node instance.
+
+       \param[in]  node  Memory of the node
+       \returns    "_Node" followed by the node number, as for the NUMA node processor aggregates
+    */
+    std::wstring MemoryProvider::GetNodeName(const SCXSystemLib::MemoryNodeValues& node) // private
+    {
+        return L"_Node" + StrFrom(node.node);
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Set the keys of a NUMA node instance.
+
+       \param[in]       node  Memory of the node
+       \param[out]      inst  Instance to add keys to
+
+    */
+    void MemoryProvider::AddNodeKeys(const SCXSystemLib::MemoryNodeValues& node, SCXInstance &inst) const // private
+    {
+        SCX_LOGTRACE(m_log, L"MemoryProvider::AddNodeKeys()");
+
+        SCXProperty name_prop(L"Name", GetNodeName(node));
+        inst.AddKey(name_prop);
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Set all properties of a NUMA node instance.
+
+       \param[in]       node  Memory of the node
+       \param[out]      inst  Instance to populate
+
+       Only the values present in the meminfo file of the node are set.
+
+    */
+    void MemoryProvider::AddNodeProperties(const SCXSystemLib::MemoryNodeValues& node, SCXInstance &inst) const // private
+    {
+        SCX_LOGTRACE(m_log, L"MemoryProvider::AddNodeProperties()");
+
+        const scxulong* kB = node.memInfo.value;
+        const bool* found = node.memInfo.found;
+
+        SCXProperty node_prop(L"NodeNumber", static_cast<unsigned int>(node.node));
+        inst.AddProperty(node_prop);
+
+        if (found[eMemInfoMemTotal])
+        {
+            SCXProperty data_prop(L"TotalMemory", KiloBytesToMegaBytes(kB[eMemInfoMemTotal]));
+            inst.AddProperty(data_prop);
+        }
+        if (found[eMemInfoMemFree])
+        {
+            SCXProperty data_prop(L"FreeMemory", KiloBytesToMegaBytes(kB[eMemInfoMemFree]));
+            inst.AddProperty(data_prop);
+
+            if (found[eMemInfoMemTotal] && kB[eMemInfoMemTotal] > 0)
+            {
+                unsigned char percent = static_cast<unsigned char> (GetPercentage(0, kB[eMemInfoMemFree], 0, kB[eMemInfoMemTotal]));
+                SCXProperty data_prop2(L"PercentFreeMemory", percent);
+                inst.AddProperty(data_prop2);
+            }
+        }
+        if (found[eMemInfoMemUsed])
+        {
+            SCXProperty data_prop(L"UsedMemory", KiloBytesToMegaBytes(kB[eMemInfoMemUsed]));
+            inst.AddProperty(data_prop);
+        }
+        if (found[eMemInfoHugePagesTotal])
+        {
+            SCXProperty data_prop(L"HugePagesTotal", kB[eMemInfoHugePagesTotal]);
+            inst.AddProperty(data_prop);
+        }
+        if (found[eMemInfoHugePagesFree])
+        {
+            SCXProperty data_prop(L"HugePagesFree", kB[eMemInfoHugePagesFree]);
+            inst.AddProperty(data_prop);
+        }
+        if (found[eMemInfoSlab])
+        {
+            SCXProperty data_prop(L"SlabMemory", KiloBytesToMegaBytes(kB[eMemInfoSlab]));
+            inst.AddProperty(data_prop);
+        }
+        if (found[eMemInfoSReclaimable])
+        {
+            SCXProperty data_prop(L"SlabReclaimableMemory", KiloBytesToMegaBytes(kB[eMemInfoSReclaimable]));
+            inst.AddProperty(data_prop);
+        }
+        if (found[eMemInfoShmem])
+        {
+            SCXProperty data_prop(L"SharedMemory", KiloBytesToMegaBytes(kB[eMemInfoShmem]));
+            inst.AddProperty(data_prop);
+        }
+        if (found[eMemInfoDirty])
+        {
+            SCXProperty data_prop(L"DirtyMemory", KiloBytesToMegaBytes(kB[eMemInfoDirty]));
+            inst.AddProperty(data_prop);
+        }
+        if (found[eMemInfoWriteback])
+        {
+            SCXProperty data_prop(L"WritebackMemory", KiloBytesToMegaBytes(kB[eMemInfoWriteback]));
+            inst.AddProperty(data_prop);
+        }
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Set the keys of a vmstat counter instance.
+
+       \param[in]       counter  Sampled counter
+       \param[out]      inst     Instance to add keys to
+
+    */
+    void MemoryProvider::AddCounterKeys(SCXCoreLib::SCXHandle<SCXSystemLib::VMStatInstance> counter, SCXInstance &inst) const // private
+    {
+        SCX_LOGTRACE(m_log, L"MemoryProvider::AddCounterKeys()");
+
+        SCXProperty name_prop(L"Name", counter->GetId());
+        inst.AddKey(name_prop);
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Set all properties of a vmstat counter instance.
+
+       \param[in]       counter  Sampled counter
+       \param[out]      inst     Instance to populate
+
+    */
+    void MemoryProvider::AddCounterProperties(SCXCoreLib::SCXHandle<SCXSystemLib::VMStatInstance> counter, SCXInstance &inst) const // private
+    {
+        SCX_LOGTRACE(m_log, L"MemoryProvider::AddCounterProperties()");
+
+        scxulong value = 0;
+        if (counter->GetValue(value))
+        {
+            SCXProperty data_prop(L"Value", value);
+            inst.AddProperty(data_prop);
+        }
+
+        double rate = 0.0;
+        if (counter->GetRatePerSecond(rate))
+        {
+            SCXProperty data_prop(L"RatePerSecond", rate);
+            inst.AddProperty(data_prop);
+        }
+        if (counter->GetAverageRatePerSecond(rate))
+        {
+            SCXProperty data_prop(L"AverageRatePerSecond", rate);
+            inst.AddProperty(data_prop);
+        }
+
+        SCXProperty interval_prop(L"SampleInterval", m_vmstatEnum->GetSampleInterval());
+        inst.AddProperty(interval_prop);
+    }
 
     /*----------------------------------------------------------------------------*/
     /**
@@ -256,11 +534,37 @@ namespace SCXCore {
        \param[out]  names       Collection of instances with key properties
 
     */
-    void MemoryProvider::DoEnumInstanceNames(const SCXCallContext& /* callContext */,
+    void MemoryProvider::DoEnumInstanceNames(const SCXCallContext& callContext,
                                              SCXInstanceCollection &names)
     {
         SCX_LOGTRACE(m_log, L"MemoryProvider DoEnumInstanceNames");
 
+        SupportedCimClasses cimtype = static_cast<SupportedCimClasses>(m_ProviderCapabilities.GetCimClassId(callContext.GetObjectPath()));
+
+        if (eSCX_MemoryNodeStatisticalInformation == cimtype)
+        {
+            SCXCoreLib::SCXHandle<SCXSystemLib::MemoryInstance> meminst = m_memEnum->GetTotalInstance();
+            MemoryNodeValues node;
+            for (size_t i = 0; meminst != 0 && meminst->GetNode(i, node); i++)
+            {
+                SCXInstance inst;
+                AddNodeKeys(node, inst);
+                names.AddInstance(inst);
+            }
+            return;
+        }
+
+        if (eSCX_MemoryCounterStatisticalInformation == cimtype)
+        {
+            for (size_t i = 0; i < m_vmstatEnum->Size(); i++)
+            {
+                SCXInstance inst;
+                AddCounterKeys(m_vmstatEnum->GetInstance(i), inst);
+                names.AddInstance(inst);
+            }
+            return;
+        }
+
         // There should be only one instance.
         if (m_memEnum->GetTotalInstance() != 0)
         {
@@ -280,11 +584,42 @@ namespace SCXCore {
        \throws        SCXInternalErrorException   If instances in list are not CPUInstance
 
     */
-    void MemoryProvider::DoEnumInstances(const SCXCallContext& /* callContext */,
+    void MemoryProvider::DoEnumInstances(const SCXCallContext& callContext,
                                          SCXInstanceCollection &instances)
     {
         SCX_LOGTRACE(m_log, L"MemoryProvider DoEnumInstances");
 
+        SupportedCimClasses cimtype = static_cast<SupportedCimClasses>(m_ProviderCapabilities.GetCimClassId(callContext.GetObjectPath()));
+
+        if (eSCX_MemoryNodeStatisticalInformation == cimtype)
+        {
+            // Node memory is sampled by the PAL thread, no update needed
+            SCXCoreLib::SCXHandle<SCXSystemLib::MemoryInstance> meminst = m_memEnum->GetTotalInstance();
+            MemoryNodeValues node;
+            for (size_t i = 0; meminst != 0 && meminst->GetNode(i, node); i++)
+            {
+                SCXInstance inst;
+                AddNodeKeys(node, inst);
+                AddNodeProperties(node, inst);
+                instances.AddInstance(inst);
+            }
+            return;
+        }
+
+        if (eSCX_MemoryCounterStatisticalInformation == cimtype)
+        {
+            // Counters are sampled by the PAL thread, the update computes the rates
+            m_vmstatEnum->Update();
+            for (size_t i = 0; i < m_vmstatEnum->Size(); i++)
+            {
+                SCXInstance inst;
+                AddCounterKeys(m_vmstatEnum->GetInstance(i), inst);
+                AddCounterProperties(m_vmstatEnum->GetInstance(i), inst);
+                instances.AddInstance(inst);
+            }
+            return;
+        }
+
         // Update memory PAL instance.
         m_memEnum->Update();
 
@@ -307,15 +642,49 @@ namespace SCXCore {
 
        \throws     SCXInvalidArgumentException  If no Name property in keys
        \throws     SCXInternalErrorException    If instances in list are not CPUInstance
+       \throws     SCXCIMInstanceNotFound       If the NUMA node or vmstat counter does not exist
     */
     void MemoryProvider::DoGetInstance(const SCXCallContext& callContext, SCXInstance& instance)
     {
         SCX_LOGTRACE(m_log, L"MemoryProvider::DoGetInstance()");
 
+        const SCXInstance& keys = callContext.GetObjectPath();
+        SupportedCimClasses cimtype = static_cast<SupportedCimClasses>(m_ProviderCapabilities.GetCimClassId(keys));
+
+        if (eSCX_MemoryNodeStatisticalInformation == cimtype)
+        {
+            const SCXProperty& nameprop = GetKeyRef(L"Name", keys);
+            SCXCoreLib::SCXHandle<SCXSystemLib::MemoryInstance> meminst = m_memEnum->GetTotalInstance();
+            MemoryNodeValues node;
+            for (size_t i = 0; meminst != 0 && meminst->GetNode(i, node); i++)
+            {
+                if (nameprop.GetStrValue() == GetNodeName(node))
+                {
+                    AddNodeKeys(node, instance);
+                    AddNodeProperties(node, instance);
+                    return;
+                }
+            }
+            throw SCXCIMInstanceNotFound(keys.DumpString(), SCXSRCLOCATION);
+        }
+
+        if (eSCX_MemoryCounterStatisticalInformation == cimtype)
+        {
+            const SCXProperty& nameprop = GetKeyRef(L"Name", keys);
+            m_vmstatEnum->Update();
+            SCXCoreLib::SCXHandle<SCXSystemLib::VMStatInstance> counter = m_vmstatEnum->GetInstance(nameprop.GetStrValue());
+            if (counter == NULL)
+            {
+                throw SCXCIMInstanceNotFound(keys.DumpString(), SCXSRCLOCATION);
+            }
+            AddCounterKeys(counter, instance);
+            AddCounterProperties(counter, instance);
+            return;
+        }
+
         // Refresh the collection
         m_memEnum->Update();
 
-        const SCXInstance& keys = callContext.GetObjectPath();
         ValidateKeyValue(L"Name", keys, L"Memory");
 
         // There should be only one instance.
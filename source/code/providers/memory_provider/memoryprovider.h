@@ -19,6 +19,7 @@
 #include <scxproviderlib/cmpibase.h>
 #include <scxsystemlib/memoryenumeration.h>
 #include <scxsystemlib/memoryinstance.h>
+#include <scxsystemlib/vmstatenumeration.h>
 #include <scxcorelib/scxlog.h>
 
 namespace SCXCore
@@ -47,7 +48,9 @@ namespace SCXCore
     protected:
         //! The set of CIM classes this provider supports
         enum SupportedCimClasses {
-            eSCX_MemoryStatisticalInformation
+            eSCX_MemoryStatisticalInformation,
+            eSCX_MemoryNodeStatisticalInformation,
+            eSCX_MemoryCounterStatisticalInformation
         };
 
         // Overrides from the base class with relevant implementations
@@ -63,9 +66,17 @@ namespace SCXCore
     private:
         void AddKeys(SCXCoreLib::SCXHandle<SCXSystemLib::MemoryInstance> meminst, SCXProviderLib::SCXInstance& inst) const;
         void AddProperties(SCXCoreLib::SCXHandle<SCXSystemLib::MemoryInstance> meminst, SCXProviderLib::SCXInstance& inst) const;
+        void AddNodeKeys(const SCXSystemLib::MemoryNodeValues& node, SCXProviderLib::SCXInstance& inst) const;
+        void AddNodeProperties(const SCXSystemLib::MemoryNodeValues& node, SCXProviderLib::SCXInstance& inst) const;
+        static std::wstring GetNodeName(const SCXSystemLib::MemoryNodeValues& node);
+        void AddCounterKeys(SCXCoreLib::SCXHandle<SCXSystemLib::VMStatInstance> counter, SCXProviderLib::SCXInstance& inst) const;
+        void AddCounterProperties(SCXCoreLib::SCXHandle<SCXSystemLib::VMStatInstance> counter, SCXProviderLib::SCXInstance& inst) const;
+        void ConfigureVMStat();
 
         //! PAL implementation retrieving memory information for local host
         SCXCoreLib::SCXHandle<SCXSystemLib::MemoryEnumeration> m_memEnum;
+        //! PAL implementation sampling /proc/vmstat counters
+        SCXCoreLib::SCXHandle<SCXSystemLib::VMStatEnumeration> m_vmstatEnum;
     };
 }
 
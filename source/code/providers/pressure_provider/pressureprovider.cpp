@@ -0,0 +1,329 @@
+/*------------------------------------------------------------------------------
+    Copyright (c) Microsoft Corporation.  All rights reserved.
+
+*/
+/**
+    \file
+
+    \brief     Main implementation file for Pressure Stall Information Provider
+
+    \date      2026-10-18 15:00:00
+
+*/
+/*----------------------------------------------------------------------------*/
+
+#include <scxcorelib/scxcmn.h>
+#include <scxcorelib/scxexception.h>
+#include <scxcorelib/scxlog.h>
+#include <scxcorelib/stringaid.h>
+
+#include <scxproviderlib/scxprovidercapabilities.h>
+
+#include "../meta_provider/startuplog.h"
+
+#include "pressureprovider.h"
+
+#include <scxsystemlib/pressureenumeration.h>
+#include <scxsystemlib/pressureinstance.h>
+
+using namespace SCXProviderLib;
+using namespace SCXSystemLib;
+using namespace SCXCoreLib;
+
+namespace SCXCore {
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Provide CMPI interface for this class
+
+       The class implementation (concrete class) is PressureProvider and the name of the
+       provider in CIM registration terms is SCX_PressureProvider.
+
+    */
+    SCXProviderDef(PressureProvider, SCX_PressureProvider)
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Default constructor
+
+       The Singleton thread lock will be held during this call.
+
+    */
+    PressureProvider::PressureProvider() :
+        BaseProvider(L"scx.core.providers.pressureprovider"), m_pressure(NULL)
+    {
+        LogStartup();
+        SCX_LOGTRACE(m_log, L"PressureProvider constructor");
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Destructor
+    */
+    PressureProvider::~PressureProvider()
+    {
+        // Do not log here since when this destructor is called the objects neccesary for logging might no longer be alive
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Registration of supported capabilities
+
+       Callback from the BaseProvider in which the provider registers the supported
+       classes and methods. The registrations should match the contents of the
+       MOF files exactly.
+
+    */
+    void PressureProvider::DoInit()
+    {
+        SCX_LOGTRACE(m_log, L"PressureProvider::DoInit");
+
+        if (m_pressure != NULL)
+        {
+            SCXASSERTFAIL(L"DoInit() called multiple times without a call to DoCleanup() between");
+            DoCleanup();
+        }
+
+        m_ProviderCapabilities.RegisterCimClass(eSCX_PressureStatisticalInformation,
+                                                L"SCX_PressureStatisticalInformation");
+
+        m_pressure = new PressureEnumeration();
+        m_pressure->Init();
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+        Provide a way for pal layer to do cleanup. Stop all threads etc.
+    */
+    void PressureProvider::DoCleanup()
+    {
+        SCX_LOGTRACE(m_log, L"PressureProvider::DoCleanup");
+
+        m_ProviderCapabilities.Clear();
+
+        if (m_pressure != NULL)
+        {
+            m_pressure->CleanUp();
+            m_pressure = NULL;
+        }
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Set the keys of the SCXInstance object from the information in the entity instance
+
+       \param[in]       psinst    Internal instance representation to get data from
+       \param[out]      inst      Instance to add keys to
+
+       \throws          SCXInvalidArgumentException  The instance can not be converted to a pressure instance
+
+       The key is the resource name, "cpu", "memory" or "io".
+
+    */
+    void PressureProvider::AddKeys(SCXCoreLib::SCXHandle<SCXSystemLib::PressureInstance> psinst, SCXInstance &inst) const // private
+    {
+        SCX_LOGTRACE(m_log, L"PressureProvider::AddKeys()");
+
+        if (psinst == NULL)
+        {
+            throw SCXInvalidArgumentException(L"einst", L"Not a PressureInstance", SCXSRCLOCATION);
+        }
+
+        SCXProperty name_prop(L"Name", psinst->GetId());
+        inst.AddKey(name_prop);
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+        Set all properties of the SCXInstance from the information in the EntityInstance
+
+        \param[in]       psinst   Internal instance representation to get data from
+        \param[out]      inst     Instance to populate
+
+        \throws          SCXInvalidArgumentException The instance can not be converted to a pressure instance
+
+    */
+    void PressureProvider::AddProperties(SCXCoreLib::SCXHandle<SCXSystemLib::PressureInstance> psinst, SCXInstance &inst) const // private
+    {
+        double ddata = 0;
+        scxulong data = 0;
+
+        SCX_LOGTRACE(m_log, L"PressureProvider::AddProperties()");
+
+        if (psinst == NULL)
+        {
+            throw SCXInvalidArgumentException(L"einst", L"Not a PressureInstance", SCXSRCLOCATION);
+        }
+
+        SCXProperty total_prop(L"IsAggregate", psinst->IsTotal());
+        inst.AddProperty(total_prop);
+
+        if (psinst->GetPercentSomeStalled(ddata))
+        {
+            SCXProperty data_prop(L"PercentSomeStalled", ddata);
+            inst.AddProperty(data_prop);
+        }
+        if (psinst->GetSomeAverage10(ddata))
+        {
+            SCXProperty data_prop(L"SomeAverage10", ddata);
+            inst.AddProperty(data_prop);
+        }
+        if (psinst->GetSomeAverage60(ddata))
+        {
+            SCXProperty data_prop(L"SomeAverage60", ddata);
+            inst.AddProperty(data_prop);
+        }
+        if (psinst->GetSomeAverage300(ddata))
+        {
+            SCXProperty data_prop(L"SomeAverage300", ddata);
+            inst.AddProperty(data_prop);
+        }
+        if (psinst->GetSomeTotal(data))
+        {
+            SCXProperty data_prop(L"SomeTotalStallTime", data);
+            inst.AddProperty(data_prop);
+        }
+
+        if (psinst->GetPercentFullStalled(ddata))
+        {
+            SCXProperty data_prop(L"PercentFullStalled", ddata);
+            inst.AddProperty(data_prop);
+        }
+        if (psinst->GetFullAverage10(ddata))
+        {
+            SCXProperty data_prop(L"FullAverage10", ddata);
+            inst.AddProperty(data_prop);
+        }
+        if (psinst->GetFullAverage60(ddata))
+        {
+            SCXProperty data_prop(L"FullAverage60", ddata);
+            inst.AddProperty(data_prop);
+        }
+        if (psinst->GetFullAverage300(ddata))
+        {
+            SCXProperty data_prop(L"FullAverage300", ddata);
+            inst.AddProperty(data_prop);
+        }
+        if (psinst->GetFullTotal(data))
+        {
+            SCXProperty data_prop(L"FullTotalStallTime", data);
+            inst.AddProperty(data_prop);
+        }
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+      Lookup the instance representation, given keys provided from CIMOM
+
+      \param[in]    keys   SCXInstance with property keys set
+      \returns             Pointer to located instance
+
+      \throws              SCXCIMInstanceNotFound   The instance with given keys cannot be found
+
+    */
+    SCXCoreLib::SCXHandle<SCXSystemLib::PressureInstance> PressureProvider::FindInstance(const SCXInstance& keys) const // private
+    {
+        const SCXProperty& nameprop = GetKeyRef(L"Name", keys);
+
+        SCXCoreLib::SCXHandle<SCXSystemLib::PressureInstance> testinst = m_pressure->GetInstance(nameprop.GetStrValue());
+        if (NULL == testinst)
+        {
+            throw SCXCIMInstanceNotFound(keys.DumpString(), SCXSRCLOCATION);
+        }
+
+        return testinst;
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Enumerate instance names
+
+       \param[in]   callContext Context details of this request
+       \param[out]  names       Collection of instances with key properties
+
+       Nothing is returned on systems without pressure stall information.
+
+    */
+    void PressureProvider::DoEnumInstanceNames(const SCXCallContext& /* callContext */,
+                                               SCXInstanceCollection &names)
+    {
+        SCX_LOGTRACE(m_log, L"PressureProvider DoEnumInstanceNames");
+
+        SCXCoreLib::SCXThreadLock lock(m_pressure->GetLockHandle());
+
+        m_pressure->UpdateNoLock(lock, false);
+
+        SCX_LOGTRACE(m_log, StrAppend(L"Number of pressure resources = ", m_pressure->Size()));
+
+        for (size_t i=0; i<m_pressure->Size(); i++)
+        {
+            SCXInstance inst;
+            AddKeys(m_pressure->GetInstance(i), inst);
+            names.AddInstance(inst);
+        }
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Enumerate instances
+
+       \param[in]     callContext Details of the client request
+       \param[out]    instances   Collection of instances
+
+    */
+    void PressureProvider::DoEnumInstances(const SCXCallContext& /* callContext */,
+                                           SCXInstanceCollection &instances)
+    {
+        SCX_LOGTRACE(m_log, L"PressureProvider DoEnumInstances");
+
+        SCXCoreLib::SCXThreadLock lock(m_pressure->GetLockHandle());
+
+        m_pressure->UpdateNoLock(lock);
+
+        for (size_t i=0; i<m_pressure->Size(); i++)
+        {
+            SCXInstance inst;
+            AddKeys(m_pressure->GetInstance(i), inst);
+            AddProperties(m_pressure->GetInstance(i), inst);
+            instances.AddInstance(inst);
+        }
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Get an instance
+
+       \param[in]   callContext Context of the original request, indicating which instance to retrieve.
+       \param[out]  instance    The returned instance
+
+       \throws      SCXInvalidArgumentException  If no Name property in keys
+       \throws      SCXCIMInstanceNotFound       If the resource is not reported
+    */
+    void PressureProvider::DoGetInstance(const SCXCallContext& callContext, SCXInstance& instance)
+    {
+        SCX_LOGTRACE(m_log, L"PressureProvider::DoGetInstance()");
+
+        SCXCoreLib::SCXThreadLock lock(m_pressure->GetLockHandle());
+
+        m_pressure->UpdateNoLock(lock);
+
+        SCXCoreLib::SCXHandle<SCXSystemLib::PressureInstance> testinst = FindInstance(callContext.GetObjectPath());
+
+        AddKeys(testinst, instance);
+        AddProperties(testinst, instance);
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+        Dump object as string (for logging).
+
+        \returns       The object represented as a string suitable for logging.
+
+    */
+    const std::wstring PressureProvider::DumpString() const
+    {
+        return L"PressureProvider";
+    }
+}
+
+/*----------------------------E-N-D---O-F---F-I-L-E---------------------------*/
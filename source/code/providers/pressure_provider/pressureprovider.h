@@ -0,0 +1,75 @@
+/*------------------------------------------------------------------------------
+    Copyright (c) Microsoft Corporation.  All rights reserved.
+
+*/
+/**
+    \file
+
+    \brief     Pressure stall information provider header file
+
+    \date      2026-10-18 15:00:00
+
+*/
+/*----------------------------------------------------------------------------*/
+#ifndef PRESSUREPROVIDER_H
+#define PRESSUREPROVIDER_H
+
+#include <string>
+
+#include <scxproviderlib/cmpibase.h>
+#include <scxsystemlib/pressureenumeration.h>
+#include <scxsystemlib/pressureinstance.h>
+#include <scxcorelib/scxlog.h>
+
+namespace SCXCore
+{
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Pressure stall information provider
+
+       Concrete instance of the CMPI BaseProvider delivering CIM
+       information about how much time tasks on current host spend
+       waiting for CPU, memory and IO.
+
+       A provider-specific thread lock will be held at each call to
+       the Do* methods, so this implementation class does not need
+       to worry about that.
+
+    */
+    class PressureProvider : public SCXProviderLib::BaseProvider
+    {
+    public:
+        PressureProvider();
+        ~PressureProvider();
+
+        virtual const std::wstring DumpString() const;
+
+    protected:
+        //! The set of CIM classes this provider supports
+        enum SupportedCimClasses {
+            eSCX_PressureStatisticalInformation
+        };
+
+        // Overrides from the base class with relevant implementations
+        virtual void DoInit();
+        virtual void DoEnumInstanceNames(const SCXProviderLib::SCXCallContext& callContext,
+                                         SCXProviderLib::SCXInstanceCollection &names);
+        virtual void DoEnumInstances(const SCXProviderLib::SCXCallContext& callContext,
+                                     SCXProviderLib::SCXInstanceCollection &instances);
+        virtual void DoGetInstance(const SCXProviderLib::SCXCallContext& callContext,
+                                   SCXProviderLib::SCXInstance& instance);
+        virtual void DoCleanup();
+
+    private:
+        void AddKeys(SCXCoreLib::SCXHandle<SCXSystemLib::PressureInstance> psinst, SCXProviderLib::SCXInstance& inst) const;
+        void AddProperties(SCXCoreLib::SCXHandle<SCXSystemLib::PressureInstance> psinst, SCXProviderLib::SCXInstance& inst) const;
+        SCXCoreLib::SCXHandle<SCXSystemLib::PressureInstance> FindInstance(const SCXProviderLib::SCXInstance& keys) const;
+
+        //! PAL implementation retrieving pressure stall information for local host
+        SCXCoreLib::SCXHandle<SCXSystemLib::PressureEnumeration> m_pressure;
+    };
+}
+
+#endif /* PRESSUREPROVIDER_H */
+/*----------------------------E-N-D---O-F---F-I-L-E---------------------------*/
@@ -13,6 +13,7 @@
 /*----------------------------------------------------------------------------*/
 
 #include <scxcorelib/scxcmn.h>
+#include <scxcorelib/scxconfigfile.h>
 #include <scxcorelib/scxexception.h>
 
 #include <scxproviderlib/scxprovidercapabilities.h>
@@ -24,6 +25,7 @@
 #include <scxsystemlib/processenumeration.h>
 #include <scxcorelib/scxlog.h>
 #include <scxcorelib/stringaid.h>
+#include <scxcorelib/scxfile.h>
 
 #include <sstream>
 #include <algorithm>
@@ -97,6 +99,120 @@ namespace SCXCore {
                                                  L"TopResourceConsumers");
         m_ProviderCapabilities.RegisterCimClass(eSCX_UnixProcessStatisticalInformation,
                                                 L"SCX_UnixProcessStatisticalInformation");
+        m_ProviderCapabilities.RegisterCimClass(eSCX_ProcessGroupStatisticalInformation,
+                                                L"SCX_ProcessGroupStatisticalInformation");
+        m_ProviderCapabilities.RegisterCimClass(eSCX_UnixThreadStatisticalInformation,
+                                                L"SCX_UnixThreadStatisticalInformation");
+        m_ProviderCapabilities.RegisterCimClass(eSCX_OOMKillEvent,
+                                                L"SCX_OOMKillEvent");
+
+        // All settings share one file, so it is read once. It is optional.
+        ConfigurationFileParser config(L"/etc/opt/microsoft/scx/conf/scxprocess.conf");
+        if (SCXFile::Exists(SCXFilePath(L"/etc/opt/microsoft/scx/conf/scxprocess.conf")))
+        {
+            config.Parse();
+        }
+
+        ConfigureThreadSampling(config);
+        ConfigureOOMKillEvents(config);
+        ConfigureIOAccounting(config);
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Select the processes whose threads are sampled
+
+       Per-thread sampling is opt-in since a single process may have thousands
+       of threads. The selection is read from /etc/opt/microsoft/scx/conf/scxprocess.conf
+       with the keys ThreadSamplingNames (comma separated process names) and
+       ThreadSamplingPids (comma separated process ids). If the file is missing
+       no threads are sampled.
+
+       \param config Parsed contents of scxprocess.conf
+    */
+    void ProcessProvider::ConfigureThreadSampling(const ConfigurationParser& config) // private
+    {
+        std::vector<std::wstring> names;
+        std::vector<scxpid_t> pids;
+
+        ConfigurationFileParser::const_iterator iter = config.find(L"ThreadSamplingNames");
+        if (iter != config.end())
+        {
+            StrTokenize(iter->second, names, L",");
+        }
+
+        iter = config.find(L"ThreadSamplingPids");
+        if (iter != config.end())
+        {
+            std::vector<std::wstring> tokens;
+            StrTokenize(iter->second, tokens, L",");
+            for (size_t i=0; i<tokens.size(); i++)
+            {
+                try
+                {
+                    pids.push_back(static_cast<scxpid_t>(StrToULong(tokens[i])));
+                }
+                catch (SCXCoreLib::SCXNotSupportedException&)
+                {
+                    SCX_LOGWARNING(m_log, StrAppend(L"Ignoring invalid ThreadSamplingPids entry: ", tokens[i]));
+                }
+            }
+        }
+
+        if ( ! names.empty() || ! pids.empty())
+        {
+            SCX_LOGINFO(m_log, StrAppend(StrAppend(L"Sampling threads of process names: ", names.size()),
+                                         StrAppend(L", process ids: ", pids.size())));
+        }
+        m_processes->SetThreadSampling(names, pids);
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Set the number of OOM kill events kept
+
+       Read from /etc/opt/microsoft/scx/conf/scxprocess.conf with the key
+       OOMKillEventCount. If the file or key is missing the latest
+       OOMKILL_DEFAULT_EVENT_COUNT events are kept.
+
+       \param config Parsed contents of scxprocess.conf
+    */
+    void ProcessProvider::ConfigureOOMKillEvents(const ConfigurationParser& config) // private
+    {
+        ConfigurationFileParser::const_iterator iter = config.find(L"OOMKillEventCount");
+        if (iter != config.end())
+        {
+            try
+            {
+                m_processes->SetOOMKillEventCount(StrToUInt(iter->second));
+            }
+            catch (SCXCoreLib::SCXNotSupportedException&)
+            {
+                SCX_LOGWARNING(m_log, StrAppend(L"Ignoring invalid OOMKillEventCount: ", iter->second));
+            }
+        }
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Turn the per-process I/O accounting on or off
+
+       Read from /etc/opt/microsoft/scx/conf/scxprocess.conf with the key
+       IOAccounting. It is on unless the key is false, no or 0.
+
+       \param config Parsed contents of scxprocess.conf
+    */
+    void ProcessProvider::ConfigureIOAccounting(const ConfigurationParser& config) // private
+    {
+        ConfigurationFileParser::const_iterator iter = config.find(L"IOAccounting");
+        if (iter != config.end() && (
+                iter->second == L"false" ||
+                iter->second == L"no" ||
+                iter->second == L"0"))
+        {
+            SCX_LOGINFO(m_log, L"Per-process I/O accounting turned off");
+            m_processes->SetIOAccounting(false);
+        }
     }
 
     /*----------------------------------------------------------------------------*/
@@ -307,6 +423,37 @@ namespace SCXCore {
                 SCXProperty prop(L"PagesReadPerSec", ulong);
                 inst.AddProperty(prop);
             }
+
+            if (processinst->GetReadBytesPerSecond(ulong))
+            {
+                SCXProperty prop(L"ReadBytesPerSecond", ulong);
+                inst.AddProperty(prop);
+            }
+
+            if (processinst->GetWriteBytesPerSecond(ulong))
+            {
+                SCXProperty prop(L"WriteBytesPerSecond", ulong);
+                inst.AddProperty(prop);
+            }
+
+            if (processinst->GetReadOperationsPerSecond(ulong))
+            {
+                SCXProperty prop(L"ReadOperationsPerSecond", ulong);
+                inst.AddProperty(prop);
+            }
+
+            if (processinst->GetWriteOperationsPerSecond(ulong))
+            {
+                SCXProperty prop(L"WriteOperationsPerSecond", ulong);
+                inst.AddProperty(prop);
+            }
+
+            // Counters of the process sampler itself, the same on every instance
+            SCXProperty allocated_prop(L"InstancesAllocated", static_cast<scxulong>(m_processes->GetAllocationsLastSample()));
+            inst.AddProperty(allocated_prop);
+
+            SCXProperty reused_prop(L"InstancesReused", static_cast<scxulong>(m_processes->GetReusesLastSample()));
+            inst.AddProperty(reused_prop);
         }
         else if (eSCX_UnixProcess == cimtype)
         {
@@ -505,6 +652,330 @@ namespace SCXCore {
     }
 
 
+    /*----------------------------------------------------------------------------*/
+    /**
+       Add the key properties of a process group to an SCXInstance
+
+       \param[in]   groupinst      Process group instance to get data from
+       \param[out]  inst           Instance to add keys to
+
+       \throws      SCXInvalidArgumentException - The instance is NULL
+    */
+    void ProcessProvider::AddGroupKeys(SCXCoreLib::SCXHandle<SCXSystemLib::ProcessGroupInstance> groupinst, SCXInstance &inst) // private
+    {
+        SCX_LOGTRACE(m_log, L"ProcessProvider AddGroupKeys()");
+
+        if (groupinst == NULL)
+        {
+            throw SCXInvalidArgumentException(L"groupinst", L"Not a ProcessGroupInstance", SCXSRCLOCATION);
+        }
+
+        SCXProperty name_prop(L"Name", groupinst->GetId());
+        inst.AddKey(name_prop);
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Set all properties from the ProcessGroupInstance in the SCXInstance
+
+       \param[in]  groupinst    - Process group instance to get data from
+       \param[in]  inst         - Instance to populate
+
+       \throws      SCXInvalidArgumentException - The instance is NULL
+    */
+    void ProcessProvider::AddGroupProperties(SCXCoreLib::SCXHandle<SCXSystemLib::ProcessGroupInstance> groupinst, SCXInstance &inst) // private
+    {
+        if (groupinst == NULL)
+        {
+            throw SCXInvalidArgumentException(L"groupinst", L"Not a ProcessGroupInstance", SCXSRCLOCATION);
+        }
+
+        SCX_LOGTRACE(m_log, L"ProcessProvider AddGroupProperties()");
+
+        std::string str;
+        scxulong ulong = 0;
+
+        SCXProperty total_prop(L"IsAggregate", true);
+        inst.AddProperty(total_prop);
+
+        if (groupinst->GetProcessName(str))
+        {
+            SCXProperty prop(L"ProcessName", StrFromMultibyte(str));
+            inst.AddProperty(prop);
+        }
+
+        if (groupinst->GetEffectiveUserID(ulong))
+        {
+            SCXProperty prop(L"EffectiveUserID", ulong);
+            inst.AddProperty(prop);
+        }
+
+        if (groupinst->GetCGroupPath(str))
+        {
+            SCXProperty prop(L"CGroupPath", StrFromMultibyte(str));
+            inst.AddProperty(prop);
+        }
+
+        if (groupinst->GetProcessCount(ulong))
+        {
+            SCXProperty prop(L"ProcessCount", static_cast<unsigned int>(ulong));
+            inst.AddProperty(prop);
+        }
+
+        if (groupinst->GetCPUTime(ulong))
+        {
+            SCXProperty prop(L"CPUTime", static_cast<unsigned int>(ulong));
+            inst.AddProperty(prop);
+        }
+
+        if (groupinst->GetPercentUserTime(ulong))
+        {
+            SCXProperty prop(L"PercentUserTime", static_cast<unsigned int>(ulong));
+            inst.AddProperty(prop);
+        }
+
+        if (groupinst->GetPercentPrivilegedTime(ulong))
+        {
+            SCXProperty prop(L"PercentPrivilegedTime", static_cast<unsigned int>(ulong));
+            inst.AddProperty(prop);
+        }
+
+        if (groupinst->GetUsedMemory(ulong))
+        {
+            SCXProperty prop(L"UsedMemory", ulong);
+            inst.AddProperty(prop);
+        }
+
+        if (groupinst->GetBlockReadsPerSecond(ulong))
+        {
+            SCXProperty prop(L"BlockReadsPerSecond", ulong);
+            inst.AddProperty(prop);
+        }
+
+        if (groupinst->GetBlockWritesPerSecond(ulong))
+        {
+            SCXProperty prop(L"BlockWritesPerSecond", ulong);
+            inst.AddProperty(prop);
+        }
+
+        if (groupinst->GetBlockTransfersPerSecond(ulong))
+        {
+            SCXProperty prop(L"BlockTransfersPerSecond", ulong);
+            inst.AddProperty(prop);
+        }
+
+        if (groupinst->GetPagesReadPerSec(ulong))
+        {
+            SCXProperty prop(L"PagesReadPerSec", ulong);
+            inst.AddProperty(prop);
+        }
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+      Lookup the process group, given keys provided from CIMOM
+
+      \param[in]    keys   SCXInstance with property keys set
+      \returns             Pointer to located instance
+
+      \throws              SCXCIMInstanceNotFound   The instance with given keys cannot be found
+    */
+    SCXCoreLib::SCXHandle<SCXSystemLib::ProcessGroupInstance> ProcessProvider::FindGroupInstance(const SCXInstance& keys) const // private
+    {
+        const SCXProperty &nameprop = GetKeyRef(L"Name", keys);
+
+        std::vector<SCXCoreLib::SCXHandle<SCXSystemLib::ProcessGroupInstance> > groups = m_processes->GetProcessGroups();
+        for (size_t i=0; i<groups.size(); i++)
+        {
+            if (groups[i]->GetId() == nameprop.GetStrValue())
+            {
+                return groups[i];
+            }
+        }
+
+        throw SCXCIMInstanceNotFound(keys.DumpString(), SCXSRCLOCATION);
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Add the key properties of a sampled thread to an SCXInstance
+
+       \param[in]   threadinst     Thread instance to get data from
+       \param[out]  inst           Instance to add keys to
+
+       \throws      SCXInvalidArgumentException - The instance is NULL
+    */
+    void ProcessProvider::AddThreadKeys(SCXCoreLib::SCXHandle<SCXSystemLib::ThreadInstance> threadinst, SCXInstance &inst) // private
+    {
+        SCX_LOGTRACE(m_log, L"ProcessProvider AddThreadKeys()");
+
+        if (threadinst == NULL)
+        {
+            throw SCXInvalidArgumentException(L"threadinst", L"Not a ThreadInstance", SCXSRCLOCATION);
+        }
+
+        SCXProperty name_prop(L"Name", threadinst->GetId());
+        inst.AddKey(name_prop);
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Set all properties from the ThreadInstance in the SCXInstance
+
+       \param[in]  threadinst   - Thread instance to get data from
+       \param[in]  inst         - Instance to populate
+
+       \throws      SCXInvalidArgumentException - The instance is NULL
+    */
+    void ProcessProvider::AddThreadProperties(SCXCoreLib::SCXHandle<SCXSystemLib::ThreadInstance> threadinst, SCXInstance &inst) // private
+    {
+        if (threadinst == NULL)
+        {
+            throw SCXInvalidArgumentException(L"threadinst", L"Not a ThreadInstance", SCXSRCLOCATION);
+        }
+
+        SCX_LOGTRACE(m_log, L"ProcessProvider AddThreadProperties()");
+
+        std::string str;
+        scxulong ulong = 0;
+        unsigned int uint = 0;
+
+        SCXProperty total_prop(L"IsAggregate", false);
+        inst.AddProperty(total_prop);
+
+        if (threadinst->GetPID(ulong))
+        {
+            SCXProperty prop(L"ProcessID", ulong);
+            inst.AddProperty(prop);
+        }
+
+        if (threadinst->GetTID(ulong))
+        {
+            SCXProperty prop(L"ThreadID", ulong);
+            inst.AddProperty(prop);
+        }
+
+        if (threadinst->GetProcessName(str))
+        {
+            SCXProperty prop(L"ProcessName", StrFromMultibyte(str));
+            inst.AddProperty(prop);
+        }
+
+        if (threadinst->GetName(str))
+        {
+            SCXProperty prop(L"ThreadName", StrFromMultibyte(str));
+            inst.AddProperty(prop);
+        }
+
+        if (threadinst->GetLastProcessor(uint))
+        {
+            SCXProperty prop(L"LastProcessor", uint);
+            inst.AddProperty(prop);
+        }
+
+        if (threadinst->GetCPUTime(ulong))
+        {
+            SCXProperty prop(L"CPUTime", static_cast<unsigned int>(ulong));
+            inst.AddProperty(prop);
+        }
+
+        if (threadinst->GetPercentUserTime(ulong))
+        {
+            SCXProperty prop(L"PercentUserTime", static_cast<unsigned int>(ulong));
+            inst.AddProperty(prop);
+        }
+
+        if (threadinst->GetPercentPrivilegedTime(ulong))
+        {
+            SCXProperty prop(L"PercentPrivilegedTime", static_cast<unsigned int>(ulong));
+            inst.AddProperty(prop);
+        }
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+      Lookup the sampled thread, given keys provided from CIMOM
+
+      \param[in]    keys   SCXInstance with property keys set
+      \returns             Pointer to located instance
+
+      \throws              SCXCIMInstanceNotFound   The instance with given keys cannot be found
+    */
+    SCXCoreLib::SCXHandle<SCXSystemLib::ThreadInstance> ProcessProvider::FindThreadInstance(const SCXInstance& keys) const // private
+    {
+        const SCXProperty &nameprop = GetKeyRef(L"Name", keys);
+
+        std::vector<SCXCoreLib::SCXHandle<SCXSystemLib::ThreadInstance> > threads = m_processes->GetThreads();
+        for (size_t i=0; i<threads.size(); i++)
+        {
+            if (threads[i]->GetId() == nameprop.GetStrValue())
+            {
+                return threads[i];
+            }
+        }
+
+        throw SCXCIMInstanceNotFound(keys.DumpString(), SCXSRCLOCATION);
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Add the key properties of an OOM kill event to an SCXInstance
+
+       \param[in]   event          Event to get data from
+       \param[out]  inst           Instance to add keys to
+    */
+    void ProcessProvider::AddOOMKillKeys(const SCXSystemLib::OOMKillEvent& event, SCXInstance &inst) // private
+    {
+        SCX_LOGTRACE(m_log, L"ProcessProvider AddOOMKillKeys()");
+
+        SCXProperty name_prop(L"Name", StrFrom(event.sequence));
+        inst.AddKey(name_prop);
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Set all properties of an OOM kill event in the SCXInstance
+
+       \param[in]  event        - Event to get data from
+       \param[in]  inst         - Instance to populate
+
+       The process properties are only set if a victim was found.
+    */
+    void ProcessProvider::AddOOMKillProperties(const SCXSystemLib::OOMKillEvent& event, SCXInstance &inst) // private
+    {
+        SCX_LOGTRACE(m_log, L"ProcessProvider AddOOMKillProperties()");
+
+        SCXProperty total_prop(L"IsAggregate", false);
+        inst.AddProperty(total_prop);
+
+        SCXProperty seq_prop(L"SequenceNumber", event.sequence);
+        inst.AddProperty(seq_prop);
+
+        SCXProperty time_prop(L"DetectionTime", event.time);
+        inst.AddProperty(time_prop);
+
+        SCXProperty attributed_prop(L"Attributed", event.attributed);
+        inst.AddProperty(attributed_prop);
+
+        if (event.attributed)
+        {
+            SCXProperty pid_prop(L"ProcessID", static_cast<scxulong>(event.pid));
+            inst.AddProperty(pid_prop);
+
+            SCXProperty name_prop(L"ProcessName", StrFromMultibyte(event.name));
+            inst.AddProperty(name_prop);
+
+            SCXProperty rss_prop(L"ResidentSetSize", event.residentSetSize);
+            inst.AddProperty(rss_prop);
+
+            SCXProperty cgroup_prop(L"CGroup", StrFromMultibyte(event.cgroup));
+            inst.AddProperty(cgroup_prop);
+
+            SCXProperty constrained_prop(L"CGroupConstrained", event.cgroupConstrained);
+            inst.AddProperty(constrained_prop);
+        }
+    }
+
     /*----------------------------------------------------------------------------*/
     /**
        Enumerate instance names
@@ -521,6 +992,46 @@ namespace SCXCore {
 
         SCXCoreLib::SCXThreadLock lock(m_processes->GetLockHandle());
 
+        if (eSCX_ProcessGroupStatisticalInformation == cimtype)
+        {
+            std::vector<SCXCoreLib::SCXHandle<SCXSystemLib::ProcessGroupInstance> > groups = m_processes->GetProcessGroups();
+            SCX_LOGTRACE(m_log, StrAppend(L"Number of Process Groups = ", groups.size()));
+
+            for (size_t i=0; i<groups.size(); i++)
+            {
+                SCXInstance inst;
+                AddGroupKeys(groups[i], inst);
+                SendInstanceName(inst);
+            }
+            return;
+        }
+
+        if (eSCX_UnixThreadStatisticalInformation == cimtype)
+        {
+            std::vector<SCXCoreLib::SCXHandle<SCXSystemLib::ThreadInstance> > threads = m_processes->GetThreads();
+            SCX_LOGTRACE(m_log, StrAppend(L"Number of sampled Threads = ", threads.size()));
+
+            for (size_t i=0; i<threads.size(); i++)
+            {
+                SCXInstance inst;
+                AddThreadKeys(threads[i], inst);
+                SendInstanceName(inst);
+            }
+            return;
+        }
+
+        if (eSCX_OOMKillEvent == cimtype)
+        {
+            std::vector<SCXSystemLib::OOMKillEvent> events = m_processes->GetOOMKillEvents();
+            for (size_t i=0; i<events.size(); i++)
+            {
+                SCXInstance inst;
+                AddOOMKillKeys(events[i], inst);
+                SendInstanceName(inst);
+            }
+            return;
+        }
+
         m_processes->UpdateNoLock(lock, false);
 
         SCX_LOGTRACE(m_log, StrAppend(L"Number of Processes = ", m_processes->Size()));
@@ -555,6 +1066,52 @@ namespace SCXCore {
 
         SCXCoreLib::SCXThreadLock lock(m_processes->GetLockHandle());
 
+        if (eSCX_ProcessGroupStatisticalInformation == cimtype)
+        {
+            // Groups are computed by the sampler thread; no update needed here
+            std::vector<SCXCoreLib::SCXHandle<SCXSystemLib::ProcessGroupInstance> > groups = m_processes->GetProcessGroups();
+            SCX_LOGTRACE(m_log, StrAppend(L"Number of Process Groups = ", groups.size()));
+
+            for (size_t i=0; i<groups.size(); i++)
+            {
+                SCXInstance inst;
+                AddGroupKeys(groups[i], inst);
+                AddGroupProperties(groups[i], inst);
+                SendInstance(inst);
+            }
+            return;
+        }
+
+        if (eSCX_UnixThreadStatisticalInformation == cimtype)
+        {
+            // Threads are sampled by the sampler thread; no update needed here
+            std::vector<SCXCoreLib::SCXHandle<SCXSystemLib::ThreadInstance> > threads = m_processes->GetThreads();
+            SCX_LOGTRACE(m_log, StrAppend(L"Number of sampled Threads = ", threads.size()));
+
+            for (size_t i=0; i<threads.size(); i++)
+            {
+                SCXInstance inst;
+                AddThreadKeys(threads[i], inst);
+                AddThreadProperties(threads[i], inst);
+                SendInstance(inst);
+            }
+            return;
+        }
+
+        if (eSCX_OOMKillEvent == cimtype)
+        {
+            // Events are recorded by the sampler thread; no update needed here
+            std::vector<SCXSystemLib::OOMKillEvent> events = m_processes->GetOOMKillEvents();
+            for (size_t i=0; i<events.size(); i++)
+            {
+                SCXInstance inst;
+                AddOOMKillKeys(events[i], inst);
+                AddOOMKillProperties(events[i], inst);
+                SendInstance(inst);
+            }
+            return;
+        }
+
         // Update Process PAL instance. This is both update of number of Processes and
         // current statistics for each Process.
         m_processes->UpdateNoLock(lock);
@@ -593,6 +1150,38 @@ namespace SCXCore {
 
         SCXCoreLib::SCXThreadLock lock(m_processes->GetLockHandle());
 
+        if (eSCX_ProcessGroupStatisticalInformation == cimtype)
+        {
+            SCXCoreLib::SCXHandle<SCXSystemLib::ProcessGroupInstance> groupinst = FindGroupInstance(callContext.GetObjectPath());
+            AddGroupKeys(groupinst, instance);
+            AddGroupProperties(groupinst, instance);
+            return;
+        }
+
+        if (eSCX_UnixThreadStatisticalInformation == cimtype)
+        {
+            SCXCoreLib::SCXHandle<SCXSystemLib::ThreadInstance> threadinst = FindThreadInstance(callContext.GetObjectPath());
+            AddThreadKeys(threadinst, instance);
+            AddThreadProperties(threadinst, instance);
+            return;
+        }
+
+        if (eSCX_OOMKillEvent == cimtype)
+        {
+            const SCXProperty &nameprop = GetKeyRef(L"Name", callContext.GetObjectPath());
+            std::vector<SCXSystemLib::OOMKillEvent> events = m_processes->GetOOMKillEvents();
+            for (size_t i=0; i<events.size(); i++)
+            {
+                if (StrFrom(events[i].sequence) == nameprop.GetStrValue())
+                {
+                    AddOOMKillKeys(events[i], instance);
+                    AddOOMKillProperties(events[i], instance);
+                    return;
+                }
+            }
+            throw SCXCIMInstanceNotFound(callContext.GetObjectPath().DumpString(), SCXSRCLOCATION);
+        }
+
         // Refresh the collection (both keys and current data)
         m_processes->UpdateNoLock(lock);
 
@@ -660,6 +1249,20 @@ namespace SCXCore {
         {
             gotResource = processinst->GetPagesReadPerSec(res);
         }
+        else if (StrCompare(resource, L"ReadBytesPerSecond", true) == 0)
+        {
+            gotResource = processinst->GetReadBytesPerSecond(res);
+        }
+        else if (StrCompare(resource, L"WriteBytesPerSecond", true) == 0)
+        {
+            gotResource = processinst->GetWriteBytesPerSecond(res);
+        }
+        else if (StrCompare(resource, L"IOBytesPerSecond", true) == 0)
+        {
+            scxulong written = 0;
+            gotResource = processinst->GetReadBytesPerSecond(res) && processinst->GetWriteBytesPerSecond(written);
+            res += written;
+        }
         else
         {
             throw UnknownResourceException(resource, SCXSRCLOCATION);
@@ -726,7 +1329,15 @@ namespace SCXCore {
             ProcessInstanceSort p;
 
             p.procinst = m_processes->GetInstance(i);
-            p.value = GetResource(resource, p.procinst);
+            try
+            {
+                p.value = GetResource(resource, p.procinst);
+            }
+            catch (SCXCoreLib::SCXInternalErrorException&)
+            {
+                // Not available for this process, such as the I/O of one we may not read
+                continue;
+            }
             procsort.push_back(p);
         }
 
@@ -21,9 +21,13 @@
 #include <scxsystemlib/processenumeration.h>
 #include <scxcorelib/scxlog.h>
 
-namespace SCXCore
+namespace SCXCoreLib
 {
+    class ConfigurationParser;
+}
 
+namespace SCXCore
+{
     /*----------------------------------------------------------------------------*/
     /**
        Process provider
@@ -78,7 +82,10 @@ namespace SCXCore
         //! The set of CIM classes this provider supports
         enum SupportedCimClasses {
             eSCX_UnixProcess,
-            eSCX_UnixProcessStatisticalInformation
+            eSCX_UnixProcessStatisticalInformation,
+            eSCX_ProcessGroupStatisticalInformation,
+            eSCX_UnixThreadStatisticalInformation,
+            eSCX_OOMKillEvent
         };
 
         //! The CIM methods this provider supports
@@ -105,6 +112,17 @@ namespace SCXCore
         void AddKeys(SCXCoreLib::SCXHandle<SCXSystemLib::ProcessInstance> processinst, SCXProviderLib::SCXInstance& inst, SupportedCimClasses cimtype);
         void AddProperties(SCXCoreLib::SCXHandle<SCXSystemLib::ProcessInstance> processinst, SCXProviderLib::SCXInstance& inst, SupportedCimClasses cimtype);
         SCXCoreLib::SCXHandle<SCXSystemLib::ProcessInstance> FindInstance(const SCXProviderLib::SCXInstance& keys) const;
+        void AddGroupKeys(SCXCoreLib::SCXHandle<SCXSystemLib::ProcessGroupInstance> groupinst, SCXProviderLib::SCXInstance& inst);
+        void AddGroupProperties(SCXCoreLib::SCXHandle<SCXSystemLib::ProcessGroupInstance> groupinst, SCXProviderLib::SCXInstance& inst);
+        SCXCoreLib::SCXHandle<SCXSystemLib::ProcessGroupInstance> FindGroupInstance(const SCXProviderLib::SCXInstance& keys) const;
+        void AddThreadKeys(SCXCoreLib::SCXHandle<SCXSystemLib::ThreadInstance> threadinst, SCXProviderLib::SCXInstance& inst);
+        void AddThreadProperties(SCXCoreLib::SCXHandle<SCXSystemLib::ThreadInstance> threadinst, SCXProviderLib::SCXInstance& inst);
+        SCXCoreLib::SCXHandle<SCXSystemLib::ThreadInstance> FindThreadInstance(const SCXProviderLib::SCXInstance& keys) const;
+        void AddOOMKillKeys(const SCXSystemLib::OOMKillEvent& event, SCXProviderLib::SCXInstance& inst);
+        void AddOOMKillProperties(const SCXSystemLib::OOMKillEvent& event, SCXProviderLib::SCXInstance& inst);
+        void ConfigureThreadSampling(const SCXCoreLib::ConfigurationParser& config);
+        void ConfigureOOMKillEvents(const SCXCoreLib::ConfigurationParser& config);
+        void ConfigureIOAccounting(const SCXCoreLib::ConfigurationParser& config);
         void GetTopResourceConsumers(const std::wstring &resource, unsigned int count, std::wstring &result);
         scxulong GetResource(const std::wstring &resource, SCXCoreLib::SCXHandle<SCXSystemLib::ProcessInstance> processinst);
 
@@ -25,81 +25,6 @@ using namespace SCXCoreLib;
 
 namespace SCXCore
 {
-    /*----------------------------------------------------------------------------*/
-    /**
-       Parses a stream of the form 
-
-       # Comment
-       key1 = value1
-       key2 = value2
-
-       \param[in] configuration Stream with configuration data. Typically as
-                  read from a configuration file.
-    */
-    void ConfigurationParser::ParseStream(std::wistream& configuration)
-    {
-        SCXCoreLib::SCXLogHandle log = SCXLogHandleFactory::GetLogHandle(L"scx.core.providers.runasprovider.configparser");
-
-        std::vector<std::wstring> lines;
-        SCXStream::NLFs nlfs;
-        SCXStream::ReadAllLines(configuration, lines, nlfs);
-        SCX_LOGTRACE(log, StrAppend(L"Number of lines in configuration: ", lines.size()));
-
-        for (std::vector<std::wstring>::const_iterator it = lines.begin();
-             it != lines.end(); it++)
-        {
-            std::wstring line = StrTrim(*it);
-            SCX_LOGTRACE(log, StrAppend(L"Parsing line: ", line));
-            if (line.length() == 0 ||
-                line.substr(0,1) == L"#") //comment
-            {
-                continue;
-            }
-            std::vector<std::wstring> parts;
-            StrTokenize(line, parts, L"=");
-            if (parts.size() == 2)
-            {
-                iterator iter = lower_bound(parts[0]);
-                if ((end() != iter) && !(key_comp()(parts[0], iter->first)))
-                {
-                    iter->second = parts[1];
-                }
-                else
-                {
-                    insert(iter, std::pair<const std::wstring, std::wstring>(parts[0], parts[1]));
-                }
-            }
-        }
-    }
-
-    /*----------------------------------------------------------------------------*/
-    /**
-       Constructor for the configuration file parser.
-    */
-    ConfigurationFileParser::ConfigurationFileParser(const SCXCoreLib::SCXFilePath& file) :
-        m_file(file)
-    {
-    }
-
-    /*----------------------------------------------------------------------------*/
-    /**
-       Parses the configuration file. If the file does not exist this is ignored.
-    */
-    void ConfigurationFileParser::Parse()
-    {
-        SCXCoreLib::SCXLogHandle log = SCXLogHandleFactory::GetLogHandle(L"scx.core.providers.runasprovider.configparser");
-
-        try
-        {
-            ParseStream(*SCXFile::OpenWFstream(m_file, std::ios_base::in));
-        }
-        catch (SCXException& e)
-        {
-            SCX_LOGWARNING(log, StrAppend(L"Failed to read file: ", m_file.Get()));
-            SCX_LOGWARNING(log, StrAppend(L"Reason for failure: ", e.What()));
-        }
-    }
-
     /*----------------------------------------------------------------------------*/
     /**
        Writes configuration of the form 
@@ -15,53 +15,15 @@
 #define SCXRUNASCONFIGURATOR_H
 
 #include <map>
+#include <scxcorelib/scxconfigfile.h>
 #include <scxcorelib/scxfilepath.h>
 #include <scxcorelib/scxhandle.h>
 #include <scxcorelib/scxexception.h>
 
 namespace SCXCore
 {
-    /*----------------------------------------------------------------------------*/
-    /**
-       Class for parsing generic configuration streams of the form:
-
-       # Comment
-       key1 = value1
-       key2 = value2
-    */
-    class ConfigurationParser : public std::map<std::wstring, std::wstring>
-    {
-    public:
-        /**
-           Parses configuration.
-         */
-        virtual void Parse() = 0;
-        /**
-           Virtual destructor.
-        */
-        virtual ~ConfigurationParser() {};
-    protected:
-        virtual void ParseStream(std::wistream& configuration);
-    };
-
-    /*----------------------------------------------------------------------------*/
-    /**
-       Class for parsing files with generic configuration
-
-    */
-    class ConfigurationFileParser : public ConfigurationParser
-    {
-    public:
-        ConfigurationFileParser(const SCXCoreLib::SCXFilePath& file);
-
-        /**
-           Parses the configuration file. If the file does not exist this is ignored.
-        */
-        void Parse();
-    private:
-        //! Path to file containing configuration.
-        SCXCoreLib::SCXFilePath m_file;
-    };
+    using SCXCoreLib::ConfigurationParser;
+    using SCXCoreLib::ConfigurationFileParser;
 
     /*----------------------------------------------------------------------------*/
     /**
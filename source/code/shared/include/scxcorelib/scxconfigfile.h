@@ -0,0 +1,71 @@
+/*--------------------------------------------------------------------------------
+    Copyright (c) Microsoft Corporation.  All rights reserved.
+
+*/
+/**
+    \file
+
+    \brief       Parser for the key = value configuration files of the agent
+
+    \date        2026-10-18 23:30:00
+
+    The parser was written for scxrunas.conf and is now also used for
+    scxprocess.conf and scxmemory.conf.
+
+*/
+/*----------------------------------------------------------------------------*/
+#ifndef SCXCONFIGFILE_H
+#define SCXCONFIGFILE_H
+
+#include <map>
+#include <iostream>
+#include <string>
+#include <scxcorelib/scxfilepath.h>
+
+namespace SCXCoreLib
+{
+    /*----------------------------------------------------------------------------*/
+    /**
+       Class for parsing generic configuration streams of the form:
+
+       # Comment
+       key1 = value1
+       key2 = value2
+    */
+    class ConfigurationParser : public std::map<std::wstring, std::wstring>
+    {
+    public:
+        /**
+           Parses configuration.
+         */
+        virtual void Parse() = 0;
+        /**
+           Virtual destructor.
+        */
+        virtual ~ConfigurationParser() {};
+    protected:
+        virtual void ParseStream(std::wistream& configuration);
+    };
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Class for parsing files with generic configuration
+
+    */
+    class ConfigurationFileParser : public ConfigurationParser
+    {
+    public:
+        ConfigurationFileParser(const SCXFilePath& file);
+
+        /**
+           Parses the configuration file. If the file does not exist this is ignored.
+        */
+        void Parse();
+    private:
+        //! Path to file containing configuration.
+        SCXFilePath m_file;
+    };
+}
+
+#endif /* SCXCONFIGFILE_H */
+/*----------------------------E-N-D---O-F---F-I-L-E---------------------------*/
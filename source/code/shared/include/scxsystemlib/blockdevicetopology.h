@@ -0,0 +1,150 @@
+/*--------------------------------------------------------------------------------
+    Copyright (c) Microsoft Corporation.  All rights reserved.
+
+*/
+/**
+    \file
+
+    \brief       Inventory of the block devices of /sys/block and what they are built on
+
+    \date        2026-10-18 20:00:00
+
+    Device mapper (LVM, multipath, crypt) and md devices list the devices
+    they are built on in /sys/block/<device>/slaves. The graph holds those
+    edges, the device mapper names of /sys/block/<device>/dm/name and the
+    partitions of each disk, so that a mounted device can be resolved to
+    the disks under it without looking at /dev. The attributes of each
+    device (size, removable, rotational, model) are read along with them,
+    so the disk enumerations get them without opening the devices. Linux
+    only.
+
+*/
+/*----------------------------------------------------------------------------*/
+#ifndef BLOCKDEVICETOPOLOGY_H
+#define BLOCKDEVICETOPOLOGY_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <scxcorelib/scxcmn.h>
+#include <scxcorelib/scxhandle.h>
+#include <scxcorelib/scxlog.h>
+#include <scxcorelib/scxthreadlock.h>
+
+#include <time.h>
+
+namespace SCXSystemLib
+{
+    /** Upper bound on the number of layers followed when resolving a device. */
+    const unsigned int BLOCKDEVICE_MAX_DEPTH = 16;
+
+    /** Minimum number of seconds between two reads of /sys/block by Refresh(). */
+    const time_t BLOCKDEVICE_REFRESH_INTERVAL = 30;
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Access to sysfs for the block device topology.
+    */
+    class BlockDeviceTopologyDependencies
+    {
+    public:
+        BlockDeviceTopologyDependencies(const std::string& root = "/sys/block") : m_root(root) {}
+        virtual ~BlockDeviceTopologyDependencies() {};
+
+        virtual const std::string& GetRoot() const;
+        virtual bool ListEntries(const std::string& path, std::vector<std::string>& names) const;
+        virtual bool ReadFile(const std::string& path, std::string& content) const;
+        virtual time_t GetMonotonicTime() const;
+
+    private:
+        std::string m_root;     //!< Directory holding the block devices
+    };
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       An entry of /sys/block with its attributes.
+    */
+    struct BlockDevice
+    {
+        BlockDevice() : major(0), minor(0), sizeSectors(0), logicalBlockSize(0),
+                        removable(false), hasRotational(false), rotational(false) {}
+
+        unsigned int major;                 //!< Device major ID number
+        unsigned int minor;                 //!< Device minor ID number
+        scxulong sizeSectors;               //!< Size in 512 byte sectors
+        unsigned int logicalBlockSize;      //!< Logical block size in bytes, 0 if not known
+        bool removable;                     //!< The device has removable media
+        bool hasRotational;                 //!< rotational is known
+        bool rotational;                    //!< The device is rotating media, false for solid state
+        std::string vendor;                 //!< Vendor of the device, empty if not known
+        std::string model;                  //!< Model of the device, empty if not known
+        std::vector<std::string> slaves;    //!< Kernel names of the devices it is built on
+        std::vector<std::string> holders;   //!< Kernel names of the devices built on it
+    };
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Graph of block devices: device mapper and md devices to the devices
+       they are built on, and partitions to their disks.
+
+       Refresh() lists /sys/block and reads the dev file of every entry. The
+       graph is only rebuilt when the set of entries or one of their device
+       numbers has changed since the previous call; the generation counts the
+       rebuilds. sysfs has no cheap change signal (directory times do not
+       move on hot plug), so /sys/block is read at most once every
+       BLOCKDEVICE_REFRESH_INTERVAL seconds and a device added or removed in
+       between is seen by the next read. One graph is shared by the disk enumerations, see GetShared().
+       All methods take the lock of the graph.
+    */
+    class BlockDeviceTopology
+    {
+    public:
+        BlockDeviceTopology(SCXCoreLib::SCXHandle<BlockDeviceTopologyDependencies> deps = SCXCoreLib::SCXHandle<BlockDeviceTopologyDependencies>(new BlockDeviceTopologyDependencies()));
+
+        static BlockDeviceTopology& GetShared();
+
+        bool Refresh();
+        unsigned int GetGeneration() const;
+
+        bool FindDeviceMapperDevice(const std::string& dmName, std::string& name) const;
+        bool GetPhysicalDisks(const std::string& name, std::vector<std::string>& disks) const;
+        bool GetBlockDevice(const std::string& name, BlockDevice& device) const;
+
+        static bool ParseDeviceNumber(const std::string& content, unsigned int& major, unsigned int& minor);
+
+    private:
+        /** Kernel name and device number of an entry of /sys/block. */
+        struct Signature
+        {
+            std::string name;                   //!< Kernel name
+            unsigned int major;                 //!< Device major ID number
+            unsigned int minor;                 //!< Device minor ID number
+
+            /** \returns true if both describe the same device */
+            bool operator==(const Signature& other) const
+            {
+                return major == other.major && minor == other.minor && name == other.name;
+            }
+        };
+
+        void ReadSignature(std::vector<Signature>& signature) const;
+        void Rebuild(const std::vector<Signature>& signature);
+        void AddPhysicalDisks(const std::string& name, unsigned int depth, std::vector<std::string>& disks) const;
+        void ReadAttributes(const std::string& dir, BlockDevice& device) const;
+
+        SCXCoreLib::SCXHandle<BlockDeviceTopologyDependencies> m_deps; //!< Reads sysfs
+        SCXCoreLib::SCXLogHandle m_log;                 //!< Log handle
+        SCXCoreLib::SCXThreadLockHandle m_lock;         //!< Serializes refreshes and lookups
+
+        std::vector<Signature> m_signature;             //!< Entries of /sys/block the graph was built from, sorted by name
+        std::map<std::string, BlockDevice> m_nodes;     //!< Entries of /sys/block by kernel name
+        std::map<std::string, std::string> m_partitions;    //!< Disk of each partition, by kernel name
+        std::map<std::string, std::string> m_dmNames;   //!< Kernel name of each device mapper device, by its dm name
+        unsigned int m_generation;                      //!< Number of times the graph was built
+        time_t m_lastRefresh;                           //!< Monotonic time /sys/block was last read
+    };
+}
+
+#endif /* BLOCKDEVICETOPOLOGY_H */
+/*----------------------------E-N-D---O-F---F-I-L-E---------------------------*/
@@ -0,0 +1,83 @@
+/*--------------------------------------------------------------------------------
+    Copyright (c) Microsoft Corporation.  All rights reserved.
+
+*/
+/**
+    \file
+
+    \brief       Usage history and time to full estimate of a file system
+
+    \date        2026-10-18 21:00:00
+
+    The used space of a file system is kept as one average per hour for a
+    week. A Theil-Sen line (the median of the slopes between all pairs of
+    hours) is fitted to it whenever an hour is closed, so single spikes
+    such as a large temporary file do not move the estimate much. Queries
+    return the cached result of the latest fit.
+
+*/
+/*----------------------------------------------------------------------------*/
+#ifndef CAPACITYFORECAST_H
+#define CAPACITYFORECAST_H
+
+#include <time.h>
+
+#include <scxcorelib/scxcmn.h>
+
+namespace SCXSystemLib
+{
+    /** Number of hourly buckets kept, a week. */
+    const size_t CAPACITY_FORECAST_BUCKETS = 168;
+
+    /** Length of a bucket in seconds. */
+    const unsigned int CAPACITY_FORECAST_BUCKET_SECONDS = 3600;
+
+    /** Number of closed buckets needed before a trend is fitted. */
+    const size_t CAPACITY_FORECAST_MIN_BUCKETS = 6;
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Long horizon usage series of a file system with a robust linear trend.
+
+       Memory is bounded by CAPACITY_FORECAST_BUCKETS. Hours without samples,
+       as when the agent was not running, are simply missing from the fit.
+    */
+    class CapacityForecast
+    {
+    public:
+        CapacityForecast();
+
+        void Reset();
+        void AddSample(time_t now, scxulong mbUsed, scxulong mbFree);
+
+        bool GetGrowthRate(double& mbPerHour) const;
+        bool GetTimeToFull(scxulong& seconds) const;
+        size_t GetBucketCount() const;
+
+    private:
+        void CloseBucket();
+        void Fit();
+
+        /** Average used space of one hour. */
+        struct Bucket
+        {
+            scxulong hour;          //!< Hours since the epoch
+            double mbUsed;          //!< Average used space in MB
+        };
+
+        Bucket m_buckets[CAPACITY_FORECAST_BUCKETS]; //!< Ring of closed hours
+        size_t m_count;             //!< Number of closed hours in the ring
+        size_t m_next;              //!< Slot of the next closed hour
+
+        scxulong m_hour;            //!< Hour being sampled, hours since the epoch
+        double m_sum;               //!< Sum of the used space sampled in m_hour
+        unsigned int m_samples;     //!< Number of samples in m_hour
+        scxulong m_mbFree;          //!< Latest free space in MB
+
+        bool m_hasTrend;            //!< m_slope is fitted
+        double m_slope;             //!< Growth of the used space in MB per hour
+    };
+}
+
+#endif /* CAPACITYFORECAST_H */
+/*----------------------------E-N-D---O-F---F-I-L-E---------------------------*/
@@ -0,0 +1,123 @@
+/*----------------------------------------------------------------------------
+    Copyright (c) Microsoft Corporation.  All rights reserved.
+
+*/
+/**
+    \file
+
+    \brief       Enumeration of Linux control groups
+
+    \date        2026-10-18 10:00:00
+
+    Both the unified (v2) hierarchy and the legacy (v1) per-controller
+    hierarchies are supported. Only Linux has control groups; on other
+    platforms the enumeration is always empty.
+
+*/
+/*----------------------------------------------------------------------------*/
+#ifndef CGROUPENUMERATION_H
+#define CGROUPENUMERATION_H
+
+#include <string>
+#include <vector>
+#include <set>
+
+#include <scxsystemlib/entityenumeration.h>
+#include <scxsystemlib/cgroupinstance.h>
+#include <scxcorelib/scxlog.h>
+#include <scxcorelib/scxthread.h>
+#include <scxcorelib/scxthreadlock.h>
+
+namespace SCXSystemLib
+{
+    /** Time between each sample in seconds. */
+    const int CGROUP_SECONDS_PER_SAMPLE = 60;
+
+    /** Default number of directory levels below the root that are enumerated. */
+    const unsigned int CGROUP_DEFAULT_MAX_DEPTH = 3;
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Class representing all external dependencies from the cgroup PAL.
+
+       The root of the cgroup file system is configurable so that the PAL can
+       be run against a fake tree.
+    */
+    class CGroupPALDependencies
+    {
+    public:
+        CGroupPALDependencies(const std::string& root = "/sys/fs/cgroup") : m_root(root) {}
+        virtual ~CGroupPALDependencies() {};
+
+        virtual const std::string& GetRoot() const;
+        virtual bool ReadFile(const std::string& path, std::string& content) const;
+        virtual bool ListDirectories(const std::string& path, std::vector<std::string>& names) const;
+        virtual bool Exists(const std::string& path) const;
+        virtual long GetClockTicks() const;
+        virtual scxulong GetTimeMicroseconds() const;
+
+    private:
+        std::string m_root;     //!< Mount point of the cgroup file system
+    };
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Class that represents a collection of control groups.
+
+       The set of control groups is rediscovered on every sample; groups that
+       disappear are removed and new ones are added. Only the top
+       CGROUP_DEFAULT_MAX_DEPTH levels are walked by default to bound the cost
+       on hosts with deep systemd hierarchies.
+    */
+    class CGroupEnumeration : public EntityEnumeration<CGroupInstance>
+    {
+    public:
+        explicit CGroupEnumeration(SCXCoreLib::SCXHandle<CGroupPALDependencies> deps = SCXCoreLib::SCXHandle<CGroupPALDependencies>(new CGroupPALDependencies()),
+                                   unsigned int maxDepth = CGROUP_DEFAULT_MAX_DEPTH);
+        ~CGroupEnumeration();
+        virtual void Init();
+        virtual void Update(bool updateInstances=true);
+        virtual void CleanUp();
+        void SampleData();
+
+        const SCXCoreLib::SCXThreadLockHandle& GetLockHandle() const;
+        void UpdateNoLock(SCXCoreLib::SCXThreadLock& lck, bool updateInstances=true);
+        unsigned int GetVersion() const;
+
+        //
+        // These would normally be private, but are here for unit test purposes
+        //
+        static bool ParseValue(const std::string& content, scxulong& value);
+        static bool ParseKeyValue(const std::string& content, const char* key, scxulong& value);
+        static bool ParseIOStat(const std::string& content,
+                                scxulong& rbytes, scxulong& wbytes, scxulong& rios, scxulong& wios);
+        static bool ParseBlkio(const std::string& content, scxulong& read, scxulong& write);
+
+    private:
+        void DetectVersion();
+        void Discover(const std::string& hierarchy, const std::string& path, unsigned int depth,
+                      std::set<std::string>& paths) const;
+        void SampleV1(SCXCoreLib::SCXHandle<CGroupInstance> inst);
+        void SampleV2(SCXCoreLib::SCXHandle<CGroupInstance> inst);
+        SCXCoreLib::SCXHandle<CGroupInstance> FindOrAdd(const std::string& path);
+        std::string ControllerPath(const std::string& hierarchy, const std::string& path,
+                                   const char* file) const;
+
+        SCXCoreLib::SCXHandle<CGroupPALDependencies> m_deps; //!< Collects external dependencies of this class.
+        SCXCoreLib::SCXLogHandle m_log;         //!< Log handle.
+        SCXCoreLib::SCXThreadLockHandle m_lock; //!< Handles locking in the cgroup enumeration.
+        unsigned int m_maxDepth;                //!< Number of levels below the root to enumerate.
+        unsigned int m_version;                 //!< 2 for unified, 1 for legacy, 0 if not mounted.
+
+        std::string m_cpuacctHierarchy;         //!< v1 hierarchy of the cpuacct controller (empty if none).
+        std::string m_memoryHierarchy;          //!< v1 hierarchy of the memory controller (empty if none).
+        std::string m_blkioHierarchy;           //!< v1 hierarchy of the blkio controller (empty if none).
+        std::string m_pidsHierarchy;            //!< v1 hierarchy of the pids controller (empty if none).
+
+        SCXCoreLib::SCXHandle<SCXCoreLib::SCXThread> m_dataAquisitionThread; //!< Thread pointer.
+        static void DataAquisitionThreadBody(SCXCoreLib::SCXThreadParamHandle& param);
+    };
+}
+
+#endif /* CGROUPENUMERATION_H */
+/*----------------------------E-N-D---O-F---F-I-L-E---------------------------*/
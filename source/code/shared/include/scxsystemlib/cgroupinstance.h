@@ -0,0 +1,103 @@
+/*----------------------------------------------------------------------------
+    Copyright (c) Microsoft Corporation.  All rights reserved.
+
+*/
+/**
+    \file
+
+    \brief       PAL representation of a Linux control group
+
+    \date        2026-10-18 10:00:00
+
+*/
+/*----------------------------------------------------------------------------*/
+#ifndef CGROUPINSTANCE_H
+#define CGROUPINSTANCE_H
+
+#include <string>
+
+#include <scxsystemlib/entityinstance.h>
+#include <scxsystemlib/datasampler.h>
+#include <scxcorelib/scxlog.h>
+
+namespace SCXSystemLib
+{
+    /** Number of samples collected in the datasampler for control groups. */
+    const int MAX_CGROUPINSTANCE_DATASAMPLER_SAMPLES = 6;
+
+    /** Datasampler for control group counters. */
+    typedef DataSampler<scxulong, MAX_CGROUPINSTANCE_DATASAMPLER_SAMPLES> CGroupInstanceDataSampler;
+
+    /*----------------------------------------------------------------------------*/
+    /**
+        Class that represents one control group.
+
+        Counters (CPU time and I/O) are sampled by CGroupEnumeration and turned
+        into rates by Update(). Gauges (memory and pids) hold the latest value.
+        All CPU times are kept in microseconds regardless of cgroup version.
+    */
+    class CGroupInstance : public EntityInstance
+    {
+        friend class CGroupEnumeration;
+
+    public:
+        CGroupInstance(const std::string& path);
+        virtual ~CGroupInstance();
+
+        virtual void Update();
+
+        const std::string& GetPath() const;
+
+        // Return values indicate whether the controller providing the value
+        // is available for this control group or not.
+        bool GetPercentProcessorTime(scxulong& percent) const;
+        bool GetPercentUserTime(scxulong& percent) const;
+        bool GetPercentPrivilegedTime(scxulong& percent) const;
+        bool GetUsedMemory(scxulong& bytes) const;
+        bool GetMemoryLimit(scxulong& bytes) const;
+        bool GetProcessCount(scxulong& count) const;
+        bool GetReadBytesPerSecond(scxulong& bps) const;
+        bool GetWriteBytesPerSecond(scxulong& bps) const;
+        bool GetReadOperationsPerSecond(scxulong& ops) const;
+        bool GetWriteOperationsPerSecond(scxulong& ops) const;
+
+    private:
+        static void AddCounterSample(CGroupInstanceDataSampler& sampler, scxulong value);
+        scxulong GetRate(const CGroupInstanceDataSampler& sampler, scxulong factor) const;
+
+        SCXCoreLib::SCXLogHandle m_log;             //!< Log handle
+        std::string m_path;                         //!< Path relative to the cgroup root, "/" for the root group
+        bool m_seen;                                //!< Found during the latest sample
+
+        bool m_hasCPU;                              //!< CPU usage is available
+        bool m_hasCPUSplit;                         //!< User/system split is available
+        bool m_hasMemory;                           //!< Memory usage is available
+        bool m_hasMemoryLimit;                      //!< A memory limit is set
+        bool m_hasIO;                               //!< I/O counters are available
+        bool m_hasPids;                             //!< Number of tasks is available
+
+        scxulong m_usedMemory;                      //!< Memory usage in bytes
+        scxulong m_memoryLimit;                     //!< Memory limit in bytes
+        scxulong m_pids;                            //!< Number of tasks
+
+        scxulong m_percentProcessorTime;            //!< CPU percentage, computed by Update()
+        scxulong m_percentUserTime;                 //!< User mode CPU percentage, computed by Update()
+        scxulong m_percentPrivilegedTime;           //!< Kernel mode CPU percentage, computed by Update()
+        scxulong m_readBytesPerSecond;              //!< Computed by Update()
+        scxulong m_writeBytesPerSecond;             //!< Computed by Update()
+        scxulong m_readOpsPerSecond;                //!< Computed by Update()
+        scxulong m_writeOpsPerSecond;               //!< Computed by Update()
+
+        CGroupInstanceDataSampler m_time_usec;      //!< Monotonic time of each sample
+        CGroupInstanceDataSampler m_usage_usec;     //!< Total CPU time
+        CGroupInstanceDataSampler m_user_usec;      //!< User mode CPU time
+        CGroupInstanceDataSampler m_system_usec;    //!< Kernel mode CPU time
+        CGroupInstanceDataSampler m_readBytes;      //!< Bytes read from block devices
+        CGroupInstanceDataSampler m_writeBytes;     //!< Bytes written to block devices
+        CGroupInstanceDataSampler m_readOps;        //!< Read operations on block devices
+        CGroupInstanceDataSampler m_writeOps;       //!< Write operations on block devices
+    };
+}
+
+#endif /* CGROUPINSTANCE_H */
+/*----------------------------E-N-D---O-F---F-I-L-E---------------------------*/
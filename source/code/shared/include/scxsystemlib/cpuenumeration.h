@@ -15,10 +15,12 @@
 #ifndef CPUENUMERATION_H
 #define CPUENUMERATION_H
 
+#include <string>
 #include <vector>
 
 #include <scxsystemlib/entityenumeration.h>
 #include <scxsystemlib/cpuinstance.h>
+#include <scxsystemlib/schedulerinstance.h>
 #include <scxcorelib/scxlog.h>
 #include <scxcorelib/scxthread.h>
 #include <scxcorelib/scxthreadlock.h>
@@ -46,6 +48,12 @@ namespace SCXSystemLib
     /** Time between each sample in seconds. */
     const int CPU_SECONDS_PER_SAMPLE = 60;
 
+    /** Maximum number of counter columns parsed from a cpu row of /proc/stat. */
+    const size_t CPU_STAT_COLUMNS = 10;
+
+    /** Initial size of the buffer /proc/stat is read into. Grown as needed. */
+    const size_t CPU_STAT_INITIAL_BUFFER_SIZE = 16384;
+
     /*----------------------------------------------------------------------------*/
     /**
        Class representing all external dependencies from the CPU PAL.
@@ -54,8 +62,11 @@ namespace SCXSystemLib
     class CPUPALDependencies
     {
     public:
+        CPUPALDependencies();
         virtual SCXCoreLib::SCXHandle<std::wistream> OpenStatFile() const;
+        virtual size_t ReadStatFile(char* buf, size_t size) const;
         virtual SCXCoreLib::SCXHandle<std::wistream> OpenCpuinfoFile() const;
+        virtual bool ReadSysFile(const std::string& path, std::string& content) const;
         virtual long sysconf(int name) const;
 #if defined(sun)
         virtual const SCXCoreLib::SCXHandle<SCXKstat> CreateKstat() const;
@@ -81,7 +92,15 @@ namespace SCXSystemLib
                                  int bugsz,
                                  int number) const;
 #endif
-        virtual ~CPUPALDependencies() {};
+        virtual ~CPUPALDependencies();
+
+    private:
+        CPUPALDependencies(const CPUPALDependencies&);              //!< Not implemented, owns a file descriptor
+        CPUPALDependencies& operator=(const CPUPALDependencies&);   //!< Not implemented, owns a file descriptor
+
+#if defined(linux)
+        mutable int m_statFd;   //!< /proc/stat, kept open between samples
+#endif
     };
 
     /*----------------------------------------------------------------------------*/
@@ -101,6 +120,10 @@ namespace SCXSystemLib
         virtual void CleanUp();
         void SampleData();
 
+        SCXCoreLib::SCXHandle<SchedulerInstance> GetSchedulerInstance() const;
+        size_t GetGroupCount() const;
+        SCXCoreLib::SCXHandle<CPUInstance> GetGroupInstance(size_t pos) const;
+
         //
         // These would normally be protected, but are here for unit test purposes
         // (Being a friend doesn't seem to give access to protected static members)
@@ -110,6 +133,8 @@ namespace SCXSystemLib
             SCXCoreLib::SCXLogHandle& logH,
             bool fForceComputation = false);
         static size_t ProcessorCountLogical(SCXCoreLib::SCXHandle<CPUPALDependencies> deps);
+        static size_t ParseStatCounters(const char* p, const char* end, scxulong* values, size_t maxValues);
+        static void GetCpusetFiles(const std::string& procSelfCgroup, std::vector<std::string>& files);
 
         /**
            Provider access to ProcessorCountPhysical() method
@@ -145,6 +170,29 @@ namespace SCXSystemLib
         SCXCoreLib::SCXHandle<CPUPALDependencies> m_deps; //!< Collects external dependencies of this class.
         SCXCoreLib::SCXLogHandle m_log;         //!< Log handle.
         SCXCoreLib::SCXThreadLockHandle m_lock; //!< Handles locking in the cpu enumeration.
+        SCXCoreLib::SCXHandle<SchedulerInstance> m_scheduler; //!< System wide scheduler counters.
+        std::vector<SCXCoreLib::SCXHandle<CPUInstance> > m_groups;  //!< Core, socket and NUMA node aggregates, rebuilt by Update() only.
+        std::vector<std::vector<unsigned int> > m_groupMembers;     //!< Processor numbers of each entry in m_groups.
+#if defined(linux) || defined(WIN32)
+        std::vector<char> m_statBuffer;         //!< Contents of /proc/stat, reused between samples.
+
+        size_t ReadStatFile();
+        CPUInstance* FindInstanceByProcNumber(unsigned int procNumber) const;
+        static void AddTickSample(CPUInstance* inst, const scxulong* values);
+#endif
+#if defined(linux)
+        std::string m_cpusetFile;               //!< cpuset file of our control group, empty if none.
+        std::string m_onlineList;               //!< Contents of the online file when the topology was last built.
+        std::string m_cpusetList;               //!< Contents of the cpuset file when the topology was last built.
+        std::string m_readBuffer;               //!< Scratch buffer for reading the topology files.
+        std::vector<unsigned int> m_online;     //!< Online processors, sorted.
+        std::vector<unsigned int> m_allowed;    //!< Online processors in our cpuset, sorted.
+        bool m_cpusetRestricted;                //!< Our cpuset excludes some online processors.
+
+        bool UpdateTopology();
+        void BuildGroups();
+        void SampleGroups();
+#endif
 
         SCXCoreLib::SCXHandle<SCXCoreLib::SCXThread> m_dataAquisitionThread; //!< Thread pointer.
         static void DataAquisitionThreadBody(SCXCoreLib::SCXThreadParamHandle& param);
@@ -36,6 +36,17 @@ namespace SCXSystemLib
 #else
     typedef DataSampler<scxulong, MAX_CPUINSTANCE_DATASAMPER_SAMPLES> CPUInstanceDataSampler;
 #endif
+
+    /** What an instance aggregates. */
+    enum CPUGrouping
+    {
+        eCPUGroupingProcessor,  //!< A single logical processor
+        eCPUGroupingCore,       //!< The hardware threads of a core
+        eCPUGroupingSocket,     //!< The processors of a physical package
+        eCPUGroupingNode,       //!< The processors of a NUMA node
+        eCPUGroupingTotal       //!< All processors
+    };
+
     /*----------------------------------------------------------------------------*/
     /**
        Class that represents a colletion of instances.
@@ -50,10 +61,12 @@ namespace SCXSystemLib
     public:
 
         CPUInstance(unsigned int procNumber, bool isTotal = false);
+        CPUInstance(const std::wstring& name, CPUGrouping grouping);
         virtual ~CPUInstance();
 
         const std::wstring& GetProcName() const;
         unsigned int GetProcNumber() const;
+        CPUGrouping GetGrouping() const;
 
         virtual void Update();
 
@@ -67,6 +80,8 @@ namespace SCXSystemLib
         bool GetIowaitTime(scxulong& iowaitTime) const;
         bool GetInterruptTime(scxulong& interruptTime) const;
         bool GetDpcTime(scxulong& dpcTime) const;
+        bool GetStealTime(scxulong& stealTime) const;
+        bool GetGuestTime(scxulong& guestTime) const;
         bool GetQueueLength(scxulong& queueLength) const;
 
 #if defined(aix)
@@ -84,6 +99,7 @@ namespace SCXSystemLib
         scxulong GetTotalLastTick() const;
 
     private:
+        void ClearSamples();
         scxulong GetPercentageSafe(const scxulong tic_delta,
                                          const scxulong tot_delta,
                                          const bool inverse = false) const;
@@ -94,6 +110,7 @@ namespace SCXSystemLib
 
         std::wstring m_procName;         //!< Processor name
         unsigned int m_procNumber;       //!< Processor number
+        CPUGrouping m_grouping;          //!< What the instance aggregates
 
         scxulong m_processorTime;        //!< Processor time.
         scxulong m_idleTime;             //!< Processor idle time.
@@ -103,6 +120,8 @@ namespace SCXSystemLib
         scxulong m_iowaitTime;           //!< Processor io wait time.
         scxulong m_interruptTime;        //!< Processor interrupt time.
         scxulong m_dpcTime;              //!< Processor dpc time.
+        scxulong m_stealTime;            //!< Processor time stolen by the hypervisor.
+        scxulong m_guestTime;            //!< Processor time spent running guests.
         scxulong m_queueLength;          //!< Processor queue length.
 
         // NB: Not all of these are used on every platform
@@ -113,6 +132,8 @@ namespace SCXSystemLib
         CPUInstanceDataSampler m_IOWaitTime_tics;    //!< Data sampler for IO wait time.
         CPUInstanceDataSampler m_IRQTime_tics;       //!< Data sampler for IRQ time.
         CPUInstanceDataSampler m_SoftIRQTime_tics;   //!< Data sampler for soft IRQ time
+        CPUInstanceDataSampler m_StealTime_tics;     //!< Data sampler for steal time.
+        CPUInstanceDataSampler m_GuestTime_tics;     //!< Data sampler for guest and guest nice time.
         CPUInstanceDataSampler m_Total_tics;         //!< Data sampler for total time.
     };
 
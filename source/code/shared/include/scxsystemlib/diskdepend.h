@@ -28,6 +28,7 @@
 #include <scxsystemlib/scxlvmtab.h>
 #include <scxsystemlib/scxraid.h>
 #include <map>
+#include <set>
 
 #include <sys/statvfs.h>
 #include <sys/stat.h>
@@ -42,6 +43,9 @@ namespace SCXSystemLib
      */
     typedef struct statvfs64  SCXStatVfs;
 
+    /** Upper bound on the number of file system types whose ignore decision is remembered. */
+    const size_t MAX_CACHED_FILESYSTEM_TYPES = 256;
+
     /**
        The types of disks interfaces recognized by the disk PAL.
 
@@ -72,6 +76,32 @@ namespace SCXSystemLib
         std::wstring devAttribute; //!< Device attribute value (or empty if no such attribute).
     };
 
+    /**
+       Counters of one row of /proc/diskstats.
+
+       Partitions on kernels before 2.6.25 only have four fields: reads
+       issued, sectors read, writes issued and sectors written. They are
+       stored in the matching disk fields and the other fields are zero.
+    */
+    struct ProcDiskStats
+    {
+        unsigned int major;         //!< Device major ID number
+        unsigned int minor;         //!< Device minor ID number
+        std::string name;           //!< Device name
+        size_t fieldCount;          //!< Number of counter fields on the line (4, 11, 15 or 17)
+        scxulong readsCompleted;    //!< Field  1: Reads completed successfully
+        scxulong readsMerged;       //!< Field  2: Adjacent reads merged for efficiency
+        scxulong sectorsRead;       //!< Field  3: Sectors read successfully
+        scxulong msReading;         //!< Field  4: Milliseconds spent by all reads
+        scxulong writesCompleted;   //!< Field  5: Writes completed successfully
+        scxulong writesMerged;      //!< Field  6: Adjacent writes merged for efficiency
+        scxulong sectorsWritten;    //!< Field  7: Sectors written successfully
+        scxulong msWriting;         //!< Field  8: Milliseconds spent by all writes
+        scxulong ioInProgress;      //!< Field  9: I/Os currently in progress
+        scxulong msIO;              //!< Field 10: Milliseconds spent doing I/Os
+        scxulong weightedMsIO;      //!< Field 11: Weighted milliseconds spent doing I/Os
+    };
+
     /*----------------------------------------------------------------------------*/
     /**
        Define the interface for disk dependencies.
@@ -103,12 +133,22 @@ namespace SCXSystemLib
         virtual void RefreshProcDiskStats() = 0;
 
         /**
-           Get a proc disk stats row.
+           Get a proc disk stats row by device number. Does not allocate.
+
+           \param major Device major ID number.
+           \param minor Device minor ID number.
+           \returns The row, or NULL if the device is not in the cache.
+        */
+        virtual const ProcDiskStats* GetProcDiskStats(unsigned int major, unsigned int minor) = 0;
+
+        /**
+           Find a proc disk stats row by device name. Callers keep the
+           device numbers of the row and use them for later lookups.
 
            \param device The device we want statistics for.
-           \returns A vector with the stats tokenized as a vector of strings.
+           \returns The row, or NULL if the device is not in the cache.
         */
-        virtual const std::vector<std::wstring>& GetProcDiskStats(const std::wstring& device) = 0;
+        virtual const ProcDiskStats* FindProcDiskStats(const std::wstring& device) = 0;
 
         /**
            Get a list of files in a directory.
@@ -140,6 +180,15 @@ namespace SCXSystemLib
         */
         virtual void RefreshMNTTab() = 0;
 
+        /**
+            Get the generation of the mount tab. It changes when a refresh
+            finds that the mount tab has changed, and is never zero after
+            the first refresh.
+
+            \returns the generation of the mount tab.
+        */
+        virtual unsigned int GetMNTTabGeneration() const = 0;
+
         /**
             Check if a given file system should be ignored or not.
 
@@ -347,11 +396,15 @@ namespace SCXSystemLib
         virtual const SCXCoreLib::SCXFilePath& LocateMountTab();
         virtual const SCXCoreLib::SCXFilePath& LocateProcDiskStats();
         virtual void RefreshProcDiskStats();
-        virtual const std::vector<std::wstring>& GetProcDiskStats(const std::wstring& device);
+        virtual const ProcDiskStats* GetProcDiskStats(unsigned int major, unsigned int minor);
+        virtual const ProcDiskStats* FindProcDiskStats(const std::wstring& device);
+        static size_t ParseProcDiskStats(const char* p, const char* end, std::vector<ProcDiskStats>& rows);
         virtual void GetFilesInDirectory(const std::wstring& path, std::vector<SCXCoreLib::SCXFilePath>& files);
         virtual const SCXLvmTab& GetLVMTab();
         virtual const std::vector<MntTabEntry>& GetMNTTab();
         virtual void RefreshMNTTab();
+        virtual unsigned int GetMNTTabGeneration() const;
+        static size_t ParseMountInfo(const char* p, const char* end, std::vector<MntTabEntry>& entries);
         virtual bool FileSystemIgnored(const std::wstring& fs);
         virtual bool DeviceIgnored(const std::wstring& device);
         virtual bool LinkToPhysicalExists(const std::wstring& fs, const std::wstring& dev_path, const std::wstring& mountpoint);
@@ -426,6 +479,10 @@ namespace SCXSystemLib
 #endif /* aix */
     private:
         SCXCoreLib::SCXLogHandle m_log; //!< Log handle.
+#if defined(linux)
+        bool RefreshMountInfo();
+#endif
+        static size_t ReadWholeFile(int fd, std::vector<char>& buffer);
     protected:
         typedef std::map<std::wstring, SCXCoreLib::SCXHandle<DeviceInstance> >  DeviceMapType;  //!< Type used for the device-path-to-instance map
         SCXCoreLib::SCXFilePath m_MntTabPath; //!< path to mount tab file.
@@ -433,9 +490,19 @@ namespace SCXSystemLib
         SCXCoreLib::SCXHandle<SCXLvmTab> m_pLvmTab; //!< A parsed lvmtab file object.
         SCXCoreLib::SCXHandle<SCXRaid> m_pRaid; //!< A parsed RAID configuration.
         std::vector<MntTabEntry> m_MntTab; //!< A parsed mnttab object.
+        unsigned int m_MntTabGeneration; //!< Generation of m_MntTab, zero before the first refresh.
+        SCXCoreLib::SCXFilePath m_MountInfoPath; //!< path to mountinfo file.
+        int m_MountInfoFd; //!< Open mountinfo file, polled for changes, or -1.
+        bool m_MountInfoUnavailable; //!< mountinfo could not be opened; the mount tab file is read instead.
+        std::vector<char> m_MountInfoBuffer; //!< Contents of mountinfo, reused between refreshes.
         DeviceMapType m_deviceMap; //!< Device path to instance map.
-        std::map<std::wstring, std::vector<std::wstring> > m_ProcDiskStats; //!< parsed /proc/diskstats data.
+        int m_ProcDiskStatsFd; //!< Open /proc/diskstats, or -1.
+        std::vector<char> m_ProcDiskStatsBuffer; //!< Contents of /proc/diskstats, reused between refreshes.
+        std::vector<ProcDiskStats> m_ProcDiskStats; //!< Parsed /proc/diskstats rows, entries reused between refreshes.
+        size_t m_ProcDiskStatsCount; //!< Entries of m_ProcDiskStats used by the latest refresh.
+        std::vector<size_t> m_ProcDiskStatsIndex; //!< Open addressing hash of (major, minor) to row number plus one, zero if unused.
         std::map<std::wstring, std::wstring> m_fsMap; //!< Used to map filesystem identifiers to names.
+        std::map<std::wstring, bool> m_fsIgnored; //!< FileSystemIgnored() decision by file system type as given.
 
         virtual bool FileSystemNoLinkToPhysical(const std::wstring& fs);
 #if defined(sun)
@@ -449,6 +516,7 @@ namespace SCXSystemLib
         typedef bool CompareFunction(const std::wstring& needle, const std::wstring& heystack);
 
         static bool IsStringInArray(const std::wstring& str, const std::wstring* arr, CompareFunction compare);
+        static std::set<std::wstring> MakeStringSet(const std::wstring* arr);
 
         static bool CompareEqual(const std::wstring& needle, const std::wstring& heystack);
         static bool CompareStartsWith(const std::wstring& needle, const std::wstring& heystack);
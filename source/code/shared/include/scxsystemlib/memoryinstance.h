@@ -19,6 +19,7 @@
 #include <scxcorelib/scxhandle.h>
 #include <scxsystemlib/entityinstance.h>
 #include <scxsystemlib/datasampler.h>
+#include <scxsystemlib/prockeytable.h>
 #include <string>
 #include <vector>
 
@@ -38,6 +39,65 @@ namespace SCXSystemLib
     /** Datasampler for memory information. */
     typedef DataSampler<scxulong, MAX_MEMINSTANCE_DATASAMPER_SAMPLES> MemoryInstanceDataSampler;
 
+#if defined(linux)
+    /** Initial size of the buffers /proc/meminfo and /proc/vmstat are read into. Grown as needed. */
+    const size_t MEMORY_PROC_INITIAL_BUFFER_SIZE = 8192;
+
+    /** Size of the buffer a per NUMA node meminfo file is read into. Sysfs files are at most a page. */
+    const size_t MEMORY_NODE_MEMINFO_MAX_SIZE = 4096;
+#endif
+
+    /** Keys parsed from /proc/meminfo and the per NUMA node meminfo files. */
+    enum MemInfoKey
+    {
+        eMemInfoMemTotal = 0,
+        eMemInfoMemFree,
+        eMemInfoMemAvailable,       //!< Only on kernels 3.14 and later
+        eMemInfoMemUsed,            //!< Only in the per node files
+        eMemInfoBuffers,
+        eMemInfoCached,
+        eMemInfoSwapTotal,
+        eMemInfoSwapFree,
+        eMemInfoHugePagesTotal,     //!< In pages, not kB
+        eMemInfoHugePagesFree,      //!< In pages, not kB
+        eMemInfoHugepagesize,
+        eMemInfoSlab,
+        eMemInfoSReclaimable,
+        eMemInfoShmem,
+        eMemInfoDirty,
+        eMemInfoWriteback,
+        eMemInfoKeyCount            //!< Number of keys, not a key
+    };
+
+    /** Keys parsed from /proc/vmstat. */
+    enum VMStatKey
+    {
+        eVMStatPgpgin = 0,
+        eVMStatPgpgout,
+        eVMStatKeyCount             //!< Number of keys, not a key
+    };
+
+    /** Values of /proc/meminfo, in kB, indexed by MemInfoKey. */
+    struct MemInfoValues
+    {
+        scxulong value[eMemInfoKeyCount];   //!< Value of each key
+        bool found[eMemInfoKeyCount];       //!< Set if the key was present
+    };
+
+    /** Values of /proc/vmstat, indexed by VMStatKey. */
+    struct VMStatValues
+    {
+        scxulong value[eVMStatKeyCount];    //!< Value of each key
+        bool found[eVMStatKeyCount];        //!< Set if the key was present
+    };
+
+    /** Memory of one NUMA node, from /sys/devices/system/node/node#/meminfo. */
+    struct MemoryNodeValues
+    {
+        unsigned int node;                  //!< Node number
+        MemInfoValues memInfo;              //!< Values of the node
+    };
+
     /*----------------------------------------------------------------------------*/
     /**
        Class representing all external dependencies from the Memory PAL.
@@ -47,13 +107,16 @@ namespace SCXSystemLib
     {
     public:
 
-        MemoryDependencies() {};
-        virtual ~MemoryDependencies() {};
+        MemoryDependencies();
+        virtual ~MemoryDependencies();
 
 #if defined(linux)
 
-        virtual std::vector<std::wstring> GetMemInfoLines();
-        virtual std::vector<std::wstring> GetVMStatLines();
+        virtual size_t ReadMemInfo(char* buf, size_t size);
+        virtual size_t ReadVMStat(char* buf, size_t size);
+        virtual bool ReadNodeOnline(std::string& content);
+        virtual size_t ReadNodeMemInfo(unsigned int node, char* buf, size_t size);
+        virtual scxulong GetTimeMilliseconds();
 
 #elif defined(sun)
 
@@ -79,6 +142,17 @@ namespace SCXSystemLib
 
 #endif
 
+#if defined(linux)
+    private:
+        MemoryDependencies(const MemoryDependencies&);              //!< Not implemented, owns file descriptors
+        MemoryDependencies& operator=(const MemoryDependencies&);   //!< Not implemented, owns file descriptors
+
+        size_t ReadProcFile(const char* path, int& fd, char* buf, size_t size);
+
+        SCXCoreLib::SCXThreadLockHandle m_lock; //!< Serializes the first open of the files
+        int m_memInfoFd;    //!< /proc/meminfo, kept open between reads
+        int m_vmStatFd;     //!< /proc/vmstat, kept open between reads
+#endif
     };
 
     /*----------------------------------------------------------------------------*/
@@ -92,6 +166,11 @@ namespace SCXSystemLib
         a thread which updates the m_pageReads and m_pageWrites members 
         continuously. So all updates are not contained to the Update function.
 
+        On Linux the same thread also samples the detailed breakdown of
+        /proc/meminfo (huge pages, slab, shmem, dirty and writeback) and the
+        memory of each NUMA node. Those values are not available until the
+        first sample has been taken.
+
     */
     class MemoryInstance : public EntityInstance
     {
@@ -111,6 +190,18 @@ namespace SCXSystemLib
         bool GetTotalSwap(scxulong& totalSwap) const;
         bool GetAvailableSwap(scxulong& availableSwap) const;
         bool GetUsedSwap(scxulong& usedSwap) const;
+        bool GetHugePagesTotal(scxulong& hugePagesTotal) const;
+        bool GetHugePagesFree(scxulong& hugePagesFree) const;
+        bool GetHugePageSize(scxulong& hugePageSize) const;
+        bool GetSlabMemory(scxulong& slab) const;
+        bool GetSlabReclaimableMemory(scxulong& slabReclaimable) const;
+        bool GetSharedMemory(scxulong& shmem) const;
+        bool GetDirtyMemory(scxulong& dirty) const;
+        bool GetWritebackMemory(scxulong& writeback) const;
+        bool GetDirtyMemoryTrend(double& trend) const;
+        bool GetWritebackMemoryTrend(double& trend) const;
+        size_t GetNodeCount() const;
+        bool GetNode(size_t index, MemoryNodeValues& node) const;
         
         virtual void Update();
         virtual void CleanUp();
@@ -118,7 +209,13 @@ namespace SCXSystemLib
         virtual const std::wstring DumpString() const;
 
         static bool GetPagingSinceBoot(scxulong& pageReads, scxulong& pageWrites, MemoryInstance* inst, SCXCoreLib::SCXHandle<MemoryDependencies> = SCXCoreLib::SCXHandle<MemoryDependencies>(new MemoryDependencies()));
-        
+
+#if defined(linux)
+        void ParseMemInfo(const char* p, const char* end, MemInfoValues& values) const;
+        void ParseNodeMemInfo(const char* p, const char* end, MemInfoValues& values) const;
+        void ParseVMStat(const char* p, const char* end, VMStatValues& values) const;
+#endif
+
 #if defined(sun)
         SCXCoreLib::SCXHandle<SCXKstat> GetKstat();
 #endif
@@ -138,6 +235,34 @@ namespace SCXSystemLib
         MemoryInstanceDataSampler m_pageWrites;         //!< Data sampler for page writes.
         bool m_reservedMemoryIsSupported;               //!< Is m_reservedMemory a usable number?
 
+#if defined(linux)
+        ProcKeyTable m_memInfoKeys;                     //!< Keys parsed from /proc/meminfo.
+        ProcKeyTable m_nodeMemInfoKeys;                 //!< Keys parsed from the per NUMA node meminfo files.
+        ProcKeyTable m_vmStatKeys;                      //!< Keys parsed from /proc/vmstat.
+        MemInfoValues m_memInfo;                        //!< Latest values of /proc/meminfo.
+        std::vector<char> m_memInfoBuffer;              //!< Contents of /proc/meminfo, reused by Update().
+        std::vector<char> m_vmStatBuffer;               //!< Contents of /proc/vmstat, reused by the sampler thread.
+
+        // Written by the sampler thread, read under m_sampleLock
+        SCXCoreLib::SCXThreadLockHandle m_sampleLock;   //!< Protects m_sampledMemInfo and m_nodes.
+        MemInfoValues m_sampledMemInfo;                 //!< /proc/meminfo as of the latest sample.
+        std::vector<MemoryNodeValues> m_nodes;          //!< Memory of each NUMA node as of the latest sample.
+        MemoryInstanceDataSampler m_dirty;              //!< Data sampler for dirty memory, in kB.
+        MemoryInstanceDataSampler m_writeback;          //!< Data sampler for memory under writeback, in kB.
+
+        // Only used by the sampler thread
+        std::vector<char> m_sampleBuffer;               //!< Contents of /proc/meminfo.
+        std::vector<MemoryNodeValues> m_nodeScratch;    //!< Swapped with m_nodes after each sample.
+        std::string m_nodeOnline;                       //!< Contents of the node online file.
+        std::vector<unsigned int> m_nodeList;           //!< NUMA nodes that are online.
+
+        size_t ReadMemInfo(MemoryDependencies* deps, std::vector<char>& buffer);
+        size_t ReadVMStat(MemoryDependencies* deps);
+        void SampleDetails(MemoryDependencies* deps);
+        bool GetSampledValue(MemInfoKey key, scxulong& value) const;
+        static double GetTrend(const MemoryInstanceDataSampler& sampler);
+#endif
+
         SCXCoreLib::SCXHandle<SCXCoreLib::SCXThread> m_dataAquisitionThread;  //!< Pointer to thread body.
         
 #if defined(sun)
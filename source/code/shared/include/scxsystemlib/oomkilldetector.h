@@ -0,0 +1,154 @@
+/*----------------------------------------------------------------------------
+    Copyright (c) Microsoft Corporation.  All rights reserved.
+
+*/
+/**
+    \file
+
+    \brief       Detection of processes killed by the out of memory killer
+
+    \date        2026-10-18 18:00:00
+
+    The kernel counts OOM kills in the oom_kill counter of /proc/vmstat,
+    and per control group in the oom_kill field of memory.events (unified
+    hierarchy) or memory.oom_control (legacy hierarchy). The detector reads
+    the system counter once per process sample, and only when it has moved
+    looks at the processes that disappeared from the process snapshot to
+    find the victims. Linux only.
+
+*/
+/*----------------------------------------------------------------------------*/
+#ifndef OOMKILLDETECTOR_H
+#define OOMKILLDETECTOR_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <scxsystemlib/cgroupenumeration.h>
+#include <scxsystemlib/memoryinstance.h>
+#include <scxsystemlib/processinstance.h>
+#include <scxsystemlib/prockeytable.h>
+#include <scxcorelib/scxhandle.h>
+#include <scxcorelib/scxlog.h>
+#include <scxcorelib/scxtime.h>
+
+namespace SCXSystemLib
+{
+    /** Default number of OOM kill events kept. */
+    const size_t OOMKILL_DEFAULT_EVENT_COUNT = 32;
+
+    /** Number of samples a kill waits for its victim to disappear before it is recorded without one. */
+    const unsigned int OOMKILL_MAX_PENDING_SAMPLES = 2;
+
+    /** Upper bound on the number of control groups whose oom_kill counter is remembered. */
+    const size_t OOMKILL_MAX_TRACKED_CGROUPS = 1024;
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       A process killed by the out of memory killer.
+
+       The process values are the last ones seen by the process sampler
+       before the process disappeared.
+    */
+    struct OOMKillEvent
+    {
+        OOMKillEvent() : sequence(0), attributed(false), pid(0), residentSetSize(0), cgroupConstrained(false) {}
+
+        scxulong sequence;                  //!< Number of the event since the agent started, counting from 1
+        SCXCoreLib::SCXCalendarTime time;   //!< Time the kill was detected
+        bool attributed;                    //!< A victim was found; if false the process values are not set
+        scxpid_t pid;                       //!< Process id of the victim
+        std::string name;                   //!< Name of the victim
+        scxulong residentSetSize;           //!< Resident set size of the victim in KB
+        std::string cgroup;                 //!< Control group of the victim
+        bool cgroupConstrained;             //!< The kill was counted by the control group of the victim
+    };
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Detects OOM kills and attributes them to processes of the process
+       snapshot.
+
+       Driven by ProcessEnumeration::SampleData() with the enumeration lock
+       held: BeginSample() after the process walk, AddDeparted() for every
+       process that disappeared if BeginSample() returned true, and then
+       EndSample(). The kernel picks the process with the highest badness,
+       which is mostly its memory footprint, so departed processes in a
+       control group whose oom_kill counter moved are taken first, then
+       the departed process with the largest resident set. Attribution
+       is best effort; a kill whose victim has not disappeared after
+       OOMKILL_MAX_PENDING_SAMPLES samples is recorded without one.
+
+       The events are kept in a ring of a configurable size, the oldest
+       event is dropped when it is full.
+    */
+    class OOMKillDetector
+    {
+    public:
+        OOMKillDetector(SCXCoreLib::SCXHandle<MemoryDependencies> memDeps = SCXCoreLib::SCXHandle<MemoryDependencies>(new MemoryDependencies()),
+                        SCXCoreLib::SCXHandle<CGroupPALDependencies> cgroupDeps = SCXCoreLib::SCXHandle<CGroupPALDependencies>(new CGroupPALDependencies()));
+
+        void SetEventCount(size_t count);
+        size_t GetEventCount() const;
+
+        bool BeginSample();
+        void AddDeparted(const ProcessInstance& proc);
+        void EndSample();
+
+        void GetEvents(std::vector<OOMKillEvent>& events) const;
+        scxulong GetKillCount() const;
+
+    private:
+        /** Last known values of a process that disappeared during the current sample. */
+        struct Candidate
+        {
+            scxpid_t pid;                   //!< Process id
+            std::string name;               //!< Process name
+            scxulong residentSetSize;       //!< Resident set size in KB
+            std::string cgroup;             //!< Control group path
+            std::string memoryCGroup;       //!< Path in the memory controller hierarchy
+            bool taken;                     //!< Already recorded as a victim
+        };
+
+        /** Remembered oom_kill counter of a memory control group. */
+        struct CGroupKillCount
+        {
+            scxulong count;                 //!< Value of the counter when last read
+            scxulong lastRead;              //!< Value of m_attributions when last read
+        };
+
+        bool ReadKillCount(scxulong& count);
+        bool ReadCGroupKillCount(const std::string& memoryCGroup, scxulong& count) const;
+        void Attribute();
+        void EvictCGroupKillCount();
+        void Record(const Candidate* victim, bool cgroupConstrained);
+
+        SCXCoreLib::SCXHandle<MemoryDependencies> m_memDeps;        //!< Reads /proc/vmstat
+        SCXCoreLib::SCXHandle<CGroupPALDependencies> m_cgroupDeps;  //!< Reads control group files
+        SCXCoreLib::SCXLogHandle m_log;     //!< Log handle
+
+        ProcKeyTable m_keys;                //!< Holds the oom_kill key of /proc/vmstat
+        std::vector<char> m_buffer;         //!< Contents of /proc/vmstat, reused between samples
+        bool m_disabled;                    //!< /proc/vmstat has no oom_kill counter
+        bool m_readFailed;                  //!< The latest read of /proc/vmstat failed
+        bool m_hasBaseline;                 //!< m_killCount has been read once
+        scxulong m_killCount;               //!< Latest value of the oom_kill counter
+        scxulong m_killsSeen;               //!< Kills counted since the agent started
+        scxulong m_pending;                 //!< Kills not yet recorded
+        unsigned int m_pendingSamples;      //!< Samples the pending kills have waited for their victims
+
+        std::vector<Candidate> m_departed;  //!< Departed processes, entries reused between samples
+        size_t m_departedCount;             //!< Entries of m_departed used by the current sample
+        std::map<std::string, CGroupKillCount> m_cgroupKills;   //!< Latest oom_kill counter of memory control groups
+        scxulong m_attributions;            //!< Number of calls to Attribute(), orders m_cgroupKills by age
+
+        std::vector<OOMKillEvent> m_events; //!< Ring of events
+        size_t m_eventCount;                //!< Capacity of the ring
+        size_t m_next;                      //!< Slot of the next event in the ring
+        scxulong m_sequence;                //!< Sequence number of the latest event
+    };
+}
+
+#endif /* OOMKILLDETECTOR_H */
+/*----------------------------E-N-D---O-F---F-I-L-E---------------------------*/
@@ -0,0 +1,95 @@
+/*----------------------------------------------------------------------------
+    Copyright (c) Microsoft Corporation.  All rights reserved.
+
+*/
+/**
+    \file
+
+    \brief       Enumeration of Linux pressure stall information (PSI)
+
+    \date        2026-10-18 15:00:00
+
+    PSI is read from /proc/pressure/cpu, /proc/pressure/memory and
+    /proc/pressure/io. It is only available on Linux 4.20 and later when
+    the kernel is built with CONFIG_PSI and not booted with psi=0; in all
+    other cases the enumeration is empty.
+
+*/
+/*----------------------------------------------------------------------------*/
+#ifndef PRESSUREENUMERATION_H
+#define PRESSUREENUMERATION_H
+
+#include <string>
+
+#include <scxsystemlib/entityenumeration.h>
+#include <scxsystemlib/pressureinstance.h>
+#include <scxcorelib/scxlog.h>
+#include <scxcorelib/scxthread.h>
+#include <scxcorelib/scxthreadlock.h>
+
+namespace SCXSystemLib
+{
+    /** Time between each sample in seconds. */
+    const int PRESSURE_SECONDS_PER_SAMPLE = 60;
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Class representing all external dependencies from the PSI PAL.
+
+       The directory holding the pressure files is configurable so that the
+       PAL can be run against fake pressure files.
+    */
+    class PressurePALDependencies
+    {
+    public:
+        PressurePALDependencies(const std::string& root = "/proc/pressure") : m_root(root) {}
+        virtual ~PressurePALDependencies() {};
+
+        virtual const std::string& GetRoot() const;
+        virtual bool ReadFile(const std::string& path, std::string& content) const;
+        virtual scxulong GetTimeMicroseconds() const;
+
+    private:
+        std::string m_root;     //!< Directory holding the pressure files
+    };
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Class that represents the pressure stall information of all resources.
+
+       The set of resources is decided once by Init(); a resource whose file
+       can not be read at that point is not reported.
+    */
+    class PressureEnumeration : public EntityEnumeration<PressureInstance>
+    {
+    public:
+        explicit PressureEnumeration(SCXCoreLib::SCXHandle<PressurePALDependencies> deps = SCXCoreLib::SCXHandle<PressurePALDependencies>(new PressurePALDependencies()));
+        ~PressureEnumeration();
+        virtual void Init();
+        virtual void Update(bool updateInstances=true);
+        virtual void CleanUp();
+        void SampleData();
+
+        const SCXCoreLib::SCXThreadLockHandle& GetLockHandle() const;
+        void UpdateNoLock(SCXCoreLib::SCXThreadLock& lck, bool updateInstances=true);
+
+        bool IsSupported() const;
+
+        //
+        // These would normally be private, but are here for unit test purposes
+        //
+        static bool ParseLine(const std::string& content, const char* kind,
+                              double& avg10, double& avg60, double& avg300, scxulong& total);
+
+    private:
+        SCXCoreLib::SCXHandle<PressurePALDependencies> m_deps; //!< Collects external dependencies of this class.
+        SCXCoreLib::SCXLogHandle m_log;         //!< Log handle.
+        SCXCoreLib::SCXThreadLockHandle m_lock; //!< Serializes sampling and updates.
+
+        SCXCoreLib::SCXHandle<SCXCoreLib::SCXThread> m_dataAquisitionThread; //!< Thread pointer.
+        static void DataAquisitionThreadBody(SCXCoreLib::SCXThreadParamHandle& param);
+    };
+}
+
+#endif /* PRESSUREENUMERATION_H */
+/*----------------------------E-N-D---O-F---F-I-L-E---------------------------*/
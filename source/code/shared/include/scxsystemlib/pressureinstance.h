@@ -0,0 +1,95 @@
+/*----------------------------------------------------------------------------
+    Copyright (c) Microsoft Corporation.  All rights reserved.
+
+*/
+/**
+    \file
+
+    \brief       PAL representation of Linux pressure stall information for one resource
+
+    \date        2026-10-18 15:00:00
+
+*/
+/*----------------------------------------------------------------------------*/
+#ifndef PRESSUREINSTANCE_H
+#define PRESSUREINSTANCE_H
+
+#include <string>
+
+#include <scxsystemlib/entityinstance.h>
+#include <scxsystemlib/datasampler.h>
+#include <scxcorelib/scxlog.h>
+
+namespace SCXSystemLib
+{
+    /** Number of samples collected in the datasampler for pressure stall information. */
+    const int MAX_PRESSUREINSTANCE_DATASAMPLER_SAMPLES = 6;
+
+    /** Datasampler for pressure stall counters. */
+    typedef DataSampler<scxulong, MAX_PRESSUREINSTANCE_DATASAMPLER_SAMPLES> PressureInstanceDataSampler;
+
+    /*----------------------------------------------------------------------------*/
+    /**
+        Class that represents the pressure stall information of one resource
+        (cpu, memory or io).
+
+        The "some" line accounts for time where at least one task was stalled
+        on the resource, the "full" line for time where all non-idle tasks
+        were stalled. The kernel's own averages are kept as read; the
+        cumulative "total=" stall time is sampled by PressureEnumeration and
+        turned into a percentage over the sampled window by Update().
+    */
+    class PressureInstance : public EntityInstance
+    {
+        friend class PressureEnumeration;
+
+    public:
+        PressureInstance(const std::string& resource);
+        virtual ~PressureInstance();
+
+        virtual void Update();
+
+        const std::string& GetResource() const;
+
+        // Return values indicate whether the value is available for this
+        // resource or not. The "full" values are not reported for cpu by
+        // kernels older than 5.13.
+        bool GetSomeAverage10(double& percent) const;
+        bool GetSomeAverage60(double& percent) const;
+        bool GetSomeAverage300(double& percent) const;
+        bool GetSomeTotal(scxulong& usec) const;
+        bool GetPercentSomeStalled(double& percent) const;
+        bool GetFullAverage10(double& percent) const;
+        bool GetFullAverage60(double& percent) const;
+        bool GetFullAverage300(double& percent) const;
+        bool GetFullTotal(scxulong& usec) const;
+        bool GetPercentFullStalled(double& percent) const;
+
+    private:
+        static void AddCounterSample(PressureInstanceDataSampler& sampler, scxulong value);
+        double GetPercentStalled(const PressureInstanceDataSampler& sampler) const;
+
+        SCXCoreLib::SCXLogHandle m_log;             //!< Log handle
+        std::string m_resource;                     //!< Name of the file below /proc/pressure
+
+        bool m_hasSome;                             //!< The "some" line was found in the latest sample
+        bool m_hasFull;                             //!< The "full" line was found in the latest sample
+
+        double m_someAvg10;                         //!< Kernel average of the "some" line over 10 seconds
+        double m_someAvg60;                         //!< Kernel average of the "some" line over 60 seconds
+        double m_someAvg300;                        //!< Kernel average of the "some" line over 300 seconds
+        double m_fullAvg10;                         //!< Kernel average of the "full" line over 10 seconds
+        double m_fullAvg60;                         //!< Kernel average of the "full" line over 60 seconds
+        double m_fullAvg300;                        //!< Kernel average of the "full" line over 300 seconds
+
+        double m_percentSomeStalled;                //!< Computed by Update()
+        double m_percentFullStalled;                //!< Computed by Update()
+
+        PressureInstanceDataSampler m_time_usec;    //!< Monotonic time of each sample
+        PressureInstanceDataSampler m_someTotal;    //!< Cumulative "some" stall time in microseconds
+        PressureInstanceDataSampler m_fullTotal;    //!< Cumulative "full" stall time in microseconds
+    };
+}
+
+#endif /* PRESSUREINSTANCE_H */
+/*----------------------------E-N-D---O-F---F-I-L-E---------------------------*/
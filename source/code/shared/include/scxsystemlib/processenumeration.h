@@ -14,9 +14,13 @@
 #define PROCESSENUMERATION_H
 
 #include <map>
+#include <set>
 
 #include <scxsystemlib/entityenumeration.h>
 #include <scxsystemlib/processinstance.h>
+#include <scxsystemlib/processgroupinstance.h>
+#include <scxsystemlib/threadinstance.h>
+#include <scxsystemlib/oomkilldetector.h>
 #include <scxcorelib/scxlog.h>
 #include <scxcorelib/scxthread.h>
 #include <scxcorelib/scxhandle.h>
@@ -29,6 +33,21 @@ namespace SCXSystemLib
     /** Type of live process map. One pid corresponds to one process. */
     typedef std::map<scxpid_t, SCXCoreLib::SCXHandle<ProcessInstance> > ProcMap;
 
+    /** Type of process group map. One key corresponds to one aggregate. */
+    typedef std::map<ProcessGroupKey, SCXCoreLib::SCXHandle<ProcessGroupInstance> > ProcGroupMap;
+
+    /** Type of process name index. Maps a process name to the pids having that name. */
+    typedef std::map<std::string, std::set<scxpid_t> > ProcNameIndex;
+
+    /** Type of sampled thread map. Thread ids are unique system wide. */
+    typedef std::map<scxpid_t, SCXCoreLib::SCXHandle<ThreadInstance> > ThreadMap;
+
+    /** Upper bound on the number of dead process instances kept for reuse. */
+    const size_t MAX_POOLED_PROCESSINSTANCES = 512;
+
+    /** Upper bound on the number of threads sampled, to bound the cost of a misconfiguration. */
+    const size_t MAX_SAMPLED_THREADS = 4096;
+
     /*----------------------------------------------------------------------------*/
     /**
         Class that represents a collection of Process:s.
@@ -56,8 +75,18 @@ namespace SCXSystemLib
 
         SCXCoreLib::SCXHandle<ProcessInstance> Find(scxpid_t pid);
         std::vector<SCXCoreLib::SCXHandle<ProcessInstance> > Find(const std::wstring& name);
+        std::vector<SCXCoreLib::SCXHandle<ProcessGroupInstance> > GetProcessGroups() const;
+        void SetThreadSampling(const std::vector<std::wstring>& names, const std::vector<scxpid_t>& pids);
+        std::vector<SCXCoreLib::SCXHandle<ThreadInstance> > GetThreads() const;
+        void SetOOMKillEventCount(size_t count);
+        void SetIOAccounting(bool enabled);
+        std::vector<OOMKillEvent> GetOOMKillEvents() const;
         static bool SendSignalByName(const std::wstring& name, int sig);
+        static std::vector<SCXCoreLib::SCXHandle<ProcessInstance> > FindByName(const std::wstring& name);
+        static bool FindPidsByName(const std::wstring& name, std::vector<scxpid_t>& pids);
         static bool GetNumberOfProcesses(unsigned int& numberOfProcesses);
+        size_t GetAllocationsLastSample() const;
+        size_t GetReusesLastSample() const;
 
     private:
         SCXCoreLib::SCXLogHandle m_log;                         //!< Handle to log file 
@@ -65,10 +94,40 @@ namespace SCXSystemLib
 
         SCXCoreLib::SCXHandle<SCXCoreLib::SCXThread> m_dataAquisitionThread; //!< Thread pointer.
         static void DataAquisitionThreadBody(SCXCoreLib::SCXThreadParamHandle& param);
+        void UpdateProcessGroups();
+        void IndexName(scxpid_t pid, ProcessInstance& proc, const std::string& name);
+        void UnindexName(scxpid_t pid, ProcessInstance& proc);
+#if defined(hpux)
+        SCXCoreLib::SCXHandle<ProcessInstance> NewInstance(scxpid_t pid, struct pst_status* basename);
+#else
+        SCXCoreLib::SCXHandle<ProcessInstance> NewInstance(scxpid_t pid, const char* basename);
+#endif
+        void RetireInstance(SCXCoreLib::SCXHandle<ProcessInstance> inst);
+        void SampleThreads(struct timeval& realtime);
 
         /** Map of active processes */
         ProcMap m_procs;
 
+        /** Pids of active processes by name, kept in step with m_procs by SampleData() */
+        ProcNameIndex m_nameIndex;
+
+        /** Instances of dead processes, kept for reuse by NewInstance() */
+        std::vector<SCXCoreLib::SCXHandle<ProcessInstance> > m_pool;
+        size_t m_allocations;   //!< Number of process instances allocated by the latest SampleData()
+        size_t m_reuses;        //!< Number of process instances reused from the pool by the latest SampleData()
+        bool m_ioAccounting;    //!< Read /proc/#/io of the processes, see SetIOAccounting()
+
+        /** Aggregates of active processes, rebuilt at each sample */
+        ProcGroupMap m_groups;
+
+        /** Threads of the processes selected with SetThreadSampling() */
+        ThreadMap m_threads;
+        std::set<std::string> m_threadNames;    //!< Process names to sample threads for
+        std::set<scxpid_t> m_threadPids;        //!< Process ids to sample threads for
+
+        /** Detects OOM kills among the processes that disappear */
+        OOMKillDetector m_oomKills;
+
         int m_EnumErrorCount;    //!< Number of consecutive enumeration attempts with errors.
         int m_EnumGoodCount;     //!< Number of consecutive enumeration attempts without errors.
         SCXCoreLib::SCXLogSeverity m_EnumLogLevel;  //!< Log level to use when logging execption during instance update
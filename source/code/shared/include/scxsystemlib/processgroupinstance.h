@@ -0,0 +1,99 @@
+/*----------------------------------------------------------------------------
+    Copyright (c) Microsoft Corporation.  All rights reserved.
+
+*/
+/**
+    \file
+
+    \brief       Aggregated statistics for a group of processes
+
+    \date        2026-10-18 09:00:00
+
+    A process group is the set of live processes that share command name,
+    effective user id and control group. The groups are computed by
+    ProcessEnumeration in the same pass that samples the processes.
+
+*/
+/*----------------------------------------------------------------------------*/
+#ifndef PROCESSGROUPINSTANCE_H
+#define PROCESSGROUPINSTANCE_H
+
+#include <string>
+
+#include <scxsystemlib/entityinstance.h>
+#include <scxsystemlib/processinstance.h>
+
+namespace SCXSystemLib
+{
+    /*----------------------------------------------------------------------------*/
+    /**
+        Key that identifies a process group.
+    */
+    struct ProcessGroupKey
+    {
+        std::string name;       //!< Process name as returned by ProcessInstance::GetName()
+        scxulong    euid;       //!< Effective user id
+        std::string cgroup;     //!< Control group path (empty if not supported)
+
+        /** Strict weak ordering so that the key can be used in a std::map */
+        bool operator<(const ProcessGroupKey& other) const
+        {
+            if (euid != other.euid) { return euid < other.euid; }
+            int c = name.compare(other.name);
+            if (c != 0) { return c < 0; }
+            return cgroup < other.cgroup;
+        }
+    };
+
+    /*----------------------------------------------------------------------------*/
+    /**
+        Class that represents the aggregate of a group of processes.
+
+        Values are sums over all processes in the group at the time of the
+        latest sample. Percentages are summed too, so a group of four busy
+        processes on a multi-CPU host may report 400 percent.
+    */
+    class ProcessGroupInstance : public EntityInstance
+    {
+        friend class ProcessEnumeration;
+
+    public:
+        ProcessGroupInstance(const ProcessGroupKey& key);
+        virtual ~ProcessGroupInstance();
+
+        bool GetProcessName(std::string& name) const;
+        bool GetEffectiveUserID(scxulong& euid) const;
+        bool GetCGroupPath(std::string& cgroup) const;
+        bool GetProcessCount(scxulong& count) const;
+
+        bool GetCPUTime(scxulong& cpu) const;
+        bool GetPercentUserTime(scxulong& put) const;
+        bool GetPercentPrivilegedTime(scxulong& ppt) const;
+        bool GetUsedMemory(scxulong& um) const;
+        bool GetBlockReadsPerSecond(scxulong& brs) const;
+        bool GetBlockWritesPerSecond(scxulong& bws) const;
+        bool GetBlockTransfersPerSecond(scxulong& bts) const;
+        bool GetPagesReadPerSec(scxulong& prs) const;
+
+    private:
+        void Reset();
+        void Accumulate(const ProcessInstance& proc);
+
+        ProcessGroupKey m_key;          //!< What identifies the group
+
+        scxulong m_processCount;        //!< Number of live processes in the group
+        scxulong m_cpuTime;             //!< Sum of CPU percentage
+        scxulong m_userTime;            //!< Sum of user mode percentage
+        scxulong m_privilegedTime;      //!< Sum of kernel mode percentage
+        scxulong m_usedMemory;          //!< Sum of resident set sizes in kilobytes
+        scxulong m_blockReads;          //!< Sum of block reads per second
+        scxulong m_blockWrites;         //!< Sum of block writes per second
+        scxulong m_pagesRead;           //!< Sum of hard page faults per second
+
+        bool m_hasBlockIO;              //!< Platform reports block I/O per process
+        bool m_hasPagesRead;            //!< Platform reports hard page faults per process
+    };
+}
+
+#endif /* PROCESSGROUPINSTANCE_H */
+/*----------------------------E-N-D---O-F---F-I-L-E---------------------------*/
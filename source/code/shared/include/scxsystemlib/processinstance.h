@@ -132,6 +132,20 @@ namespace SCXSystemLib
         bool ReadStatMFile(FILE *filePointer, const char* filename);
     };
 
+    /** Holds Linux I/O accounting of a process, from /proc/#/io */
+    struct LinuxProcIO {
+        LinuxProcIO() : readSyscalls(0), writeSyscalls(0), readBytes(0),
+                        writeBytes(0), cancelledWriteBytes(0) {}
+
+        scxulong readSyscalls;          //!< syscr, read system calls
+        scxulong writeSyscalls;         //!< syscw, write system calls
+        scxulong readBytes;             //!< read_bytes, bytes fetched from storage
+        scxulong writeBytes;            //!< write_bytes, bytes sent to storage
+        scxulong cancelledWriteBytes;   //!< cancelled_write_bytes, dirty bytes truncated before writeback
+
+        bool ReadIOFile(FILE *filePointer);
+    };
+
 #endif /* Linux */
 
     /** Implements subtraction for system type struct timeval.
@@ -252,6 +266,9 @@ namespace SCXSystemLib
 
 #if defined(linux)
         void SetBootTime(void);
+        void ReadCGroupFile(const char* basename);
+        void UpdateIOAccounting(bool enabled);
+        void Recycle(scxpid_t pid, const char* basename);
 #endif
 
 #if defined(hpux)
@@ -277,6 +294,7 @@ namespace SCXSystemLib
         bool GetTerminationDate(SCXCoreLib::SCXCalendarTime& term) const;
         bool GetParentProcessID(int& pid) const;
         bool GetRealUserID(scxulong& uid) const;
+        bool GetEffectiveUserID(scxulong& euid) const;
         bool GetProcessGroupID(scxulong& pgid) const;
         bool GetProcessNiceValue(unsigned int& nice) const;
 
@@ -301,6 +319,10 @@ namespace SCXSystemLib
         bool GetUsedMemory(scxulong &um) const;
         bool GetPercentUsedMemory(scxulong &) const;
         bool GetPagesReadPerSec(scxulong &prs) const;
+        bool GetReadBytesPerSecond(scxulong &rbs) const;
+        bool GetWriteBytesPerSecond(scxulong &wbs) const;
+        bool GetReadOperationsPerSecond(scxulong &ros) const;
+        bool GetWriteOperationsPerSecond(scxulong &wos) const;
 
         /* Properties in SCX_UnixProcessStatisticalInformation, Phase 2 */
         bool GetRealText(scxulong &rt) const;
@@ -314,6 +336,10 @@ namespace SCXSystemLib
         bool GetCpuTimeDeadChildren(scxulong &ctdc) const;
         bool GetSystemTimeDeadChildren(scxulong &stdc) const;
 
+        /* Used for aggregation in SCX_ProcessGroupStatisticalInformation */
+        bool GetCGroupPath(std::string& cgroup) const;
+        bool GetMemoryCGroupPath(std::string& cgroup) const;
+
         /* Utility stuff */
         bool SendSignal(int signl) const;
 
@@ -330,14 +356,22 @@ namespace SCXSystemLib
         bool m_found;                           //!< Found during iteration
         bool m_accessViolationEncountered;      //!< Flag that we've had problems with access
         struct timeval m_timeOfDeath;           //!< When did process die
+        std::string m_indexedName;              //!< Name under which ProcessEnumeration has indexed this process
 
 #if defined(linux)
         char m_procStatName[PROCPATH_LEN];      //!< Name of /proc/#/stat file
         char m_procStatMName[PROCPATH_LEN];     //!< Name of /proc/#/statm file
+        char m_procIOName[PROCPATH_LEN];        //!< Name of /proc/#/io file
         uid_t     m_uid;                        //!< User ID of owner 
         gid_t     m_gid;                        //!< Group ID of owner 
+        std::string m_cgroup;                   //!< Control group path, from /proc/#/cgroup
+        std::string m_memoryCGroup;             //!< Path in the memory controller hierarchy, from /proc/#/cgroup
         LinuxProcStat m;                        //!< Linux specific process information
         LinuxProcStatM n;                       //!< Linux specific process information
+        LinuxProcIO m_io;                       //!< Latest I/O accounting, valid if m_hasIO
+        bool m_hasIO;                           //!< /proc/#/io was read at the latest sample
+        bool m_ioRead;                          //!< /proc/#/io has been read at least once
+        bool m_ioUnavailable;                   //!< /proc/#/io could not be read, it is not tried again
         static SCXCoreLib::SCXCalendarTime m_system_boot; //!< Time of system boot 
         unsigned int m_jiffies_per_second;              //!< Time base for PC Linux
         static const unsigned int m_pageSize = 4;       //!< Page size in KB on Linux
@@ -346,12 +380,22 @@ namespace SCXSystemLib
         ScxULongDataSampler_t m_UserTime_tics;          //!< Data sampler for user time.
         ScxULongDataSampler_t m_SystemTime_tics;        //!< Data sampler for system time.
         ScxULongDataSampler_t m_HardPageFaults_tics;    //!< Data sampler for hard page faults.
+        ScxULongDataSampler_t m_ReadSyscalls_tics;      //!< Data sampler for read system calls.
+        ScxULongDataSampler_t m_WriteSyscalls_tics;     //!< Data sampler for write system calls.
+        ScxULongDataSampler_t m_ReadBytes_tics;         //!< Data sampler for bytes read from storage.
+        ScxULongDataSampler_t m_WriteBytes_tics;        //!< Data sampler for bytes written to storage.
+        ScxULongDataSampler_t m_CancelledWriteBytes_tics; //!< Data sampler for cancelled write bytes.
 
         /* These are updated when UpdateTimedValues() is run. */
         struct timeval m_delta_RealTime;                //!< Elapsed real time at update
         scxulong m_delta_UserTime;                      //!< Consumed user time at update
         scxulong m_delta_SystemTime;                    //!< Consumed system time at update
         scxulong m_delta_HardPageFaults;                //!< Executed page faults at update
+        struct timeval m_delta_IORealTime;              //!< Elapsed real time covered by the I/O samplers at update
+        scxulong m_delta_ReadSyscalls;                  //!< Read system calls at update
+        scxulong m_delta_WriteSyscalls;                 //!< Write system calls at update
+        scxulong m_delta_ReadBytes;                     //!< Bytes read from storage at update
+        scxulong m_delta_WriteBytes;                    //!< Bytes written to storage, less cancelled writes, at update
 
         scxulong ComputeItemsPerSecond(scxulong delta_item,             // Defined below
                                        const struct timeval& elapsedTime) const;
@@ -0,0 +1,73 @@
+/*--------------------------------------------------------------------------------
+    Copyright (c) Microsoft Corporation.  All rights reserved.
+
+*/
+/**
+    \file
+
+    \brief       Key lookup table for /proc files made up of "key value" lines
+
+    \date        2026-10-18 16:00:00
+
+    Files like /proc/meminfo and /proc/vmstat have one named counter per
+    line and grow new lines with every kernel release. The table maps the
+    few keys a caller is interested in to indexes into a fixed array of
+    values, so a whole file can be parsed in one pass over a raw buffer
+    without tokenizing or allocating.
+
+*/
+/*----------------------------------------------------------------------------*/
+#ifndef PROCKEYTABLE_H
+#define PROCKEYTABLE_H
+
+#include <scxcorelib/scxcmn.h>
+#include <string>
+#include <vector>
+
+namespace SCXSystemLib
+{
+    /*----------------------------------------------------------------------------*/
+    /**
+       Hash table of the keys to pick out of a /proc key/value file.
+
+       The hash is seeded, and the seed is chosen when keys are added so
+       that no two keys share a slot. A lookup is then a single hash and a
+       single compare. Should no such seed be found the table still works,
+       using linear probing.
+    */
+    class ProcKeyTable
+    {
+    public:
+        /** Returned by Find() for keys not in the table. */
+        static const size_t npos;
+
+        ProcKeyTable();
+
+        bool Add(const std::string& key, size_t index);
+        void Clear();
+        size_t Size() const;
+        bool IsPerfect() const;
+
+        size_t Find(const char* key, size_t len) const;
+        size_t Parse(const char* p, const char* end, scxulong* values, bool* found, size_t skipWords = 0) const;
+
+    private:
+        /** One slot of the table. An empty key marks an unused slot. */
+        struct Slot
+        {
+            std::string key;    //!< Key, without trailing colon
+            size_t index;       //!< Index of the value the key maps to
+        };
+
+        static unsigned int Hash(const char* key, size_t len, unsigned int seed);
+        bool Rebuild(size_t size, unsigned int seed);
+
+        std::vector<Slot> m_slots;          //!< Hash table, size is a power of two
+        std::vector<Slot> m_keys;           //!< All keys in the order added, for rehashing
+        unsigned int m_seed;                //!< Seed of the current hash function
+        bool m_perfect;                     //!< True if no two keys share a slot
+    };
+}
+
+#endif /* PROCKEYTABLE_H */
+/*----------------------------E-N-D---O-F---F-I-L-E---------------------------*/
@@ -0,0 +1,74 @@
+/*--------------------------------------------------------------------------------
+  Copyright (c) Microsoft Corporation.  All rights reserved.
+
+*/
+/**
+   \file
+
+   \brief       PAL representation of the system wide scheduler counters
+
+   \date        2026-10-18 14:00:00
+
+   The counters are the ctxt, intr, processes, procs_running and
+   procs_blocked rows of /proc/stat. They are sampled by CPUEnumeration in
+   the same pass as the per-CPU rows.
+*/
+/*----------------------------------------------------------------------------*/
+#ifndef SCHEDULERINSTANCE_H
+#define SCHEDULERINSTANCE_H
+
+#include <scxsystemlib/entityinstance.h>
+#include <scxsystemlib/datasampler.h>
+#include <scxsystemlib/cpuinstance.h>
+#include <scxcorelib/scxlog.h>
+
+namespace SCXSystemLib
+{
+    /** Datasampler for scheduler counters. */
+    typedef DataSampler<scxulong, MAX_CPUINSTANCE_DATASAMPER_SAMPLES> SchedulerDataSampler;
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Class that represents the system wide scheduler counters.
+
+       There is only one instance, and it is the total instance.
+    */
+    class SchedulerInstance : public EntityInstance
+    {
+        friend class CPUEnumeration;
+
+    public:
+        SchedulerInstance();
+        virtual ~SchedulerInstance();
+
+        virtual void Update();
+
+        bool GetContextSwitchesPerSecond(scxulong& rate) const;
+        bool GetInterruptsPerSecond(scxulong& rate) const;
+        bool GetProcessesCreatedPerSecond(scxulong& rate) const;
+        bool GetRunQueueLength(scxulong& length) const;
+        bool GetBlockedQueueLength(scxulong& length) const;
+
+    private:
+        void AddSample(scxulong timeMsec, scxulong contextSwitches, scxulong interrupts,
+                       scxulong processesCreated, scxulong running, scxulong blocked);
+        scxulong GetRate(const SchedulerDataSampler& counter, scxulong elapsedMsec) const;
+
+        SCXCoreLib::SCXLogHandle m_log;  //!< Log handle
+
+        scxulong m_contextSwitchesPerSecond;    //!< Context switches per second.
+        scxulong m_interruptsPerSecond;         //!< Interrupts serviced per second.
+        scxulong m_processesCreatedPerSecond;   //!< Processes and threads created per second.
+        scxulong m_runQueueLength;              //!< Runnable threads at the latest sample.
+        scxulong m_blockedQueueLength;          //!< Threads blocked on IO at the latest sample.
+
+        SchedulerDataSampler m_Time_msec;           //!< Data sampler for time of sample, in milliseconds.
+        SchedulerDataSampler m_ContextSwitches;     //!< Data sampler for the ctxt counter.
+        SchedulerDataSampler m_Interrupts;          //!< Data sampler for the intr counter.
+        SchedulerDataSampler m_ProcessesCreated;    //!< Data sampler for the processes counter.
+    };
+
+}
+
+#endif /* SCHEDULERINSTANCE_H */
+/*----------------------------E-N-D---O-F---F-I-L-E---------------------------*/
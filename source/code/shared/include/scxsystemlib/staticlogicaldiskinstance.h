@@ -16,6 +16,7 @@
 
 #include <scxsystemlib/entityinstance.h>
 #include <scxsystemlib/diskdepend.h>
+#include <scxsystemlib/statvfsprobe.h>
 #include <scxcorelib/scxlog.h>
 #include <scxcorelib/scxhandle.h>
 
@@ -81,6 +82,7 @@ namespace SCXSystemLib
         int m_codeSet;                          //!< Code set (0-8 for Unknown/Other/ASCII/Unicode/ISO2022/ISO8859/Extended UNIX Code/UTF-8/UCS-2
         scxulong m_maxFilenameLen;              //!< Maximum file name length
         scxulong m_blockSize;                   //!< Block size
+        StatVfsProbe m_statVfs;                 //!< Timeout bounded statvfs() of the mount point
     };
 } /* namespace SCXSystemLib */
 #endif /* STATICLOGICALDISKINSTANCE_H */
@@ -54,6 +54,8 @@ namespace SCXSystemLib
         bool GetTotalHeads(scxulong& value) const;
         bool GetTotalSectors(scxulong& value) const;
         bool GetSectorSize(unsigned int& value) const;
+        bool GetIsRotational(bool& value) const;
+        bool GetIsRemovable(bool& value) const;
 
         /** Set the device ID for this instance, e.g. /dev/sda */
         void SetDevice( const std::wstring& device ) {m_device = device;}
@@ -87,6 +89,9 @@ namespace SCXSystemLib
         scxulong m_totalHeads;                   //!< Total number of heads
         scxulong m_totalSectors;                 //!< Total number of sectors
         unsigned int m_sectorSize;               //!< Sector size, in bytes
+        bool m_hasMediaType;                     //!< m_rotational and m_removable are known
+        bool m_rotational;                       //!< Rotating media, false for solid state
+        bool m_removable;                        //!< Removable media
     };
 } /* namespace SCXSystemLib */
 #endif /* STATICPHYSICALDISKINSTANCE_H */
@@ -19,6 +19,7 @@
 #include <scxcorelib/scxlog.h>
 #include <scxsystemlib/datasampler.h>
 #include <scxsystemlib/diskdepend.h>
+#include <scxsystemlib/statvfsprobe.h>
 #include <scxcorelib/scxhandle.h>
 
 #if defined(sun)
@@ -36,6 +37,9 @@ namespace SCXSystemLib
     /** Datasampler for disk information. */
     typedef DataSampler<scxulong, MAX_DISKINSTANCE_DATASAMPER_SAMPLES> DiskInstanceDataSampler;
 
+    /** Number of buckets of the disk latency histogram, the last one is unbounded. */
+    const size_t DISK_LATENCY_BUCKETS = 11;
+
     /*----------------------------------------------------------------------------*/
     /**
         Represents a single statistical disk instance. This class holds common parts 
@@ -62,7 +66,13 @@ namespace SCXSystemLib
         virtual bool GetDiskQueueLength(double& value) const;
         virtual bool GetDiskSize(scxulong& mbUsed, scxulong& mbFree) const;
         virtual bool GetInodeUsage(scxulong& inodesTotal, scxulong& inodesFree) const;
+        virtual bool GetInodesAvailable(scxulong& inodesAvailable) const;
+        virtual bool GetInodeConsumption(double& perSecond) const;
+        virtual bool GetReservedSpace(scxulong& mbReserved) const;
         virtual bool GetBlockSize(scxulong& blockSize) const;
+        virtual bool GetSpaceStale(bool& stale) const;
+        virtual bool GetLatencyHistogram(std::vector<scxulong>& counts) const;
+        static void GetLatencyHistogramBounds(std::vector<scxulong>& bounds);
         
         virtual bool GetHealthState(bool& healthy) const;
         
@@ -95,6 +105,23 @@ namespace SCXSystemLib
         scxlong FindDiskInfoByID(scxlong id);
         scxlong FindLVInfoByID(scxlong id);
     protected:    
+        void SampleInodeConsumption();
+
+#if defined(linux)
+        const ProcDiskStats* LookupProcDiskStats(size_t index, const std::wstring& device);
+        void AddLatencySample();
+
+        /** Device number of a /proc/diskstats row, as found by name. */
+        struct ProcDiskStatsId
+        {
+            ProcDiskStatsId() : major(0), minor(0), found(false) {}
+            unsigned int major;    //!< Device major ID number
+            unsigned int minor;    //!< Device minor ID number
+            bool found;            //!< The device has been found by name
+        };
+        std::vector<ProcDiskStatsId> m_procDiskStatsIds; //!< Device numbers of m_device and m_samplerDevices, in that order
+#endif
+
         SCXCoreLib::SCXHandle<DiskDepend> m_deps;//!< StaticDiskDepend object
         SCXCoreLib::SCXLogHandle m_log;         //!< Log handle
 #if defined(sun)
@@ -128,7 +155,11 @@ namespace SCXSystemLib
         scxulong m_mbUsed;         //!< MB used
         scxulong m_mbFree;         //!< MB free
         scxulong m_inodesTotal;    //!< Total inodes
-        scxulong m_inodesFree;     //!< Free (available) inodes
+        scxulong m_inodesFree;     //!< Free inodes
+        scxulong m_inodesAvailable;//!< Inodes available to unprivileged users
+        scxulong m_mbReserved;     //!< MB reserved for the super user
+        double m_inodesPerSec;     //!< Inodes consumed per second
+        bool m_hasInodeRate;       //!< m_inodesPerSec is sampled
         scxulong m_blockSize;      //!< Disk block size
         double m_qLength;          //!< Average disk queue length
 
@@ -145,6 +176,17 @@ namespace SCXSystemLib
         DiskInstanceDataSampler m_runTimes;  //!< Data sampler for run times
         DiskInstanceDataSampler m_timeStamp; //!< Data sampler for time stamps
         DiskInstanceDataSampler m_qLengths;  //!< Data sampler for queue lengths
+        DiskInstanceDataSampler m_ioTimes;   //!< Data sampler for time spent doing I/O
+        DiskInstanceDataSampler m_queueTimes;//!< Data sampler for time spent doing I/O weighted by queue length
+        DiskInstanceDataSampler m_inodesUsed;//!< Data sampler for used inodes, sampled by Update()
+        DiskInstanceDataSampler m_spaceTimes;//!< Data sampler for time stamps of m_inodesUsed
+
+        bool m_hasUtilization;                          //!< m_tPercentage and m_qLength are from the time spent doing I/O
+        bool m_hasLatencyHistogram;                     //!< m_latencyHistogram is sampled
+        scxulong m_latencyHistogram[DISK_LATENCY_BUCKETS]; //!< I/Os by average latency of their sample interval
+
+        StatVfsProbe m_statVfs;    //!< Timeout bounded statvfs() of the mount point
+        bool m_spaceStale;         //!< Space and inode values are from an earlier sample
     };
 
 }
@@ -58,6 +58,7 @@ namespace SCXSystemLib
         SCXCoreLib::SCXHandle<SCXCoreLib::SCXThread> m_sampler;       //!< Data sampler.
         SCXCoreLib::SCXThreadLockHandle m_lock; //!< Handles locking in the disk enumeration.
         std::map<std::wstring,scxulong> m_pathToRdev; //!< Cache for path to rdev values.
+        unsigned int m_mntTabGeneration; //!< Mount tab generation m_pathToRdev was filled with.
 
         void FindLogicalDisks();
         
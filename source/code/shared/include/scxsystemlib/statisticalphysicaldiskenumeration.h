@@ -64,8 +64,12 @@ namespace SCXSystemLib
         SCXCoreLib::SCXHandle<SCXCoreLib::SCXThread> m_sampler;       //!< Data sampler.
         SCXCoreLib::SCXThreadLockHandle m_lock; //!< Handles locking in the disk enumeration.
         std::map<std::wstring,scxulong> m_pathToRdev; //!< Cache for path to rdev values.
+        unsigned int m_mntTabGeneration; //!< Mount tab generation the disks were last found with.
+        time_t m_devMTime;               //!< Modification time of /dev when the disks were last found.
+        unsigned int m_topologyGeneration; //!< Block device topology generation the disks were last found with.
 
         void FindPhysicalDisks();
+        bool MountsOrDevicesChanged();
         
         void UpdatePathToRdev(const std::wstring& dir);
         SCXCoreLib::SCXHandle<StatisticalPhysicalDiskInstance> AddDiskInstance(const std::wstring& name, const std::wstring& device);
@@ -0,0 +1,109 @@
+/*--------------------------------------------------------------------------------
+    Copyright (c) Microsoft Corporation.  All rights reserved.
+
+*/
+/**
+    \file
+
+    \brief       Timeout bounded statvfs() of a mount point
+
+    \date        2026-10-18 19:00:00
+
+    statvfs() on a mount point whose server (NFS, CIFS) does not answer may
+    block for minutes, or for ever on hard mounts. The call is therefore
+    made on a worker thread and the caller only waits a bounded time for it.
+
+*/
+/*----------------------------------------------------------------------------*/
+#ifndef STATVFSPROBE_H
+#define STATVFSPROBE_H
+
+#include <string>
+#include <time.h>
+
+#include <scxsystemlib/diskdepend.h>
+#include <scxcorelib/scxhandle.h>
+#include <scxcorelib/scxlog.h>
+#include <scxcorelib/scxthread.h>
+
+namespace SCXSystemLib
+{
+    /** Default time to wait for statvfs() in milliseconds. */
+    const unsigned int STATVFS_DEFAULT_TIMEOUT_MSEC = 2000;
+
+    /** Number of consecutive timeouts that puts a mount point in quarantine. */
+    const unsigned int STATVFS_QUARANTINE_TIMEOUTS = 3;
+
+    /** Length of the first quarantine in seconds, doubled for each following one. */
+    const unsigned int STATVFS_QUARANTINE_MIN_SECONDS = 300;
+
+    /** Upper bound on the length of a quarantine in seconds. */
+    const unsigned int STATVFS_QUARANTINE_MAX_SECONDS = 3600;
+
+    /** Outcome of StatVfsProbe::StatVfs(). */
+    enum StatVfsResult
+    {
+        eStatVfsOk = 0,     //!< A fresh value was read
+        eStatVfsStale,      //!< statvfs() did not answer in time; the last good value is returned
+        eStatVfsNoValue,    //!< statvfs() did not answer in time and has never answered
+        eStatVfsFailed      //!< statvfs() answered with an error
+    };
+
+    class StatVfsProbeThreadParam;
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Calls statvfs() for one mount point on a worker thread with a deadline.
+
+       Only network and FUSE file systems are called on a worker, see
+       MayBlock(); others are called directly. At most one call per mount point is outstanding. If a call has not
+       returned when the next one is due, no new worker is started and the
+       last good value is returned as stale, which counts as one more
+       timeout. A worker that never returns is left behind; it owns
+       everything it uses. After STATVFS_QUARANTINE_TIMEOUTS consecutive
+       timeouts the mount point is
+       quarantined: no calls are made until the quarantine has passed, and
+       each further quarantine is twice as long as the previous one. A call
+       that returns resets the count and the quarantine length.
+
+       Not thread safe; callers serialize, as the disk enumerations do with
+       their lock.
+    */
+    class StatVfsProbe
+    {
+    public:
+        StatVfsProbe(SCXCoreLib::SCXHandle<DiskDepend> deps, unsigned int timeoutMsec = STATVFS_DEFAULT_TIMEOUT_MSEC);
+        ~StatVfsProbe();
+
+        void SetTimeout(unsigned int timeoutMsec);
+        StatVfsResult StatVfs(const std::wstring& mountPoint, const std::wstring& fsType, SCXStatVfs& buf, int& err);
+        bool IsQuarantined() const;
+
+        static bool MayBlock(const std::wstring& fsType);
+
+    private:
+        bool Harvest(SCXStatVfs& buf, int& err, int& rc);
+        void Accept(const SCXStatVfs& buf);
+        void CountTimeout(const std::wstring& mountPoint);
+        StatVfsResult TimedOut(const std::wstring& mountPoint, SCXStatVfs& buf);
+
+        SCXCoreLib::SCXHandle<DiskDepend> m_deps;           //!< Dependencies, shared with the workers
+        SCXCoreLib::SCXLogHandle m_log;                     //!< Log handle
+        unsigned int m_timeoutMsec;                         //!< Time to wait for a worker
+
+        SCXCoreLib::SCXHandle<StatVfsProbeThreadParam> m_param; //!< Parameters of the outstanding worker, if any
+        SCXCoreLib::SCXHandle<SCXCoreLib::SCXThread> m_thread;  //!< Outstanding worker, if any
+
+        bool m_hasValue;                                    //!< m_value holds a good value
+        SCXStatVfs m_value;                                 //!< Latest good value
+        unsigned int m_timeouts;                            //!< Consecutive timeouts
+        unsigned int m_quarantineSeconds;                   //!< Length of the next quarantine
+        time_t m_quarantineEnd;                             //!< End of the current quarantine, 0 if none
+
+        StatVfsProbe(const StatVfsProbe&);                  //!< Intentionally not implemented
+        StatVfsProbe& operator=(const StatVfsProbe&);       //!< Intentionally not implemented
+    };
+}
+
+#endif /* STATVFSPROBE_H */
+/*----------------------------E-N-D---O-F---F-I-L-E---------------------------*/
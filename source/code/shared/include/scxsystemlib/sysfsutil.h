@@ -0,0 +1,45 @@
+/*--------------------------------------------------------------------------------
+    Copyright (c) Microsoft Corporation.  All rights reserved.
+
+*/
+/**
+    \file
+
+    \brief       Helpers for the small sysfs, procfs and cgroup files
+
+    \date        2026-10-18 16:00:00
+
+    Files like /sys/devices/system/node/online are read by more than one
+    PAL. They hold a few hundred bytes at most and are re-read every
+    sample, so they are read with one read() into a stack buffer rather
+    than through a stream.
+
+*/
+/*----------------------------------------------------------------------------*/
+#ifndef SYSFSUTIL_H
+#define SYSFSUTIL_H
+
+#include <scxcorelib/scxcmn.h>
+#include <string>
+#include <vector>
+
+namespace SCXSystemLib
+{
+    /** Largest sysfs file read into a string by SysFsUtil::ReadFile(). */
+    const size_t SYSFS_FILE_MAX_SIZE = 4096;
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Reads and parses the small files in sysfs, procfs and the cgroup file system.
+    */
+    class SysFsUtil
+    {
+    public:
+        static bool ReadFile(const std::string& path, std::string& content);
+        static size_t ReadFile(const char* path, char* buf, size_t size);
+        static bool ParseCpuList(const std::string& list, std::vector<unsigned int>& cpus);
+    };
+}
+
+#endif /* SYSFSUTIL_H */
+/*----------------------------E-N-D---O-F---F-I-L-E---------------------------*/
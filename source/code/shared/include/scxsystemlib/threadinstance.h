@@ -0,0 +1,90 @@
+/*----------------------------------------------------------------------------
+    Copyright (c) Microsoft Corporation.  All rights reserved.
+
+*/
+/**
+    \file
+
+    \brief       PAL representation of a thread of a Unix process
+
+    \date        2026-10-18 11:00:00
+
+    Threads are only sampled for processes selected with
+    ProcessEnumeration::SetThreadSampling(), and only on Linux where each
+    thread has its own /proc/#/task/#/stat file.
+
+*/
+/*----------------------------------------------------------------------------*/
+#ifndef THREADINSTANCE_H
+#define THREADINSTANCE_H
+
+#include <string>
+
+#include <scxsystemlib/entityinstance.h>
+#include <scxsystemlib/datasampler.h>
+#include <scxsystemlib/processinstance.h>
+#include <scxcorelib/scxlog.h>
+
+namespace SCXSystemLib
+{
+    /** Number of samples collected in the datasampler for threads.
+        Kept small since a sampled process may have thousands of threads. */
+    const int MAX_THREADINSTANCE_DATASAMPLER_SAMPLES = 3;
+
+    /** Datasampler for thread CPU time. */
+    typedef DataSampler<scxulong, MAX_THREADINSTANCE_DATASAMPLER_SAMPLES> ThreadULongDataSampler_t;
+    /** Datasampler for time stored as a struct timeval */
+    typedef DataSampler<struct timeval, MAX_THREADINSTANCE_DATASAMPLER_SAMPLES> ThreadTvDataSampler_t;
+
+    /*----------------------------------------------------------------------------*/
+    /**
+        Class that represents a thread of a sampled process.
+    */
+    class ThreadInstance : public EntityInstance
+    {
+        friend class ProcessEnumeration;
+
+    public:
+        virtual ~ThreadInstance();
+
+        bool GetPID(scxulong& pid) const;
+        bool GetTID(scxulong& tid) const;
+        bool GetProcessName(std::string& name) const;
+        bool GetName(std::string& name) const;
+        bool GetLastProcessor(unsigned int& cpu) const;
+        bool GetCPUTime(scxulong& cpu) const;
+        bool GetPercentUserTime(scxulong& put) const;
+        bool GetPercentPrivilegedTime(scxulong& ppt) const;
+
+    private:
+        ThreadInstance(scxpid_t pid, scxpid_t tid, const std::string& processName);
+
+        /** Tests if this instance was detected when scanning the threads. */
+        bool WasFound() { bool found = m_found; m_found = false; return found; }
+        bool UpdateInstance();
+        void UpdateDataSampler(struct timeval& realtime);
+        void UpdateTimedValues();
+
+        SCXCoreLib::SCXLogHandle m_log;         //!< Log handle.
+        scxpid_t m_pid;                         //!< Process ID of the owning process
+        scxpid_t m_tid;                         //!< Thread ID
+        std::string m_processName;              //!< Name of the owning process
+        bool m_found;                           //!< Found during iteration
+
+        scxulong m_percentUserTime;             //!< Computed by UpdateTimedValues()
+        scxulong m_percentPrivilegedTime;       //!< Computed by UpdateTimedValues()
+
+#if defined(linux)
+        char m_taskStatName[2 * PROCPATH_LEN];  //!< Name of /proc/#/task/#/stat file
+        LinuxProcStat m;                        //!< Thread information, same layout as for processes
+        unsigned int m_jiffies_per_second;      //!< Time base for PC Linux
+
+        ThreadTvDataSampler_t    m_RealTime_tics;   //!< Data sampler for real time.
+        ThreadULongDataSampler_t m_UserTime_tics;   //!< Data sampler for user time.
+        ThreadULongDataSampler_t m_SystemTime_tics; //!< Data sampler for system time.
+#endif
+    };
+}
+
+#endif /* THREADINSTANCE_H */
+/*----------------------------E-N-D---O-F---F-I-L-E---------------------------*/
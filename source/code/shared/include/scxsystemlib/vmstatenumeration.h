@@ -0,0 +1,88 @@
+/*----------------------------------------------------------------------------
+    Copyright (c) Microsoft Corporation.  All rights reserved.
+
+*/
+/**
+    \file
+
+    \brief       Enumeration of /proc/vmstat counters
+
+    \date        2026-10-18 17:00:00
+
+    The counters to sample are given as a list of names, where a name
+    ending in '*' matches every counter starting with the rest of it. The
+    names are resolved against /proc/vmstat once by Init(), so a counter
+    that the running kernel does not have is simply not reported.
+
+*/
+/*----------------------------------------------------------------------------*/
+#ifndef VMSTATENUMERATION_H
+#define VMSTATENUMERATION_H
+
+#include <string>
+#include <vector>
+
+#include <scxsystemlib/entityenumeration.h>
+#include <scxsystemlib/memoryinstance.h>
+#include <scxsystemlib/prockeytable.h>
+#include <scxsystemlib/vmstatinstance.h>
+#include <scxcorelib/scxlog.h>
+#include <scxcorelib/scxthread.h>
+#include <scxcorelib/scxthreadlock.h>
+
+namespace SCXSystemLib
+{
+    /** Default time between each sample in seconds. */
+    const unsigned int VMSTAT_DEFAULT_SECONDS_PER_SAMPLE = 10;
+
+    /** Largest number of counters sampled. */
+    const size_t VMSTAT_MAX_COUNTERS = 256;
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Class that represents the sampled counters of /proc/vmstat.
+
+       All counters are sampled with one read of /proc/vmstat per interval,
+       parsed through a key table into a fixed array. /proc/vmstat is read
+       through MemoryDependencies.
+    */
+    class VMStatEnumeration : public EntityEnumeration<VMStatInstance>
+    {
+    public:
+        explicit VMStatEnumeration(SCXCoreLib::SCXHandle<MemoryDependencies> deps = SCXCoreLib::SCXHandle<MemoryDependencies>(new MemoryDependencies()));
+        ~VMStatEnumeration();
+
+        void SetCounters(const std::vector<std::string>& names);
+        void SetSampleInterval(unsigned int seconds);
+        unsigned int GetSampleInterval() const;
+
+        virtual void Init();
+        virtual void Update(bool updateInstances=true);
+        virtual void CleanUp();
+        void SampleData();
+
+        static void GetDefaultCounters(std::vector<std::string>& names);
+        static bool IsMatch(const char* key, size_t len, const std::string& name);
+
+    private:
+        size_t ReadVMStat();
+
+        SCXCoreLib::SCXHandle<MemoryDependencies> m_deps; //!< Collects external dependencies of this class.
+        SCXCoreLib::SCXLogHandle m_log;         //!< Log handle.
+        SCXCoreLib::SCXThreadLockHandle m_lock; //!< Serializes sampling and updates.
+
+        std::vector<std::string> m_names;       //!< Counters to sample, possibly ending in '*'.
+        unsigned int m_secondsPerSample;        //!< Time between samples.
+
+        ProcKeyTable m_keys;                    //!< Maps counter names to instance index.
+        std::vector<char> m_buffer;             //!< Contents of /proc/vmstat, reused between samples.
+        scxulong m_values[VMSTAT_MAX_COUNTERS]; //!< Latest values, indexed like the instances.
+        bool m_found[VMSTAT_MAX_COUNTERS];      //!< Counters present in the latest sample.
+
+        SCXCoreLib::SCXHandle<SCXCoreLib::SCXThread> m_dataAquisitionThread; //!< Thread pointer.
+        static void DataAquisitionThreadBody(SCXCoreLib::SCXThreadParamHandle& param);
+    };
+}
+
+#endif /* VMSTATENUMERATION_H */
+/*----------------------------E-N-D---O-F---F-I-L-E---------------------------*/
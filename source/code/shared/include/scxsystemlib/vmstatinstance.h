@@ -0,0 +1,74 @@
+/*----------------------------------------------------------------------------
+    Copyright (c) Microsoft Corporation.  All rights reserved.
+
+*/
+/**
+    \file
+
+    \brief       PAL representation of a /proc/vmstat counter
+
+    \date        2026-10-18 17:00:00
+
+*/
+/*----------------------------------------------------------------------------*/
+#ifndef VMSTATINSTANCE_H
+#define VMSTATINSTANCE_H
+
+#include <string>
+
+#include <scxsystemlib/entityinstance.h>
+#include <scxsystemlib/datasampler.h>
+#include <scxcorelib/scxlog.h>
+
+namespace SCXSystemLib
+{
+    /** Number of samples collected in the datasampler for vmstat counters. */
+    const int MAX_VMSTATINSTANCE_DATASAMPLER_SAMPLES = 7;
+
+    /** Datasampler for vmstat counters. */
+    typedef DataSampler<scxulong, MAX_VMSTATINSTANCE_DATASAMPLER_SAMPLES> VMStatInstanceDataSampler;
+
+    /*----------------------------------------------------------------------------*/
+    /**
+        Class that represents one counter of /proc/vmstat, like pgmajfault
+        or allocstall_normal.
+
+        The counter is sampled by VMStatEnumeration, by default every ten
+        seconds, and turned into rates per second by Update(): one over the
+        latest interval and one averaged over all samples kept.
+    */
+    class VMStatInstance : public EntityInstance
+    {
+        friend class VMStatEnumeration;
+
+    public:
+        VMStatInstance(const std::string& key);
+        virtual ~VMStatInstance();
+
+        virtual void Update();
+
+        const std::string& GetKey() const;
+
+        bool GetValue(scxulong& value) const;
+        bool GetRatePerSecond(double& rate) const;
+        bool GetAverageRatePerSecond(double& rate) const;
+
+    private:
+        void AddSample(scxulong timeMsec, scxulong value);
+        double GetRate(size_t samples) const;
+
+        SCXCoreLib::SCXLogHandle m_log;             //!< Log handle
+        std::string m_key;                          //!< Name of the counter in /proc/vmstat
+
+        bool m_hasValue;                            //!< Computed by Update()
+        scxulong m_latestValue;                     //!< Computed by Update()
+        double m_rate;                              //!< Computed by Update()
+        double m_averageRate;                       //!< Computed by Update()
+
+        VMStatInstanceDataSampler m_time_msec;      //!< Monotonic time of each sample
+        VMStatInstanceDataSampler m_value;          //!< Value of the counter
+    };
+}
+
+#endif /* VMSTATINSTANCE_H */
+/*----------------------------E-N-D---O-F---F-I-L-E---------------------------*/
@@ -261,10 +261,10 @@ namespace SCXCoreLib
     SCXThread::~SCXThread()
     {
 #if defined(SCX_UNIX)
-        if (m_threadMaySurviveDestruction)
+        if (m_threadMaySurviveDestruction && 0 != m_threadID)
         {
-            // Detach current thread to reclaim thread resources automatically.
-            (void)pthread_detach(pthread_self());
+            // Detach the thread, not the caller, so its resources are reclaimed when it exits.
+            (void)pthread_detach(m_threadID);
         }
         else
         {
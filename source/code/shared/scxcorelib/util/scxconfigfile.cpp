@@ -0,0 +1,101 @@
+/*--------------------------------------------------------------------------------
+    Copyright (c) Microsoft Corporation.  All rights reserved.
+
+*/
+/**
+    \file
+
+    \brief       Implementation of the configuration file parser.
+
+    \date        2026-10-18 23:30:00
+
+*/
+/*----------------------------------------------------------------------------*/
+
+#include <scxcorelib/scxcmn.h>
+#include <scxcorelib/scxconfigfile.h>
+#include <scxcorelib/scxfile.h>
+#include <scxcorelib/scxlog.h>
+#include <scxcorelib/scxstream.h>
+#include <scxcorelib/stringaid.h>
+#include <vector>
+
+namespace SCXCoreLib
+{
+    /*----------------------------------------------------------------------------*/
+    /**
+       Parses a stream of the form
+
+       # Comment
+       key1 = value1
+       key2 = value2
+
+       \param[in] configuration Stream with configuration data. Typically as
+                  read from a configuration file.
+    */
+    void ConfigurationParser::ParseStream(std::wistream& configuration)
+    {
+        SCXLogHandle log = SCXLogHandleFactory::GetLogHandle(L"scx.core.common.configparser");
+
+        std::vector<std::wstring> lines;
+        SCXStream::NLFs nlfs;
+        SCXStream::ReadAllLines(configuration, lines, nlfs);
+        SCX_LOGTRACE(log, StrAppend(L"Number of lines in configuration: ", lines.size()));
+
+        for (std::vector<std::wstring>::const_iterator it = lines.begin();
+             it != lines.end(); it++)
+        {
+            std::wstring line = StrTrim(*it);
+            SCX_LOGTRACE(log, StrAppend(L"Parsing line: ", line));
+            if (line.length() == 0 ||
+                line.substr(0,1) == L"#") //comment
+            {
+                continue;
+            }
+            std::vector<std::wstring> parts;
+            StrTokenize(line, parts, L"=");
+            if (parts.size() == 2)
+            {
+                iterator iter = lower_bound(parts[0]);
+                if ((end() != iter) && !(key_comp()(parts[0], iter->first)))
+                {
+                    iter->second = parts[1];
+                }
+                else
+                {
+                    insert(iter, std::pair<const std::wstring, std::wstring>(parts[0], parts[1]));
+                }
+            }
+        }
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Constructor for the configuration file parser.
+    */
+    ConfigurationFileParser::ConfigurationFileParser(const SCXFilePath& file) :
+        m_file(file)
+    {
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Parses the configuration file. If the file does not exist this is ignored.
+    */
+    void ConfigurationFileParser::Parse()
+    {
+        SCXLogHandle log = SCXLogHandleFactory::GetLogHandle(L"scx.core.common.configparser");
+
+        try
+        {
+            ParseStream(*SCXFile::OpenWFstream(m_file, std::ios_base::in));
+        }
+        catch (SCXException& e)
+        {
+            SCX_LOGWARNING(log, StrAppend(L"Failed to read file: ", m_file.Get()));
+            SCX_LOGWARNING(log, StrAppend(L"Reason for failure: ", e.What()));
+        }
+    }
+}
+
+/*----------------------------E-N-D---O-F---F-I-L-E---------------------------*/
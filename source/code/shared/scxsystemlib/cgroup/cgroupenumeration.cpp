@@ -0,0 +1,888 @@
+/*----------------------------------------------------------------------------
+    Copyright (c) Microsoft Corporation.  All rights reserved.
+
+*/
+/**
+    \file
+
+    \brief       Enumeration of Linux control groups
+
+    \date        2026-10-18 10:00:00
+
+*/
+/*----------------------------------------------------------------------------*/
+
+#include <scxcorelib/scxcmn.h>
+#include <scxcorelib/scxexception.h>
+#include <scxcorelib/scxlog.h>
+#include <scxcorelib/scxcondition.h>
+#include <scxcorelib/stringaid.h>
+
+#include <scxsystemlib/cgroupenumeration.h>
+#include <scxsystemlib/cgroupinstance.h>
+
+#include <string>
+#include <vector>
+#include <set>
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(linux)
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <sys/types.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+using namespace SCXCoreLib;
+
+namespace
+{
+    /** Memory limits at or above this value mean "no limit" in cgroup v1. */
+    const scxulong CGROUP_V1_UNLIMITED = 0x4000000000000000ULL;
+
+    /** Control files are small; anything larger is truncated. */
+    const size_t CGROUP_MAX_FILE_SIZE = 64 * 1024;
+
+    /**
+       Skips to the start of the next line.
+
+       \param p Current position
+       \returns Position after the next newline, or at the terminating null
+    */
+    const char* NextLine(const char* p)
+    {
+        while (*p != '\0' && *p != '\n')
+        {
+            ++p;
+        }
+        return ('\n' == *p) ? p + 1 : p;
+    }
+}
+
+namespace SCXSystemLib
+{
+    /*----------------------------------------------------------------------------*/
+    /**
+       Gets the mount point of the cgroup file system.
+
+       \returns Path to the cgroup root without trailing slash
+    */
+    const std::string& CGroupPALDependencies::GetRoot() const
+    {
+        return m_root;
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Reads a cgroup control file.
+
+       \param[in]  path    Absolute path of the file
+       \param[out] content Contents of the file
+       \returns    false if the file could not be read
+    */
+    bool CGroupPALDependencies::ReadFile(const std::string& path, std::string& content) const
+    {
+        content.clear();
+#if defined(linux)
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            return false;
+        }
+
+        char buf[4096];
+        ssize_t r;
+        while ((r = read(fd, buf, sizeof(buf))) > 0 && content.size() < CGROUP_MAX_FILE_SIZE)
+        {
+            content.append(buf, static_cast<size_t>(r));
+        }
+        close(fd);
+        return r >= 0;
+#else
+        (void) path;
+        return false;
+#endif
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Lists the sub directories of a directory.
+
+       \param[in]  path  Absolute path of the directory
+       \param[out] names Names (not paths) of the sub directories
+       \returns    false if the directory could not be opened
+    */
+    bool CGroupPALDependencies::ListDirectories(const std::string& path, std::vector<std::string>& names) const
+    {
+        names.clear();
+#if defined(linux)
+        DIR* dir = opendir(path.c_str());
+        if (NULL == dir)
+        {
+            return false;
+        }
+
+        struct dirent* entry;
+        while ((entry = readdir(dir)) != NULL)
+        {
+            if ('.' == entry->d_name[0])
+            {
+                continue;
+            }
+
+            bool isDir = (DT_DIR == entry->d_type);
+            if (DT_UNKNOWN == entry->d_type)
+            {
+                struct stat st;
+                isDir = (0 == stat((path + "/" + entry->d_name).c_str(), &st) && S_ISDIR(st.st_mode));
+            }
+            if (isDir)
+            {
+                names.push_back(entry->d_name);
+            }
+        }
+        closedir(dir);
+        return true;
+#else
+        (void) path;
+        return false;
+#endif
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Checks if a file or directory exists.
+
+       \param[in] path Absolute path
+       \returns   true if the path exists
+    */
+    bool CGroupPALDependencies::Exists(const std::string& path) const
+    {
+#if defined(linux)
+        struct stat st;
+        return 0 == stat(path.c_str(), &st);
+#else
+        (void) path;
+        return false;
+#endif
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Gets the unit of cpuacct.stat.
+
+       \returns Number of clock ticks per second
+    */
+    long CGroupPALDependencies::GetClockTicks() const
+    {
+#if defined(linux)
+        long ticks = sysconf(_SC_CLK_TCK);
+        return (ticks > 0) ? ticks : 100;
+#else
+        return 100;
+#endif
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Gets the time that samples are stamped with.
+
+       The monotonic clock is used so that a step of the wall clock does
+       not distort the rates.
+
+       \returns Microseconds since an arbitrary fixed point
+    */
+    scxulong CGroupPALDependencies::GetTimeMicroseconds() const
+    {
+#if defined(linux)
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return static_cast<scxulong>(ts.tv_sec) * 1000000 + static_cast<scxulong>(ts.tv_nsec) / 1000;
+#else
+        return 0;
+#endif
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Class that represents values passed between the threads of the cgroup enumeration.
+    */
+    class CGroupEnumerationThreadParam : public SCXThreadParam
+    {
+    public:
+        /*----------------------------------------------------------------------------*/
+        /**
+           Constructor
+
+           \param[in] cgroupenum Pointer to cgroup enumeration associated with the thread.
+        */
+        CGroupEnumerationThreadParam(CGroupEnumeration* cgroupenum)
+            : SCXThreadParam(), m_cgroupenum(cgroupenum)
+        {}
+
+        /*----------------------------------------------------------------------------*/
+        /**
+           Retrieves the cgroup enumeration parameter.
+
+           \returns Pointer to cgroup enumeration associated with the thread.
+        */
+        CGroupEnumeration* GetCGroupEnumeration()
+        {
+            return m_cgroupenum;
+        }
+    private:
+        CGroupEnumeration* m_cgroupenum; //!< Pointer to cgroup enumeration associated with the thread.
+    };
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Default constructor
+
+       \param[in] deps     Dependencies for the cgroup enumeration.
+       \param[in] maxDepth Number of directory levels below the root to enumerate.
+    */
+    CGroupEnumeration::CGroupEnumeration(SCXCoreLib::SCXHandle<CGroupPALDependencies> deps,
+                                         unsigned int maxDepth) :
+        EntityEnumeration<CGroupInstance>(),
+        m_deps(deps),
+        m_lock(SCXCoreLib::ThreadLockHandleGet()),
+        m_maxDepth(maxDepth),
+        m_version(0),
+        m_dataAquisitionThread(NULL)
+    {
+        m_log = SCXLogHandleFactory::GetLogHandle(L"scx.core.common.pal.system.cgroup.cgroupenumeration");
+
+        SCX_LOGTRACE(m_log, L"CGroupEnumeration default constructor");
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Destructor
+    */
+    CGroupEnumeration::~CGroupEnumeration()
+    {
+        SCX_LOGTRACE(m_log, L"CGroupEnumeration destructor");
+        if (NULL != m_dataAquisitionThread)
+        {
+            if (m_dataAquisitionThread->IsAlive())
+            {
+                CleanUp();
+            }
+            m_dataAquisitionThread = NULL;
+        }
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Detects the cgroup layout and starts sampling.
+    */
+    void CGroupEnumeration::Init()
+    {
+        SCX_LOGTRACE(m_log, L"CGroupEnumeration Init()");
+
+        DetectVersion();
+
+        if (0 == m_version)
+        {
+            SCX_LOGINFO(m_log, StrFromMultibyte(m_deps->GetRoot()).append(L" is not a cgroup file system, no control groups will be reported"));
+            return;
+        }
+
+        if (NULL == m_dataAquisitionThread)
+        {
+            CGroupEnumerationThreadParam* params = new CGroupEnumerationThreadParam(this);
+            m_dataAquisitionThread = new SCXCoreLib::SCXThread(CGroupEnumeration::DataAquisitionThreadBody, params);
+        }
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Update all instances
+
+       \param updateInstances Compute rates from the latest samples
+
+       The set of instances is maintained by SampleData().
+    */
+    void CGroupEnumeration::Update(bool updateInstances)
+    {
+        SCXCoreLib::SCXThreadLock lock(m_lock);
+        UpdateNoLock(lock, updateInstances);
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Update all instances without taking the enumeration lock
+
+       \param lck             A previously taken lock that belongs to this PAL
+       \param updateInstances Compute rates from the latest samples
+
+       The sampling thread adds and removes instances, so a caller that
+       iterates over the instances must hold the lock from GetLockHandle()
+       for the duration and supply it here as "proof" that it was taken.
+    */
+    void CGroupEnumeration::UpdateNoLock(SCXCoreLib::SCXThreadLock&, bool updateInstances)
+    {
+        SCX_LOGTRACE(m_log, StrAppend(L"CGroupEnumeration Update() - ", updateInstances));
+
+        if (updateInstances)
+        {
+            UpdateInstances();
+        }
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Get the lock handle of the enumeration
+
+       \returns Handle to the lock protecting the instance list
+    */
+    const SCXCoreLib::SCXThreadLockHandle& CGroupEnumeration::GetLockHandle() const
+    {
+        return m_lock;
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Cleanup
+    */
+    void CGroupEnumeration::CleanUp()
+    {
+        SCX_LOGTRACE(m_log, L"CGroupEnumeration CleanUp()");
+        if (NULL != m_dataAquisitionThread)
+        {
+            m_dataAquisitionThread->RequestTerminate();
+            m_dataAquisitionThread->Wait();
+        }
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Gets the cgroup version in use.
+
+       \returns 2 for the unified hierarchy, 1 for legacy hierarchies, 0 if
+                no cgroup file system was found
+    */
+    unsigned int CGroupEnumeration::GetVersion() const
+    {
+        return m_version;
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Detects if the root holds a unified or legacy cgroup file system.
+
+       In the legacy layout each controller is a sub directory of the root.
+       Co-mounted controllers show up as "cpu,cpuacct" (with a symlink from
+       each controller name on most distributions).
+    */
+    void CGroupEnumeration::DetectVersion()
+    {
+        const string& root = m_deps->GetRoot();
+
+        m_version = 0;
+        m_cpuacctHierarchy.clear();
+        m_memoryHierarchy.clear();
+        m_blkioHierarchy.clear();
+        m_pidsHierarchy.clear();
+
+        if (m_deps->Exists(root + "/cgroup.controllers"))
+        {
+            m_version = 2;
+            SCX_LOGTRACE(m_log, L"CGroupEnumeration DetectVersion() - unified hierarchy");
+            return;
+        }
+
+        static const char* cpuacctNames[] = { "cpuacct", "cpu,cpuacct", "cpuacct,cpu" };
+        for (size_t i = 0; i < sizeof(cpuacctNames) / sizeof(cpuacctNames[0]); ++i)
+        {
+            if (m_deps->Exists(root + "/" + cpuacctNames[i] + "/cpuacct.usage"))
+            {
+                m_cpuacctHierarchy = root + "/" + cpuacctNames[i];
+                break;
+            }
+        }
+        if (m_deps->Exists(root + "/memory/memory.usage_in_bytes"))
+        {
+            m_memoryHierarchy = root + "/memory";
+        }
+        if (m_deps->Exists(root + "/blkio"))
+        {
+            m_blkioHierarchy = root + "/blkio";
+        }
+        if (m_deps->Exists(root + "/pids/pids.current"))
+        {
+            m_pidsHierarchy = root + "/pids";
+        }
+
+        if (!m_cpuacctHierarchy.empty() || !m_memoryHierarchy.empty() ||
+            !m_blkioHierarchy.empty() || !m_pidsHierarchy.empty())
+        {
+            m_version = 1;
+            SCX_LOGTRACE(m_log, L"CGroupEnumeration DetectVersion() - legacy hierarchies");
+        }
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Collects the control groups below a directory.
+
+       \param[in]  hierarchy Absolute path to the hierarchy root
+       \param[in]  path      Control group path relative to the hierarchy root
+       \param[in]  depth     Depth of path below the root
+       \param[out] paths     Control group paths found are added to this set
+    */
+    void CGroupEnumeration::Discover(const std::string& hierarchy, const std::string& path,
+                                     unsigned int depth, std::set<std::string>& paths) const
+    {
+        paths.insert(path);
+
+        if (depth >= m_maxDepth)
+        {
+            return;
+        }
+
+        vector<string> names;
+        m_deps->ListDirectories(hierarchy + ("/" == path ? string() : path), names);
+        for (vector<string>::const_iterator it = names.begin(); it != names.end(); ++it)
+        {
+            Discover(hierarchy, ("/" == path ? string() : path) + "/" + *it, depth + 1, paths);
+        }
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Builds the absolute path of a control file.
+
+       \param[in] hierarchy Absolute path to the hierarchy root
+       \param[in] path      Control group path relative to the hierarchy root
+       \param[in] file      Name of the control file
+       \returns   Absolute path of the file
+    */
+    std::string CGroupEnumeration::ControllerPath(const std::string& hierarchy, const std::string& path,
+                                                  const char* file) const
+    {
+        return hierarchy + ("/" == path ? string() : path) + "/" + file;
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Finds the instance of a control group, creating it if needed.
+
+       \param[in] path Control group path
+       \returns   The instance
+    */
+    SCXCoreLib::SCXHandle<CGroupInstance> CGroupEnumeration::FindOrAdd(const std::string& path)
+    {
+        SCXCoreLib::SCXHandle<CGroupInstance> inst = GetInstance(StrFromMultibyte(path));
+        if (NULL == inst)
+        {
+            SCX_LOGTRACE(m_log, wstring(L"CGroupEnumeration - Adding cgroup ").append(StrFromMultibyte(path)));
+            inst = new CGroupInstance(path);
+            AddInstance(inst);
+        }
+        return inst;
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Store new data for all instances
+    */
+    void CGroupEnumeration::SampleData()
+    {
+        SCX_LOGTRACE(m_log, L"CGroupEnumeration - Start SampleData");
+
+        SCXCoreLib::SCXThreadLock lock(m_lock);
+
+        if (0 == m_version)
+        {
+            return;
+        }
+
+        set<string> paths;
+        if (2 == m_version)
+        {
+            Discover(m_deps->GetRoot(), "/", 0, paths);
+        }
+        else
+        {
+            const string* hierarchies[] = { &m_cpuacctHierarchy, &m_memoryHierarchy, &m_blkioHierarchy, &m_pidsHierarchy };
+            for (size_t i = 0; i < sizeof(hierarchies) / sizeof(hierarchies[0]); ++i)
+            {
+                if (!hierarchies[i]->empty())
+                {
+                    Discover(*hierarchies[i], "/", 0, paths);
+                }
+            }
+        }
+
+        for (EntityIterator iter = Begin(); iter != End(); ++iter)
+        {
+            (*iter)->m_seen = false;
+        }
+
+        scxulong now = m_deps->GetTimeMicroseconds();
+        for (set<string>::const_iterator it = paths.begin(); it != paths.end(); ++it)
+        {
+            SCXCoreLib::SCXHandle<CGroupInstance> inst = FindOrAdd(*it);
+            inst->m_seen = true;
+            inst->m_time_usec.AddSample(now);
+
+            if (2 == m_version)
+            {
+                SampleV2(inst);
+            }
+            else
+            {
+                SampleV1(inst);
+            }
+        }
+
+        // Remove control groups that no longer exist
+        EntityIterator iter = Begin();
+        while (iter != End())
+        {
+            if (!(*iter)->m_seen)
+            {
+                SCX_LOGTRACE(m_log, wstring(L"CGroupEnumeration - Removing cgroup ").append((*iter)->GetId()));
+                RemoveInstance(iter);
+                iter = Begin();
+            }
+            else
+            {
+                ++iter;
+            }
+        }
+
+        SCX_LOGTRACE(m_log, L"CGroupEnumeration - End SampleData");
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Samples a control group in the unified hierarchy.
+
+       \param inst Instance to update
+    */
+    void CGroupEnumeration::SampleV2(SCXCoreLib::SCXHandle<CGroupInstance> inst)
+    {
+        const string& root = m_deps->GetRoot();
+        const string& path = inst->GetPath();
+        string content;
+        scxulong value = 0;
+
+        inst->m_hasCPU = inst->m_hasCPUSplit = false;
+        if (m_deps->ReadFile(ControllerPath(root, path, "cpu.stat"), content))
+        {
+            scxulong user = 0, system = 0;
+            if (ParseKeyValue(content, "usage_usec", value))
+            {
+                CGroupInstance::AddCounterSample(inst->m_usage_usec, value);
+                inst->m_hasCPU = true;
+            }
+            if (ParseKeyValue(content, "user_usec", user) && ParseKeyValue(content, "system_usec", system))
+            {
+                CGroupInstance::AddCounterSample(inst->m_user_usec, user);
+                CGroupInstance::AddCounterSample(inst->m_system_usec, system);
+                inst->m_hasCPUSplit = true;
+            }
+        }
+
+        inst->m_hasMemory = m_deps->ReadFile(ControllerPath(root, path, "memory.current"), content) &&
+                            ParseValue(content, inst->m_usedMemory);
+
+        // "max" does not parse as a number and means no limit
+        inst->m_hasMemoryLimit = m_deps->ReadFile(ControllerPath(root, path, "memory.max"), content) &&
+                                 ParseValue(content, inst->m_memoryLimit);
+
+        inst->m_hasIO = false;
+        if (m_deps->ReadFile(ControllerPath(root, path, "io.stat"), content))
+        {
+            scxulong rbytes = 0, wbytes = 0, rios = 0, wios = 0;
+            ParseIOStat(content, rbytes, wbytes, rios, wios);
+            CGroupInstance::AddCounterSample(inst->m_readBytes, rbytes);
+            CGroupInstance::AddCounterSample(inst->m_writeBytes, wbytes);
+            CGroupInstance::AddCounterSample(inst->m_readOps, rios);
+            CGroupInstance::AddCounterSample(inst->m_writeOps, wios);
+            inst->m_hasIO = true;
+        }
+
+        inst->m_hasPids = m_deps->ReadFile(ControllerPath(root, path, "pids.current"), content) &&
+                          ParseValue(content, inst->m_pids);
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Samples a control group in the legacy hierarchies.
+
+       \param inst Instance to update
+
+       A control group path need not exist in every hierarchy; values from
+       hierarchies where it is missing are reported as not supported.
+    */
+    void CGroupEnumeration::SampleV1(SCXCoreLib::SCXHandle<CGroupInstance> inst)
+    {
+        const string& path = inst->GetPath();
+        string content;
+        scxulong value = 0;
+
+        inst->m_hasCPU = inst->m_hasCPUSplit = false;
+        if (!m_cpuacctHierarchy.empty())
+        {
+            if (m_deps->ReadFile(ControllerPath(m_cpuacctHierarchy, path, "cpuacct.usage"), content) &&
+                ParseValue(content, value))
+            {
+                CGroupInstance::AddCounterSample(inst->m_usage_usec, value / 1000);
+                inst->m_hasCPU = true;
+            }
+
+            scxulong user = 0, system = 0;
+            if (m_deps->ReadFile(ControllerPath(m_cpuacctHierarchy, path, "cpuacct.stat"), content) &&
+                ParseKeyValue(content, "user", user) && ParseKeyValue(content, "system", system))
+            {
+                scxulong ticks = static_cast<scxulong>(m_deps->GetClockTicks());
+                CGroupInstance::AddCounterSample(inst->m_user_usec, user * 1000000 / ticks);
+                CGroupInstance::AddCounterSample(inst->m_system_usec, system * 1000000 / ticks);
+                inst->m_hasCPUSplit = true;
+            }
+        }
+
+        inst->m_hasMemory = inst->m_hasMemoryLimit = false;
+        if (!m_memoryHierarchy.empty())
+        {
+            inst->m_hasMemory = m_deps->ReadFile(ControllerPath(m_memoryHierarchy, path, "memory.usage_in_bytes"), content) &&
+                                ParseValue(content, inst->m_usedMemory);
+            inst->m_hasMemoryLimit = m_deps->ReadFile(ControllerPath(m_memoryHierarchy, path, "memory.limit_in_bytes"), content) &&
+                                     ParseValue(content, inst->m_memoryLimit) &&
+                                     inst->m_memoryLimit < CGROUP_V1_UNLIMITED;
+        }
+
+        inst->m_hasIO = false;
+        if (!m_blkioHierarchy.empty())
+        {
+            scxulong rbytes = 0, wbytes = 0, rios = 0, wios = 0;
+            if (m_deps->ReadFile(ControllerPath(m_blkioHierarchy, path, "blkio.throttle.io_service_bytes"), content) &&
+                ParseBlkio(content, rbytes, wbytes) &&
+                m_deps->ReadFile(ControllerPath(m_blkioHierarchy, path, "blkio.throttle.io_serviced"), content) &&
+                ParseBlkio(content, rios, wios))
+            {
+                CGroupInstance::AddCounterSample(inst->m_readBytes, rbytes);
+                CGroupInstance::AddCounterSample(inst->m_writeBytes, wbytes);
+                CGroupInstance::AddCounterSample(inst->m_readOps, rios);
+                CGroupInstance::AddCounterSample(inst->m_writeOps, wios);
+                inst->m_hasIO = true;
+            }
+        }
+
+        inst->m_hasPids = false;
+        if (!m_pidsHierarchy.empty())
+        {
+            inst->m_hasPids = m_deps->ReadFile(ControllerPath(m_pidsHierarchy, path, "pids.current"), content) &&
+                              ParseValue(content, inst->m_pids);
+        }
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Parses a control file holding a single number.
+
+       \param[in]  content File contents
+       \param[out] value   Parsed value
+       \returns    false if the file does not start with a number (e.g. "max")
+    */
+    bool CGroupEnumeration::ParseValue(const std::string& content, scxulong& value)
+    {
+        const char* p = content.c_str();
+        char* end = NULL;
+
+        while (' ' == *p || '\t' == *p)
+        {
+            ++p;
+        }
+        if (*p < '0' || *p > '9')
+        {
+            return false;
+        }
+
+        value = strtoull(p, &end, 10);
+        return end != p;
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Parses one row of a flat keyed file such as cpu.stat or cpuacct.stat.
+
+       \param[in]  content File contents with "<key> <value>" rows
+       \param[in]  key     Key to look for
+       \param[out] value   Parsed value
+       \returns    false if the key is not present
+    */
+    bool CGroupEnumeration::ParseKeyValue(const std::string& content, const char* key, scxulong& value)
+    {
+        size_t keylen = strlen(key);
+
+        for (const char* p = content.c_str(); *p != '\0'; p = NextLine(p))
+        {
+            if (0 == strncmp(p, key, keylen) && ' ' == p[keylen])
+            {
+                return ParseValue(string(p + keylen + 1, NextLine(p + keylen)), value);
+            }
+        }
+        return false;
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Parses the unified hierarchy io.stat file, summing over all devices.
+
+       \param[in]  content File contents, one row per device:
+                           "8:0 rbytes=1 wbytes=2 rios=3 wios=4 dbytes=0 dios=0"
+       \param[out] rbytes  Bytes read
+       \param[out] wbytes  Bytes written
+       \param[out] rios    Read operations
+       \param[out] wios    Write operations
+       \returns    true (an empty file means no I/O has been done)
+    */
+    bool CGroupEnumeration::ParseIOStat(const std::string& content,
+                                        scxulong& rbytes, scxulong& wbytes, scxulong& rios, scxulong& wios)
+    {
+        rbytes = wbytes = rios = wios = 0;
+
+        const char* p = content.c_str();
+        while (*p != '\0')
+        {
+            // Find the start of the next "key=value" token
+            while (*p != '\0' && (' ' == *p || '\n' == *p))
+            {
+                ++p;
+            }
+            const char* key = p;
+            while (*p != '\0' && *p != ' ' && *p != '\n' && *p != '=')
+            {
+                ++p;
+            }
+            if ('=' != *p)
+            {
+                continue;
+            }
+
+            size_t keylen = static_cast<size_t>(p - key);
+            char* end = NULL;
+            scxulong value = strtoull(p + 1, &end, 10);
+            p = end;
+
+            if (6 == keylen && 0 == strncmp(key, "rbytes", keylen))      { rbytes += value; }
+            else if (6 == keylen && 0 == strncmp(key, "wbytes", keylen)) { wbytes += value; }
+            else if (4 == keylen && 0 == strncmp(key, "rios", keylen))   { rios += value; }
+            else if (4 == keylen && 0 == strncmp(key, "wios", keylen))   { wios += value; }
+        }
+        return true;
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Parses a legacy blkio file, summing reads and writes over all devices.
+
+       \param[in]  content File contents with "8:0 Read 123" rows and a
+                           trailing "Total 456" row
+       \param[out] read    Sum of the Read rows
+       \param[out] write   Sum of the Write rows
+       \returns    true (an empty file means no I/O has been done)
+    */
+    bool CGroupEnumeration::ParseBlkio(const std::string& content, scxulong& read, scxulong& write)
+    {
+        read = write = 0;
+
+        for (const char* p = content.c_str(); *p != '\0'; p = NextLine(p))
+        {
+            const char* op = strchr(p, ' ');
+            const char* eol = NextLine(p);
+            if (NULL == op || op >= eol)
+            {
+                continue;
+            }
+            ++op;
+
+            if (0 == strncmp(op, "Read ", 5))
+            {
+                read += strtoull(op + 5, NULL, 10);
+            }
+            else if (0 == strncmp(op, "Write ", 6))
+            {
+                write += strtoull(op + 6, NULL, 10);
+            }
+        }
+        return true;
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Thread body that updates all values
+
+       \param  param Must contain a parameter of type CGroupEnumerationThreadParam*
+
+       The thread stores new values in all instances once every CGROUP_SECONDS_PER_SAMPLE seconds.
+    */
+    void CGroupEnumeration::DataAquisitionThreadBody(SCXCoreLib::SCXThreadParamHandle& param)
+    {
+        SCXLogHandle log = SCXLogHandleFactory::GetLogHandle(L"scx.core.common.pal.system.cgroup.cgroupenumeration");
+        SCX_LOGTRACE(log, L"CGroupEnumeration::DataAquisitionThreadBody()");
+
+        if (0 == param)
+        {
+            SCXASSERT( ! "No parameters to DataAquisitionThreadBody");
+            return;
+        }
+
+        CGroupEnumerationThreadParam* params = static_cast<CGroupEnumerationThreadParam*>(param.GetData());
+        if (0 == params)
+        {
+            SCXASSERT( ! "Invalid parameters to DataAquisitionThreadBody");
+            return;
+        }
+
+        CGroupEnumeration* cgroupenum = params->GetCGroupEnumeration();
+        if (0 == cgroupenum)
+        {
+            SCXASSERT( ! "CGroup Enumeration not set");
+            return;
+        }
+
+        bool bUpdate = true;
+        params->m_cond.SetSleep(CGROUP_SECONDS_PER_SAMPLE * 1000);
+        {
+            SCXConditionHandle h(params->m_cond);
+
+            while ( ! params->GetTerminateFlag())
+            {
+                if (bUpdate)
+                {
+                    try
+                    {
+                        cgroupenum->SampleData();
+                    }
+                    catch (const SCXException& e)
+                    {
+                        SCX_LOGWARNING(log, std::wstring(L"CGroupEnumeration DataAquisition - ").append(e.What()).append(L" - ").append(e.Where()));
+                    }
+                    bUpdate = false;
+                }
+
+                SCX_LOGHYSTERICAL(log, L"CGroupEnumeration DataAquisition - Sleep ");
+                enum SCXCondition::eConditionResult r = h.Wait();
+                if (SCXCondition::eCondTimeout == r)
+                {
+                    bUpdate = true;
+                }
+            }
+        }
+
+        SCX_LOGHYSTERICAL(log, L"CGroupEnumeration DataAquisition - Ending ");
+    }
+}
+
+/*----------------------------E-N-D---O-F---F-I-L-E---------------------------*/
@@ -0,0 +1,267 @@
+/*----------------------------------------------------------------------------
+    Copyright (c) Microsoft Corporation.  All rights reserved.
+
+*/
+/**
+    \file
+
+    \brief       PAL representation of a Linux control group
+
+    \date        2026-10-18 10:00:00
+
+*/
+/*----------------------------------------------------------------------------*/
+
+#include <scxcorelib/scxcmn.h>
+#include <scxcorelib/stringaid.h>
+
+#include <scxsystemlib/cgroupinstance.h>
+
+using namespace std;
+using namespace SCXCoreLib;
+
+namespace SCXSystemLib
+{
+    /*----------------------------------------------------------------------------*/
+    /**
+        Constructor
+
+        \param path Path of the control group relative to the cgroup root
+
+        The root control group ("/") is flagged as the total instance since it
+        accounts for everything on the host.
+    */
+    CGroupInstance::CGroupInstance(const std::string& path) :
+        EntityInstance(path == "/"),
+        m_path(path),
+        m_seen(false),
+        m_hasCPU(false),
+        m_hasCPUSplit(false),
+        m_hasMemory(false),
+        m_hasMemoryLimit(false),
+        m_hasIO(false),
+        m_hasPids(false),
+        m_usedMemory(0),
+        m_memoryLimit(0),
+        m_pids(0),
+        m_percentProcessorTime(0),
+        m_percentUserTime(0),
+        m_percentPrivilegedTime(0),
+        m_readBytesPerSecond(0),
+        m_writeBytesPerSecond(0),
+        m_readOpsPerSecond(0),
+        m_writeOpsPerSecond(0)
+    {
+        m_log = SCXLogHandleFactory::GetLogHandle(L"scx.core.common.pal.system.cgroup.cgroupinstance");
+
+        SetId(StrFromMultibyte(path));
+
+        SCX_LOGTRACE(m_log, wstring(L"CGroupInstance constructor - ").append(GetId()));
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+        Destructor
+    */
+    CGroupInstance::~CGroupInstance()
+    {
+        SCX_LOGTRACE(m_log, wstring(L"CGroupInstance destructor - ").append(GetId()));
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+        Adds a sample of a monotonic counter.
+
+        \param sampler Sampler to add to
+        \param value   Latest counter value
+
+        A counter that goes backwards means that the control group was removed
+        and recreated with the same path between two samples. The history is
+        then discarded so that no bogus rate is computed.
+    */
+    void CGroupInstance::AddCounterSample(CGroupInstanceDataSampler& sampler, scxulong value)
+    {
+        if (sampler.GetNumberOfSamples() > 0 && value < sampler[0])
+        {
+            sampler.Clear();
+        }
+        sampler.AddSample(value);
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+        Computes the rate of change of a counter over the sampled window.
+
+        \param sampler Counter sampler
+        \param factor  Multiplier applied to the counter delta
+        \returns       factor * counter delta per second
+    */
+    scxulong CGroupInstance::GetRate(const CGroupInstanceDataSampler& sampler, scxulong factor) const
+    {
+        size_t samples = sampler.GetNumberOfSamples();
+        if (samples > m_time_usec.GetNumberOfSamples())
+        {
+            samples = m_time_usec.GetNumberOfSamples();
+        }
+
+        scxulong elapsed = m_time_usec.GetDelta(samples);
+        if (0 == elapsed)
+        {
+            return 0;
+        }
+
+        return sampler.GetDelta(samples) * factor / elapsed;
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+        Computes rates from the sampled counters.
+    */
+    void CGroupInstance::Update()
+    {
+        SCX_LOGHYSTERICAL(m_log, wstring(L"CGroupInstance Update() - ").append(GetId()));
+
+        // CPU times are in microseconds, as are the sample times
+        m_percentProcessorTime = GetRate(m_usage_usec, 100);
+        m_percentUserTime = GetRate(m_user_usec, 100);
+        m_percentPrivilegedTime = GetRate(m_system_usec, 100);
+
+        m_readBytesPerSecond = GetRate(m_readBytes, 1000000);
+        m_writeBytesPerSecond = GetRate(m_writeBytes, 1000000);
+        m_readOpsPerSecond = GetRate(m_readOps, 1000000);
+        m_writeOpsPerSecond = GetRate(m_writeOps, 1000000);
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+        Get the path of the control group
+
+        \returns     Path relative to the cgroup root, "/" for the root group
+    */
+    const std::string& CGroupInstance::GetPath() const
+    {
+        return m_path;
+    }
+
+    /**
+       Get the percentage of a CPU consumed by the group
+
+       \param[out]  percent Return parameter, may exceed 100 on multi-CPU hosts
+       \returns     true if a value is supported for this group
+    */
+    bool CGroupInstance::GetPercentProcessorTime(scxulong& percent) const
+    {
+        percent = m_percentProcessorTime;
+        return m_hasCPU;
+    }
+
+    /**
+       Get the percentage of a CPU consumed by the group in user mode
+
+       \param[out]  percent Return parameter
+       \returns     true if a value is supported for this group
+    */
+    bool CGroupInstance::GetPercentUserTime(scxulong& percent) const
+    {
+        percent = m_percentUserTime;
+        return m_hasCPUSplit;
+    }
+
+    /**
+       Get the percentage of a CPU consumed by the group in kernel mode
+
+       \param[out]  percent Return parameter
+       \returns     true if a value is supported for this group
+    */
+    bool CGroupInstance::GetPercentPrivilegedTime(scxulong& percent) const
+    {
+        percent = m_percentPrivilegedTime;
+        return m_hasCPUSplit;
+    }
+
+    /**
+       Get the memory charged to the group
+
+       \param[out]  bytes Return parameter
+       \returns     true if a value is supported for this group
+    */
+    bool CGroupInstance::GetUsedMemory(scxulong& bytes) const
+    {
+        bytes = m_usedMemory;
+        return m_hasMemory;
+    }
+
+    /**
+       Get the memory limit of the group
+
+       \param[out]  bytes Return parameter
+       \returns     true if the group has a memory limit
+    */
+    bool CGroupInstance::GetMemoryLimit(scxulong& bytes) const
+    {
+        bytes = m_memoryLimit;
+        return m_hasMemoryLimit;
+    }
+
+    /**
+       Get the number of tasks in the group
+
+       \param[out]  count Return parameter
+       \returns     true if a value is supported for this group
+    */
+    bool CGroupInstance::GetProcessCount(scxulong& count) const
+    {
+        count = m_pids;
+        return m_hasPids;
+    }
+
+    /**
+       Get the number of bytes read from block devices per second
+
+       \param[out]  bps Return parameter
+       \returns     true if a value is supported for this group
+    */
+    bool CGroupInstance::GetReadBytesPerSecond(scxulong& bps) const
+    {
+        bps = m_readBytesPerSecond;
+        return m_hasIO;
+    }
+
+    /**
+       Get the number of bytes written to block devices per second
+
+       \param[out]  bps Return parameter
+       \returns     true if a value is supported for this group
+    */
+    bool CGroupInstance::GetWriteBytesPerSecond(scxulong& bps) const
+    {
+        bps = m_writeBytesPerSecond;
+        return m_hasIO;
+    }
+
+    /**
+       Get the number of read operations on block devices per second
+
+       \param[out]  ops Return parameter
+       \returns     true if a value is supported for this group
+    */
+    bool CGroupInstance::GetReadOperationsPerSecond(scxulong& ops) const
+    {
+        ops = m_readOpsPerSecond;
+        return m_hasIO;
+    }
+
+    /**
+       Get the number of write operations on block devices per second
+
+       \param[out]  ops Return parameter
+       \returns     true if a value is supported for this group
+    */
+    bool CGroupInstance::GetWriteOperationsPerSecond(scxulong& ops) const
+    {
+        ops = m_writeOpsPerSecond;
+        return m_hasIO;
+    }
+}
+
+/*----------------------------E-N-D---O-F---F-I-L-E---------------------------*/
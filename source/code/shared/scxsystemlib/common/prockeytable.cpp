@@ -0,0 +1,279 @@
+/*--------------------------------------------------------------------------------
+    Copyright (c) Microsoft Corporation.  All rights reserved.
+
+*/
+/**
+    \file
+
+    \brief       Key lookup table for /proc files made up of "key value" lines
+
+    \date        2026-10-18 16:00:00
+
+*/
+/*----------------------------------------------------------------------------*/
+
+#include <scxcorelib/scxcmn.h>
+#include <scxsystemlib/prockeytable.h>
+
+#include <string.h>
+
+namespace
+{
+    /** Smallest table created. */
+    const size_t PROC_KEY_TABLE_MIN_SIZE = 16;
+
+    /** Number of seeds tried for each table size before giving up on a perfect hash. */
+    const unsigned int PROC_KEY_TABLE_SEED_TRIES = 64;
+}
+
+namespace SCXSystemLib
+{
+    const size_t ProcKeyTable::npos = static_cast<size_t>(-1);
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Constructor. Creates an empty table.
+    */
+    ProcKeyTable::ProcKeyTable() : m_seed(0), m_perfect(true)
+    {
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Adds a key to the table.
+
+       \param[in] key   Key as it appears in the file, without a trailing colon
+       \param[in] index Index of the value the key maps to in Parse()
+       \returns   false if the key is empty or already in the table
+
+       The table is rehashed on every call, so all keys should be added
+       before the table is used for parsing.
+    */
+    bool ProcKeyTable::Add(const std::string& key, size_t index)
+    {
+        if (key.empty() || npos != Find(key.data(), key.size()))
+        {
+            return false;
+        }
+
+        Slot slot;
+        slot.key = key;
+        slot.index = index;
+        m_keys.push_back(slot);
+
+        // Keep the table at most a quarter full, which makes a perfect seed easy to find
+        size_t size = PROC_KEY_TABLE_MIN_SIZE;
+        while (size < 4 * m_keys.size())
+        {
+            size *= 2;
+        }
+
+        for (size_t tableSize = size; tableSize <= 2 * size; tableSize *= 2)
+        {
+            for (unsigned int seed = 0; seed < PROC_KEY_TABLE_SEED_TRIES; seed++)
+            {
+                if (Rebuild(tableSize, seed))
+                {
+                    return true;
+                }
+            }
+        }
+
+        // Extremely unlikely, but still correct with probing
+        Rebuild(2 * size, 0);
+        return true;
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Removes all keys from the table.
+    */
+    void ProcKeyTable::Clear()
+    {
+        m_slots.clear();
+        m_keys.clear();
+        m_seed = 0;
+        m_perfect = true;
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Gets the number of keys in the table.
+
+       \returns Number of keys
+    */
+    size_t ProcKeyTable::Size() const
+    {
+        return m_keys.size();
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Tests if every key has a slot of its own.
+
+       \returns true if lookups never need to probe
+    */
+    bool ProcKeyTable::IsPerfect() const
+    {
+        return m_perfect;
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Looks up a key.
+
+       \param[in] key Start of the key, need not be null terminated
+       \param[in] len Length of the key
+       \returns   Index the key maps to, or npos if not in the table
+    */
+    size_t ProcKeyTable::Find(const char* key, size_t len) const
+    {
+        if (m_slots.empty())
+        {
+            return npos;
+        }
+
+        size_t mask = m_slots.size() - 1;
+        size_t pos = Hash(key, len, m_seed) & mask;
+        while (!m_slots[pos].key.empty())
+        {
+            const Slot& slot = m_slots[pos];
+            if (slot.key.size() == len && 0 == memcmp(slot.key.data(), key, len))
+            {
+                return slot.index;
+            }
+            if (m_perfect)
+            {
+                // The only key that hashes here is another one
+                break;
+            }
+            pos = (pos + 1) & mask;
+        }
+        return npos;
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Parses the lines of a /proc key/value file.
+
+       \param[in]  p      Start of the file contents
+       \param[in]  end    End of the file contents
+       \param[out] values Values of the keys found, indexed by the index given to Add()
+       \param[out] found  Set to true for every index a value was stored for
+       \param[in]  skipWords Number of words in front of the key on each line
+       \returns    Number of keys found
+
+       Lines are "key value" (vmstat) or "key: value kB" (meminfo). The per
+       NUMA node meminfo files prefix each line with "Node N ", which is
+       skipped by passing skipWords = 2. Lines whose key is not in the table
+       are skipped after a single lookup, and parsing stops as soon as all
+       keys have been found. The caller clears found before the call; values
+       are only written for found keys. No memory is allocated.
+    */
+    size_t ProcKeyTable::Parse(const char* p, const char* end, scxulong* values, bool* found, size_t skipWords /* = 0 */) const
+    {
+        size_t count = 0;
+        size_t total = m_keys.size();
+
+        while (p < end && count < total)
+        {
+            const char* eol = static_cast<const char*>(memchr(p, '\n', end - p));
+            if (NULL == eol)
+            {
+                eol = end;
+            }
+
+            for (size_t word = 0; word < skipWords; word++)
+            {
+                while (p < eol && ' ' != *p && '\t' != *p)
+                {
+                    ++p;
+                }
+                while (p < eol && (' ' == *p || '\t' == *p))
+                {
+                    ++p;
+                }
+            }
+
+            const char* keyEnd = p;
+            while (keyEnd < eol && ':' != *keyEnd && ' ' != *keyEnd && '\t' != *keyEnd)
+            {
+                ++keyEnd;
+            }
+
+            size_t index = Find(p, static_cast<size_t>(keyEnd - p));
+            if (npos != index && !found[index])
+            {
+                const char* q = keyEnd;
+                while (q < eol && (':' == *q || ' ' == *q || '\t' == *q))
+                {
+                    ++q;
+                }
+                if (q < eol && *q >= '0' && *q <= '9')
+                {
+                    scxulong value = 0;
+                    for ( ; q < eol && *q >= '0' && *q <= '9'; ++q)
+                    {
+                        value = value * 10 + static_cast<scxulong>(*q - '0');
+                    }
+                    values[index] = value;
+                    found[index] = true;
+                    count++;
+                }
+            }
+
+            p = eol + 1;
+        }
+        return count;
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Hash function, FNV-1a with a seed mixed into the offset basis.
+
+       \param[in] key  Start of the key
+       \param[in] len  Length of the key
+       \param[in] seed Seed
+       \returns   Hash value
+    */
+    unsigned int ProcKeyTable::Hash(const char* key, size_t len, unsigned int seed)
+    {
+        unsigned int h = 2166136261u ^ (seed * 0x9e3779b9u);
+        for (size_t i = 0; i < len; i++)
+        {
+            h ^= static_cast<unsigned char>(key[i]);
+            h *= 16777619u;
+        }
+        return h;
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Rebuilds the table with a given size and seed.
+
+       \param[in] size Number of slots, a power of two larger than the number of keys
+       \param[in] seed Seed of the hash function
+       \returns   true if the result is a perfect hash
+    */
+    bool ProcKeyTable::Rebuild(size_t size, unsigned int seed)
+    {
+        m_slots.assign(size, Slot());
+        m_seed = seed;
+        m_perfect = true;
+
+        size_t mask = size - 1;
+        for (size_t i = 0; i < m_keys.size(); i++)
+        {
+            size_t pos = Hash(m_keys[i].key.data(), m_keys[i].key.size(), seed) & mask;
+            while (!m_slots[pos].key.empty())
+            {
+                m_perfect = false;
+                pos = (pos + 1) & mask;
+            }
+            m_slots[pos] = m_keys[i];
+        }
+        return m_perfect;
+    }
+}
+
+/*----------------------------E-N-D---O-F---F-I-L-E---------------------------*/
@@ -0,0 +1,159 @@
+/*--------------------------------------------------------------------------------
+    Copyright (c) Microsoft Corporation.  All rights reserved.
+
+*/
+/**
+    \file
+
+    \brief       Helpers for the small sysfs, procfs and cgroup files
+
+    \date        2026-10-18 16:00:00
+
+*/
+/*----------------------------------------------------------------------------*/
+
+#include <scxcorelib/scxcmn.h>
+#include <scxsystemlib/sysfsutil.h>
+
+#include <algorithm>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace SCXSystemLib
+{
+    /*----------------------------------------------------------------------------*/
+    /**
+       Reads a small sysfs, procfs or cgroup file into a string.
+
+       \param[in]  path    Absolute path of the file
+       \param[out] content Contents of the file, at most SYSFS_FILE_MAX_SIZE bytes
+       \returns    false if the file could not be read
+
+       The content string is assigned rather than reallocated, so a caller
+       that passes the same string every time does not allocate memory once
+       the string has grown to fit.
+    */
+    bool SysFsUtil::ReadFile(const std::string& path, std::string& content)
+    {
+        char buf[SYSFS_FILE_MAX_SIZE];
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            return false;
+        }
+
+        ssize_t n;
+        do
+        {
+            n = read(fd, buf, sizeof(buf));
+        } while (n < 0 && EINTR == errno);
+        close(fd);
+        if (n < 0)
+        {
+            return false;
+        }
+        content.assign(buf, static_cast<size_t>(n));
+        return true;
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Reads a small sysfs, procfs or cgroup file into a caller supplied buffer.
+
+       \param[in]  path  Absolute path of the file
+       \param[out] buf   Buffer to read into
+       \param[in]  size  Size of buffer
+       \returns    Number of bytes read, zero if the file could not be read
+
+       The path is taken as a C string so that a caller formatting it into
+       a stack buffer does not allocate.
+    */
+    size_t SysFsUtil::ReadFile(const char* path, char* buf, size_t size)
+    {
+        int fd = open(path, O_RDONLY);
+        if (fd < 0)
+        {
+            return 0;
+        }
+
+        ssize_t n;
+        do
+        {
+            n = read(fd, buf, size);
+        } while (n < 0 && EINTR == errno);
+        close(fd);
+        return n < 0 ? 0 : static_cast<size_t>(n);
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Parses a cpu list as used by sysfs and cpusets, e.g. "0-3,8,10-11".
+
+       \param[in]  list Text to parse, trailing newline allowed
+       \param[out] cpus Processor numbers, sorted and without duplicates
+       \returns    false if the list is malformed
+
+       An empty list is valid and results in no processors. The same format
+       is used for lists of NUMA nodes.
+    */
+    bool SysFsUtil::ParseCpuList(const std::string& list, std::vector<unsigned int>& cpus)
+    {
+        cpus.clear();
+
+        const char* p = list.c_str();
+        while (*p != '\0' && *p != '\n')
+        {
+            if (*p < '0' || *p > '9')
+            {
+                return false;
+            }
+
+            unsigned int first = 0;
+            for ( ; *p >= '0' && *p <= '9'; ++p)
+            {
+                first = first * 10 + static_cast<unsigned int>(*p - '0');
+            }
+
+            unsigned int last = first;
+            if ('-' == *p)
+            {
+                ++p;
+                if (*p < '0' || *p > '9')
+                {
+                    return false;
+                }
+                last = 0;
+                for ( ; *p >= '0' && *p <= '9'; ++p)
+                {
+                    last = last * 10 + static_cast<unsigned int>(*p - '0');
+                }
+                if (last < first)
+                {
+                    return false;
+                }
+            }
+
+            for (unsigned int cpu = first; cpu <= last; cpu++)
+            {
+                cpus.push_back(cpu);
+            }
+
+            if (',' == *p)
+            {
+                ++p;
+            }
+            else if (*p != '\0' && *p != '\n')
+            {
+                return false;
+            }
+        }
+
+        std::sort(cpus.begin(), cpus.end());
+        cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+        return true;
+    }
+}
+
+/*----------------------------E-N-D---O-F---F-I-L-E---------------------------*/
@@ -24,9 +24,13 @@
 
 #include <scxsystemlib/cpuenumeration.h>
 #include <scxsystemlib/cpuinstance.h>
+#include <scxsystemlib/sysfsutil.h>
 
+#include <algorithm>
 #include <fstream>
 #include <iostream>
+#include <iterator>
+#include <map>
 #include <set>
 #include <vector>
 #include <string>
@@ -36,6 +40,14 @@
 # include <errno.h>
 #endif
 
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(linux)
+# include <fcntl.h>
+# include <time.h>
+#endif
+
 // System-specific includes
 
 #if defined(aix)
@@ -66,9 +78,52 @@
 using namespace std;
 using namespace SCXCoreLib;
 
+namespace
+{
+    /** Processors that are online, in cpu list format. */
+    const std::string CPU_ONLINE_FILE = "/sys/devices/system/cpu/online";
+
+    /** Control groups of the agent process. */
+    const std::string CPU_PROC_SELF_CGROUP_FILE = "/proc/self/cgroup";
+
+    /** Mount point of the cgroup file system (unified) or of the cpuset hierarchy (legacy). */
+    const std::string CPU_CGROUP_V2_ROOT = "/sys/fs/cgroup";
+    const std::string CPU_CGROUP_V1_CPUSET_ROOT = "/sys/fs/cgroup/cpuset";
+
+    /** Per processor topology, followed by the processor number and the file name. */
+    const std::string CPU_SYS_CPU_DIR = "/sys/devices/system/cpu/cpu";
+
+    /** NUMA nodes that are online, and per node directories. */
+    const std::string CPU_NODE_ONLINE_FILE = "/sys/devices/system/node/online";
+    const std::string CPU_SYS_NODE_DIR = "/sys/devices/system/node/node";
+}
+
 namespace SCXSystemLib
 {
 
+    /**
+       Constructor
+    */
+    CPUPALDependencies::CPUPALDependencies()
+#if defined(linux)
+        : m_statFd(-1)
+#endif
+    {
+    }
+
+    /**
+       Destructor. Closes /proc/stat if it was opened by ReadStatFile().
+    */
+    CPUPALDependencies::~CPUPALDependencies()
+    {
+#if defined(linux)
+        if (m_statFd >= 0)
+        {
+            close(m_statFd);
+        }
+#endif
+    }
+
     /**
        Returns a stream for reading from /proc/stat
     */
@@ -83,6 +138,68 @@ namespace SCXSystemLib
 #endif
     }
 
+    /**
+       Reads the contents of /proc/stat into a caller supplied buffer.
+
+       \param[out] buf  Buffer to read into
+       \param[in]  size Size of buffer
+       \returns        Number of bytes read. If equal to size the buffer was
+                        too small and the contents are truncated.
+
+       \throws SCXErrnoException if /proc/stat cannot be opened or read
+
+       On Linux the file is opened once and then re-read from offset zero
+       with pread(), which makes the kernel regenerate the contents. No
+       memory is allocated.
+    */
+    size_t CPUPALDependencies::ReadStatFile(char* buf, size_t size) const
+    {
+#if defined(linux)
+        if (m_statFd < 0)
+        {
+            m_statFd = open("/proc/stat", O_RDONLY);
+            if (m_statFd < 0)
+            {
+                throw SCXErrnoException(L"open", errno, SCXSRCLOCATION);
+            }
+        }
+
+        size_t total = 0;
+        while (total < size)
+        {
+            ssize_t n = pread(m_statFd, buf + total, size - total, static_cast<off_t>(total));
+            if (n < 0)
+            {
+                if (EINTR == errno)
+                {
+                    continue;
+                }
+                throw SCXErrnoException(L"pread", errno, SCXSRCLOCATION);
+            }
+            if (0 == n)
+            {
+                break;
+            }
+            total += static_cast<size_t>(n);
+        }
+        return total;
+#else
+        // Read through the stream so that the stat file can still be replaced
+        SCXHandle<wistream> statFile = OpenStatFile();
+        size_t total = 0;
+        wstring line;
+        while (statFile != 0 && total < size && getline(*statFile, line))
+        {
+            string narrow = StrToMultibyte(line);
+            narrow.append(1, '\n');
+            size_t n = narrow.size() < size - total ? narrow.size() : size - total;
+            memcpy(buf + total, narrow.data(), n);
+            total += n;
+        }
+        return total;
+#endif
+    }
+
     SCXHandle<wistream> CPUPALDependencies::OpenCpuinfoFile() const
     {
 #if defined(linux)
@@ -92,6 +209,24 @@ namespace SCXSystemLib
 #endif
     }
 
+    /**
+       Reads a small sysfs, procfs or cgroup file.
+
+       \param[in]  path    Absolute path of the file
+       \param[out] content Contents of the file
+       \returns    false if the file could not be read
+    */
+    bool CPUPALDependencies::ReadSysFile(const std::string& path, std::string& content) const
+    {
+#if defined(linux)
+        return SysFsUtil::ReadFile(path, content);
+#else
+        (void) path;
+        content.clear();
+        return false;
+#endif
+    }
+
     /**
        Calls the sysconf system call.
 
@@ -268,6 +403,13 @@ namespace SCXSystemLib
         EntityEnumeration<CPUInstance>(),
         m_deps(deps),
         m_lock(SCXCoreLib::ThreadLockHandleGet()),
+        m_scheduler(new SchedulerInstance()),
+#if defined(linux) || defined(WIN32)
+        m_statBuffer(CPU_STAT_INITIAL_BUFFER_SIZE),
+#endif
+#if defined(linux)
+        m_cpusetRestricted(false),
+#endif
         m_dataAquisitionThread(NULL)
 #if defined(aix)
         , m_dataarea(deps->sysconf(_SC_NPROCESSORS_CONF))
@@ -314,6 +456,24 @@ namespace SCXSystemLib
 
         SetTotalInstance(SCXCoreLib::SCXHandle<CPUInstance>(new CPUInstance(0, true)));
 
+#if defined(linux)
+        // Our control group is assumed not to change during the agent's lifetime
+        string cgroups;
+        if (m_deps->ReadSysFile(CPU_PROC_SELF_CGROUP_FILE, cgroups))
+        {
+            vector<string> files;
+            GetCpusetFiles(cgroups, files);
+            for (vector<string>::const_iterator it = files.begin(); m_cpusetFile.empty() && it != files.end(); ++it)
+            {
+                if (m_deps->ReadSysFile(*it, m_readBuffer))
+                {
+                    m_cpusetFile = *it;
+                }
+            }
+        }
+        SCX_LOGTRACE(m_log, StrFromMultibyte(m_cpusetFile.empty() ? string("CPUEnumeration Init() - No cpuset") : "CPUEnumeration Init() - cpuset from " + m_cpusetFile));
+#endif
+
         Update(false);
 
         if (NULL == m_dataAquisitionThread)
@@ -634,13 +794,20 @@ namespace SCXSystemLib
         {
             throw SCXInternalErrorException(L"pstat_getprocessor() failed", SCXSRCLOCATION);
         }
+#elif defined(linux)
+        UpdateTopology();
+        size_t count = Size();
 #else
         size_t count = ProcessorCountLogical(m_deps);
 #endif // defined(hpux)
 
         SCX_LOGTRACE(m_log, StrAppend(StrAppend(L"CPUEnumeration Update() - ", updateInstances).append(L" - "), count));
 
-#if defined(linux) || defined(WIN32)
+#if defined(linux)
+
+        // Instances are maintained by UpdateTopology()
+
+#elif defined(WIN32)
 
         // add cpus if needed
         for (size_t i=Size(); i<count; i++)
@@ -768,10 +935,54 @@ namespace SCXSystemLib
         if (updateInstances)
         {
             UpdateInstances();
+            for (size_t i = 0; i < m_groups.size(); i++)
+            {
+                m_groups[i]->Update();
+            }
+            m_scheduler->Update();
         }
 
     }
 
+    /*----------------------------------------------------------------------------*/
+    /**
+       Get the system wide scheduler counters
+
+       \returns The scheduler instance, updated by the latest Update()
+
+       Sampled in the same pass over /proc/stat as the processors. Values are
+       only available on Linux.
+    */
+    SCXCoreLib::SCXHandle<SchedulerInstance> CPUEnumeration::GetSchedulerInstance() const
+    {
+        return m_scheduler;
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Get the number of core, socket and NUMA node aggregates
+
+       \returns Number of aggregates, zero on platforms other than Linux
+
+       The aggregates only change in Update(); call from the thread that calls it.
+    */
+    size_t CPUEnumeration::GetGroupCount() const
+    {
+        return m_groups.size();
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Get a core, socket or NUMA node aggregate
+
+       \param[in] pos Index of the aggregate, less than GetGroupCount()
+       \returns   The aggregate, updated by the latest Update()
+    */
+    SCXCoreLib::SCXHandle<CPUInstance> CPUEnumeration::GetGroupInstance(size_t pos) const
+    {
+        return m_groups[pos];
+    }
+
     /*----------------------------------------------------------------------------*/
     /**
        Cleanup
@@ -784,6 +995,467 @@ namespace SCXSystemLib
         m_dataAquisitionThread->Wait();
     }
 
+#if defined(linux) || defined(WIN32)
+    /*----------------------------------------------------------------------------*/
+    /**
+       Reads /proc/stat into m_statBuffer
+
+       \returns Number of bytes read
+
+       The buffer is grown (and the file re-read) if the contents did not fit,
+       which only happens during the first samples or after CPUs are added.
+    */
+    size_t CPUEnumeration::ReadStatFile()
+    {
+        size_t len = m_deps->ReadStatFile(&m_statBuffer[0], m_statBuffer.size());
+        while (len >= m_statBuffer.size())
+        {
+            m_statBuffer.resize(m_statBuffer.size() * 2);
+            SCX_LOGTRACE(m_log, StrAppend(L"CPUEnumeration ReadStatFile - Buffer grown to ", m_statBuffer.size()));
+            len = m_deps->ReadStatFile(&m_statBuffer[0], m_statBuffer.size());
+        }
+        return len;
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Finds the instance of a processor number.
+
+       \param[in] procNumber Number of the processor, as in the cpu<N> rows of /proc/stat
+       \returns              The instance, or NULL if there is none
+
+       Instances are stored in processor number order, but there may be
+       gaps when processors are offline or outside our cpuset, so the
+       instance is looked up with a binary search. A raw pointer is returned
+       since the instance is only used while the enumeration lock is held,
+       and a NULL handle would cost an allocation.
+    */
+    CPUInstance* CPUEnumeration::FindInstanceByProcNumber(unsigned int procNumber) const
+    {
+        size_t low = 0;
+        size_t high = Size();
+        while (low < high)
+        {
+            size_t mid = low + (high - low) / 2;
+            CPUInstance* inst = GetInstance(mid).GetData();
+            if (inst->GetProcNumber() == procNumber)
+            {
+                return inst;
+            }
+            if (inst->GetProcNumber() < procNumber)
+            {
+                low = mid + 1;
+            }
+            else
+            {
+                high = mid;
+            }
+        }
+        return NULL;
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Adds a sample of the counters of a cpu row in /proc/stat to an instance.
+
+       \param[in] inst   Instance to add the sample to
+       \param[in] values CPU_STAT_COLUMNS counters, in /proc/stat order
+    */
+    void CPUEnumeration::AddTickSample(CPUInstance* inst, const scxulong* values)
+    {
+        scxulong user = values[0];
+        scxulong nice = values[1];
+        scxulong system = values[2];
+        scxulong idle = values[3];
+        scxulong iowait = values[4];
+        scxulong irq = values[5];
+        scxulong softirq = values[6];
+        scxulong steal = values[7];
+        // Guest time is already included in user (and guest nice in nice)
+        scxulong guest = values[8] + values[9];
+
+        scxulong total_tics = user + nice + system + iowait + irq + softirq + idle + steal;
+
+        // Add new values using friendship declared on the
+        // instance class (the m_*_tics properties are private)
+        inst->m_UserCPU_tics.AddSample(user);
+        inst->m_NiceCPU_tics.AddSample(nice);
+        inst->m_SystemCPUTime_tics.AddSample(system);
+        inst->m_IdleCPU_tics.AddSample(idle);
+        inst->m_IOWaitTime_tics.AddSample(iowait);
+        inst->m_IRQTime_tics.AddSample(irq);
+        inst->m_SoftIRQTime_tics.AddSample(softirq);
+        inst->m_StealTime_tics.AddSample(steal);
+        inst->m_GuestTime_tics.AddSample(guest);
+        inst->m_Total_tics.AddSample(total_tics);
+    }
+#endif
+
+#if defined(linux)
+    /*----------------------------------------------------------------------------*/
+    /**
+       Brings the set of instances in line with the processors we may run on.
+
+       \returns true if the set of instances changed
+
+       The processors are those listed as online in sysfs, limited to the
+       cpuset of our control group if there is one. Both files are re-read
+       on every call, but the instances are only rebuilt when the contents
+       differ from the last time; instances of processors that remain keep
+       their samples. If the online file can not be read, sysconf() is used
+       and processors are assumed to be numbered from zero.
+
+       Only called from Update(), never from the sampler thread: the provider
+       iterates the instances without the lock after Update() has returned.
+    */
+    bool CPUEnumeration::UpdateTopology()
+    {
+        bool onlineChanged = true;
+        if (m_deps->ReadSysFile(CPU_ONLINE_FILE, m_readBuffer))
+        {
+            onlineChanged = (m_readBuffer != m_onlineList);
+            if (onlineChanged)
+            {
+                m_onlineList.swap(m_readBuffer);
+            }
+        }
+        else
+        {
+            // Fall back to the processor count, formatted as a cpu list
+            size_t count = ProcessorCountLogical(m_deps);
+            m_readBuffer = (count > 0) ? "0-" + StrToMultibyte(StrFrom(count - 1)) : string();
+            onlineChanged = (m_readBuffer != m_onlineList);
+            if (onlineChanged)
+            {
+                m_onlineList.swap(m_readBuffer);
+            }
+        }
+
+        bool cpusetChanged = false;
+        if (!m_cpusetFile.empty())
+        {
+            if (!m_deps->ReadSysFile(m_cpusetFile, m_readBuffer))
+            {
+                m_readBuffer.clear();
+            }
+            cpusetChanged = (m_readBuffer != m_cpusetList);
+            if (cpusetChanged)
+            {
+                m_cpusetList.swap(m_readBuffer);
+            }
+        }
+
+        if (!onlineChanged && !cpusetChanged && !m_allowed.empty())
+        {
+            return false;
+        }
+
+        SCX_LOGINFO(m_log, StrFromMultibyte("CPUEnumeration - Processor topology changed, online: " + m_onlineList + ", cpuset: " + m_cpusetList));
+
+        if (!SysFsUtil::ParseCpuList(m_onlineList, m_online) || m_online.empty())
+        {
+            SCX_LOGWARNING(m_log, StrFromMultibyte("CPUEnumeration - Unable to parse online processor list: " + m_onlineList));
+            m_online.clear();
+            size_t count = ProcessorCountLogical(m_deps);
+            for (size_t i = 0; i < count; i++)
+            {
+                m_online.push_back(static_cast<unsigned int>(i));
+            }
+        }
+
+        vector<unsigned int> cpuset;
+        m_allowed.clear();
+        if (!m_cpusetList.empty() && SysFsUtil::ParseCpuList(m_cpusetList, cpuset) && !cpuset.empty())
+        {
+            set_intersection(m_online.begin(), m_online.end(), cpuset.begin(), cpuset.end(),
+                             back_inserter(m_allowed));
+        }
+        if (m_allowed.empty())
+        {
+            m_allowed = m_online;
+        }
+
+        bool restricted = (m_allowed.size() < m_online.size());
+        if (restricted != m_cpusetRestricted)
+        {
+            // The total is now computed over a different set of processors
+            GetTotalInstance()->ClearSamples();
+            m_cpusetRestricted = restricted;
+        }
+
+        // Rebuild the list in processor number order, keeping the instances
+        // (and thereby the samples) of processors that remain
+        vector<SCXCoreLib::SCXHandle<CPUInstance> > old(Begin(), End());
+        Clear(false);
+
+        vector<SCXCoreLib::SCXHandle<CPUInstance> >::const_iterator oldIter = old.begin();
+        for (vector<unsigned int>::const_iterator it = m_allowed.begin(); it != m_allowed.end(); ++it)
+        {
+            while (oldIter != old.end() && (*oldIter)->GetProcNumber() < *it)
+            {
+                SCX_LOGTRACE(m_log, StrAppend(L"CPUEnumeration UpdateTopology() - Removing CPU ", (*oldIter)->GetProcNumber()));
+                ++oldIter;
+            }
+
+            if (oldIter != old.end() && (*oldIter)->GetProcNumber() == *it)
+            {
+                AddInstance(*oldIter);
+                ++oldIter;
+            }
+            else
+            {
+                SCX_LOGTRACE(m_log, StrAppend(L"CPUEnumeration UpdateTopology() - Adding CPU ", *it));
+                AddInstance(SCXCoreLib::SCXHandle<CPUInstance>(new CPUInstance(*it)));
+            }
+        }
+        for ( ; oldIter != old.end(); ++oldIter)
+        {
+            SCX_LOGTRACE(m_log, StrAppend(L"CPUEnumeration UpdateTopology() - Removing CPU ", (*oldIter)->GetProcNumber()));
+        }
+
+        BuildGroups();
+
+        return true;
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Builds the core, socket and NUMA node aggregates of the monitored processors.
+
+       Called when the topology changes. The aggregates start without samples.
+       Cores are only reported when they have more than one hardware thread,
+       since they would otherwise duplicate a processor instance. Systems that
+       do not expose the topology in sysfs get no aggregates.
+
+       Runs from UpdateTopology() in Update() only, with the lock held, so the
+       sampler thread never sees a partial list and the provider thread, which
+       reads the aggregates after Update(), never sees them change under it.
+    */
+    void CPUEnumeration::BuildGroups()
+    {
+        m_groups.clear();
+        m_groupMembers.clear();
+
+        map<pair<long, long>, vector<unsigned int> > cores;
+        map<long, vector<unsigned int> > sockets;
+
+        string content;
+        for (vector<unsigned int>::const_iterator it = m_allowed.begin(); it != m_allowed.end(); ++it)
+        {
+            string dir = CPU_SYS_CPU_DIR + StrToMultibyte(StrFrom(*it)) + "/topology/";
+
+            if (!m_deps->ReadSysFile(dir + "physical_package_id", content))
+            {
+                continue;
+            }
+            long socket = strtol(content.c_str(), NULL, 10);
+            sockets[socket].push_back(*it);
+
+            if (m_deps->ReadSysFile(dir + "core_id", content))
+            {
+                long core = strtol(content.c_str(), NULL, 10);
+                cores[make_pair(socket, core)].push_back(*it);
+            }
+        }
+
+        for (map<pair<long, long>, vector<unsigned int> >::const_iterator it = cores.begin(); it != cores.end(); ++it)
+        {
+            if (it->second.size() > 1)
+            {
+                wstring name = L"_Core" + StrFrom(it->first.first) + L"." + StrFrom(it->first.second);
+                m_groups.push_back(SCXCoreLib::SCXHandle<CPUInstance>(new CPUInstance(name, eCPUGroupingCore)));
+                m_groupMembers.push_back(it->second);
+            }
+        }
+
+        for (map<long, vector<unsigned int> >::const_iterator it = sockets.begin(); it != sockets.end(); ++it)
+        {
+            m_groups.push_back(SCXCoreLib::SCXHandle<CPUInstance>(new CPUInstance(L"_Socket" + StrFrom(it->first), eCPUGroupingSocket)));
+            m_groupMembers.push_back(it->second);
+        }
+
+        vector<unsigned int> nodes;
+        if (m_deps->ReadSysFile(CPU_NODE_ONLINE_FILE, content) && SysFsUtil::ParseCpuList(content, nodes))
+        {
+            for (vector<unsigned int>::const_iterator it = nodes.begin(); it != nodes.end(); ++it)
+            {
+                vector<unsigned int> nodeCpus, members;
+                string cpulist = CPU_SYS_NODE_DIR + StrToMultibyte(StrFrom(*it)) + "/cpulist";
+                if (!m_deps->ReadSysFile(cpulist, content) || !SysFsUtil::ParseCpuList(content, nodeCpus))
+                {
+                    continue;
+                }
+
+                set_intersection(nodeCpus.begin(), nodeCpus.end(), m_allowed.begin(), m_allowed.end(),
+                                 back_inserter(members));
+                if (!members.empty())
+                {
+                    m_groups.push_back(SCXCoreLib::SCXHandle<CPUInstance>(new CPUInstance(L"_Node" + StrFrom(*it), eCPUGroupingNode)));
+                    m_groupMembers.push_back(members);
+                }
+            }
+        }
+
+        SCX_LOGTRACE(m_log, StrAppend(L"CPUEnumeration BuildGroups() - Number of aggregates: ", m_groups.size()));
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Adds a sample to each aggregate from the latest samples of its processors.
+
+       Must be called after the processor rows of /proc/stat have been
+       sampled; nothing more is read. Processors without samples are skipped.
+    */
+    void CPUEnumeration::SampleGroups()
+    {
+        for (size_t g = 0; g < m_groups.size(); g++)
+        {
+            scxulong values[CPU_STAT_COLUMNS] = { 0 };
+            bool found = false;
+
+            const vector<unsigned int>& members = m_groupMembers[g];
+            for (vector<unsigned int>::const_iterator it = members.begin(); it != members.end(); ++it)
+            {
+                const CPUInstance* inst = FindInstanceByProcNumber(*it);
+                if (NULL == inst || 0 == inst->m_Total_tics.GetNumberOfSamples())
+                {
+                    continue;
+                }
+
+                // Same column order as /proc/stat; guest and guest nice are already summed
+                values[0] += inst->m_UserCPU_tics[0];
+                values[1] += inst->m_NiceCPU_tics[0];
+                values[2] += inst->m_SystemCPUTime_tics[0];
+                values[3] += inst->m_IdleCPU_tics[0];
+                values[4] += inst->m_IOWaitTime_tics[0];
+                values[5] += inst->m_IRQTime_tics[0];
+                values[6] += inst->m_SoftIRQTime_tics[0];
+                values[7] += inst->m_StealTime_tics[0];
+                values[8] += inst->m_GuestTime_tics[0];
+                found = true;
+            }
+
+            if (found)
+            {
+                AddTickSample(m_groups[g].GetData(), values);
+            }
+        }
+    }
+#endif
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Finds the files that may hold the cpuset of our control group.
+
+       \param[in]  procSelfCgroup Contents of /proc/self/cgroup
+       \param[out] files          Candidate files, most specific first
+
+       A legacy (v1) cpuset hierarchy takes precedence over the unified (v2)
+       hierarchy. Inside a container the path in /proc/self/cgroup may be the
+       one seen from the host, so the root of the hierarchy is added as a
+       fallback; with cgroup namespaces or bind mounts that is our group.
+    */
+    void CPUEnumeration::GetCpusetFiles(const std::string& procSelfCgroup, std::vector<std::string>& files)
+    {
+        files.clear();
+
+        string v1Path, v2Path;
+        bool hasV1 = false, hasV2 = false;
+
+        size_t pos = 0;
+        while (pos < procSelfCgroup.size())
+        {
+            size_t eol = procSelfCgroup.find('\n', pos);
+            if (string::npos == eol)
+            {
+                eol = procSelfCgroup.size();
+            }
+            string line = procSelfCgroup.substr(pos, eol - pos);
+            pos = eol + 1;
+
+            // hierarchy-ID:controller-list:cgroup-path
+            size_t colon1 = line.find(':');
+            size_t colon2 = (string::npos == colon1) ? string::npos : line.find(':', colon1 + 1);
+            if (string::npos == colon2)
+            {
+                continue;
+            }
+            string controllers = line.substr(colon1 + 1, colon2 - colon1 - 1);
+            string path = line.substr(colon2 + 1);
+            if ("/" == path)
+            {
+                path.clear();
+            }
+
+            if (controllers.empty() && "0" == line.substr(0, colon1))
+            {
+                hasV2 = true;
+                v2Path = path;
+            }
+            else if (("," + controllers + ",").find(",cpuset,") != string::npos)
+            {
+                hasV1 = true;
+                v1Path = path;
+            }
+        }
+
+        if (hasV1)
+        {
+            if (!v1Path.empty())
+            {
+                files.push_back(CPU_CGROUP_V1_CPUSET_ROOT + v1Path + "/cpuset.effective_cpus");
+                files.push_back(CPU_CGROUP_V1_CPUSET_ROOT + v1Path + "/cpuset.cpus");
+            }
+            files.push_back(CPU_CGROUP_V1_CPUSET_ROOT + "/cpuset.effective_cpus");
+            files.push_back(CPU_CGROUP_V1_CPUSET_ROOT + "/cpuset.cpus");
+        }
+        else if (hasV2)
+        {
+            if (!v2Path.empty())
+            {
+                files.push_back(CPU_CGROUP_V2_ROOT + v2Path + "/cpuset.cpus.effective");
+            }
+            files.push_back(CPU_CGROUP_V2_ROOT + "/cpuset.cpus.effective");
+        }
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Parses the whitespace separated counters of a row in /proc/stat
+
+       \param[in]  p          First character after the row label
+       \param[in]  end        End of the row
+       \param[out] values     Array receiving the counters
+       \param[in]  maxValues  Number of elements in values
+       \returns               Number of counters parsed
+
+       Parsing stops at the end of the row, at maxValues, or at the first
+       field that is not a decimal number.
+    */
+    size_t CPUEnumeration::ParseStatCounters(const char* p, const char* end, scxulong* values, size_t maxValues)
+    {
+        size_t count = 0;
+        while (count < maxValues)
+        {
+            while (p < end && (' ' == *p || '\t' == *p))
+            {
+                ++p;
+            }
+            if (p >= end || *p < '0' || *p > '9')
+            {
+                break;
+            }
+
+            scxulong value = 0;
+            for ( ; p < end && *p >= '0' && *p <= '9'; ++p)
+            {
+                value = value * 10 + static_cast<scxulong>(*p - '0');
+            }
+            values[count++] = value;
+        }
+        return count;
+    }
+
     /*----------------------------------------------------------------------------*/
     /**
        Store new data for all instances
@@ -800,119 +1472,144 @@ namespace SCXSystemLib
 
 #if defined(linux) || defined(WIN32)
 
-        SCXHandle<wistream> statFile = m_deps->OpenStatFile();
-        wstring line;
-        while (getline(*statFile, line) > 0)
-        {
-            vector<wstring> tokens;
-            SCXCoreLib::SCXHandle<CPUInstance> inst(0);
-
-            SCX_LOGHYSTERICAL(m_log, wstring(L"CPUEnumeration SampleData - Read line: ").append(line));
+#if defined(linux)
+        // The instance list is only changed by Update(), on the provider thread
+        // that also iterates it. Processors that came online since are skipped
+        // below until then.
 
-            StrTokenize(line, tokens);
+        // If our cpuset excludes some processors the total row of /proc/stat
+        // does not describe us; the total is then summed from our processors.
+        bool sumTotal = m_cpusetRestricted;
+#else
+        bool sumTotal = false;
+#endif
+        scxulong sums[CPU_STAT_COLUMNS] = { 0 };
+        bool foundCPU = false;
+
+        // Parse straight out of the (reused) buffer. Nothing in the loop below
+        // allocates memory unless something is logged.
+        size_t len = ReadStatFile();
+        const char* p = &m_statBuffer[0];
+        const char* end = p + len;
+        scxulong values[CPU_STAT_COLUMNS];
+        scxulong ctxt = 0, intr = 0, processes = 0, running = 0, blocked = 0;
+        bool foundCtxt = false;
+
+        while (p < end)
+        {
+            const char* eol = static_cast<const char*>(memchr(p, '\n', end - p));
+            if (NULL == eol)
+            {
+                eol = end;
+            }
 
-            if (tokens.size() > 0)
+            // See example of stat file at the end of this source code file
+            if (eol - p > 3 && 0 == strncmp(p, "cpu", 3))
             {
-                // See example of stat file at the end of this source code file
-                if (StrIsPrefix(tokens[0], L"cpu"))
+                const char* q = p + 3;
+                CPUInstance* inst = NULL;
+
+                if (' ' == *q)
                 {
-                    if (tokens[0].compare(L"cpu") == 0)
+                    if (!sumTotal)
                     {
-                        inst = GetTotalInstance();
-                        SCX_LOGHYSTERICAL(m_log, L"CPUEnumeration SampleData - Found total row");
+                        inst = GetTotalInstance().GetData();
                     }
-
-                for (size_t i=0; inst == NULL && i<Size(); i++)
+                    SCX_LOGHYSTERICAL(m_log, L"CPUEnumeration SampleData - Found total row");
+                }
+                else if (*q >= '0' && *q <= '9')
+                {
+                    unsigned int procNumber = 0;
+                    for ( ; q < eol && *q >= '0' && *q <= '9'; ++q)
                     {
-                        SCXCoreLib::SCXHandle<CPUInstance> tmp_inst = GetInstance(i);
-
-                        // Concatinate a string to match representing a specific cpu
-                        if (tokens[0].compare(wstring(L"cpu").append(tmp_inst->GetProcName())) == 0)
-                        {
-                            inst = tmp_inst;
-                            SCX_LOGHYSTERICAL(m_log, StrAppend(L"CPUEnumeration SampleData - Found instance row - ", inst->GetProcNumber()));
-                        }
+                        procNumber = procNumber * 10 + static_cast<unsigned int>(*q - '0');
                     }
-
-                    if (inst != NULL)
+                    inst = FindInstanceByProcNumber(procNumber);
+                    if (NULL == inst)
                     {
-                        scxulong user = 0;
-                        scxulong nice = 0;
-                        scxulong system = 0;
-                        scxulong idle = 0;
-                        scxulong iowait = 0;
-                        scxulong irq = 0;
-                        scxulong softirq = 0;
-
-                        if (tokens.size() >= 5)
-                        {
-                            try
-                            {
-                                user = StrToULong(tokens[1]);
-                                SCX_LOGHYSTERICAL(m_log, StrAppend(L"    Read user = ", user));
-                                nice = StrToULong(tokens[2]);
-                                SCX_LOGHYSTERICAL(m_log, StrAppend(L"    Read nice = ", nice));
-                                system = StrToULong(tokens[3]);
-                                SCX_LOGHYSTERICAL(m_log, StrAppend(L"    Read system = ", system));
-                                idle = StrToULong(tokens[4]);
-                                SCX_LOGHYSTERICAL(m_log, StrAppend(L"    Read idle = ", idle));
-                            }
-                            catch (const SCXNotSupportedException& e)
-                            {
-                                SCX_LOGWARNING(m_log, std::wstring(L"Could not parse line from stat file: ").append(line).append(L" - ").append(e.What()));
-                            }
-                            if (tokens.size() >= 8)
-                            {
-                                try
-                                {
-                                    iowait = StrToULong(tokens[5]);
-                                    SCX_LOGHYSTERICAL(m_log, StrAppend(L"    Read iowait = ", iowait));
-                                    irq = StrToULong(tokens[6]);
-                                    SCX_LOGHYSTERICAL(m_log, StrAppend(L"    Read irq = ", irq));
-                                    softirq = StrToULong(tokens[7]);
-                                    SCX_LOGHYSTERICAL(m_log, StrAppend(L"    Read softirq = ", softirq));
-                                }
-                                catch (const SCXNotSupportedException& e)
-                                {
-                                    SCX_LOGWARNING(m_log, std::wstring(L"Could not parse line from stat file: ").append(line).append(L" - ").append(e.What()));
-                                }
-                            }
-                            else
-                            {
-                                iowait = irq = softirq = 0;
-                            }
-
-                            scxulong total_tics = user + nice + system + iowait + irq + softirq + idle;
+                        // Outside our cpuset, or came online since the topology was read
+                        SCX_LOGHYSTERICAL(m_log, StrAppend(L"CPUEnumeration SampleData - Not monitoring cpu", procNumber));
+                    }
+                }
 
-                            SCX_LOGHYSTERICAL(m_log, StrAppend(L"    Calculate total = ", total_tics));
+                if (inst != NULL)
+                {
+                    size_t count = ParseStatCounters(q, eol, values, CPU_STAT_COLUMNS);
 
-                            // Add new values using friendship declared on the
-                            // instance class (the m_*_tics properties are private)
-                            inst->m_UserCPU_tics.AddSample(user);
-                            inst->m_NiceCPU_tics.AddSample(nice);
-                            inst->m_SystemCPUTime_tics.AddSample(system);
-                            inst->m_IdleCPU_tics.AddSample(idle);
-                            inst->m_IOWaitTime_tics.AddSample(iowait);
-                            inst->m_IRQTime_tics.AddSample(irq);
-                            inst->m_SoftIRQTime_tics.AddSample(softirq);
-                            inst->m_Total_tics.AddSample(total_tics);
+                    if (count >= 4)
+                    {
+                        // Columns that older kernels don't have are zero
+                        for (size_t i = count; i < CPU_STAT_COLUMNS; i++)
+                        {
+                            values[i] = 0;
+                        }
 
-                            SCX_LOGHYSTERICAL(m_log, L"CPUEnumeration SampleData - All Values stored");
+                        AddTickSample(inst, values);
 
-                        }
-                        else
+                        if (!inst->IsTotal())
                         {
-                            SCX_LOGERROR(m_log, StrAppend(L"CPUEnumeration SampleData - Too few column in data file - ", tokens.size()));
+                            for (size_t i = 0; i < CPU_STAT_COLUMNS; i++)
+                            {
+                                sums[i] += values[i];
+                            }
+                            foundCPU = true;
                         }
+
+                        SCX_LOGHYSTERICAL(m_log, L"CPUEnumeration SampleData - All Values stored");
                     }
                     else
                     {
-                        SCX_LOGERROR(m_log, wstring(L"CPUEnumeration SampleData - No cpu in list found that match row in data file - ").append(tokens[0]));
+                        SCX_LOGERROR(m_log, StrAppend(L"CPUEnumeration SampleData - Too few column in data file - ", count + 1));
                     }
                 }
             }
+            // System wide counters. Only the first (total) column of intr is used.
+            else if (eol - p > 5 && 0 == strncmp(p, "ctxt ", 5))
+            {
+                foundCtxt = (1 == ParseStatCounters(p + 5, eol, &ctxt, 1));
+            }
+            else if (eol - p > 5 && 0 == strncmp(p, "intr ", 5))
+            {
+                ParseStatCounters(p + 5, eol, &intr, 1);
+            }
+            else if (eol - p > 10 && 0 == strncmp(p, "processes ", 10))
+            {
+                ParseStatCounters(p + 10, eol, &processes, 1);
+            }
+            else if (eol - p > 14 && 0 == strncmp(p, "procs_running ", 14))
+            {
+                ParseStatCounters(p + 14, eol, &running, 1);
+            }
+            else if (eol - p > 14 && 0 == strncmp(p, "procs_blocked ", 14))
+            {
+                ParseStatCounters(p + 14, eol, &blocked, 1);
+            }
+
+            p = eol + 1;
         }
 
+        if (sumTotal && foundCPU)
+        {
+            AddTickSample(GetTotalInstance().GetData(), sums);
+        }
+
+#if defined(linux)
+        SampleGroups();
+#endif
+
+#if defined(linux)
+        if (foundCtxt)
+        {
+            // The monotonic clock keeps a step of the wall clock out of the rates
+            struct timespec now;
+            clock_gettime(CLOCK_MONOTONIC, &now);
+            scxulong nowMsec = static_cast<scxulong>(now.tv_sec) * 1000 + static_cast<scxulong>(now.tv_nsec) / 1000000;
+            m_scheduler->AddSample(nowMsec, ctxt, intr, processes, running, blocked);
+        }
+#else
+        (void) foundCtxt;
+#endif
+
 #elif defined(sun) || defined(hpux)
 
         scxulong user_tot = 0;
@@ -54,6 +54,7 @@ namespace SCXSystemLib
         SCX_LOGTRACE(m_log, wstring(L"CPUInstance default constructor - ").append(m_procName));
 
         m_procNumber = procNumber;
+        m_grouping = isTotal ? eCPUGroupingTotal : eCPUGroupingProcessor;
 
         // Init data
         m_processorTime = 0;
@@ -64,10 +65,43 @@ namespace SCXSystemLib
         m_iowaitTime = 0;
         m_interruptTime = 0;
         m_dpcTime = 0;
+        m_stealTime = 0;
+        m_guestTime = 0;
         m_queueLength = 0;
     }
 
 
+    /*----------------------------------------------------------------------------*/
+    /**
+        Constructor of an instance aggregating a group of processors
+
+        Parameters:  name - Name of the instance
+                     grouping - What the instance aggregates (core, socket or NUMA node)
+    */
+    CPUInstance::CPUInstance(const std::wstring& name, CPUGrouping grouping) : EntityInstance(false)
+    {
+        m_log = SCXLogHandleFactory::GetLogHandle(L"scx.core.common.pal.system.cpu.cpuinstance");
+
+        m_procName = name;
+
+        SCX_LOGTRACE(m_log, wstring(L"CPUInstance group constructor - ").append(m_procName));
+
+        m_procNumber = 0;
+        m_grouping = grouping;
+
+        m_processorTime = 0;
+        m_idleTime = 0;
+        m_userTime = 0;
+        m_niceTime = 0;
+        m_privilegedTime = 0;
+        m_iowaitTime = 0;
+        m_interruptTime = 0;
+        m_dpcTime = 0;
+        m_stealTime = 0;
+        m_guestTime = 0;
+        m_queueLength = 0;
+    }
+
     /*----------------------------------------------------------------------------*/
     /**
         Destructor
@@ -77,6 +111,27 @@ namespace SCXSystemLib
         SCX_LOGTRACE(m_log, wstring(L"CPUInstance destructor - ").append(m_procName));
     }
 
+    /*----------------------------------------------------------------------------*/
+    /**
+       Discards all samples.
+
+       Used by CPUEnumeration when the set of processors that make up the
+       total instance changes, since deltas across such a change are bogus.
+    */
+    void CPUInstance::ClearSamples()
+    {
+        m_UserCPU_tics.Clear();
+        m_NiceCPU_tics.Clear();
+        m_SystemCPUTime_tics.Clear();
+        m_IdleCPU_tics.Clear();
+        m_IOWaitTime_tics.Clear();
+        m_IRQTime_tics.Clear();
+        m_SoftIRQTime_tics.Clear();
+        m_StealTime_tics.Clear();
+        m_GuestTime_tics.Clear();
+        m_Total_tics.Clear();
+    }
+
     /*----------------------------------------------------------------------------*/
 #if defined(aix)
     /**
@@ -139,6 +194,17 @@ namespace SCXSystemLib
         return m_procNumber;
     }
 
+    /*----------------------------------------------------------------------------*/
+    /**
+        Get what the instance aggregates
+
+        Retval:      eCPUGroupingProcessor for a single processor
+    */
+    CPUGrouping CPUInstance::GetGrouping() const
+    {
+        return m_grouping;
+    }
+
     /*----------------------------------------------------------------------------*/
     /**
         Get processor time
@@ -266,6 +332,46 @@ namespace SCXSystemLib
 #endif
     }
 
+    /*----------------------------------------------------------------------------*/
+    /**
+        Get processor steal time
+
+        Parameters:  stealTime - RETURN: time the hypervisor ran other virtual
+                                 processors while this one wanted to run
+
+        Retval:      true if a value is supported by this implementation
+    */
+    bool CPUInstance::GetStealTime(scxulong& stealTime) const
+    {
+#if defined(linux)
+        stealTime = m_stealTime;
+        return true;
+#else
+        stealTime = stealTime;
+        return false;
+#endif
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+        Get processor guest time
+
+        Parameters:  guestTime - RETURN: time spent running virtual processors
+                                 of guests hosted on this system
+
+        Retval:      true if a value is supported by this implementation
+    */
+    bool CPUInstance::GetGuestTime(scxulong& guestTime) const
+    {
+#if defined(linux)
+        guestTime = m_guestTime;
+        return true;
+#else
+        guestTime = guestTime;
+        return false;
+#endif
+    }
+
     /*----------------------------------------------------------------------------*/
     /**
         Get processor queue length
@@ -303,6 +409,8 @@ namespace SCXSystemLib
         scxulong iowait_delta_tics = m_IOWaitTime_tics.GetDelta(MAX_CPUINSTANCE_DATASAMPER_SAMPLES);
         scxulong irq_delta_tics = m_IRQTime_tics.GetDelta(MAX_CPUINSTANCE_DATASAMPER_SAMPLES);
         scxulong softirq_delta_tics = m_SoftIRQTime_tics.GetDelta(MAX_CPUINSTANCE_DATASAMPER_SAMPLES);
+        scxulong steal_delta_tics = m_StealTime_tics.GetDelta(MAX_CPUINSTANCE_DATASAMPER_SAMPLES);
+        scxulong guest_delta_tics = m_GuestTime_tics.GetDelta(MAX_CPUINSTANCE_DATASAMPER_SAMPLES);
 
         SCX_LOGHYSTERICAL(m_log, StrAppend(L"    total count = ", m_Total_tics.GetNumberOfSamples()));
         SCX_LOGHYSTERICAL(m_log, StrAppend(L"    total delta = ", total_delta_tics));
@@ -313,8 +421,11 @@ namespace SCXSystemLib
         SCX_LOGHYSTERICAL(m_log, StrAppend(L"    iowait delta = ", iowait_delta_tics));
         SCX_LOGHYSTERICAL(m_log, StrAppend(L"    irq delta = ", irq_delta_tics));
         SCX_LOGHYSTERICAL(m_log, StrAppend(L"    softirq delta = ", softirq_delta_tics));
+        SCX_LOGHYSTERICAL(m_log, StrAppend(L"    steal delta = ", steal_delta_tics));
+        SCX_LOGHYSTERICAL(m_log, StrAppend(L"    guest delta = ", guest_delta_tics));
 
-        m_processorTime = GetPercentageSafe(idle_delta_tics,   total_delta_tics, true);
+        // Stolen time is neither idle nor spent executing on our behalf
+        m_processorTime = GetPercentageSafe(idle_delta_tics + steal_delta_tics, total_delta_tics, true);
         m_idleTime      = GetPercentageSafe(idle_delta_tics,   total_delta_tics);
         m_userTime      = GetPercentageSafe(user_delta_tics,   total_delta_tics);
         m_niceTime      = GetPercentageSafe(nice_delta_tics,   total_delta_tics);
@@ -322,6 +433,8 @@ namespace SCXSystemLib
         m_iowaitTime    = GetPercentageSafe(iowait_delta_tics, total_delta_tics);
         m_interruptTime = GetPercentageSafe(irq_delta_tics,    total_delta_tics);
         m_dpcTime       = GetPercentageSafe(softirq_delta_tics,total_delta_tics);
+        m_stealTime     = GetPercentageSafe(steal_delta_tics,  total_delta_tics);
+        m_guestTime     = GetPercentageSafe(guest_delta_tics,  total_delta_tics);
 
 #elif defined(aix)
 
@@ -0,0 +1,190 @@
+/*--------------------------------------------------------------------------------
+  Copyright (c) Microsoft Corporation.  All rights reserved.
+
+*/
+/**
+   \file
+
+   \brief       PAL representation of the system wide scheduler counters
+
+   \date        2026-10-18 14:00:00
+*/
+/*----------------------------------------------------------------------------*/
+
+#include <scxcorelib/scxcmn.h>
+#include <scxcorelib/stringaid.h>
+
+#include <scxsystemlib/schedulerinstance.h>
+
+using namespace std;
+using namespace SCXCoreLib;
+
+namespace SCXSystemLib
+{
+    /*----------------------------------------------------------------------------*/
+    /**
+        Constructor
+    */
+    SchedulerInstance::SchedulerInstance() : EntityInstance(true),
+        m_contextSwitchesPerSecond(0),
+        m_interruptsPerSecond(0),
+        m_processesCreatedPerSecond(0),
+        m_runQueueLength(0),
+        m_blockedQueueLength(0)
+    {
+        m_log = SCXLogHandleFactory::GetLogHandle(L"scx.core.common.pal.system.cpu.schedulerinstance");
+        SetId(L"_Total");
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+        Destructor
+    */
+    SchedulerInstance::~SchedulerInstance()
+    {
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+        Stores a new sample of the counters.
+
+        \param[in] timeMsec          Monotonic time of sample, in milliseconds
+        \param[in] contextSwitches   Value of the ctxt counter
+        \param[in] interrupts        Value of the intr counter
+        \param[in] processesCreated  Value of the processes counter
+        \param[in] running           Value of procs_running
+        \param[in] blocked           Value of procs_blocked
+
+        Called by CPUEnumeration from the sampler thread.
+    */
+    void SchedulerInstance::AddSample(scxulong timeMsec, scxulong contextSwitches, scxulong interrupts,
+                                      scxulong processesCreated, scxulong running, scxulong blocked)
+    {
+        m_Time_msec.AddSample(timeMsec);
+        m_ContextSwitches.AddSample(contextSwitches);
+        m_Interrupts.AddSample(interrupts);
+        m_ProcessesCreated.AddSample(processesCreated);
+        m_runQueueLength = running;
+        m_blockedQueueLength = blocked;
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+        Calculates the per second rate of a counter over the sampled window.
+
+        \param[in] counter      Samples of the counter
+        \param[in] elapsedMsec  Time covered by the samples, in milliseconds
+        \returns                Rate per second, or 0 if it cannot be computed
+    */
+    scxulong SchedulerInstance::GetRate(const SchedulerDataSampler& counter, scxulong elapsedMsec) const
+    {
+        if (0 == elapsedMsec || counter.GetNumberOfSamples() < 2 || counter[0] < counter[counter.GetNumberOfSamples() - 1])
+        {
+            // Too few samples, or the counter was reset
+            return 0;
+        }
+        return counter.GetDelta(MAX_CPUINSTANCE_DATASAMPER_SAMPLES) * 1000 / elapsedMsec;
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+        Update values
+    */
+    void SchedulerInstance::Update()
+    {
+        scxulong elapsed = m_Time_msec.GetDelta(MAX_CPUINSTANCE_DATASAMPER_SAMPLES);
+
+        SCX_LOGHYSTERICAL(m_log, StrAppend(L"SchedulerInstance::Update() - elapsed msec = ", elapsed));
+
+        m_contextSwitchesPerSecond  = GetRate(m_ContextSwitches, elapsed);
+        m_interruptsPerSecond       = GetRate(m_Interrupts, elapsed);
+        m_processesCreatedPerSecond = GetRate(m_ProcessesCreated, elapsed);
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+        Get context switches per second
+
+        \param[out]  rate  Context switches per second over the sampled window
+        \returns     true if a value is supported by this implementation
+    */
+    bool SchedulerInstance::GetContextSwitchesPerSecond(scxulong& rate) const
+    {
+        rate = m_contextSwitchesPerSecond;
+#if defined(linux)
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+        Get interrupts per second
+
+        \param[out]  rate  Interrupts serviced per second over the sampled window
+        \returns     true if a value is supported by this implementation
+    */
+    bool SchedulerInstance::GetInterruptsPerSecond(scxulong& rate) const
+    {
+        rate = m_interruptsPerSecond;
+#if defined(linux)
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+        Get processes created per second
+
+        \param[out]  rate  Processes and threads created (forks) per second over the sampled window
+        \returns     true if a value is supported by this implementation
+    */
+    bool SchedulerInstance::GetProcessesCreatedPerSecond(scxulong& rate) const
+    {
+        rate = m_processesCreatedPerSecond;
+#if defined(linux)
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+        Get run queue length
+
+        \param[out]  length  Number of runnable threads at the latest sample
+        \returns     true if a value is supported by this implementation
+    */
+    bool SchedulerInstance::GetRunQueueLength(scxulong& length) const
+    {
+        length = m_runQueueLength;
+#if defined(linux)
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+        Get blocked queue length
+
+        \param[out]  length  Number of threads blocked waiting for IO at the latest sample
+        \returns     true if a value is supported by this implementation
+    */
+    bool SchedulerInstance::GetBlockedQueueLength(scxulong& length) const
+    {
+        length = m_blockedQueueLength;
+#if defined(linux)
+        return true;
+#else
+        return false;
+#endif
+    }
+}
+
+/*----------------------------E-N-D---O-F---F-I-L-E---------------------------*/
@@ -0,0 +1,477 @@
+/*--------------------------------------------------------------------------------
+    Copyright (c) Microsoft Corporation.  All rights reserved.
+
+*/
+/**
+    \file
+
+    \brief       Inventory of the block devices of /sys/block and what they are built on
+
+    \date        2026-10-18 20:00:00
+
+*/
+/*----------------------------------------------------------------------------*/
+
+#include <scxcorelib/scxcmn.h>
+#include <scxcorelib/stringaid.h>
+#include <scxsystemlib/blockdevicetopology.h>
+
+#include <algorithm>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+using namespace std;
+using namespace SCXCoreLib;
+
+namespace
+{
+    /** sysfs attributes read by the graph are small; anything larger is truncated. */
+    const size_t BLOCKDEVICE_MAX_FILE_SIZE = 4096;
+
+    /**
+       Orders signature entries by kernel name.
+    */
+    template <class T>
+    struct ByName
+    {
+        /**
+           Compares two entries.
+           \param[in] a First entry
+           \param[in] b Second entry
+           \returns   true if a sorts before b
+        */
+        bool operator()(const T& a, const T& b) const
+        {
+            return a.name < b.name;
+        }
+    };
+
+    /**
+       Strips trailing white space, as sysfs attributes end with a newline.
+
+       \param[in,out] s String to strip
+    */
+    void StripTrailing(std::string& s)
+    {
+        size_t end = s.find_last_not_of(" \t\n");
+        s.erase((string::npos == end) ? 0 : end + 1);
+    }
+}
+
+namespace SCXSystemLib
+{
+    /*----------------------------------------------------------------------------*/
+    /**
+       Gets the directory holding the block devices.
+
+       \returns Path without trailing slash
+    */
+    const std::string& BlockDeviceTopologyDependencies::GetRoot() const
+    {
+        return m_root;
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Lists the entries of a directory. The block devices of /sys/block are
+       symbolic links, so entries of any type are listed.
+
+       \param[in]  path  Absolute path of the directory
+       \param[out] names Names (not paths) of the entries
+       \returns    false if the directory could not be opened
+    */
+    bool BlockDeviceTopologyDependencies::ListEntries(const std::string& path, std::vector<std::string>& names) const
+    {
+        names.clear();
+        DIR* dir = opendir(path.c_str());
+        if (NULL == dir)
+        {
+            return false;
+        }
+
+        struct dirent* entry;
+        while ((entry = readdir(dir)) != NULL)
+        {
+            if ('.' != entry->d_name[0])
+            {
+                names.push_back(entry->d_name);
+            }
+        }
+        closedir(dir);
+        return true;
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Reads a sysfs attribute.
+
+       \param[in]  path    Absolute path of the file
+       \param[out] content Contents of the file
+       \returns    false if the file could not be read
+    */
+    bool BlockDeviceTopologyDependencies::ReadFile(const std::string& path, std::string& content) const
+    {
+        content.clear();
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            return false;
+        }
+
+        char buf[512];
+        ssize_t r;
+        while ((r = read(fd, buf, sizeof(buf))) > 0 && content.size() < BLOCKDEVICE_MAX_FILE_SIZE)
+        {
+            content.append(buf, static_cast<size_t>(r));
+        }
+        close(fd);
+        return r >= 0;
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Gets the time used to rate limit refreshes.
+
+       \returns Seconds of CLOCK_MONOTONIC, which does not move with the wall clock
+    */
+    time_t BlockDeviceTopologyDependencies::GetMonotonicTime() const
+    {
+        struct timespec ts;
+        if (0 != clock_gettime(CLOCK_MONOTONIC, &ts))
+        {
+            return 0;
+        }
+        return ts.tv_sec;
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Constructor
+
+       \param[in] deps Dependencies for reading sysfs
+    */
+    BlockDeviceTopology::BlockDeviceTopology(SCXCoreLib::SCXHandle<BlockDeviceTopologyDependencies> deps) :
+        m_deps(deps),
+        m_lock(ThreadLockHandleGet()),
+        m_generation(0),
+        m_lastRefresh(0)
+    {
+        m_log = SCXLogHandleFactory::GetLogHandle(L"scx.core.common.pal.system.disk.blockdevicetopology");
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Gets the graph shared by the disk enumerations.
+
+       \returns The shared graph
+    */
+    BlockDeviceTopology& BlockDeviceTopology::GetShared()
+    {
+        static BlockDeviceTopology s_topology;
+        return s_topology;
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Rebuilds the graph if the entries of /sys/block have changed. Calls
+       within BLOCKDEVICE_REFRESH_INTERVAL seconds of the previous read keep
+       the graph as it is without looking at /sys/block.
+
+       \returns true if the graph was rebuilt
+    */
+    bool BlockDeviceTopology::Refresh()
+    {
+        SCXThreadLock lock(m_lock);
+
+        time_t now = m_deps->GetMonotonicTime();
+        if (0 != m_generation && now >= m_lastRefresh && now - m_lastRefresh < BLOCKDEVICE_REFRESH_INTERVAL)
+        {
+            return false;
+        }
+        m_lastRefresh = now;
+
+        std::vector<Signature> signature;
+        ReadSignature(signature);
+        if (signature == m_signature && 0 != m_generation)
+        {
+            return false;
+        }
+
+        Rebuild(signature);
+        m_signature.swap(signature);
+        m_generation++;
+        SCX_LOGTRACE(m_log, StrAppend(StrAppend(L"Block device topology rebuilt, devices: ", m_nodes.size()) + L", generation: ", m_generation));
+        return true;
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Gets the number of times the graph was built.
+
+       \returns Generation, which changes whenever the graph does
+    */
+    unsigned int BlockDeviceTopology::GetGeneration() const
+    {
+        SCXThreadLock lock(m_lock);
+        return m_generation;
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Finds a device mapper device by its dm name, the name it has in /dev/mapper.
+
+       \param[in]  dmName Device mapper name, for example vg00-lvol1
+       \param[out] name   Kernel name, for example dm-3
+       \returns    false if there is no such device
+    */
+    bool BlockDeviceTopology::FindDeviceMapperDevice(const std::string& dmName, std::string& name) const
+    {
+        SCXThreadLock lock(m_lock);
+
+        std::map<std::string, std::string>::const_iterator it = m_dmNames.find(dmName);
+        if (m_dmNames.end() == it)
+        {
+            return false;
+        }
+        name = it->second;
+        return true;
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Gets the disks a device is built on. A partition is replaced by its
+       disk, and device mapper and md devices by the disks of the devices
+       they are built on, down to disks that are built on nothing.
+
+       \param[in]  name  Kernel name of a device or partition, for example dm-3 or sda1
+       \param[out] disks Kernel names of the disks, each once
+       \returns    false if the device is not in the graph
+    */
+    bool BlockDeviceTopology::GetPhysicalDisks(const std::string& name, std::vector<std::string>& disks) const
+    {
+        SCXThreadLock lock(m_lock);
+
+        disks.clear();
+        if (m_nodes.end() == m_nodes.find(name) && m_partitions.end() == m_partitions.find(name))
+        {
+            return false;
+        }
+        AddPhysicalDisks(name, 0, disks);
+        return ! disks.empty();
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Gets a device of /sys/block with its attributes.
+
+       \param[in]  name   Kernel name, for example sda
+       \param[out] device The device
+       \returns    false if the device is not in /sys/block
+    */
+    bool BlockDeviceTopology::GetBlockDevice(const std::string& name, BlockDevice& device) const
+    {
+        SCXThreadLock lock(m_lock);
+
+        std::map<std::string, BlockDevice>::const_iterator it = m_nodes.find(name);
+        if (m_nodes.end() == it)
+        {
+            return false;
+        }
+        device = it->second;
+        return true;
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Parses a sysfs dev attribute.
+
+       \param[in]  content Contents of the attribute, "<major>:<minor>"
+       \param[out] major   Device major ID number
+       \param[out] minor   Device minor ID number
+       \returns    false if the contents could not be parsed
+    */
+    bool BlockDeviceTopology::ParseDeviceNumber(const std::string& content, unsigned int& major, unsigned int& minor)
+    {
+        const char* p = content.c_str();
+        char* end = NULL;
+        unsigned long value = strtoul(p, &end, 10);
+        if (end == p || ':' != *end)
+        {
+            return false;
+        }
+        major = static_cast<unsigned int>(value);
+
+        p = end + 1;
+        value = strtoul(p, &end, 10);
+        if (end == p)
+        {
+            return false;
+        }
+        minor = static_cast<unsigned int>(value);
+        return true;
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Lists /sys/block with the device number of every entry.
+
+       \param[out] signature Entries sorted by name; empty if /sys/block can not be read
+    */
+    void BlockDeviceTopology::ReadSignature(std::vector<Signature>& signature) const
+    {
+        const std::string& root = m_deps->GetRoot();
+        std::vector<std::string> names;
+        if ( ! m_deps->ListEntries(root, names))
+        {
+            SCX_LOGHYSTERICAL(m_log, L"Unable to list " + StrFromMultibyte(root));
+            return;
+        }
+
+        signature.reserve(names.size());
+        std::string content;
+        for (size_t i = 0; i < names.size(); i++)
+        {
+            Signature entry;
+            entry.name = names[i];
+            if ( ! m_deps->ReadFile(root + "/" + names[i] + "/dev", content) ||
+                 ! ParseDeviceNumber(content, entry.major, entry.minor))
+            {
+                continue;
+            }
+            signature.push_back(entry);
+        }
+        std::sort(signature.begin(), signature.end(), ByName<Signature>());
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Builds the graph from the entries of /sys/block.
+
+       \param[in] signature Entries of /sys/block
+    */
+    void BlockDeviceTopology::Rebuild(const std::vector<Signature>& signature)
+    {
+        m_nodes.clear();
+        m_partitions.clear();
+        m_dmNames.clear();
+
+        const std::string& root = m_deps->GetRoot();
+        std::vector<std::string> entries;
+        std::string content;
+        for (size_t i = 0; i < signature.size(); i++)
+        {
+            const std::string& name = signature[i].name;
+            const std::string dir = root + "/" + name;
+
+            BlockDevice& node = m_nodes[name];
+            node.major = signature[i].major;
+            node.minor = signature[i].minor;
+            m_deps->ListEntries(dir + "/slaves", node.slaves);
+            m_deps->ListEntries(dir + "/holders", node.holders);
+            ReadAttributes(dir, node);
+
+            if (m_deps->ReadFile(dir + "/dm/name", content))
+            {
+                StripTrailing(content);
+                if ( ! content.empty())
+                {
+                    m_dmNames[content] = name;
+                }
+            }
+
+            // Partitions are the sub directories named after the disk that
+            // have a partition attribute
+            if (m_deps->ListEntries(dir, entries))
+            {
+                for (size_t j = 0; j < entries.size(); j++)
+                {
+                    if (entries[j].size() > name.size() &&
+                        0 == entries[j].compare(0, name.size(), name) &&
+                        m_deps->ReadFile(dir + "/" + entries[j] + "/partition", content))
+                    {
+                        m_partitions[entries[j]] = name;
+                    }
+                }
+            }
+        }
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Reads the attributes of a device. Attributes a device does not have
+       keep their defaults; device/model and device/vendor are only there
+       for devices with a driver that reports them (SCSI, SATA, NVMe,
+       virtio has neither).
+
+       \param[in]     dir    Directory of the device in /sys/block
+       \param[in,out] device Device to fill in
+    */
+    void BlockDeviceTopology::ReadAttributes(const std::string& dir, BlockDevice& device) const
+    {
+        std::string content;
+        if (m_deps->ReadFile(dir + "/size", content))
+        {
+            device.sizeSectors = strtoull(content.c_str(), NULL, 10);
+        }
+        if (m_deps->ReadFile(dir + "/removable", content) && ! content.empty())
+        {
+            device.removable = ('1' == content[0]);
+        }
+        if (m_deps->ReadFile(dir + "/queue/rotational", content) && ! content.empty())
+        {
+            device.hasRotational = true;
+            device.rotational = ('1' == content[0]);
+        }
+        if (m_deps->ReadFile(dir + "/queue/logical_block_size", content))
+        {
+            device.logicalBlockSize = static_cast<unsigned int>(strtoul(content.c_str(), NULL, 10));
+        }
+        if (m_deps->ReadFile(dir + "/device/model", content))
+        {
+            StripTrailing(content);
+            device.model = content;
+        }
+        if (m_deps->ReadFile(dir + "/device/vendor", content))
+        {
+            StripTrailing(content);
+            device.vendor = content;
+        }
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Adds the disks a device is built on, see GetPhysicalDisks().
+
+       \param[in]     name  Kernel name of a device or partition
+       \param[in]     depth Number of layers above the device
+       \param[in,out] disks Disks found so far
+    */
+    void BlockDeviceTopology::AddPhysicalDisks(const std::string& name, unsigned int depth, std::vector<std::string>& disks) const
+    {
+        std::map<std::string, std::string>::const_iterator partition = m_partitions.find(name);
+        const std::string& device = (m_partitions.end() == partition) ? name : partition->second;
+
+        std::map<std::string, BlockDevice>::const_iterator node = m_nodes.find(device);
+        if (m_nodes.end() == node || node->second.slaves.empty() || depth >= BLOCKDEVICE_MAX_DEPTH)
+        {
+            // A slave that is in neither /sys/block nor a known partition is
+            // still a device; it is taken as it is
+            if (disks.end() == std::find(disks.begin(), disks.end(), device))
+            {
+                disks.push_back(device);
+            }
+            return;
+        }
+
+        for (size_t i = 0; i < node->second.slaves.size(); i++)
+        {
+            AddPhysicalDisks(node->second.slaves[i], depth + 1, disks);
+        }
+    }
+}
+
+/*----------------------------E-N-D---O-F---F-I-L-E---------------------------*/
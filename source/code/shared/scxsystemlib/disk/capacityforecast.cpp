@@ -0,0 +1,183 @@
+/*--------------------------------------------------------------------------------
+    Copyright (c) Microsoft Corporation.  All rights reserved.
+
+*/
+/**
+    \file
+
+    \brief       Usage history and time to full estimate of a file system
+
+    \date        2026-10-18 21:00:00
+
+*/
+/*----------------------------------------------------------------------------*/
+
+#include <scxcorelib/scxcmn.h>
+#include <scxsystemlib/capacityforecast.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace SCXSystemLib
+{
+    /*----------------------------------------------------------------------------*/
+    /**
+       Constructor
+    */
+    CapacityForecast::CapacityForecast()
+    {
+        Reset();
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Drops the history.
+    */
+    void CapacityForecast::Reset()
+    {
+        m_count = 0;
+        m_next = 0;
+        m_hour = 0;
+        m_sum = 0;
+        m_samples = 0;
+        m_mbFree = 0;
+        m_hasTrend = false;
+        m_slope = 0;
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Adds a sample of the space of the file system.
+
+       \param[in] now    Time of the sample
+       \param[in] mbUsed Used space in MB
+       \param[in] mbFree Space available to unprivileged users in MB
+
+       A sample stamped before the hour being sampled, as after the clock is
+       set back, is folded into that hour so the history is kept.
+    */
+    void CapacityForecast::AddSample(time_t now, scxulong mbUsed, scxulong mbFree)
+    {
+        scxulong hour = static_cast<scxulong>(now) / CAPACITY_FORECAST_BUCKET_SECONDS;
+        if (hour < m_hour)
+        {
+            hour = m_hour;
+        }
+        else if (hour != m_hour && m_samples > 0)
+        {
+            CloseBucket();
+        }
+
+        m_hour = hour;
+        m_sum += static_cast<double>(mbUsed);
+        m_samples++;
+        m_mbFree = mbFree;
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Gets the growth of the used space.
+
+       \param[out] mbPerHour Growth in MB per hour, negative if the usage shrinks
+       \returns    false until CAPACITY_FORECAST_MIN_BUCKETS hours are sampled
+    */
+    bool CapacityForecast::GetGrowthRate(double& mbPerHour) const
+    {
+        mbPerHour = m_slope;
+        return m_hasTrend;
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Gets the time until the file system is full at the current growth.
+
+       \param[out] seconds Seconds until the latest free space is used up
+       \returns    false if there is no trend or the usage does not grow
+    */
+    bool CapacityForecast::GetTimeToFull(scxulong& seconds) const
+    {
+        seconds = 0;
+        if ( ! m_hasTrend || m_slope <= 0)
+        {
+            return false;
+        }
+
+        seconds = static_cast<scxulong>(static_cast<double>(m_mbFree) / m_slope * CAPACITY_FORECAST_BUCKET_SECONDS);
+        return true;
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Gets the number of closed hours in the history.
+
+       \returns Number of hours, at most CAPACITY_FORECAST_BUCKETS
+    */
+    size_t CapacityForecast::GetBucketCount() const
+    {
+        return m_count;
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Moves the hour being sampled into the ring and fits the trend again.
+    */
+    void CapacityForecast::CloseBucket()
+    {
+        Bucket& bucket = m_buckets[m_next];
+        bucket.hour = m_hour;
+        bucket.mbUsed = m_sum / m_samples;
+        m_next = (m_next + 1) % CAPACITY_FORECAST_BUCKETS;
+        if (m_count < CAPACITY_FORECAST_BUCKETS)
+        {
+            m_count++;
+        }
+
+        m_sum = 0;
+        m_samples = 0;
+        Fit();
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Fits the Theil-Sen slope to the closed hours. With a full ring that is
+       the median of some 14000 slopes, once per hour.
+    */
+    void CapacityForecast::Fit()
+    {
+        m_hasTrend = false;
+        if (m_count < CAPACITY_FORECAST_MIN_BUCKETS)
+        {
+            return;
+        }
+
+        std::vector<double> slopes;
+        slopes.reserve(m_count * (m_count - 1) / 2);
+        for (size_t i = 0; i < m_count; i++)
+        {
+            for (size_t j = i + 1; j < m_count; j++)
+            {
+                const Bucket& a = m_buckets[i];
+                const Bucket& b = m_buckets[j];
+                if (a.hour != b.hour)
+                {
+                    slopes.push_back((b.mbUsed - a.mbUsed) / (static_cast<double>(b.hour) - static_cast<double>(a.hour)));
+                }
+            }
+        }
+        if (slopes.empty())
+        {
+            return;
+        }
+
+        std::vector<double>::iterator middle = slopes.begin() + slopes.size() / 2;
+        std::nth_element(slopes.begin(), middle, slopes.end());
+        m_slope = *middle;
+        if (0 == slopes.size() % 2)
+        {
+            m_slope = (m_slope + *std::max_element(slopes.begin(), middle)) / 2;
+        }
+        m_hasTrend = true;
+    }
+}
+
+/*----------------------------E-N-D---O-F---F-I-L-E---------------------------*/
@@ -14,6 +14,7 @@
 
 #include <scxcorelib/scxcmn.h>
 #include <scxcorelib/scxdirectoryinfo.h>
+#include <scxcorelib/scxexception.h>
 #include <scxcorelib/scxfile.h>
 #include <scxcorelib/stringaid.h>
 
@@ -24,9 +25,64 @@
 #include <sys/vmount.h>
 #include <vector>
 #elif defined(linux)
+#include <scxsystemlib/blockdevicetopology.h>
 #include <scxsystemlib/scxlvmutils.h>
 #endif
 
+#include <algorithm>
+
+#include <errno.h>
+#include <string.h>
+#if defined(linux)
+#include <poll.h>
+#endif
+
+namespace
+{
+    /** Initial size of the buffers /proc/diskstats and /proc/self/mountinfo are read into. */
+    const size_t PROC_INITIAL_BUFFER_SIZE = 16384;
+
+    /** Number of counter fields of /proc/diskstats that are kept. */
+    const size_t PROC_DISKSTATS_MAX_FIELDS = 11;
+
+    /**
+       Hashes a device number for the /proc/diskstats index.
+
+       \param[in] major Device major ID number
+       \param[in] minor Device minor ID number
+       \returns   Hash value
+    */
+    inline size_t HashDeviceNumber(unsigned int major, unsigned int minor)
+    {
+        unsigned int h = (major * 2654435761u) ^ (minor * 40503u);
+        return static_cast<size_t>(h ^ (h >> 15));
+    }
+
+    /**
+       Compares two parsed mount tabs.
+
+       \param[in] a First mount tab
+       \param[in] b Second mount tab
+       \returns   true if both have the same entries in the same order
+    */
+    bool SameMntTab(const std::vector<SCXSystemLib::MntTabEntry>& a, const std::vector<SCXSystemLib::MntTabEntry>& b)
+    {
+        if (a.size() != b.size())
+        {
+            return false;
+        }
+        for (size_t i = 0; i < a.size(); i++)
+        {
+            if (a[i].device != b[i].device || a[i].mountPoint != b[i].mountPoint ||
+                a[i].fileSystem != b[i].fileSystem || a[i].devAttribute != b[i].devAttribute)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
 namespace SCXSystemLib
 {
     const scxlong DiskDepend::s_cINVALID_INSTANCE = -1;
@@ -38,7 +94,12 @@ namespace SCXSystemLib
     DiskDependDefault::DiskDependDefault(const SCXCoreLib::SCXLogHandle& log):
         m_log(log),
         m_pLvmTab(0),
-        m_pRaid(0)
+        m_pRaid(0),
+        m_MntTabGeneration(0),
+        m_MountInfoFd(-1),
+        m_MountInfoUnavailable(false),
+        m_ProcDiskStatsFd(-1),
+        m_ProcDiskStatsCount(0)
     {
         InitializeObject();
     }
@@ -50,7 +111,12 @@ namespace SCXSystemLib
     DiskDependDefault::DiskDependDefault():
         m_log(SCXCoreLib::SCXLogHandleFactory::GetLogHandle(L"scx.core.common.pal.system.disk.diskdepend")),
         m_pLvmTab(0),
-        m_pRaid(0)
+        m_pRaid(0),
+        m_MntTabGeneration(0),
+        m_MountInfoFd(-1),
+        m_MountInfoUnavailable(false),
+        m_ProcDiskStatsFd(-1),
+        m_ProcDiskStatsCount(0)
     {
         InitializeObject();
     }
@@ -65,6 +131,7 @@ namespace SCXSystemLib
 #elif defined(linux)
         m_ProcDiskStatsPath.Set(L"/proc/diskstats");
         m_MntTabPath.Set(L"/etc/mtab");
+        m_MountInfoPath.Set(L"/proc/self/mountinfo");
 #elif defined(sun) || defined(hpux)
         m_MntTabPath.Set(L"/etc/mnttab");
 #else
@@ -153,6 +220,14 @@ namespace SCXSystemLib
     */
     DiskDependDefault::~DiskDependDefault()
     {
+        if (m_ProcDiskStatsFd >= 0)
+        {
+            ::close(m_ProcDiskStatsFd);
+        }
+        if (m_MountInfoFd >= 0)
+        {
+            ::close(m_MountInfoFd);
+        }
     }
 
 
@@ -180,41 +255,246 @@ namespace SCXSystemLib
     */
     void DiskDependDefault::RefreshProcDiskStats()
     {
-        m_ProcDiskStats.clear();
+        m_ProcDiskStatsCount = 0;
 
-        SCXCoreLib::SCXHandle<std::wfstream> fsDiskStats(SCXCoreLib::SCXFile::OpenWFstream(LocateProcDiskStats(), std::ios::in));
-        fsDiskStats.SetOwner();
-        std::wstring line;
-        while ( ! fsDiskStats->eof() && fsDiskStats->is_open())
+        if (m_ProcDiskStatsFd < 0)
         {
-            getline(*fsDiskStats, line);
-            std::vector<std::wstring> parts;
-            SCXCoreLib::StrTokenize(line, parts, L" \n\t");
-            if (parts.size() < 3)
+            m_ProcDiskStatsFd = ::open(SCXCoreLib::StrToMultibyte(LocateProcDiskStats().Get()).c_str(), O_RDONLY);
+            if (m_ProcDiskStatsFd < 0)
+            {
+                throw SCXCoreLib::SCXErrnoException(L"open", errno, SCXSRCLOCATION);
+            }
+        }
+        size_t len = ReadWholeFile(m_ProcDiskStatsFd, m_ProcDiskStatsBuffer);
+
+        const char* p = &m_ProcDiskStatsBuffer[0];
+        m_ProcDiskStatsCount = ParseProcDiskStats(p, p + len, m_ProcDiskStats);
+
+        // Rebuild the index with at most half of the slots in use
+        size_t slots = 16;
+        while (slots < 2 * m_ProcDiskStatsCount)
+        {
+            slots *= 2;
+        }
+        m_ProcDiskStatsIndex.assign(slots, 0);
+        for (size_t i = 0; i < m_ProcDiskStatsCount; i++)
+        {
+            size_t slot = HashDeviceNumber(m_ProcDiskStats[i].major, m_ProcDiskStats[i].minor) & (slots - 1);
+            while (0 != m_ProcDiskStatsIndex[slot])
+            {
+                slot = (slot + 1) & (slots - 1);
+            }
+            m_ProcDiskStatsIndex[slot] = i + 1;
+        }
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Parse the contents of /proc/diskstats.
+
+       Lines with fewer than four counter fields are skipped, as are
+       fields past the eleventh.
+
+       \param[in]     p    Start of the contents.
+       \param[in]     end  End of the contents.
+       \param[in,out] rows Parsed rows. Entries are reused, entries past the returned count are stale.
+       \returns       Number of rows parsed.
+    */
+    size_t DiskDependDefault::ParseProcDiskStats(const char* p, const char* end, std::vector<ProcDiskStats>& rows)
+    {
+        size_t count = 0;
+        scxulong fields[PROC_DISKSTATS_MAX_FIELDS];
+
+        while (p < end)
+        {
+            const char* eol = static_cast<const char*>(memchr(p, '\n', static_cast<size_t>(end - p)));
+            if (NULL == eol)
+            {
+                eol = end;
+            }
+
+            // major minor name field...
+            scxulong major = 0;
+            scxulong minor = 0;
+            const char* name = NULL;
+            size_t nameLen = 0;
+            size_t fieldCount = 0;
+            size_t column = 0;
+            for (const char* q = p; q < eol; )
+            {
+                if (' ' == *q || '\t' == *q)
+                {
+                    q++;
+                    continue;
+                }
+                const char* word = q;
+                while (q < eol && ' ' != *q && '\t' != *q)
+                {
+                    q++;
+                }
+                if (2 == column)
+                {
+                    name = word;
+                    nameLen = static_cast<size_t>(q - word);
+                }
+                else
+                {
+                    scxulong value = 0;
+                    for (const char* d = word; d < q && *d >= '0' && *d <= '9'; d++)
+                    {
+                        value = value * 10 + static_cast<scxulong>(*d - '0');
+                    }
+                    if (0 == column)
+                    {
+                        major = value;
+                    }
+                    else if (1 == column)
+                    {
+                        minor = value;
+                    }
+                    else
+                    {
+                        if (fieldCount < PROC_DISKSTATS_MAX_FIELDS)
+                        {
+                            fields[fieldCount] = value;
+                        }
+                        fieldCount++;
+                    }
+                }
+                column++;
+            }
+            p = eol + 1;
+
+            if (fieldCount < 4)
             {
                 continue;
             }
-            m_ProcDiskStats[parts[2]] = parts;
+
+            if (count == rows.size())
+            {
+                rows.push_back(ProcDiskStats());
+            }
+            ProcDiskStats& row = rows[count++];
+            row.major = static_cast<unsigned int>(major);
+            row.minor = static_cast<unsigned int>(minor);
+            row.name.assign(name, nameLen);
+            row.fieldCount = fieldCount;
+            if (fieldCount < PROC_DISKSTATS_MAX_FIELDS)
+            {
+                // Partition on a kernel before 2.6.25
+                row.readsCompleted = fields[0];
+                row.readsMerged = 0;
+                row.sectorsRead = fields[1];
+                row.msReading = 0;
+                row.writesCompleted = fields[2];
+                row.writesMerged = 0;
+                row.sectorsWritten = fields[3];
+                row.msWriting = 0;
+                row.ioInProgress = 0;
+                row.msIO = 0;
+                row.weightedMsIO = 0;
+            }
+            else
+            {
+                row.readsCompleted = fields[0];
+                row.readsMerged = fields[1];
+                row.sectorsRead = fields[2];
+                row.msReading = fields[3];
+                row.writesCompleted = fields[4];
+                row.writesMerged = fields[5];
+                row.sectorsWritten = fields[6];
+                row.msWriting = fields[7];
+                row.ioInProgress = fields[8];
+                row.msIO = fields[9];
+                row.weightedMsIO = fields[10];
+            }
         }
-        fsDiskStats->close();
+        return count;
     }
 
     /*----------------------------------------------------------------------------*/
     /**
        \copydoc SCXSystemLib::DiskDepend::GetProcDiskStats
     */
-    const std::vector<std::wstring>& DiskDependDefault::GetProcDiskStats(const std::wstring& device)
+    const ProcDiskStats* DiskDependDefault::GetProcDiskStats(unsigned int major, unsigned int minor)
+    {
+        if (m_ProcDiskStatsIndex.empty())
+        {
+            return NULL;
+        }
+
+        size_t mask = m_ProcDiskStatsIndex.size() - 1;
+        for (size_t slot = HashDeviceNumber(major, minor) & mask; 0 != m_ProcDiskStatsIndex[slot]; slot = (slot + 1) & mask)
+        {
+            const ProcDiskStats& row = m_ProcDiskStats[m_ProcDiskStatsIndex[slot] - 1];
+            if (row.major == major && row.minor == minor)
+            {
+                return &row;
+            }
+        }
+        return NULL;
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       \copydoc SCXSystemLib::DiskDepend::FindProcDiskStats
+    */
+    const ProcDiskStats* DiskDependDefault::FindProcDiskStats(const std::wstring& device)
     {
         SCXCoreLib::SCXFilePath dev(device);
-        std::map<std::wstring, std::vector<std::wstring> >::const_iterator it =
-            m_ProcDiskStats.find(dev.GetFilename());
+        std::string name = SCXCoreLib::StrToMultibyte(dev.GetFilename());
+        for (size_t i = 0; i < m_ProcDiskStatsCount; i++)
+        {
+            if (m_ProcDiskStats[i].name == name)
+            {
+                return &m_ProcDiskStats[i];
+            }
+        }
+        return NULL;
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Read a /proc file from the start in one go.
 
-        if (it == m_ProcDiskStats.end())
+       \param[in]     fd     Open file.
+       \param[in,out] buffer Buffer to read into, grown until the file fits.
+       \returns       Number of bytes read.
+       \throws        SCXErrnoException if the file can not be read.
+    */
+    size_t DiskDependDefault::ReadWholeFile(int fd, std::vector<char>& buffer)
+    {
+        if (buffer.empty())
         {
-            static std::vector<std::wstring> empty;
-            return empty;
+            buffer.resize(PROC_INITIAL_BUFFER_SIZE);
+        }
+
+        for (;;)
+        {
+            size_t len = 0;
+            while (len < buffer.size())
+            {
+                ssize_t n = pread(fd, &buffer[len], buffer.size() - len, static_cast<off_t>(len));
+                if (n < 0)
+                {
+                    if (EINTR == errno)
+                    {
+                        continue;
+                    }
+                    throw SCXCoreLib::SCXErrnoException(L"pread", errno, SCXSRCLOCATION);
+                }
+                if (0 == n)
+                {
+                    break;
+                }
+                len += static_cast<size_t>(n);
+            }
+            if (len < buffer.size())
+            {
+                return len;
+            }
+            buffer.resize(buffer.size() * 2);
         }
-        return it->second;
     }
 
     /*----------------------------------------------------------------------------*/
@@ -274,10 +554,13 @@ namespace SCXSystemLib
     */
     void DiskDependDefault::RefreshMNTTab()
     {
-        if (0 < m_MntTab.size())
+#if defined(linux)
+        if (RefreshMountInfo())
         {
-            m_MntTab.clear();
+            return;
         }
+#endif
+        std::vector<MntTabEntry> mntTab;
 #if defined(aix)
         int needed = 0;
         // Get the number of bytes needed for all mntctl data.
@@ -305,7 +588,7 @@ namespace SCXSystemLib
                     entry.device = SCXCoreLib::StrFromMultibyte(device);
                     entry.mountPoint = SCXCoreLib::StrFromMultibyte(mountPoint);
                     entry.fileSystem = m_fsMap.find(fs)->second;
-                    m_MntTab.push_back(entry);
+                    mntTab.push_back(entry);
                 }
                 p += vmt->vmt_length;
             }
@@ -340,11 +623,153 @@ namespace SCXSystemLib
                         entry.devAttribute = entry.devAttribute.substr(0,entry.devAttribute.find_first_not_of(L"0123456789abcdef"));
                     }
                 }
-                m_MntTab.push_back(entry);
+                mntTab.push_back(entry);
             }
         }
         fs->close();
 #endif
+        if (0 == m_MntTabGeneration || ! SameMntTab(mntTab, m_MntTab))
+        {
+            m_MntTab.swap(mntTab);
+            m_MntTabGeneration++;
+        }
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       \copydoc SCXSystemLib::DiskDepend::GetMNTTabGeneration
+    */
+    unsigned int DiskDependDefault::GetMNTTabGeneration() const
+    {
+        return m_MntTabGeneration;
+    }
+
+#if defined(linux)
+    /*----------------------------------------------------------------------------*/
+    /**
+       Refresh the mount tab from /proc/self/mountinfo.
+
+       The kernel flags the open file with POLLPRI when the mount table of
+       the namespace changes, so the file is only read again after that.
+       Unlike /etc/mtab, mountinfo can not go stale.
+
+       \returns false if mountinfo is not available and the mount tab file is to be read instead.
+       \note Not thread safe.
+    */
+    bool DiskDependDefault::RefreshMountInfo()
+    {
+        if (m_MountInfoUnavailable)
+        {
+            return false;
+        }
+
+        if (m_MountInfoFd < 0)
+        {
+            m_MountInfoFd = ::open(SCXCoreLib::StrToMultibyte(m_MountInfoPath.Get()).c_str(), O_RDONLY);
+            if (m_MountInfoFd < 0)
+            {
+                SCX_LOGINFO(m_log, SCXCoreLib::StrAppend(L"Unable to open " + m_MountInfoPath.Get() + L", reading " + LocateMountTab().Get() + L" instead; errno = ", errno));
+                m_MountInfoUnavailable = true;
+                return false;
+            }
+        }
+        else
+        {
+            struct pollfd pfd;
+            pfd.fd = m_MountInfoFd;
+            pfd.events = POLLPRI;
+            pfd.revents = 0;
+            if (0 == poll(&pfd, 1, 0))
+            {
+                return true;
+            }
+        }
+
+        size_t len = ReadWholeFile(m_MountInfoFd, m_MountInfoBuffer);
+        const char* p = &m_MountInfoBuffer[0];
+        ParseMountInfo(p, p + len, m_MntTab);
+        m_MntTabGeneration++;
+        SCX_LOGTRACE(m_log, SCXCoreLib::StrAppend(L"Mount table read, entries: ", m_MntTab.size()));
+        return true;
+    }
+#endif
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Parse the contents of a mountinfo file.
+
+       A line is "id parent major:minor root mountpoint options [optional
+       fields] - fstype source superoptions". Octal escapes of the mount
+       point and source are decoded.
+
+       \param[in]  p       Start of the contents.
+       \param[in]  end     End of the contents.
+       \param[out] entries Mount tab entries, one per line.
+       \returns    Number of entries.
+    */
+    size_t DiskDependDefault::ParseMountInfo(const char* p, const char* end, std::vector<MntTabEntry>& entries)
+    {
+        entries.clear();
+
+        std::vector<std::string> words;
+        while (p < end)
+        {
+            const char* eol = static_cast<const char*>(memchr(p, '\n', static_cast<size_t>(end - p)));
+            if (NULL == eol)
+            {
+                eol = end;
+            }
+
+            words.clear();
+            for (const char* q = p; q < eol; )
+            {
+                if (' ' == *q)
+                {
+                    q++;
+                    continue;
+                }
+                std::string word;
+                for ( ; q < eol && ' ' != *q; q++)
+                {
+                    if ('\\' == *q && eol - q > 3 &&
+                        q[1] >= '0' && q[1] <= '3' && q[2] >= '0' && q[2] <= '7' && q[3] >= '0' && q[3] <= '7')
+                    {
+                        word += static_cast<char>(((q[1] - '0') << 6) | ((q[2] - '0') << 3) | (q[3] - '0'));
+                        q += 3;
+                    }
+                    else
+                    {
+                        word += *q;
+                    }
+                }
+                words.push_back(word);
+            }
+            p = eol + 1;
+
+            // The separator follows the optional fields
+            size_t sep = 6;
+            while (sep < words.size() && "-" != words[sep])
+            {
+                sep++;
+            }
+            if (sep + 2 >= words.size())
+            {
+                continue;
+            }
+
+            MntTabEntry entry;
+            entry.mountPoint = SCXCoreLib::StrFromMultibyte(words[4]);
+            entry.fileSystem = SCXCoreLib::StrFromMultibyte(words[sep + 1]);
+            entry.device = SCXCoreLib::StrFromMultibyte(words[sep + 2]);
+            size_t dev = words[5].find("dev=");
+            if (std::string::npos != dev)
+            {
+                std::string attr = words[5].substr(dev + 4);
+                entry.devAttribute = SCXCoreLib::StrFromMultibyte(attr.substr(0, attr.find_first_not_of("0123456789abcdef")));
+            }
+            entries.push_back(entry);
+        }
+        return entries.size();
     }
 
     /*----------------------------------------------------------------------------*/
@@ -397,10 +822,28 @@ namespace SCXSystemLib
             L"gvfs",
             L"" };
 
+        // Built once, the exact names are looked up rather than compared one by one
+        static const std::set<std::wstring> ignoredSet = MakeStringSet(IGFS);
+
+        // A host has a handful of file system types but may have thousands of
+        // mounts of them, so the decision is remembered per type as given
+        std::map<std::wstring, bool>::const_iterator cached = m_fsIgnored.find(fs);
+        if (cached != m_fsIgnored.end())
+        {
+            return cached->second;
+        }
+
         std::wstring fs_in_lower_case = SCXCoreLib::StrToLower(fs);
-        return IsStringInArray(fs_in_lower_case, IGFS_PARTS, CompareContains)
-            || IsStringInArray(fs_in_lower_case, IGFS_START, CompareStartsWith)
-            || IsStringInArray(fs_in_lower_case, IGFS, CompareEqual);
+        bool ignored = ignoredSet.count(fs_in_lower_case) > 0
+            || IsStringInArray(fs_in_lower_case, IGFS_PARTS, CompareContains)
+            || IsStringInArray(fs_in_lower_case, IGFS_START, CompareStartsWith);
+
+        if (m_fsIgnored.size() >= MAX_CACHED_FILESYSTEM_TYPES)
+        {
+            m_fsIgnored.clear();
+        }
+        m_fsIgnored[fs] = ignored;
+        return ignored;
     }
 
     /*----------------------------------------------------------------------------*/
@@ -445,8 +888,9 @@ namespace SCXSystemLib
             L"zfs",
 #endif
             L"" };
+        static const std::set<std::wstring> noLinkSet = MakeStringSet(IGFS);
 
-        return IsStringInArray(SCXCoreLib::StrToLower(fs), IGFS, CompareEqual);
+        return noLinkSet.count(SCXCoreLib::StrToLower(fs)) > 0;
     }
 
 
@@ -588,13 +1032,32 @@ namespace SCXSystemLib
             }
         }
 #elif defined(linux)
+        static SCXLVMUtils lvmUtils;
+
+        // Devices in the block device topology are resolved through it, down
+        // to the disks under any device mapper or md layers. Kernel names
+        // have '!' where the /dev path has '/'.
+        BlockDeviceTopology& topology = BlockDeviceTopology::GetShared();
+        std::string kernelName = SCXCoreLib::StrToMultibyte(name);
+        std::vector<std::string> disks;
+        if (( ! lvmUtils.IsDMDevice(device) || topology.FindDeviceMapperDevice(kernelName, kernelName)) &&
+            topology.GetPhysicalDisks(kernelName, disks))
+        {
+            for (std::vector<std::string>::const_iterator iter = disks.begin(); iter != disks.end(); iter++)
+            {
+                std::string devName = *iter;
+                std::replace(devName.begin(), devName.end(), '!', '/');
+                path = L"/dev/" + SCXCoreLib::StrFromMultibyte(devName);
+                devices[path.GetFilename()] = path.Get();
+            }
+            return devices;
+        }
+
         // Given a device path to a partition (for example /dev/hda5), convert
         // it to a path to the base device (for example /dev/hda).
 
         try
         {
-            static SCXLVMUtils lvmUtils;
-
             // Try to convert the potential LVM device path into its matching
             // device mapper (dm) device path.
             std::wstring dmDevice = lvmUtils.GetDMDevice(device);
@@ -983,6 +1446,22 @@ namespace SCXSystemLib
         return false;
     }
 
+    /*----------------------------------------------------------------------------*/
+    /**
+       Collects the strings of an array into a set.
+       \param arr Array of strings. An empty string marks end of array.
+       \returns The strings of the array.
+    */
+    std::set<std::wstring> DiskDependDefault::MakeStringSet(const std::wstring* arr)
+    {
+        std::set<std::wstring> strings;
+        for (int i = 0; arr[i].length() != 0; i++)
+        {
+            strings.insert(arr[i]);
+        }
+        return strings;
+    }
+
     /*----------------------------------------------------------------------------*/
     /**
        Check if needle equals heystack.
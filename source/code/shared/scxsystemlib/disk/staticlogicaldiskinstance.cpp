@@ -33,7 +33,7 @@ namespace SCXSystemLib
         : m_deps(0), m_online(false), m_sizeInBytes(0), m_isReadOnly(false), m_persistenceType(0), m_availableSpace(0),
           m_isNumFilesSupported(false), m_numTotalInodes(0), m_numAvailableInodes(0),
           m_isCaseSensitive(false), m_isCasePreserved(false), m_codeSet(0),
-          m_maxFilenameLen(0), m_blockSize(0)
+          m_maxFilenameLen(0), m_blockSize(0), m_statVfs(deps)
     {
         m_log = SCXCoreLib::SCXLogHandleFactory::GetLogHandle(L"scx.core.common.pal.system.disk.staticlogicaldiskinstance");
         m_deps = deps;
@@ -402,20 +402,26 @@ namespace SCXSystemLib
     {
         UpdateDefaults();
 
-        /* Do a statvfs() call to get file system statistics */
+        /* Do a statvfs() call to get file system statistics, with a deadline since it may hang on network mounts */
 
         SCXStatVfs fsstat;
-        if (0 != m_deps->statvfs(SCXCoreLib::StrToMultibyte(GetId()).c_str(), &fsstat))
+        int err = 0;
+        StatVfsResult result = m_statVfs.StatVfs(GetId(), m_fileSystemType, fsstat, err);
+        if (eStatVfsNoValue == result)
+        {
+            return;
+        }
+        if (eStatVfsFailed == result)
         {
             // Ignore EOVERFLOW (if disk is too big) to keep disk 'on-line' even without statistics
-            if ( EOVERFLOW == errno ){
+            if ( EOVERFLOW == err ){
                 m_online = true;
                 SCX_LOGHYSTERICAL(m_log, SCXCoreLib::StrAppend(L"statvfs() failed with EOVERFLOW for ", GetId()));
             } 
             else 
             {
                 SCX_LOGERROR(m_log, 
-                    SCXCoreLib::StrAppend(L"statvfs() failed for " + GetId() + L"; errno = ", errno ) );
+                    SCXCoreLib::StrAppend(L"statvfs() failed for " + GetId() + L"; errno = ", err ) );
                 m_online = false;
             }
 
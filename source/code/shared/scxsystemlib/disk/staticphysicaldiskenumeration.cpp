@@ -16,6 +16,9 @@
 #include <scxsystemlib/staticphysicaldiskenumeration.h>
 #include <scxcorelib/stringaid.h>
 #include <scxcorelib/scxdirectoryinfo.h>
+#if defined(linux)
+#include <scxsystemlib/blockdevicetopology.h>
+#endif
 
 namespace SCXSystemLib
 {
@@ -82,6 +85,9 @@ namespace SCXSystemLib
         }
 
         m_deps->RefreshMNTTab();
+#if defined(linux)
+        BlockDeviceTopology::GetShared().Refresh();
+#endif
         for (std::vector<MntTabEntry>::const_iterator it = m_deps->GetMNTTab().begin();
              it != m_deps->GetMNTTab().end(); it++)
         {
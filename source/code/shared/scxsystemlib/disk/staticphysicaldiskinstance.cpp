@@ -31,6 +31,10 @@
 #include <linux/types.h>
 #include <sys/ioctl.h>
 
+#include <algorithm>
+
+#include <scxsystemlib/blockdevicetopology.h>
+
 #elif defined(aix)
 
 #include <scxsystemlib/scxodm.h>
@@ -71,7 +75,7 @@ namespace SCXSystemLib
     StaticPhysicalDiskInstance::StaticPhysicalDiskInstance(SCXCoreLib::SCXHandle<DiskDepend> deps)
         : m_deps(0), m_online(0), m_intType(eDiskIfcUnknown),
           m_sizeInBytes(0), m_totalCylinders(0), m_totalHeads(0), m_totalSectors(0),
-          m_sectorSize(0)
+          m_sectorSize(0), m_hasMediaType(false), m_rotational(false), m_removable(false)
     {
         m_log = SCXCoreLib::SCXLogHandleFactory::GetLogHandle(L"scx.core.common.pal.system.disk.staticphysicaldiskinstance");
         m_deps = deps;
@@ -152,7 +156,10 @@ namespace SCXSystemLib
     bool StaticPhysicalDiskInstance::GetManufacturer(std::wstring& value) const
     {
         value = m_manufacturer;
-#if defined(linux) || defined(sun)
+#if defined(linux)
+        // Only known from the vendor attribute of sysfs
+        return ! m_manufacturer.empty();
+#elif defined(sun)
         return false;
 #elif defined(aix) || defined(hpux)
         return true;
@@ -267,7 +274,10 @@ namespace SCXSystemLib
     bool StaticPhysicalDiskInstance::GetSectorSize(unsigned int& value) const
     {
         value = m_sectorSize;
-#if defined(aix) || defined(linux)
+#if defined(linux)
+        // Only known from the logical block size attribute of sysfs
+        return 0 != m_sectorSize;
+#elif defined(aix)
         return false;
 #elif defined(hpux) || defined(sun)
         return true;
@@ -276,6 +286,32 @@ namespace SCXSystemLib
 #endif
     }
 
+/*----------------------------------------------------------------------------*/
+/**
+    Retrieve if the device is rotating media or solid state.
+
+    \param       value - output parameter where true is stored for rotating media.
+    \returns     true if value is known, false otherwise; only known on Linux.
+*/
+    bool StaticPhysicalDiskInstance::GetIsRotational(bool& value) const
+    {
+        value = m_rotational;
+        return m_hasMediaType;
+    }
+
+/*----------------------------------------------------------------------------*/
+/**
+    Retrieve if the device has removable media.
+
+    \param       value - output parameter where the removable flag is stored.
+    \returns     true if value is known, false otherwise; only known on Linux.
+*/
+    bool StaticPhysicalDiskInstance::GetIsRemovable(bool& value) const
+    {
+        value = m_removable;
+        return m_hasMediaType;
+    }
+
 /*----------------------------------------------------------------------------*/
 /**
     Dump the object as a string for logging purposes.
@@ -296,7 +332,9 @@ namespace SCXSystemLib
             .Scalar("TotalCylinders", m_totalCylinders)
             .Scalar("TotalHeads", m_totalHeads)
             .Scalar("TotalSectors", m_totalSectors)
-            .Scalar("SectorSize", m_sectorSize);
+            .Scalar("SectorSize", m_sectorSize)
+            .Scalar("Rotational", m_rotational)
+            .Scalar("Removable", m_removable);
     }
 
 #if defined(aix)
@@ -465,13 +503,30 @@ namespace SCXSystemLib
 
 #if defined(linux)
 
-        int fd = 0;
+        /*
+         * Size, vendor, model, sector size and media type come from the block
+         * device inventory of sysfs when the device is in it. The kernel name
+         * has '!' where the path below /dev has '/'.
+         */
 
-        /* Get an FD to the device (Note: We must have privileges for this to work) */
+        std::string kernelName = StrToMultibyte(m_rawDevice);
+        if (0 == kernelName.compare(0, 5, "/dev/"))
+        {
+            kernelName.erase(0, 5);
+        }
+        std::replace(kernelName.begin(), kernelName.end(), '/', '!');
 
-        if (0 > (fd = m_deps->open(StrToMultibyte(m_rawDevice).c_str(), O_RDONLY)))
+        BlockDevice inventory;
+        bool inInventory = BlockDeviceTopology::GetShared().GetBlockDevice(kernelName, inventory);
+        if (inInventory)
         {
-            throw SCXErrnoOpenException(m_rawDevice, errno, SCXSRCLOCATION);
+            m_sizeInBytes = inventory.sizeSectors * 512;
+            m_manufacturer = StrFromMultibyte(inventory.vendor);
+            m_model = StrFromMultibyte(inventory.model);
+            m_sectorSize = inventory.logicalBlockSize;
+            m_hasMediaType = inventory.hasRotational;
+            m_rotational = inventory.rotational;
+            m_removable = inventory.removable;
         }
 
         /*
@@ -505,32 +560,51 @@ namespace SCXSystemLib
             m_intType = eDiskIfcUnknown;
         }
 
-        /* Get the blocksize of the device */
+        int fd = 0;
 
-        unsigned int blksize32 = 0;
-        u_int64_t blksize64 = 0;
+        /* Get an FD to the device (Note: We must have privileges for this to work) */
 
-#ifdef BLKGETSIZE64
-        if (0 == ioctl(fd, BLKGETSIZE64, &blksize64))
+        if (0 > (fd = m_deps->open(StrToMultibyte(m_rawDevice).c_str(), O_RDONLY)))
         {
-            // Returns bytes, so convert
-            blksize64 /= 512;
+            if (inInventory)
+            {
+                // The inventory has all but the geometry
+                SCX_LOGHYSTERICAL(m_log, StrAppend(L"Unable to open " + m_rawDevice + L" for its geometry, errno=", errno));
+                return;
+            }
+            throw SCXErrnoOpenException(m_rawDevice, errno, SCXSRCLOCATION);
         }
-#endif
 
-        if (blksize64 == 0)
+        /* Get the blocksize of the device */
+
+        unsigned int blksize32 = 0;
+        u_int64_t blksize64 = 0;
+
+        // The size from sysfs is used unless it is missing or zero
+        if ( ! inInventory || 0 == m_sizeInBytes)
         {
-            if (0 == m_deps->ioctl(fd, BLKGETSIZE, &blksize32))
+#ifdef BLKGETSIZE64
+            if (0 == ioctl(fd, BLKGETSIZE64, &blksize64))
             {
-                blksize64 = blksize32;
+                // Returns bytes, so convert
+                blksize64 /= 512;
             }
-            else
+#endif
+
+            if (blksize64 == 0)
             {
-                SCX_LOGERROR(m_log, L"System error getting disk blocksize, errno=" + StrFrom(errno));
+                if (0 == m_deps->ioctl(fd, BLKGETSIZE, &blksize32))
+                {
+                    blksize64 = blksize32;
+                }
+                else
+                {
+                    SCX_LOGERROR(m_log, L"System error getting disk blocksize, errno=" + StrFrom(errno));
+                }
             }
-        }
 
-        m_sizeInBytes = blksize64 / 2 * 1024;
+            m_sizeInBytes = blksize64 / 2 * 1024;
+        }
 
         /* Get the drive geometry */
 
@@ -551,7 +625,7 @@ namespace SCXSystemLib
 
         __u16 id[256];
         memset(&id, '\0', sizeof(id));
-        if (0 == m_deps->ioctl(fd, HDIO_GET_IDENTITY, id))
+        if (m_model.empty() && 0 == m_deps->ioctl(fd, HDIO_GET_IDENTITY, id))
         {
             /*
              * We get: Model (%.40s, starting at id[27]),
@@ -19,7 +19,15 @@
 #include <scxcorelib/scxfilepath.h>
 
 #include <errno.h>
+#include <string.h>
 #include <math.h>
+#include <time.h>
+
+namespace
+{
+    /** Upper bounds in milliseconds of the latency histogram buckets but the last. */
+    const scxulong s_latencyBounds[SCXSystemLib::DISK_LATENCY_BUCKETS - 1] = { 1, 2, 5, 10, 20, 50, 100, 200, 500, 1000 };
+}
 
 namespace SCXSystemLib
 {
@@ -36,6 +44,7 @@ namespace SCXSystemLib
 #if defined(sun)
            , m_kstat(0)
 #endif
+           , m_statVfs(deps), m_spaceStale(false)
     {
         m_deps = deps;
         m_log = SCXCoreLib::SCXLogHandleFactory::GetLogHandle(L"scx.core.common.pal.system.disk.statisticaldiskinstance");
@@ -88,6 +97,10 @@ namespace SCXSystemLib
         m_mbFree = 0;
         m_inodesTotal = 0;
         m_inodesFree = 0;
+        m_inodesAvailable = 0;
+        m_mbReserved = 0;
+        m_inodesPerSec = 0;
+        m_hasInodeRate = false;
         m_blockSize = 0;
         m_qLength = 0;
 
@@ -104,6 +117,14 @@ namespace SCXSystemLib
         m_waitTimes.Clear();
         m_timeStamp.Clear();
         m_qLengths.Clear();
+        m_ioTimes.Clear();
+        m_queueTimes.Clear();
+        m_inodesUsed.Clear();
+        m_spaceTimes.Clear();
+
+        m_hasUtilization = false;
+        m_hasLatencyHistogram = false;
+        memset(m_latencyHistogram, 0, sizeof(m_latencyHistogram));
     }
 
 /*----------------------------------------------------------------------------*/
@@ -121,6 +142,8 @@ namespace SCXSystemLib
         m_mbUsed = 0;
         m_inodesTotal = 0;
         m_inodesFree = 0;
+        m_inodesAvailable = 0;
+        m_mbReserved = 0;
         m_readsPerSec = m_reads.GetAverageDelta(MAX_DISKINSTANCE_DATASAMPER_SAMPLES) / DISK_SECONDS_PER_SAMPLE;
         m_writesPerSec = m_writes.GetAverageDelta(MAX_DISKINSTANCE_DATASAMPER_SAMPLES) / DISK_SECONDS_PER_SAMPLE;
         m_transfersPerSec = m_transfers.GetAverageDelta(MAX_DISKINSTANCE_DATASAMPER_SAMPLES) / DISK_SECONDS_PER_SAMPLE;
@@ -134,7 +157,24 @@ namespace SCXSystemLib
         m_waitTime = m_waitTimes.GetAverageDelta(MAX_DISKINSTANCE_DATASAMPER_SAMPLES) / DISK_SECONDS_PER_SAMPLE;
         m_qLength = m_qLengths.GetAverage<double>();
 
-#if defined(linux) || defined(hpux)
+#if defined(linux)
+        // Time spent doing I/O gives the utilization, and the same time weighted by
+        // the number of I/Os in flight the average queue size, as iostat -x shows them
+        if (m_ioTimes.GetNumberOfSamples() > 1 && 0 != m_timeStamp.GetDelta(MAX_DISKINSTANCE_DATASAMPER_SAMPLES) &&
+            !m_ioTimes.HasWrapped(MAX_DISKINSTANCE_DATASAMPER_SAMPLES) && !m_queueTimes.HasWrapped(MAX_DISKINSTANCE_DATASAMPER_SAMPLES))
+        {
+            double elapsed = static_cast<double>(m_timeStamp.GetDelta(MAX_DISKINSTANCE_DATASAMPER_SAMPLES)) * 1000.0;
+            double utilization = static_cast<double>(m_ioTimes.GetDelta(MAX_DISKINSTANCE_DATASAMPER_SAMPLES)) * 100.0 / elapsed;
+            m_tPercentage = static_cast<scxulong>(floor((utilization > 100.0 ? 100.0 : utilization) + 0.5));
+            m_qLength = static_cast<double>(m_queueTimes.GetDelta(MAX_DISKINSTANCE_DATASAMPER_SAMPLES)) / elapsed;
+            m_hasUtilization = true;
+        }
+        else
+        {
+            m_tPercentage = m_rPercentage + m_wPercentage;
+            m_hasUtilization = false;
+        }
+#elif defined(hpux)
         m_tPercentage = m_rPercentage + m_wPercentage;
 #elif defined(sun)
         if (0 != m_timeStamp.GetDelta(MAX_DISKINSTANCE_DATASAMPER_SAMPLES))
@@ -198,9 +238,13 @@ namespace SCXSystemLib
 
         if (0 < m_mountPoint.length())
         {
+            // statvfs() is made with a deadline since it may hang on an unresponsive network mount
             SCXStatVfs s_vfs;
             memset(&s_vfs, 0, sizeof(s_vfs));
-            if (0 == m_deps->statvfs(SCXCoreLib::StrToMultibyte(m_mountPoint).c_str(), &s_vfs))
+            int err = 0;
+            StatVfsResult result = m_statVfs.StatVfs(m_mountPoint, m_fsType, s_vfs, err);
+            m_spaceStale = (eStatVfsStale == result);
+            if (eStatVfsOk == result || eStatVfsStale == result)
             {
                 // ceil is used here since df system command rounds values up and we want to show values as presented
                 // when using system commands.
@@ -209,17 +253,27 @@ namespace SCXSystemLib
                                                                                     static_cast<double>(s_vfs.f_bavail))*static_cast<double>(s_vfs.f_frsize))));
                 m_blockSize = s_vfs.f_bsize;
 
+                m_mbReserved = static_cast<scxulong>(ceil(SCXCoreLib::BytesToMegaBytes((static_cast<double>(s_vfs.f_bfree)-
+                                                                                        static_cast<double>(s_vfs.f_bavail))*static_cast<double>(s_vfs.f_frsize))));
+
                 // Grab the inode information while we have it
                 m_inodesTotal = s_vfs.f_files;
                 m_inodesFree = s_vfs.f_ffree;
+                m_inodesAvailable = s_vfs.f_favail;
+
+                // A stale result repeats an old statvfs() and file systems without inodes report none
+                if (eStatVfsOk == result && 0 != m_inodesTotal && m_inodesTotal >= m_inodesFree)
+                {
+                    SampleInodeConsumption();
+                }
             }
-            else
+            else if (eStatVfsFailed == result)
             {
                 // Ignore EOVERFLOW (if disk is too big) to keep disk 'on-line' even without statistics
-                if ( EOVERFLOW != errno )
+                if ( EOVERFLOW != err )
                 {
                     SCX_LOGERROR(m_log, 
-                        SCXCoreLib::StrAppend(L"statvfs() failed for " + m_mountPoint + L"; errno = ", errno ) );
+                        SCXCoreLib::StrAppend(L"statvfs() failed for " + m_mountPoint + L"; errno = ", err ) );
                     m_online = false;
                 } 
                 else 
@@ -393,7 +447,10 @@ namespace SCXSystemLib
     bool StatisticalDiskInstance::GetIOPercentageTotal(scxulong& total) const
     {
         total = m_tPercentage;
-#if defined(aix) || defined(linux) || defined(hpux)
+#if defined(linux)
+        // Known for devices with a time spent doing I/O column in /proc/diskstats
+        return m_hasUtilization;
+#elif defined(aix) || defined(hpux)
         return false;
 #elif defined(sun)
         return true;
@@ -494,6 +551,70 @@ namespace SCXSystemLib
         return (inodesTotal != 0);
     }
 
+/*----------------------------------------------------------------------------*/
+/**
+    Retrieve number of inodes available to unprivileged users.
+
+    \param      inodesAvailable - output parameter where the number of inodes is stored.
+    \returns    true if value was set, otherwise false.
+*/
+    bool StatisticalDiskInstance::GetInodesAvailable(scxulong& inodesAvailable) const
+    {
+        inodesAvailable = m_inodesAvailable;
+        return (m_inodesTotal != 0);
+    }
+
+/*----------------------------------------------------------------------------*/
+/**
+    Retrieve the rate at which inodes are consumed, negative if they are freed.
+
+    \param      perSecond - output parameter where the inodes per second are stored.
+    \returns    true if value was set, otherwise false.
+*/
+    bool StatisticalDiskInstance::GetInodeConsumption(double& perSecond) const
+    {
+        perSecond = m_inodesPerSec;
+        return m_hasInodeRate;
+    }
+
+/*----------------------------------------------------------------------------*/
+/**
+    Retrieve space reserved for the super user, the difference between free
+    blocks and blocks available to unprivileged users.
+
+    \param      mbReserved - output parameter where reserved MB is stored.
+    \returns    true if value was set, otherwise false.
+*/
+    bool StatisticalDiskInstance::GetReservedSpace(scxulong& mbReserved) const
+    {
+        mbReserved = m_mbReserved;
+        return (0 < m_mbUsed + m_mbFree);
+    }
+
+/*----------------------------------------------------------------------------*/
+/**
+    Add the used inodes of a fresh statvfs() to their sampler and compute the
+    consumption rate over the samples kept.
+
+    Space is sampled when the instance is updated rather than by the sampler
+    thread, so the samples carry their own time stamps.
+*/
+    void StatisticalDiskInstance::SampleInodeConsumption()
+    {
+        m_inodesUsed.AddSample(m_inodesTotal - m_inodesFree);
+        m_spaceTimes.AddSample(static_cast<scxulong>(time(NULL)));
+
+        m_hasInodeRate = false;
+        m_inodesPerSec = 0;
+        size_t last = m_spaceTimes.GetNumberOfSamples() - 1;
+        if (last > 0 && m_spaceTimes[0] > m_spaceTimes[last])
+        {
+            m_inodesPerSec = (static_cast<double>(m_inodesUsed[0]) - static_cast<double>(m_inodesUsed[last])) /
+                static_cast<double>(m_spaceTimes[0] - m_spaceTimes[last]);
+            m_hasInodeRate = true;
+        }
+    }
+
 /*----------------------------------------------------------------------------*/
 /**
     Retrieve disk block size.
@@ -507,6 +628,20 @@ namespace SCXSystemLib
         return true;
     }
 
+/*----------------------------------------------------------------------------*/
+/**
+    Tell if the space and inode values are from an earlier sample because
+    statvfs() did not answer in time.
+
+    \param      stale - output parameter where the staleness is stored.
+    \returns    true if value was set, otherwise false.
+*/
+    bool StatisticalDiskInstance::GetSpaceStale(bool& stale) const
+    {
+        stale = m_spaceStale;
+        return true;
+    }
+
 /*----------------------------------------------------------------------------*/
 /**
     Retrieve the disk health state.
@@ -520,6 +655,112 @@ namespace SCXSystemLib
         return true;
     }
 
+/*----------------------------------------------------------------------------*/
+/**
+    Retrieve the latency histogram.
+
+    Each sample interval adds its number of I/Os to the bucket of its average
+    latency, so the histogram tells how the I/Os since the agent started were
+    spread over slow and fast intervals.
+
+    \param      counts - output parameter where the I/O count of each bucket is stored.
+    \returns    true if value was set, otherwise false.
+*/
+    bool StatisticalDiskInstance::GetLatencyHistogram(std::vector<scxulong>& counts) const
+    {
+        if ( ! m_hasLatencyHistogram)
+        {
+            return false;
+        }
+        counts.assign(m_latencyHistogram, m_latencyHistogram + DISK_LATENCY_BUCKETS);
+        return true;
+    }
+
+/*----------------------------------------------------------------------------*/
+/**
+    Retrieve the upper bounds of the latency histogram buckets.
+
+    \param      bounds - output parameter where the upper bound in milliseconds of each bucket
+                 but the last, which is unbounded, is stored.
+*/
+    void StatisticalDiskInstance::GetLatencyHistogramBounds(std::vector<scxulong>& bounds)
+    {
+        bounds.assign(s_latencyBounds, s_latencyBounds + DISK_LATENCY_BUCKETS - 1);
+    }
+
+#if defined(linux)
+    /*----------------------------------------------------------------------------*/
+    /**
+       Add the interval between the two latest samples to the latency histogram.
+    */
+    void StatisticalDiskInstance::AddLatencySample()
+    {
+        if (m_reads.GetNumberOfSamples() < 2 || m_writes.GetNumberOfSamples() < 2 ||
+            m_rTimes.GetNumberOfSamples() < 2 || m_wTimes.GetNumberOfSamples() < 2)
+        {
+            return;
+        }
+        m_hasLatencyHistogram = true;
+
+        if (m_reads.HasWrapped(2) || m_writes.HasWrapped(2) || m_rTimes.HasWrapped(2) || m_wTimes.HasWrapped(2))
+        {
+            return;
+        }
+        scxulong ios = m_reads.GetDelta(2) + m_writes.GetDelta(2);
+        if (0 == ios)
+        {
+            return;
+        }
+        scxulong latency = (m_rTimes.GetDelta(2) + m_wTimes.GetDelta(2)) / ios;
+
+        size_t bucket = 0;
+        while (bucket < DISK_LATENCY_BUCKETS - 1 && latency >= s_latencyBounds[bucket])
+        {
+            bucket++;
+        }
+        m_latencyHistogram[bucket] += ios;
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Get the /proc/diskstats row of a device.
+
+       The device is found by name once, after that by its device number,
+       which does not allocate. It is found by name again if the number
+       is gone, as when a device is removed and added again.
+
+       \param[in]  index  0 for m_device, i + 1 for m_samplerDevices[i].
+       \param[in]  device Device path.
+       \returns    The row, or NULL if the device is not in /proc/diskstats.
+    */
+    const ProcDiskStats* StatisticalDiskInstance::LookupProcDiskStats(size_t index, const std::wstring& device)
+    {
+        if (index >= m_procDiskStatsIds.size())
+        {
+            m_procDiskStatsIds.resize(index + 1);
+        }
+        ProcDiskStatsId& id = m_procDiskStatsIds[index];
+
+        if (id.found)
+        {
+            const ProcDiskStats* stats = m_deps->GetProcDiskStats(id.major, id.minor);
+            if (NULL != stats)
+            {
+                return stats;
+            }
+        }
+
+        const ProcDiskStats* stats = m_deps->FindProcDiskStats(device);
+        id.found = (NULL != stats);
+        if (id.found)
+        {
+            id.major = stats->major;
+            id.minor = stats->minor;
+        }
+        return stats;
+    }
+#endif
+
     /*----------------------------------------------------------------------------*/
     /**
        Find the disk info index of a disk with given id.
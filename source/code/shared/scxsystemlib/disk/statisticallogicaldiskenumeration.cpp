@@ -25,6 +25,7 @@
 #include <sys/pstat.h>
 #include <scxsystemlib/scxlvmtab.h>
 #elif defined(linux)
+#include <scxsystemlib/blockdevicetopology.h>
 #include <scxsystemlib/scxlvmutils.h>
 #elif defined(sun)
 #include <scxsystemlib/scxkstat.h>
@@ -39,7 +40,8 @@ namespace SCXSystemLib
         \param       deps - dependencies
 
     */
-    StatisticalLogicalDiskEnumeration::StatisticalLogicalDiskEnumeration(SCXCoreLib::SCXHandle<DiskDepend> deps) : m_deps(0), m_sampler(0)
+    StatisticalLogicalDiskEnumeration::StatisticalLogicalDiskEnumeration(SCXCoreLib::SCXHandle<DiskDepend> deps) : m_deps(0), m_sampler(0),
+        m_mntTabGeneration(0)
     {
         m_log = SCXCoreLib::SCXLogHandleFactory::GetLogHandle(L"scx.core.common.pal.system.disk.statisticallogicaldiskenumeration");
         m_lock = SCXCoreLib::ThreadLockHandleGet();
@@ -379,6 +381,16 @@ namespace SCXSystemLib
         }
 
         m_deps->RefreshMNTTab();
+#if defined(linux)
+        BlockDeviceTopology::GetShared().Refresh();
+#elif defined(hpux)
+        // Device nodes are looked up again after the mounts change
+        if (m_deps->GetMNTTabGeneration() != m_mntTabGeneration)
+        {
+            m_mntTabGeneration = m_deps->GetMNTTabGeneration();
+            m_pathToRdev.clear();
+        }
+#endif
         for (std::vector<MntTabEntry>::const_iterator it = m_deps->GetMNTTab().begin();
              it != m_deps->GetMNTTab().end(); it++)
         {
@@ -398,23 +410,33 @@ namespace SCXSystemLib
 
                     if (lvmUtils.IsDMDevice(it->device))
                     {
-                        try
+                        // The topology has the dm device of a /dev/mapper name
+                        // without a stat() of the device nodes
+                        std::string kernelName;
+                        if (BlockDeviceTopology::GetShared().FindDeviceMapperDevice(SCXCoreLib::StrToMultibyte(SCXCoreLib::SCXFilePath(it->device).GetFilename()), kernelName))
                         {
-                            // Try to convert the potential LVM device path into its matching
-                            // device mapper (dm) device path.
-                            std::wstring dmDevice = lvmUtils.GetDMDevice(it->device);
-
-                            SCXASSERT(!dmDevice.empty());
-                            disk->m_samplerDevices.push_back(dmDevice);
+                            disk->m_samplerDevices.push_back(L"/dev/" + SCXCoreLib::StrFromMultibyte(kernelName));
                         }
-                        catch (SCXCoreLib::SCXException& e)
+                        else
                         {
-                            static SCXCoreLib::LogSuppressor suppressor(SCXCoreLib::eWarning, SCXCoreLib::eTrace);
-                            std::wstringstream               out;
-
-                            out << L"An exception occurred resolving the dm device that represents the LVM partition " << it->device
-                                << L" : " << e.What();
-                            SCX_LOG(m_log, suppressor.GetSeverity(out.str()), out.str());
+                            try
+                            {
+                                // Try to convert the potential LVM device path into its matching
+                                // device mapper (dm) device path.
+                                std::wstring dmDevice = lvmUtils.GetDMDevice(it->device);
+
+                                SCXASSERT(!dmDevice.empty());
+                                disk->m_samplerDevices.push_back(dmDevice);
+                            }
+                            catch (SCXCoreLib::SCXException& e)
+                            {
+                                static SCXCoreLib::LogSuppressor suppressor(SCXCoreLib::eWarning, SCXCoreLib::eTrace);
+                                std::wstringstream               out;
+
+                                out << L"An exception occurred resolving the dm device that represents the LVM partition " << it->device
+                                    << L" : " << e.What();
+                                SCX_LOG(m_log, suppressor.GetSeverity(out.str()), out.str());
+                            }
                         }
                     }
                     // no else required; device was not an LVM device
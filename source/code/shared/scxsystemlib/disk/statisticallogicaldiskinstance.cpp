@@ -17,6 +17,8 @@
 #include <scxcorelib/stringaid.h>
 #include <scxcorelib/scxmath.h>
 
+#include <time.h>
+
 namespace SCXSystemLib
 {
 /*----------------------------------------------------------------------------*/
@@ -142,6 +144,44 @@ namespace SCXSystemLib
 #endif
     }
 
+/*----------------------------------------------------------------------------*/
+/**
+   Retrieve the growth of the used space, from the hourly usage history.
+
+   \param       mbPerHour - output parameter where the growth in MB per hour is stored.
+   \returns     true if value was set, otherwise false.
+*/
+    bool StatisticalLogicalDiskInstance::GetGrowthRate(double& mbPerHour) const
+    {
+        return m_forecast.GetGrowthRate(mbPerHour);
+    }
+
+/*----------------------------------------------------------------------------*/
+/**
+   Retrieve the time until the file system is full at its current growth.
+
+   \param       seconds - output parameter where the number of seconds is stored.
+   \returns     true if value was set, otherwise false; also false if the usage does not grow.
+*/
+    bool StatisticalLogicalDiskInstance::GetTimeToFull(scxulong& seconds) const
+    {
+        return m_forecast.GetTimeToFull(seconds);
+    }
+
+/*----------------------------------------------------------------------------*/
+/**
+   Update the instance, adding fresh space values to the usage history.
+*/
+    void StatisticalLogicalDiskInstance::Update()
+    {
+        StatisticalDiskInstance::Update();
+
+        if ( ! IsTotal() && m_online && ! m_spaceStale && 0 < m_mbUsed + m_mbFree)
+        {
+            m_forecast.AddSample(time(NULL), m_mbUsed, m_mbFree);
+        }
+    }
+
     /*----------------------------------------------------------------------------*/
     /**
        \copydoc SCXSystemLib::StatisticalDiskInstance::Sample
@@ -196,9 +236,8 @@ namespace SCXSystemLib
         m_transfers.AddSample(m_reads[0] + m_writes[0]);
         m_tBytes.AddSample(m_rBytes[0] + m_wBytes[0]);
 #elif defined(linux)
-        std::wstring device = m_device;
-        std::vector<std::wstring> parts;
-        std::wstringstream out;
+        const std::wstring* device = &m_device;
+        size_t index = 0;
 
         if (!m_samplerDevices.empty())
         {
@@ -210,64 +249,36 @@ namespace SCXSystemLib
             //       change.
             SCXASSERT( 1 == m_samplerDevices.size() );
 
-            device = m_samplerDevices[0];
+            device = &m_samplerDevices[0];
+            index = 1;
         }
 
-        parts = m_deps->GetProcDiskStats(device);
+        const ProcDiskStats* stats = LookupProcDiskStats(index, *device);
 
-        m_timeStamp.AddSample(time(0));
-
-        if (parts.size() == eNumberOfDiskColumns)
+        // Partitions on kernels before 2.6.25 have four fields, which the parser
+        // stores in the matching disk fields; anything else has at least eleven
+        if (NULL != stats && (4 == stats->fieldCount || stats->fieldCount >= 11))
         {
-            // this looks like a diskstats entry for a disk-type device
-            try
-            {
-                m_reads.AddSample(SCXCoreLib::StrToULong(parts[eNumberOfReadsCompleted]));
-                m_writes.AddSample(SCXCoreLib::StrToULong(parts[eNumberOfWritesCompleted]));
-                m_rBytes.AddSample(SCXCoreLib::StrToULong(parts[eNumberOfSectorsRead])*m_sectorSize);
-                m_wBytes.AddSample(SCXCoreLib::StrToULong(parts[eNumberOfSectorsWritten])*m_sectorSize);
-                m_transfers.AddSample(m_reads[0] + m_writes[0]);
-                m_tBytes.AddSample(m_rBytes[0] + m_wBytes[0]);
-            }
-            catch (const SCXCoreLib::SCXNotSupportedException& e)
-            {
-                out.str(L"");
-
-                out << L"Could not parse disk device line from diskstats for device \"" << device << L"\" - " << e.What();
-                SCX_LOGWARNING(m_log, out.str());
-            }
-        }
-        else if (parts.size() == eNumberOfPartitionColumns)
-        {
-            // this looks like a diskstats entry for a partition-type device
-            try
-            {
-                m_reads.AddSample(SCXCoreLib::StrToULong(parts[eNumberOfReadsIssued]));
-                m_writes.AddSample(SCXCoreLib::StrToULong(parts[eNumberOfWritesIssued]));
-                m_rBytes.AddSample(SCXCoreLib::StrToULong(parts[eNumberOfReadSectorRequests])*m_sectorSize);
-                m_wBytes.AddSample(SCXCoreLib::StrToULong(parts[eNumberOfWriteSectorRequests])*m_sectorSize);
-                m_transfers.AddSample(m_reads[0] + m_writes[0]);
-                m_tBytes.AddSample(m_rBytes[0] + m_wBytes[0]);
-            }
-            catch (const SCXCoreLib::SCXNotSupportedException& e)
-            {
-                out.str(L"");
-
-                out << L"Could not parse partition device line from diskstats for device \"" << device << L"\" - " << e.What();
-                SCX_LOGWARNING(m_log, out.str());
-            }
+            m_timeStamp.AddSample(time(0));
+            m_reads.AddSample(stats->readsCompleted);
+            m_writes.AddSample(stats->writesCompleted);
+            m_rBytes.AddSample(stats->sectorsRead*m_sectorSize);
+            m_wBytes.AddSample(stats->sectorsWritten*m_sectorSize);
+            m_transfers.AddSample(m_reads[0] + m_writes[0]);
+            m_tBytes.AddSample(m_rBytes[0] + m_wBytes[0]);
         }
         else
         {
             static SCXCoreLib::LogSuppressor suppressor(SCXCoreLib::eWarning, SCXCoreLib::eTrace);
 
-            out.str(L"");
+            std::wstringstream out;
 
             // Note: If this message shows up in the logs and the device in question
             //       shouldn't even be getting enumerated, then maybe the device
             //       type needs to be added to the list of ignored device types in
             //       diskdepend (see WI 33450).
-            out << L"Incomplete line read from diskstats for device \"" << device << L"\", only found " << parts.size() << L" columns";
+            out << L"Incomplete line read from diskstats for device \"" << *device << L"\", only found "
+                << (NULL == stats ? 0 : stats->fieldCount + 3) << L" columns";
             SCX_LOG(m_log, suppressor.GetSeverity(out.str()), out.str());
         }
 #elif defined(sun)
@@ -28,6 +28,8 @@
 #include <scxsystemlib/scxlvmtab.h>
 #elif defined(sun)
 #include <scxsystemlib/scxkstat.h>
+#elif defined(linux)
+#include <scxsystemlib/blockdevicetopology.h>
 #endif
 
 namespace SCXSystemLib
@@ -39,7 +41,8 @@ namespace SCXSystemLib
         \param       deps - dependencies
 
     */
-    StatisticalPhysicalDiskEnumeration::StatisticalPhysicalDiskEnumeration(SCXCoreLib::SCXHandle<DiskDepend> deps) : m_deps(0), m_sampler(0)
+    StatisticalPhysicalDiskEnumeration::StatisticalPhysicalDiskEnumeration(SCXCoreLib::SCXHandle<DiskDepend> deps) : m_deps(0), m_sampler(0),
+        m_mntTabGeneration(0), m_devMTime(0), m_topologyGeneration(0)
     {
         m_log = SCXCoreLib::SCXLogHandleFactory::GetLogHandle(L"scx.core.common.pal.system.disk.statisticalphysicaldiskenumeration");
         m_lock = SCXCoreLib::ThreadLockHandleGet();
@@ -257,6 +260,21 @@ namespace SCXSystemLib
                 total_rPercent += disk->m_rPercentage;
                 total_wPercent += disk->m_wPercentage;
                 total_tPercent += disk->m_tPercentage;
+#if defined(linux)
+                if (disk->m_hasUtilization)
+                {
+                    total->m_hasUtilization = true;
+                    total->m_qLength += disk->m_qLength;
+                }
+                if (disk->m_hasLatencyHistogram)
+                {
+                    total->m_hasLatencyHistogram = true;
+                    for (size_t i = 0; i < DISK_LATENCY_BUCKETS; i++)
+                    {
+                        total->m_latencyHistogram[i] += disk->m_latencyHistogram[i];
+                    }
+                }
+#endif
             }
         }
 
@@ -400,13 +418,28 @@ namespace SCXSystemLib
     */
     void StatisticalPhysicalDiskEnumeration::FindPhysicalDisks()
     {
+        m_deps->RefreshMNTTab();
+        bool changed = MountsOrDevicesChanged();
+#if defined(linux)
+        // Physical disks are only found through the mounted file systems, so
+        // there is nothing new to find unless the mounts or devices changed
+        if ( ! changed)
+        {
+            return;
+        }
+#elif defined(hpux)
+        if (changed)
+        {
+            m_pathToRdev.clear();
+        }
+#endif
+
         for (EntityIterator iter=Begin(); iter!=End(); iter++)
         {
             SCXCoreLib::SCXHandle<StatisticalPhysicalDiskInstance> disk = *iter;
             disk->m_online = false;
         }
 
-        m_deps->RefreshMNTTab();
         for (std::vector<MntTabEntry>::const_iterator it = m_deps->GetMNTTab().begin();
              it != m_deps->GetMNTTab().end(); it++)
         {
@@ -526,6 +559,37 @@ namespace SCXSystemLib
     }
 #endif
 
+    /*----------------------------------------------------------------------------*/
+    /**
+       Checks if the mount tab or the device nodes changed since the last call.
+
+       \returns true if the mount tab generation, the modification time of /dev
+                or, on Linux, the block device topology changed.
+
+       A /dev modified within the current second is reported again on the
+       next call, since a later change in the same second would not move it.
+    */
+    bool StatisticalPhysicalDiskEnumeration::MountsOrDevicesChanged()
+    {
+        struct stat devStat;
+        time_t devMTime = (0 == m_deps->lstat("/dev", &devStat)) ? devStat.st_mtime : 0;
+        unsigned int generation = m_deps->GetMNTTabGeneration();
+        unsigned int topologyGeneration = 0;
+#if defined(linux)
+        BlockDeviceTopology::GetShared().Refresh();
+        topologyGeneration = BlockDeviceTopology::GetShared().GetGeneration();
+#endif
+        if (generation == m_mntTabGeneration && devMTime == m_devMTime && topologyGeneration == m_topologyGeneration)
+        {
+            return false;
+        }
+
+        m_mntTabGeneration = generation;
+        m_devMTime = (devMTime < time(0)) ? devMTime : 0;
+        m_topologyGeneration = topologyGeneration;
+        return true;
+    }
+
     /*----------------------------------------------------------------------------*/
     /**
        Updates the path to rdev map.
@@ -589,6 +653,8 @@ namespace SCXSystemLib
     {
         SCXCoreLib::SCXThreadLock lock(m_lock);
 
+        // Find the disk again on the next update if it is still there
+        m_mntTabGeneration = 0;
         return EntityEnumeration<StatisticalPhysicalDiskInstance>::RemoveInstanceById(id);
 
     }
@@ -163,30 +163,28 @@ namespace SCXSystemLib
         m_waitTimes.AddSample(diski.psd_dkwait.pst_sec * 1000 + diski.psd_dkwait.pst_usec / 1000);
         m_qLengths.AddSample(diski.psd_dkqlen_curr);
 #elif defined(linux)
-        std::vector<std::wstring> parts = m_deps->GetProcDiskStats(m_device);
-        for (size_t i=0; parts.size() == 0 && i < m_samplerDevices.size(); ++i)
+        const ProcDiskStats* stats = LookupProcDiskStats(0, m_device);
+        for (size_t i=0; NULL == stats && i < m_samplerDevices.size(); ++i)
         {
-            parts = m_deps->GetProcDiskStats(m_samplerDevices[i]);
+            stats = LookupProcDiskStats(i + 1, m_samplerDevices[i]);
         }
-        m_timeStamp.AddSample(time(0));
-        if (parts.size() > 11)
+        // The time stamp is only sampled together with the counters so that
+        // the deltas of both cover the same interval
+        if (NULL != stats && stats->fieldCount > 8)
         {
-            try
-            {
-                m_reads.AddSample(SCXCoreLib::StrToULong(parts[3]));
-                m_writes.AddSample(SCXCoreLib::StrToULong(parts[7]));
-                m_rBytes.AddSample(SCXCoreLib::StrToULong(parts[5])*m_sectorSize);
-                m_wBytes.AddSample(SCXCoreLib::StrToULong(parts[9])*m_sectorSize);
-                m_rTimes.AddSample(SCXCoreLib::StrToULong(parts[6]));
-                m_wTimes.AddSample(SCXCoreLib::StrToULong(parts[10]));
-                m_transfers.AddSample(m_reads[0] + m_writes[0]);
-                m_tBytes.AddSample(m_rBytes[0] + m_wBytes[0]);
-                m_qLengths.AddSample(SCXCoreLib::StrToULong(parts[11]));
-            }
-            catch (const SCXCoreLib::SCXNotSupportedException& e)
-            {
-                SCX_LOGWARNING(m_log, std::wstring(L"Could not parse line from diskstats: ").append(L" - ").append(e.What()));
-            }
+            m_timeStamp.AddSample(time(0));
+            m_reads.AddSample(stats->readsCompleted);
+            m_writes.AddSample(stats->writesCompleted);
+            m_rBytes.AddSample(stats->sectorsRead*m_sectorSize);
+            m_wBytes.AddSample(stats->sectorsWritten*m_sectorSize);
+            m_rTimes.AddSample(stats->msReading);
+            m_wTimes.AddSample(stats->msWriting);
+            m_transfers.AddSample(m_reads[0] + m_writes[0]);
+            m_tBytes.AddSample(m_rBytes[0] + m_wBytes[0]);
+            m_qLengths.AddSample(stats->ioInProgress);
+            m_ioTimes.AddSample(stats->msIO);
+            m_queueTimes.AddSample(stats->weightedMsIO);
+            AddLatencySample();
         }
 #elif defined(sun)
         try
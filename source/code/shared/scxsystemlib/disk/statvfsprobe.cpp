@@ -0,0 +1,347 @@
+/*--------------------------------------------------------------------------------
+    Copyright (c) Microsoft Corporation.  All rights reserved.
+
+*/
+/**
+    \file
+
+    \brief       Timeout bounded statvfs() of a mount point
+
+    \date        2026-10-18 19:00:00
+
+*/
+/*----------------------------------------------------------------------------*/
+
+#include <scxcorelib/scxcmn.h>
+#include <scxcorelib/scxcondition.h>
+#include <scxcorelib/scxexception.h>
+#include <scxcorelib/stringaid.h>
+#include <scxsystemlib/statvfsprobe.h>
+
+#include <errno.h>
+#include <string.h>
+
+namespace SCXSystemLib
+{
+    /*----------------------------------------------------------------------------*/
+    /**
+       Parameters and result of one statvfs() worker.
+
+       The result is written and read with the condition lock held.
+    */
+    class StatVfsProbeThreadParam : public SCXCoreLib::SCXThreadParam
+    {
+    public:
+        /*----------------------------------------------------------------------------*/
+        /**
+           Constructor
+
+           \param[in] deps Dependencies to call statvfs() through
+           \param[in] path Mount point
+        */
+        StatVfsProbeThreadParam(SCXCoreLib::SCXHandle<DiskDepend> deps, const std::string& path)
+            : SCXThreadParam(), m_deps(deps), m_path(path), m_done(false), m_rc(-1), m_err(0)
+        {
+            memset(&m_buf, 0, sizeof(m_buf));
+        }
+
+        SCXCoreLib::SCXHandle<DiskDepend> m_deps;   //!< Dependencies
+        std::string m_path;                         //!< Mount point
+        bool m_done;                                //!< statvfs() has returned
+        int m_rc;                                   //!< Return value of statvfs()
+        int m_err;                                  //!< errno after statvfs()
+        SCXStatVfs m_buf;                           //!< Result of statvfs()
+    };
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Body of a statvfs() worker.
+
+       \param param Must contain a parameter of type StatVfsProbeThreadParam*
+    */
+    static void StatVfsProbeWorker(SCXCoreLib::SCXThreadParamHandle& param)
+    {
+        StatVfsProbeThreadParam* p = static_cast<StatVfsProbeThreadParam*>(param.GetData());
+        if (0 == p)
+        {
+            SCXASSERT( ! "Invalid parameters to StatVfsProbeWorker");
+            return;
+        }
+
+        SCXStatVfs buf;
+        memset(&buf, 0, sizeof(buf));
+        int rc = p->m_deps->statvfs(p->m_path.c_str(), &buf);
+        int err = (0 == rc) ? 0 : errno;
+
+        SCXCoreLib::SCXConditionHandle h(p->m_cond);
+        p->m_rc = rc;
+        p->m_err = err;
+        p->m_buf = buf;
+        p->m_done = true;
+        h.Signal();
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Constructor
+
+       \param[in] deps        Dependencies to call statvfs() through
+       \param[in] timeoutMsec Time to wait for statvfs() in milliseconds
+    */
+    StatVfsProbe::StatVfsProbe(SCXCoreLib::SCXHandle<DiskDepend> deps, unsigned int timeoutMsec /* = STATVFS_DEFAULT_TIMEOUT_MSEC */) :
+        m_deps(deps),
+        m_timeoutMsec(timeoutMsec),
+        m_param(0),
+        m_thread(0),
+        m_hasValue(false),
+        m_timeouts(0),
+        m_quarantineSeconds(STATVFS_QUARANTINE_MIN_SECONDS),
+        m_quarantineEnd(0)
+    {
+        m_log = SCXCoreLib::SCXLogHandleFactory::GetLogHandle(L"scx.core.common.pal.system.disk.statvfsprobe");
+        memset(&m_value, 0, sizeof(m_value));
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Destructor. A worker that has returned is joined, one that has not is
+       left behind; dropping the handle detaches it.
+    */
+    StatVfsProbe::~StatVfsProbe()
+    {
+        SCXStatVfs buf;
+        int err = 0;
+        int rc = 0;
+        Harvest(buf, err, rc);
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Sets the time to wait for statvfs().
+
+       \param[in] timeoutMsec Time in milliseconds
+    */
+    void StatVfsProbe::SetTimeout(unsigned int timeoutMsec)
+    {
+        m_timeoutMsec = timeoutMsec;
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Tests if the mount point is in quarantine.
+
+       \returns true if no calls are made until the quarantine has passed
+    */
+    bool StatVfsProbe::IsQuarantined() const
+    {
+        return 0 != m_quarantineEnd && time(NULL) < m_quarantineEnd;
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Tests if statvfs() on a file system of a type may block on a server.
+
+       \param[in] fsType File system type as in the mount table
+       \returns   true for network and FUSE file systems, and if the type is not known
+    */
+    bool StatVfsProbe::MayBlock(const std::wstring& fsType)
+    {
+        static const std::wstring NETFS[] = {
+            L"9p", L"afs", L"ceph", L"cifs", L"coda", L"davfs", L"glusterfs",
+            L"lustre", L"ncpfs", L"smb3", L"smbfs", L"sshfs",
+            L"" };
+
+        std::wstring fs = SCXCoreLib::StrToLower(fsType);
+        if (fs.empty() || SCXCoreLib::StrIsPrefix(fs, L"nfs") || SCXCoreLib::StrIsPrefix(fs, L"fuse"))
+        {
+            return true;
+        }
+        for (size_t i = 0; ! NETFS[i].empty(); i++)
+        {
+            if (fs == NETFS[i])
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Calls statvfs() and waits at most the timeout for it.
+
+       \param[in]  mountPoint Mount point
+       \param[in]  fsType     File system type of the mount point
+       \param[out] buf        Fresh value, or the last good value if stale
+       \param[out] err        errno of a failed call
+       \returns    Outcome of the call
+
+       Local file systems answer from memory, so only those for which
+       MayBlock() is true are called on a worker.
+    */
+    StatVfsResult StatVfsProbe::StatVfs(const std::wstring& mountPoint, const std::wstring& fsType, SCXStatVfs& buf, int& err)
+    {
+        err = 0;
+
+        if ( ! MayBlock(fsType))
+        {
+            memset(&buf, 0, sizeof(buf));
+            if (0 != m_deps->statvfs(SCXCoreLib::StrToMultibyte(mountPoint).c_str(), &buf))
+            {
+                err = errno;
+                return eStatVfsFailed;
+            }
+            Accept(buf);
+            return eStatVfsOk;
+        }
+
+        // A worker of an earlier call that has returned since is harvested, one that
+        // has not is still hanging and no new worker is started
+        int rc = 0;
+        if (Harvest(buf, err, rc) && 0 == rc)
+        {
+            SCX_LOGINFO(m_log, L"statvfs() answered again for " + mountPoint);
+            Accept(buf);
+        }
+
+        if (IsQuarantined())
+        {
+            SCX_LOGHYSTERICAL(m_log, L"statvfs() skipped for quarantined " + mountPoint);
+            buf = m_value;
+            return m_hasValue ? eStatVfsStale : eStatVfsNoValue;
+        }
+        if (0 != m_param)
+        {
+            return TimedOut(mountPoint, buf);
+        }
+
+        m_param = new StatVfsProbeThreadParam(m_deps, SCXCoreLib::StrToMultibyte(mountPoint));
+        m_param->m_cond.SetSleep(m_timeoutMsec);
+        try
+        {
+            m_thread = new SCXCoreLib::SCXThread(StatVfsProbeWorker, SCXCoreLib::SCXThreadParamHandle(m_param));
+        }
+        catch (const SCXCoreLib::SCXException& e)
+        {
+            SCX_LOGWARNING(m_log, L"Unable to start statvfs() worker for " + mountPoint + L" - " + e.What());
+            m_param = 0;
+            m_thread = 0;
+            buf = m_value;
+            return m_hasValue ? eStatVfsStale : eStatVfsNoValue;
+        }
+
+        {
+            SCXCoreLib::SCXConditionHandle h(m_param->m_cond);
+            while ( ! m_param->m_done)
+            {
+                if (SCXCoreLib::SCXCondition::eCondTimeout == h.Wait())
+                {
+                    break;
+                }
+            }
+        }
+
+        if ( ! Harvest(buf, err, rc))
+        {
+            SCX_LOGWARNING(m_log, SCXCoreLib::StrAppend(L"statvfs() did not answer within ms: ", m_timeoutMsec) + L" for " + mountPoint);
+            CountTimeout(mountPoint);
+            buf = m_value;
+            return m_hasValue ? eStatVfsStale : eStatVfsNoValue;
+        }
+
+        if (0 != rc)
+        {
+            return eStatVfsFailed;
+        }
+
+        Accept(buf);
+        return eStatVfsOk;
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Collects the result of the outstanding worker if it has returned.
+
+       \param[out] buf Result of statvfs()
+       \param[out] err errno after statvfs()
+       \param[out] rc  Return value of statvfs()
+       \returns    true if a worker was outstanding and has returned; it is joined
+    */
+    bool StatVfsProbe::Harvest(SCXStatVfs& buf, int& err, int& rc)
+    {
+        if (0 == m_param)
+        {
+            return false;
+        }
+
+        {
+            SCXCoreLib::SCXConditionHandle h(m_param->m_cond);
+            if ( ! m_param->m_done)
+            {
+                return false;
+            }
+            rc = m_param->m_rc;
+            err = m_param->m_err;
+            buf = m_param->m_buf;
+        }
+
+        m_thread->Wait();
+        m_thread = 0;
+        m_param = 0;
+        return true;
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Stores a good value and lifts any quarantine.
+
+       \param[in] buf Result of a successful statvfs()
+    */
+    void StatVfsProbe::Accept(const SCXStatVfs& buf)
+    {
+        m_value = buf;
+        m_hasValue = true;
+        m_timeouts = 0;
+        m_quarantineSeconds = STATVFS_QUARANTINE_MIN_SECONDS;
+        m_quarantineEnd = 0;
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Counts a timeout and puts the mount point in quarantine after
+       STATVFS_QUARANTINE_TIMEOUTS consecutive ones.
+
+       \param[in] mountPoint Mount point
+    */
+    void StatVfsProbe::CountTimeout(const std::wstring& mountPoint)
+    {
+        m_timeouts++;
+        if (m_timeouts >= STATVFS_QUARANTINE_TIMEOUTS)
+        {
+            m_quarantineEnd = time(NULL) + static_cast<time_t>(m_quarantineSeconds);
+            SCX_LOGWARNING(m_log, SCXCoreLib::StrAppend(L"statvfs() quarantined for seconds: ", m_quarantineSeconds) + L" for " + mountPoint);
+            m_quarantineSeconds = (2 * m_quarantineSeconds > STATVFS_QUARANTINE_MAX_SECONDS) ? STATVFS_QUARANTINE_MAX_SECONDS : 2 * m_quarantineSeconds;
+            m_timeouts = 0;
+        }
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Handles a call while the worker of an earlier call is still hanging.
+       The call counts as one more timeout, so a mount point whose statvfs()
+       never returns is quarantined as well.
+
+       \param[in]  mountPoint Mount point
+       \param[out] buf        Last good value
+       \returns    eStatVfsStale or eStatVfsNoValue
+    */
+    StatVfsResult StatVfsProbe::TimedOut(const std::wstring& mountPoint, SCXStatVfs& buf)
+    {
+        SCX_LOGHYSTERICAL(m_log, L"statvfs() still outstanding for " + mountPoint);
+        CountTimeout(mountPoint);
+        buf = m_value;
+        return m_hasValue ? eStatVfsStale : eStatVfsNoValue;
+    }
+}
+
+/*----------------------------E-N-D---O-F---F-I-L-E---------------------------*/
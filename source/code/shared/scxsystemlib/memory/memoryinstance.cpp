@@ -19,9 +19,19 @@
 #include <scxcorelib/stringaid.h>
 #include <scxcorelib/scxmath.h>
 #include <scxsystemlib/memoryinstance.h>
+#include <scxsystemlib/sysfsutil.h>
 #include <string>
 #include <sstream>
 
+#if defined(linux)
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
 #if defined(sun)
 #include <sys/types.h>
 #include <sys/processor.h>
@@ -39,43 +49,201 @@
 
 using namespace SCXCoreLib;
 
+#if defined(linux)
+namespace
+{
+    /** Names of the /proc/meminfo keys, in MemInfoKey order. */
+    const char* const MEMINFO_KEY_NAMES[SCXSystemLib::eMemInfoKeyCount] =
+    {
+        "MemTotal", "MemFree", "MemAvailable", "MemUsed", "Buffers", "Cached", "SwapTotal", "SwapFree",
+        "HugePages_Total", "HugePages_Free", "Hugepagesize", "Slab", "SReclaimable", "Shmem",
+        "Dirty", "Writeback"
+    };
+
+    /**
+        Keys present in the per NUMA node meminfo files.
+
+        The parser stops once all keys of a table are found, so each table
+        holds only keys its file has. MemUsed is only in the node files, and
+        the node files lack MemAvailable, Buffers, Cached, swap and Hugepagesize.
+    */
+    const SCXSystemLib::MemInfoKey NODE_MEMINFO_KEYS[] =
+    {
+        SCXSystemLib::eMemInfoMemTotal, SCXSystemLib::eMemInfoMemFree, SCXSystemLib::eMemInfoMemUsed,
+        SCXSystemLib::eMemInfoDirty, SCXSystemLib::eMemInfoWriteback, SCXSystemLib::eMemInfoShmem,
+        SCXSystemLib::eMemInfoSlab, SCXSystemLib::eMemInfoSReclaimable,
+        SCXSystemLib::eMemInfoHugePagesTotal, SCXSystemLib::eMemInfoHugePagesFree
+    };
+
+    /** NUMA nodes that are online, in cpu list format. */
+    const std::string MEMORY_NODE_ONLINE_FILE = "/sys/devices/system/node/online";
+
+    /** Per node directories, followed by the node number. */
+    const std::string MEMORY_SYS_NODE_DIR = "/sys/devices/system/node/node";
+
+    /** Names of the /proc/vmstat keys, in VMStatKey order. */
+    const char* const VMSTAT_KEY_NAMES[SCXSystemLib::eVMStatKeyCount] =
+    {
+        "pgpgin", "pgpgout"
+    };
+}
+#endif
+
 namespace SCXSystemLib
 {
 
+    /*----------------------------------------------------------------------------*/
+    /**
+        Constructor
+    */
+    MemoryDependencies::MemoryDependencies()
 #if defined(linux)
+        : m_lock(ThreadLockHandleGet()), m_memInfoFd(-1), m_vmStatFd(-1)
+#endif
+    {
+    }
 
     /*----------------------------------------------------------------------------*/
     /**
-        Get all lines from meminfo file
+        Destructor. Closes the files kept open between reads.
+    */
+    MemoryDependencies::~MemoryDependencies()
+    {
+#if defined(linux)
+        if (m_memInfoFd >= 0)
+        {
+            close(m_memInfoFd);
+        }
+        if (m_vmStatFd >= 0)
+        {
+            close(m_vmStatFd);
+        }
+#endif
+    }
+
+#if defined(linux)
 
-        \returns     vector of lines
+    /*----------------------------------------------------------------------------*/
+    /**
+        Reads a file in /proc into a caller supplied buffer.
+
+        \param[in]     path  Name of the file
+        \param[in,out] fd    Descriptor of the file, opened on first use
+        \param[out]    buf   Buffer to read into
+        \param[in]     size  Size of buffer
+        \returns       Number of bytes read. If equal to size the buffer was
+                       too small and the contents are truncated.
+
+        \throws        SCXErrnoException if the file cannot be opened or read
+
+        The file is opened once and then re-read from offset zero with
+        pread(), which makes the kernel regenerate the contents. Both the
+        provider and the sampler thread read /proc/meminfo, so the open is
+        done under a lock.
     */
-    std::vector<std::wstring> MemoryDependencies::GetMemInfoLines()
+    size_t MemoryDependencies::ReadProcFile(const char* path, int& fd, char* buf, size_t size)
     {
-        const std::wstring meminfoFileName = L"/proc/meminfo";
-        std::vector<std::wstring> lines;
-        SCXStream::NLFs nlfs;
+        {
+            SCXThreadLock lock(m_lock);
+            if (fd < 0)
+            {
+                fd = open(path, O_RDONLY);
+                if (fd < 0)
+                {
+                    throw SCXErrnoException(L"open", errno, SCXSRCLOCATION);
+                }
+            }
+        }
 
-        SCXFile::ReadAllLines(SCXFilePath(meminfoFileName), lines, nlfs);
+        size_t total = 0;
+        while (total < size)
+        {
+            ssize_t n = pread(fd, buf + total, size - total, static_cast<off_t>(total));
+            if (n < 0)
+            {
+                if (EINTR == errno)
+                {
+                    continue;
+                }
+                throw SCXErrnoException(L"pread", errno, SCXSRCLOCATION);
+            }
+            if (0 == n)
+            {
+                break;
+            }
+            total += static_cast<size_t>(n);
+        }
+        return total;
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+        Reads /proc/meminfo
+
+        \param[out]  buf   Buffer to read into
+        \param[in]   size  Size of buffer
+        \returns     Number of bytes read, equal to size if truncated
+    */
+    size_t MemoryDependencies::ReadMemInfo(char* buf, size_t size)
+    {
+        return ReadProcFile("/proc/meminfo", m_memInfoFd, buf, size);
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+        Reads /proc/vmstat
+
+        \param[out]  buf   Buffer to read into
+        \param[in]   size  Size of buffer
+        \returns     Number of bytes read, equal to size if truncated
+    */
+    size_t MemoryDependencies::ReadVMStat(char* buf, size_t size)
+    {
+        return ReadProcFile("/proc/vmstat", m_vmStatFd, buf, size);
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+        Reads the list of NUMA nodes that are online.
 
-        return lines;
+        \param[out]  content  Contents of /sys/devices/system/node/online
+        \returns     false if the file could not be read, as on kernels without NUMA support
+    */
+    bool MemoryDependencies::ReadNodeOnline(std::string& content)
+    {
+        return SysFsUtil::ReadFile(MEMORY_NODE_ONLINE_FILE, content);
     }
 
     /*----------------------------------------------------------------------------*/
     /**
-        Get all lines from vmstat file
+        Reads the meminfo file of a NUMA node.
 
-        \returns     vector of lines
+        \param[in]   node  Node number
+        \param[out]  buf   Buffer to read into
+        \param[in]   size  Size of buffer
+        \returns     Number of bytes read, zero if the file could not be read
     */
-    std::vector<std::wstring> MemoryDependencies::GetVMStatLines()
+    size_t MemoryDependencies::ReadNodeMemInfo(unsigned int node, char* buf, size_t size)
     {
-        const std::wstring vmstatFileName = L"/proc/vmstat";
-        std::vector<std::wstring> lines;
-        SCXStream::NLFs nlfs;
+        char path[64];
+        snprintf(path, sizeof(path), "%s%u/meminfo", MEMORY_SYS_NODE_DIR.c_str(), node);
+        return SysFsUtil::ReadFile(path, buf, size);
+    }
 
-        SCXFile::ReadAllLines(SCXFilePath(vmstatFileName), lines, nlfs);
+    /*----------------------------------------------------------------------------*/
+    /**
+        Gets the time that samples are stamped with.
+
+        The monotonic clock is used so that a step of the wall clock
+        does not distort the rates.
 
-        return lines;
+        \returns     Milliseconds since an arbitrary fixed point
+    */
+    scxulong MemoryDependencies::GetTimeMilliseconds()
+    {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return static_cast<scxulong>(ts.tv_sec) * 1000 + static_cast<scxulong>(ts.tv_nsec) / 1000000;
     }
 
 #elif defined(sun)
@@ -473,12 +641,40 @@ namespace SCXSystemLib
         m_reservedMemoryIsSupported(true),
 #else
         m_reservedMemoryIsSupported(false),
+#endif
+#if defined(linux)
+        m_memInfoBuffer(MEMORY_PROC_INITIAL_BUFFER_SIZE),
+        m_vmStatBuffer(MEMORY_PROC_INITIAL_BUFFER_SIZE),
+        m_sampleLock(ThreadLockHandleGet()),
+        m_sampleBuffer(MEMORY_PROC_INITIAL_BUFFER_SIZE),
 #endif
         m_dataAquisitionThread(0)
     {
         m_log = SCXLogHandleFactory::GetLogHandle(L"scx.core.common.pal.system.memory.memoryinstance");
         SCX_LOGTRACE(m_log, L"MemoryInstance default constructor");
 
+#if defined(linux)
+        for (size_t i = 0; i < eMemInfoKeyCount; i++)
+        {
+            if (eMemInfoMemUsed != i)
+            {
+                m_memInfoKeys.Add(MEMINFO_KEY_NAMES[i], i);
+            }
+            m_memInfo.value[i] = 0;
+            m_memInfo.found[i] = false;
+            m_sampledMemInfo.value[i] = 0;
+            m_sampledMemInfo.found[i] = false;
+        }
+        for (size_t i = 0; i < sizeof(NODE_MEMINFO_KEYS) / sizeof(NODE_MEMINFO_KEYS[0]); i++)
+        {
+            m_nodeMemInfoKeys.Add(MEMINFO_KEY_NAMES[NODE_MEMINFO_KEYS[i]], NODE_MEMINFO_KEYS[i]);
+        }
+        for (size_t i = 0; i < eVMStatKeyCount; i++)
+        {
+            m_vmStatKeys.Add(VMSTAT_KEY_NAMES[i], i);
+        }
+#endif
+
 #if defined(sun)
         m_kstat = deps->CreateKstat();
 #endif
@@ -658,6 +854,443 @@ namespace SCXSystemLib
         return true;
     }
 
+    /*----------------------------------------------------------------------------*/
+    /**
+        Get the number of huge pages in the pool.
+
+        \param[out]  hugePagesTotal Number of huge pages.
+        \returns     true if a value is supported by this implementation
+    */
+    bool MemoryInstance::GetHugePagesTotal(scxulong& hugePagesTotal) const
+    {
+        hugePagesTotal = 0;
+#if defined(linux)
+        if (GetSampledValue(eMemInfoHugePagesTotal, hugePagesTotal))
+        {
+            return true;
+        }
+#endif
+        return false;
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+        Get the number of huge pages in the pool that are not allocated.
+
+        \param[out]  hugePagesFree Number of free huge pages.
+        \returns     true if a value is supported by this implementation
+    */
+    bool MemoryInstance::GetHugePagesFree(scxulong& hugePagesFree) const
+    {
+        hugePagesFree = 0;
+#if defined(linux)
+        if (GetSampledValue(eMemInfoHugePagesFree, hugePagesFree))
+        {
+            return true;
+        }
+#endif
+        return false;
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+        Get the size of a huge page in kB.
+
+        \param[out]  hugePageSize Size of a huge page in kB.
+        \returns     true if a value is supported by this implementation
+    */
+    bool MemoryInstance::GetHugePageSize(scxulong& hugePageSize) const
+    {
+        hugePageSize = 0;
+#if defined(linux)
+        if (GetSampledValue(eMemInfoHugepagesize, hugePageSize))
+        {
+            return true;
+        }
+#endif
+        return false;
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+        Get the amount of memory used by the kernel slab allocator in MB.
+
+        \param[out]  slab Slab memory.
+        \returns     true if a value is supported by this implementation
+    */
+    bool MemoryInstance::GetSlabMemory(scxulong& slab) const
+    {
+        slab = 0;
+#if defined(linux)
+        if (GetSampledValue(eMemInfoSlab, slab))
+        {
+            slab = KiloBytesToMegaBytes(slab);
+            return true;
+        }
+#endif
+        return false;
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+        Get the amount of slab memory that can be reclaimed, such as caches, in MB.
+
+        \param[out]  slabReclaimable Reclaimable slab memory.
+        \returns     true if a value is supported by this implementation
+    */
+    bool MemoryInstance::GetSlabReclaimableMemory(scxulong& slabReclaimable) const
+    {
+        slabReclaimable = 0;
+#if defined(linux)
+        if (GetSampledValue(eMemInfoSReclaimable, slabReclaimable))
+        {
+            slabReclaimable = KiloBytesToMegaBytes(slabReclaimable);
+            return true;
+        }
+#endif
+        return false;
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+        Get the amount of shared memory and tmpfs in MB.
+
+        \param[out]  shmem Shared memory.
+        \returns     true if a value is supported by this implementation
+    */
+    bool MemoryInstance::GetSharedMemory(scxulong& shmem) const
+    {
+        shmem = 0;
+#if defined(linux)
+        if (GetSampledValue(eMemInfoShmem, shmem))
+        {
+            shmem = KiloBytesToMegaBytes(shmem);
+            return true;
+        }
+#endif
+        return false;
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+        Get the amount of memory waiting to be written back to disk in MB.
+
+        \param[out]  dirty Dirty memory.
+        \returns     true if a value is supported by this implementation
+    */
+    bool MemoryInstance::GetDirtyMemory(scxulong& dirty) const
+    {
+        dirty = 0;
+#if defined(linux)
+        if (GetSampledValue(eMemInfoDirty, dirty))
+        {
+            dirty = KiloBytesToMegaBytes(dirty);
+            return true;
+        }
+#endif
+        return false;
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+        Get the amount of memory being written back to disk in MB.
+
+        \param[out]  writeback Memory under writeback.
+        \returns     true if a value is supported by this implementation
+    */
+    bool MemoryInstance::GetWritebackMemory(scxulong& writeback) const
+    {
+        writeback = 0;
+#if defined(linux)
+        if (GetSampledValue(eMemInfoWriteback, writeback))
+        {
+            writeback = KiloBytesToMegaBytes(writeback);
+            return true;
+        }
+#endif
+        return false;
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+        Get the rate at which dirty memory grows.
+
+        \param[out]  trend Change in kB per second over the sampled window, negative if shrinking.
+        \returns     true if a value is supported by this implementation
+
+        A steadily positive trend means writers dirty pages faster than the
+        system writes them back.
+    */
+    bool MemoryInstance::GetDirtyMemoryTrend(double& trend) const
+    {
+#if defined(linux)
+        trend = GetTrend(m_dirty);
+        return true;
+#else
+        trend = 0.0;
+        return false;
+#endif
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+        Get the rate at which memory under writeback grows.
+
+        \param[out]  trend Change in kB per second over the sampled window, negative if shrinking.
+        \returns     true if a value is supported by this implementation
+
+    */
+    bool MemoryInstance::GetWritebackMemoryTrend(double& trend) const
+    {
+#if defined(linux)
+        trend = GetTrend(m_writeback);
+        return true;
+#else
+        trend = 0.0;
+        return false;
+#endif
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+        Get the number of NUMA nodes with memory information.
+
+        \returns     Number of nodes as of the latest sample, zero if not supported
+    */
+    size_t MemoryInstance::GetNodeCount() const
+    {
+#if defined(linux)
+        SCXThreadLock lock(m_sampleLock);
+        return m_nodes.size();
+#else
+        return 0;
+#endif
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+        Get the memory of a NUMA node.
+
+        \param[in]   index Index of the node, less than GetNodeCount()
+        \param[out]  node  Copy of the values of the node, in kB (huge pages in pages)
+        \returns     false if there is no node with the index
+
+        The nodes are replaced by each sample, so the values are copied.
+    */
+    bool MemoryInstance::GetNode(size_t index, MemoryNodeValues& node) const
+    {
+#if defined(linux)
+        SCXThreadLock lock(m_sampleLock);
+        if (index < m_nodes.size())
+        {
+            node = m_nodes[index];
+            return true;
+        }
+#else
+        (void) index;
+        (void) node;
+#endif
+        return false;
+    }
+
+#if defined(linux)
+    /*----------------------------------------------------------------------------*/
+    /**
+        Reads /proc/meminfo into a buffer, growing the buffer as needed.
+
+        \param[in]     deps    Dependencies to read through
+        \param[in,out] buffer  Buffer to read into
+        \returns       Number of bytes read
+
+        Update() and the sampler thread each have a buffer of their own.
+    */
+    size_t MemoryInstance::ReadMemInfo(MemoryDependencies* deps, std::vector<char>& buffer)
+    {
+        size_t len = deps->ReadMemInfo(&buffer[0], buffer.size());
+        while (len >= buffer.size())
+        {
+            buffer.resize(buffer.size() * 2);
+            SCX_LOGTRACE(m_log, StrAppend(L"MemoryInstance ReadMemInfo - Buffer grown to ", buffer.size()));
+            len = deps->ReadMemInfo(&buffer[0], buffer.size());
+        }
+        return len;
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+        Reads /proc/vmstat into m_vmStatBuffer, growing the buffer as needed.
+
+        \param[in]   deps  Dependencies to read through
+        \returns     Number of bytes read
+
+        Only called from the sampler thread, which owns m_vmStatBuffer.
+    */
+    size_t MemoryInstance::ReadVMStat(MemoryDependencies* deps)
+    {
+        size_t len = deps->ReadVMStat(&m_vmStatBuffer[0], m_vmStatBuffer.size());
+        while (len >= m_vmStatBuffer.size())
+        {
+            m_vmStatBuffer.resize(m_vmStatBuffer.size() * 2);
+            SCX_LOGTRACE(m_log, StrAppend(L"MemoryInstance ReadVMStat - Buffer grown to ", m_vmStatBuffer.size()));
+            len = deps->ReadVMStat(&m_vmStatBuffer[0], m_vmStatBuffer.size());
+        }
+        return len;
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+        Parses the contents of /proc/meminfo.
+
+        \param[in]   p       Start of the file contents
+        \param[in]   end     End of the file contents
+        \param[out]  values  Values of the keys in MemInfoKey, in kB
+
+        Keys missing from the file are marked as not found, and their values
+        are left untouched.
+    */
+    void MemoryInstance::ParseMemInfo(const char* p, const char* end, MemInfoValues& values) const
+    {
+        for (size_t i = 0; i < eMemInfoKeyCount; i++)
+        {
+            values.found[i] = false;
+        }
+        m_memInfoKeys.Parse(p, end, values.value, values.found);
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+        Parses the contents of a per NUMA node meminfo file.
+
+        \param[in]   p       Start of the file contents
+        \param[in]   end     End of the file contents
+        \param[out]  values  Values of the keys in MemInfoKey, in kB
+
+        Each line starts with "Node <n>", which is skipped. Keys missing
+        from the file are marked as not found.
+    */
+    void MemoryInstance::ParseNodeMemInfo(const char* p, const char* end, MemInfoValues& values) const
+    {
+        for (size_t i = 0; i < eMemInfoKeyCount; i++)
+        {
+            values.found[i] = false;
+        }
+        m_nodeMemInfoKeys.Parse(p, end, values.value, values.found, 2);
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+        Samples the detailed memory breakdown and the per NUMA node memory.
+
+        \param[in]   deps  Dependencies to read through
+
+        Called from the sampler thread in the same pass as the paging
+        counters. The results are published under m_sampleLock; in steady
+        state nothing is allocated.
+    */
+    void MemoryInstance::SampleDetails(MemoryDependencies* deps)
+    {
+        MemInfoValues values;
+        try
+        {
+            size_t len = ReadMemInfo(deps, m_sampleBuffer);
+            const char* p = &m_sampleBuffer[0];
+            ParseMemInfo(p, p + len, values);
+        }
+        catch (SCXErrnoException& e)
+        {
+            SCX_LOGWARNING(m_log, std::wstring(L"Could not read /proc/meminfo: ").append(e.What()));
+            return;
+        }
+
+        if (values.found[eMemInfoDirty])
+        {
+            m_dirty.AddSample(values.value[eMemInfoDirty]);
+        }
+        if (values.found[eMemInfoWriteback])
+        {
+            m_writeback.AddSample(values.value[eMemInfoWriteback]);
+        }
+
+        m_nodeScratch.clear();
+        if (deps->ReadNodeOnline(m_nodeOnline) && SysFsUtil::ParseCpuList(m_nodeOnline, m_nodeList))
+        {
+            char buf[MEMORY_NODE_MEMINFO_MAX_SIZE];
+            for (std::vector<unsigned int>::const_iterator it = m_nodeList.begin(); it != m_nodeList.end(); ++it)
+            {
+                size_t len = deps->ReadNodeMemInfo(*it, buf, sizeof(buf));
+                if (0 == len)
+                {
+                    SCX_LOGHYSTERICAL(m_log, StrAppend(L"MemoryInstance SampleDetails - No meminfo for node ", *it));
+                    continue;
+                }
+
+                MemoryNodeValues node;
+                node.node = *it;
+                ParseNodeMemInfo(buf, buf + len, node.memInfo);
+                m_nodeScratch.push_back(node);
+            }
+        }
+
+        SCXThreadLock lock(m_sampleLock);
+        m_sampledMemInfo = values;
+        m_nodes.swap(m_nodeScratch);
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+        Gets a value of /proc/meminfo as of the latest sample.
+
+        \param[in]   key    Key to get
+        \param[out]  value  Value of the key
+        \returns     true if the key was present
+    */
+    bool MemoryInstance::GetSampledValue(MemInfoKey key, scxulong& value) const
+    {
+        SCXThreadLock lock(m_sampleLock);
+        value = m_sampledMemInfo.value[key];
+        return m_sampledMemInfo.found[key];
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+        Computes how fast a sampled value grows.
+
+        \param[in]   sampler  Samples of the value, in kB
+        \returns     Change in kB per second over the sampled window, negative if shrinking
+    */
+    double MemoryInstance::GetTrend(const MemoryInstanceDataSampler& sampler)
+    {
+        size_t samples = sampler.GetNumberOfSamples();
+        if (samples < 2)
+        {
+            return 0.0;
+        }
+        double delta = static_cast<double>(sampler[0]) - static_cast<double>(sampler[samples - 1]);
+        return delta / static_cast<double>((samples - 1) * MEMORY_SECONDS_PER_SAMPLE);
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+        Parses the contents of /proc/vmstat.
+
+        \param[in]   p       Start of the file contents
+        \param[in]   end     End of the file contents
+        \param[out]  values  Values of the keys in VMStatKey
+
+        Keys missing from the file are marked as not found, and their values
+        are set to zero.
+    */
+    void MemoryInstance::ParseVMStat(const char* p, const char* end, VMStatValues& values) const
+    {
+        for (size_t i = 0; i < eVMStatKeyCount; i++)
+        {
+            values.value[i] = 0;
+            values.found[i] = false;
+        }
+        m_vmStatKeys.Parse(p, end, values.value, values.found);
+    }
+#endif
+
     /*----------------------------------------------------------------------------*/
     /**
         Update the object members with values from hardware.
@@ -707,115 +1340,55 @@ namespace SCXSystemLib
         We are interested in the following fields:
           MemTotal
           MemFree
+          MemAvailable (kernel 3.14 and later, not in the example above)
+          Buffers and Cached (when MemAvailable is missing)
           SwapTotal
           SwapFree
     */
-        std::vector<std::wstring> lines = m_deps->GetMemInfoLines();
+        size_t len = ReadMemInfo(m_deps.GetData(), m_memInfoBuffer);
+        const char* p = &m_memInfoBuffer[0];
+        ParseMemInfo(p, p + len, m_memInfo);
 
-        bool foundTotalPhysMem = false;
-        bool foundAvailMem = false;
-        bool foundTotalSwap = false;
-        bool foundAvailSwap = false;
-        scxulong buffers = 0, cached = 0;
+        const scxulong* kB = m_memInfo.value;
+        const bool* found = m_memInfo.found;
 
-        for (size_t i=0; i<lines.size(); i++)
+        if (found[eMemInfoMemTotal])
         {
-            std::wstring line = lines[i];
-
-            SCX_LOGHYSTERICAL(m_log, std::wstring(L"UpdateFromMemInfo() - Read line: ").append(line));
-
-            std::vector<std::wstring> tokens;
-            StrTokenize(line, tokens);
-            if (tokens.size() >= 2)
-            {
-                if (L"MemTotal:" == tokens[0])
-                {
-                    try
-                    {
-                        m_totalPhysicalMemory = KiloBytesToMegaBytes(StrToULong(tokens[1]));
-                        foundTotalPhysMem = true;
-                        SCX_LOGHYSTERICAL(m_log, StrAppend(L"    totalPhysicalMemory = ", m_totalPhysicalMemory));
-                    }
-                    catch (const SCXNotSupportedException& e)
-                    {
-                        SCX_LOGWARNING(m_log, std::wstring(L"Could not read m_totalPhysicalMemory from :").append(line).append(L" - ").append(e.What()));
-                    }
-                }
-                if (L"MemFree:" == tokens[0])
-                {
-                    try
-                    {
-                        m_availableMemory = KiloBytesToMegaBytes(StrToULong(tokens[1]));
-                        foundAvailMem = true;
-                        SCX_LOGHYSTERICAL(m_log, StrAppend(L"    availableMemory = ", m_availableMemory));
-                    }
-                    catch (const SCXNotSupportedException& e)
-                    {
-                        SCX_LOGWARNING(m_log, std::wstring(L"Could not read m_availableMemory from: ").append(line).append(L" - ").append(e.What()));
-                    }
-                }
-                if (L"Buffers:" == tokens[0])
-                {
-                    try
-                    {
-                        buffers = KiloBytesToMegaBytes(StrToULong(tokens[1]));
-                        SCX_LOGHYSTERICAL(m_log, StrAppend(L"    buffers = ", buffers));
-                    }
-                    catch (const SCXNotSupportedException& e)
-                    {
-                        SCX_LOGWARNING(m_log, std::wstring(L"Could not read buffers from: ").append(line).append(L" - ").append(e.What()));
-                    }
-                }
-                if (L"Cached:" == tokens[0])
-                {
-                    try
-                    {
-                        cached = KiloBytesToMegaBytes(StrToULong(tokens[1]));
-                        SCX_LOGHYSTERICAL(m_log, StrAppend(L"    Cached = ", cached));
-                    }
-                    catch (const SCXNotSupportedException& e)
-                    {
-                        SCX_LOGWARNING(m_log, std::wstring(L"Could not read buffers from: ").append(line).append(L" - ").append(e.What()));
-                    }
-                }
-                if (L"SwapTotal:" == tokens[0])
-                {
-                    try
-                    {
-                        m_totalSwap = KiloBytesToMegaBytes(StrToULong(tokens[1]));
-                        foundTotalSwap = true;
-                        SCX_LOGHYSTERICAL(m_log, StrAppend(L"    totalSwap = ", m_totalSwap));
-                    }
-                    catch (const SCXNotSupportedException& e)
-                    {
-                        SCX_LOGWARNING(m_log, std::wstring(L"Could not read m_totalSwap from: ").append(line).append(L" - ").append(e.What()));
-                    }
-                }
-                if (L"SwapFree:" == tokens[0])
-                {
-                    try
-                    {
-                        m_availableSwap = KiloBytesToMegaBytes(StrToULong(tokens[1]));
-                        foundAvailSwap = true;
-                        SCX_LOGHYSTERICAL(m_log, StrAppend(L"    availableSwap = ", m_availableSwap));
-                    }
-                    catch (const SCXNotSupportedException& e)
-                    {
-                        SCX_LOGWARNING(m_log, std::wstring(L"Could not read m_availableSwap from: ").append(line).append(L" - ").append(e.What()));
-                    }
-                }
-            }
+            m_totalPhysicalMemory = KiloBytesToMegaBytes(kB[eMemInfoMemTotal]);
+        }
+        if (found[eMemInfoMemAvailable])
+        {
+            // The kernel's own estimate, which accounts for reclaimable slab,
+            // shmem that cannot be dropped and the low watermarks
+            m_availableMemory = KiloBytesToMegaBytes(kB[eMemInfoMemAvailable]);
+        }
+        else if (found[eMemInfoMemFree])
+        {
+            // Older kernels: approximate with free memory plus the page cache
+            m_availableMemory = KiloBytesToMegaBytes(kB[eMemInfoMemFree] + kB[eMemInfoBuffers] + kB[eMemInfoCached]);
+        }
+        if (found[eMemInfoSwapTotal])
+        {
+            m_totalSwap = KiloBytesToMegaBytes(kB[eMemInfoSwapTotal]);
         }
+        if (found[eMemInfoSwapFree])
+        {
+            m_availableSwap = KiloBytesToMegaBytes(kB[eMemInfoSwapFree]);
+        }
+
+        SCX_LOGHYSTERICAL(m_log, StrAppend(StrAppend(StrAppend(L"    totalPhysicalMemory = ", m_totalPhysicalMemory),
+                                                     L", availableMemory = "), m_availableMemory));
+        SCX_LOGHYSTERICAL(m_log, StrAppend(StrAppend(StrAppend(L"    totalSwap = ", m_totalSwap),
+                                                     L", availableSwap = "), m_availableSwap));
 
         // perform some adjustments and calculations
-        m_availableMemory += buffers + cached;
         m_usedMemory = m_totalPhysicalMemory - m_availableMemory;
         m_usedSwap = m_totalSwap - m_availableSwap;
-        
-        SCXASSERT(foundTotalPhysMem && "MemTotal not found");
-        SCXASSERT(foundAvailMem && "MemFree not found");
-        SCXASSERT(foundTotalSwap && "SwapTotal not found");
-        SCXASSERT(foundAvailSwap && "SwapFree not found");
+
+        SCXASSERT(found[eMemInfoMemTotal] && "MemTotal not found");
+        SCXASSERT(found[eMemInfoMemFree] && "MemFree not found");
+        SCXASSERT(found[eMemInfoSwapTotal] && "SwapTotal not found");
+        SCXASSERT(found[eMemInfoSwapFree] && "SwapFree not found");
 
 #elif defined(sun)
 
@@ -1020,58 +1593,31 @@ namespace SCXSystemLib
            pgpgout
 
         */
-        try 
+        try
         {
-            std::vector<std::wstring> lines = deps->GetVMStatLines();
+            size_t len = inst->ReadVMStat(deps.GetData());
+            const char* p = &inst->m_vmStatBuffer[0];
 
-            bool foundPgpgin = false;
-            bool foundPgpgout = false;
-    
-            for (size_t i=0; (!foundPgpgin || !foundPgpgout) && i<lines.size(); i++)
-            {
-                std::wstring line = lines[i];
+            VMStatValues values;
+            inst->ParseVMStat(p, p + len, values);
 
-                SCX_LOGHYSTERICAL(log, std::wstring(L"DataAquisitionThreadBody() - Read line: ").append(line));
-    
-                std::vector<std::wstring> tokens;
-                StrTokenize(line, tokens);
-                if (tokens.size() >= 2)
-                {
-                    if (L"pgpgin" == tokens[0])
-                    {
-                        try
-                        {
-                            pageReads = StrToULong(tokens[1]);
-                            foundPgpgin = true;
-                            SCX_LOGHYSTERICAL(log, StrAppend(L"    pageReads = ", pageReads));
-                        }
-                        catch (const SCXNotSupportedException& e)
-                        {
-                            SCX_LOGWARNING(log, std::wstring(L"Could not read pageReads from: ").append(line).append(L" - ").append(e.What()));
-                        }
-                    }
-                    if (L"pgpgout" == tokens[0])
-                    {
-                        try
-                        {
-                            pageWrites = StrToULong(tokens[1]);
-                            foundPgpgout = true;
-                            SCX_LOGHYSTERICAL(log, StrAppend(L"    pageWrites = ", pageWrites));
-                        }
-                        catch (const SCXNotSupportedException& e)
-                        {
-                            SCX_LOGWARNING(log, std::wstring(L"Could not read pageWrites from: ").append(line).append(L" - ").append(e.What()));
-                        }
-                    }
-                }
+            if (values.found[eVMStatPgpgin])
+            {
+                pageReads = values.value[eVMStatPgpgin];
+                SCX_LOGHYSTERICAL(log, StrAppend(L"    pageReads = ", pageReads));
             }
-            SCXASSERT(foundPgpgin && "pgpgin not found.");
-            SCXASSERT(foundPgpgout && "pgpgout not found.");
-        } 
-        catch (SCXFileSystemException &e) 
+            if (values.found[eVMStatPgpgout])
+            {
+                pageWrites = values.value[eVMStatPgpgout];
+                SCX_LOGHYSTERICAL(log, StrAppend(L"    pageWrites = ", pageWrites));
+            }
+            SCXASSERT(values.found[eVMStatPgpgin] && "pgpgin not found.");
+            SCXASSERT(values.found[eVMStatPgpgout] && "pgpgout not found.");
+        }
+        catch (SCXErrnoException &e)
         {
             SCX_LOGERROR(log, std::wstring(L"Could not open /proc/vmstat for reading: ").append(e.What()));
-            return false;            
+            return false;
         }
 
 #elif defined(sun)
@@ -1182,6 +1728,9 @@ namespace SCXSystemLib
 
                     pageReadsParam->AddSample(pageReads);
                     pageWritesParam->AddSample(pageWrites);
+#if defined(linux)
+                    params->GetInst()->SampleDetails(deps.GetData());
+#endif
                     bUpdate = false;
                 }
 
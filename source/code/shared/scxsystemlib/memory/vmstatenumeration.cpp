@@ -0,0 +1,430 @@
+/*----------------------------------------------------------------------------
+    Copyright (c) Microsoft Corporation.  All rights reserved.
+
+*/
+/**
+    \file
+
+    \brief       Enumeration of /proc/vmstat counters
+
+    \date        2026-10-18 17:00:00
+
+*/
+/*----------------------------------------------------------------------------*/
+
+#include <scxcorelib/scxcmn.h>
+#include <scxcorelib/scxexception.h>
+#include <scxcorelib/scxlog.h>
+#include <scxcorelib/scxcondition.h>
+#include <scxcorelib/stringaid.h>
+
+#include <scxsystemlib/vmstatenumeration.h>
+#include <scxsystemlib/vmstatinstance.h>
+
+#include <string>
+
+#include <string.h>
+
+using namespace std;
+using namespace SCXCoreLib;
+
+namespace
+{
+    /**
+       Counters sampled unless configured otherwise: major faults, page
+       scanning and stealing by kswapd and direct reclaim, allocation
+       stalls, OOM kills, transparent huge pages and swapping.
+    */
+    const char* const VMSTAT_DEFAULT_COUNTERS[] =
+    {
+        "pgmajfault", "pgscan_*", "pgsteal_*", "allocstall*", "oom_kill", "thp_*", "pswpin", "pswpout"
+    };
+}
+
+namespace SCXSystemLib
+{
+    /*----------------------------------------------------------------------------*/
+    /**
+       Class that represents values passed between the threads of the vmstat enumeration.
+    */
+    class VMStatEnumerationThreadParam : public SCXThreadParam
+    {
+    public:
+        /*----------------------------------------------------------------------------*/
+        /**
+           Constructor
+
+           \param[in] vmstatenum Pointer to vmstat enumeration associated with the thread.
+        */
+        VMStatEnumerationThreadParam(VMStatEnumeration* vmstatenum)
+            : SCXThreadParam(), m_vmstatenum(vmstatenum)
+        {}
+
+        /*----------------------------------------------------------------------------*/
+        /**
+           Retrieves the vmstat enumeration parameter.
+
+           \returns Pointer to vmstat enumeration associated with the thread.
+        */
+        VMStatEnumeration* GetVMStatEnumeration()
+        {
+            return m_vmstatenum;
+        }
+    private:
+        VMStatEnumeration* m_vmstatenum; //!< Pointer to vmstat enumeration associated with the thread.
+    };
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Default constructor
+
+       \param[in] deps Dependencies for reading /proc/vmstat.
+    */
+    VMStatEnumeration::VMStatEnumeration(SCXCoreLib::SCXHandle<MemoryDependencies> deps) :
+        EntityEnumeration<VMStatInstance>(),
+        m_deps(deps),
+        m_lock(SCXCoreLib::ThreadLockHandleGet()),
+        m_secondsPerSample(VMSTAT_DEFAULT_SECONDS_PER_SAMPLE),
+        m_dataAquisitionThread(NULL)
+    {
+        m_log = SCXLogHandleFactory::GetLogHandle(L"scx.core.common.pal.system.memory.vmstatenumeration");
+
+        SCX_LOGTRACE(m_log, L"VMStatEnumeration default constructor");
+
+        for (size_t i = 0; i < VMSTAT_MAX_COUNTERS; i++)
+        {
+            m_values[i] = 0;
+            m_found[i] = false;
+        }
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Destructor
+    */
+    VMStatEnumeration::~VMStatEnumeration()
+    {
+        SCX_LOGTRACE(m_log, L"VMStatEnumeration destructor");
+        if (NULL != m_dataAquisitionThread)
+        {
+            if (m_dataAquisitionThread->IsAlive())
+            {
+                CleanUp();
+            }
+            m_dataAquisitionThread = NULL;
+        }
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Selects the counters to sample. Must be called before Init().
+
+       \param[in] names Counter names; a name ending in '*' matches all
+                        counters starting with the rest of the name. An
+                        empty list selects the default counters.
+    */
+    void VMStatEnumeration::SetCounters(const std::vector<std::string>& names)
+    {
+        m_names = names;
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Sets the time between samples. Must be called before Init().
+
+       \param[in] seconds Seconds between samples, at least one
+    */
+    void VMStatEnumeration::SetSampleInterval(unsigned int seconds)
+    {
+        m_secondsPerSample = (0 == seconds) ? 1 : seconds;
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Gets the time between samples.
+
+       \returns Seconds between samples
+    */
+    unsigned int VMStatEnumeration::GetSampleInterval() const
+    {
+        return m_secondsPerSample;
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Gets the counters sampled unless configured otherwise.
+
+       \param[out] names Counter names, possibly ending in '*'
+    */
+    void VMStatEnumeration::GetDefaultCounters(std::vector<std::string>& names)
+    {
+        names.assign(VMSTAT_DEFAULT_COUNTERS,
+                     VMSTAT_DEFAULT_COUNTERS + sizeof(VMSTAT_DEFAULT_COUNTERS) / sizeof(VMSTAT_DEFAULT_COUNTERS[0]));
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Tests if a counter is selected by a configured name.
+
+       \param[in] key  Counter name as found in /proc/vmstat, not null terminated
+       \param[in] len  Length of key
+       \param[in] name Configured name, possibly ending in '*'
+       \returns   true if the counter is selected
+    */
+    bool VMStatEnumeration::IsMatch(const char* key, size_t len, const std::string& name)
+    {
+        if (!name.empty() && '*' == name[name.size() - 1])
+        {
+            size_t prefix = name.size() - 1;
+            return len >= prefix && 0 == memcmp(key, name.data(), prefix);
+        }
+        return len == name.size() && 0 == memcmp(key, name.data(), len);
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Resolves the configured names against /proc/vmstat and starts sampling.
+    */
+    void VMStatEnumeration::Init()
+    {
+        SCX_LOGTRACE(m_log, L"VMStatEnumeration Init()");
+
+#if defined(linux)
+        if (m_names.empty())
+        {
+            GetDefaultCounters(m_names);
+        }
+
+        size_t len = 0;
+        try
+        {
+            len = ReadVMStat();
+        }
+        catch (const SCXException& e)
+        {
+            SCX_LOGINFO(m_log, wstring(L"/proc/vmstat is not readable, vmstat counters are not sampled - ").append(e.What()));
+            return;
+        }
+
+        const char* p = &m_buffer[0];
+        const char* end = p + len;
+        while (p < end)
+        {
+            const char* eol = static_cast<const char*>(memchr(p, '\n', end - p));
+            if (NULL == eol)
+            {
+                eol = end;
+            }
+            const char* keyEnd = static_cast<const char*>(memchr(p, ' ', eol - p));
+            if (NULL == keyEnd)
+            {
+                keyEnd = eol;
+            }
+            size_t keyLen = static_cast<size_t>(keyEnd - p);
+
+            for (size_t i = 0; i < m_names.size(); i++)
+            {
+                if (IsMatch(p, keyLen, m_names[i]))
+                {
+                    string key(p, keyLen);
+                    if (Size() >= VMSTAT_MAX_COUNTERS)
+                    {
+                        SCX_LOGWARNING(m_log, StrAppend(L"Too many vmstat counters selected, ignoring ", StrFromMultibyte(key)));
+                    }
+                    else if (m_keys.Add(key, Size()))
+                    {
+                        AddInstance(SCXCoreLib::SCXHandle<VMStatInstance>(new VMStatInstance(key)));
+                    }
+                    break;
+                }
+            }
+            p = eol + 1;
+        }
+
+        if (0 == Size())
+        {
+            SCX_LOGINFO(m_log, L"None of the configured vmstat counters exist on this system");
+            return;
+        }
+
+        SCX_LOGTRACE(m_log, StrAppend(StrAppend(StrAppend(L"VMStatEnumeration Init() - Counters: ", Size()),
+                                                L", seconds per sample: "), m_secondsPerSample));
+
+        SampleData();
+
+        if (NULL == m_dataAquisitionThread)
+        {
+            VMStatEnumerationThreadParam* params = new VMStatEnumerationThreadParam(this);
+            m_dataAquisitionThread = new SCXCoreLib::SCXThread(VMStatEnumeration::DataAquisitionThreadBody, params);
+        }
+#else
+        SCX_LOGINFO(m_log, L"vmstat counters are not supported on this platform");
+#endif
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Update all instances
+
+       \param updateInstances Compute rates from the latest samples
+    */
+    void VMStatEnumeration::Update(bool updateInstances)
+    {
+        SCX_LOGTRACE(m_log, StrAppend(L"VMStatEnumeration Update() - ", updateInstances));
+
+        SCXCoreLib::SCXThreadLock lock(m_lock);
+
+        if (updateInstances)
+        {
+            UpdateInstances();
+        }
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Cleanup
+    */
+    void VMStatEnumeration::CleanUp()
+    {
+        SCX_LOGTRACE(m_log, L"VMStatEnumeration CleanUp()");
+        if (NULL != m_dataAquisitionThread)
+        {
+            m_dataAquisitionThread->RequestTerminate();
+            m_dataAquisitionThread->Wait();
+        }
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Reads /proc/vmstat into m_buffer, growing the buffer as needed.
+
+       \returns Number of bytes read
+    */
+    size_t VMStatEnumeration::ReadVMStat()
+    {
+#if defined(linux)
+        if (m_buffer.empty())
+        {
+            m_buffer.resize(MEMORY_PROC_INITIAL_BUFFER_SIZE);
+        }
+
+        size_t len = m_deps->ReadVMStat(&m_buffer[0], m_buffer.size());
+        while (len >= m_buffer.size())
+        {
+            m_buffer.resize(m_buffer.size() * 2);
+            SCX_LOGTRACE(m_log, StrAppend(L"VMStatEnumeration ReadVMStat - Buffer grown to ", m_buffer.size()));
+            len = m_deps->ReadVMStat(&m_buffer[0], m_buffer.size());
+        }
+        return len;
+#else
+        return 0;
+#endif
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Store new data for all instances
+
+       One read of /proc/vmstat, parsed through the key table. Nothing is
+       allocated.
+    */
+    void VMStatEnumeration::SampleData()
+    {
+        SCX_LOGTRACE(m_log, L"VMStatEnumeration - Start SampleData");
+
+        SCXCoreLib::SCXThreadLock lock(m_lock);
+
+#if defined(linux)
+        size_t len = ReadVMStat();
+        scxulong now = m_deps->GetTimeMilliseconds();
+
+        size_t count = Size();
+        for (size_t i = 0; i < count; i++)
+        {
+            m_found[i] = false;
+        }
+
+        const char* p = &m_buffer[0];
+        m_keys.Parse(p, p + len, m_values, m_found);
+
+        size_t i = 0;
+        for (EntityIterator iter = Begin(); iter != End(); ++iter, ++i)
+        {
+            if (m_found[i])
+            {
+                (*iter)->AddSample(now, m_values[i]);
+            }
+        }
+#endif
+
+        SCX_LOGTRACE(m_log, L"VMStatEnumeration - End SampleData");
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Thread body that updates all values
+
+       \param  param Must contain a parameter of type VMStatEnumerationThreadParam*
+
+       The thread stores new values in all instances once every sample interval.
+    */
+    void VMStatEnumeration::DataAquisitionThreadBody(SCXCoreLib::SCXThreadParamHandle& param)
+    {
+        SCXLogHandle log = SCXLogHandleFactory::GetLogHandle(L"scx.core.common.pal.system.memory.vmstatenumeration");
+        SCX_LOGTRACE(log, L"VMStatEnumeration::DataAquisitionThreadBody()");
+
+        if (0 == param)
+        {
+            SCXASSERT( ! "No parameters to DataAquisitionThreadBody");
+            return;
+        }
+
+        VMStatEnumerationThreadParam* params = static_cast<VMStatEnumerationThreadParam*>(param.GetData());
+        if (0 == params)
+        {
+            SCXASSERT( ! "Invalid parameters to DataAquisitionThreadBody");
+            return;
+        }
+
+        VMStatEnumeration* vmstatenum = params->GetVMStatEnumeration();
+        if (0 == vmstatenum)
+        {
+            SCXASSERT( ! "VMStat Enumeration not set");
+            return;
+        }
+
+        // Init() took the first sample
+        bool bUpdate = false;
+        params->m_cond.SetSleep(vmstatenum->GetSampleInterval() * 1000);
+        {
+            SCXConditionHandle h(params->m_cond);
+
+            while ( ! params->GetTerminateFlag())
+            {
+                if (bUpdate)
+                {
+                    try
+                    {
+                        vmstatenum->SampleData();
+                    }
+                    catch (const SCXException& e)
+                    {
+                        SCX_LOGWARNING(log, std::wstring(L"VMStatEnumeration DataAquisition - ").append(e.What()).append(L" - ").append(e.Where()));
+                    }
+                    bUpdate = false;
+                }
+
+                SCX_LOGHYSTERICAL(log, L"VMStatEnumeration DataAquisition - Sleep ");
+                enum SCXCondition::eConditionResult r = h.Wait();
+                if (SCXCondition::eCondTimeout == r)
+                {
+                    bUpdate = true;
+                }
+            }
+        }
+
+        SCX_LOGHYSTERICAL(log, L"VMStatEnumeration DataAquisition - Ending ");
+    }
+}
+
+/*----------------------------E-N-D---O-F---F-I-L-E---------------------------*/
@@ -0,0 +1,161 @@
+/*----------------------------------------------------------------------------
+    Copyright (c) Microsoft Corporation.  All rights reserved.
+
+*/
+/**
+    \file
+
+    \brief       PAL representation of a /proc/vmstat counter
+
+    \date        2026-10-18 17:00:00
+
+*/
+/*----------------------------------------------------------------------------*/
+
+#include <scxcorelib/scxcmn.h>
+#include <scxcorelib/stringaid.h>
+
+#include <scxsystemlib/vmstatinstance.h>
+
+using namespace std;
+using namespace SCXCoreLib;
+
+namespace SCXSystemLib
+{
+    /*----------------------------------------------------------------------------*/
+    /**
+        Constructor
+
+        \param key Name of the counter in /proc/vmstat
+    */
+    VMStatInstance::VMStatInstance(const std::string& key) :
+        EntityInstance(false),
+        m_key(key),
+        m_hasValue(false),
+        m_latestValue(0),
+        m_rate(0),
+        m_averageRate(0)
+    {
+        m_log = SCXLogHandleFactory::GetLogHandle(L"scx.core.common.pal.system.memory.vmstatinstance");
+
+        SetId(StrFromMultibyte(key));
+
+        SCX_LOGTRACE(m_log, wstring(L"VMStatInstance constructor - ").append(GetId()));
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+        Destructor
+    */
+    VMStatInstance::~VMStatInstance()
+    {
+        SCX_LOGTRACE(m_log, wstring(L"VMStatInstance destructor - ").append(GetId()));
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+        Adds a sample of the counter.
+
+        \param timeMsec Monotonic time of the sample, in milliseconds
+        \param value    Latest counter value
+
+        The counters only go backwards if the kernel was replaced under us
+        (checkpoint/restore), in which case the history is discarded.
+    */
+    void VMStatInstance::AddSample(scxulong timeMsec, scxulong value)
+    {
+        if (m_value.GetNumberOfSamples() > 0 && value < m_value[0])
+        {
+            m_value.Clear();
+            m_time_msec.Clear();
+        }
+        m_time_msec.AddSample(timeMsec);
+        m_value.AddSample(value);
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+        Computes the rate of the counter over the latest samples.
+
+        \param samples Number of samples to go back
+        \returns       Increase of the counter per second, 0 with too few samples
+    */
+    double VMStatInstance::GetRate(size_t samples) const
+    {
+        scxulong elapsed = m_time_msec.GetDelta(samples);
+        if (0 == elapsed)
+        {
+            return 0;
+        }
+        return 1000.0 * static_cast<double>(m_value.GetDelta(samples)) / static_cast<double>(elapsed);
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+        Computes the rates from the sampled counter.
+
+        Called with the enumeration lock held. The getters only return values
+        computed here, since the sampler thread changes the samplers.
+    */
+    void VMStatInstance::Update()
+    {
+        SCX_LOGHYSTERICAL(m_log, wstring(L"VMStatInstance Update() - ").append(GetId()));
+
+        m_hasValue = m_value.GetNumberOfSamples() > 0;
+        m_latestValue = m_hasValue ? m_value[0] : 0;
+        m_rate = GetRate(2);
+        m_averageRate = GetRate(MAX_VMSTATINSTANCE_DATASAMPLER_SAMPLES);
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+        Get the counter name
+
+        \returns     Name of the counter in /proc/vmstat
+    */
+    const std::string& VMStatInstance::GetKey() const
+    {
+        return m_key;
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+        Get the value of the counter as of the latest Update()
+
+        \param[out]  value Value as read from /proc/vmstat
+        \returns     true if the counter has been sampled
+    */
+    bool VMStatInstance::GetValue(scxulong& value) const
+    {
+        value = m_latestValue;
+        return m_hasValue;
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+        Get the rate of the counter over the latest sampling interval
+
+        \param[out]  rate Increase per second
+        \returns     true if a value is supported by this implementation
+    */
+    bool VMStatInstance::GetRatePerSecond(double& rate) const
+    {
+        rate = m_rate;
+        return true;
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+        Get the rate of the counter over all samples kept
+
+        \param[out]  rate Increase per second
+        \returns     true if a value is supported by this implementation
+    */
+    bool VMStatInstance::GetAverageRatePerSecond(double& rate) const
+    {
+        rate = m_averageRate;
+        return true;
+    }
+}
+
+/*----------------------------E-N-D---O-F---F-I-L-E---------------------------*/
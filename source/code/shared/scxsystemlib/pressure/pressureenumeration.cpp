@@ -0,0 +1,481 @@
+/*----------------------------------------------------------------------------
+    Copyright (c) Microsoft Corporation.  All rights reserved.
+
+*/
+/**
+    \file
+
+    \brief       Enumeration of Linux pressure stall information (PSI)
+
+    \date        2026-10-18 15:00:00
+
+*/
+/*----------------------------------------------------------------------------*/
+
+#include <scxcorelib/scxcmn.h>
+#include <scxcorelib/scxexception.h>
+#include <scxcorelib/scxlog.h>
+#include <scxcorelib/scxcondition.h>
+#include <scxcorelib/stringaid.h>
+
+#include <scxsystemlib/pressureenumeration.h>
+#include <scxsystemlib/pressureinstance.h>
+
+#include <string>
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(linux)
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+using namespace SCXCoreLib;
+
+namespace
+{
+    /** Resources with a pressure file, in the order they are reported. */
+    const char* const PRESSURE_RESOURCES[] = { "cpu", "memory", "io" };
+
+    /** Pressure files are two short lines; anything larger is truncated. */
+    const size_t PRESSURE_MAX_FILE_SIZE = 4096;
+
+    /**
+       Parses the value of a "name=value" field.
+
+       \param[in]  p     Start of the field
+       \param[in]  name  Expected name, including the '='
+       \param[out] value Parsed value
+       \returns    Position after the value, or NULL if the field did not match
+    */
+    const char* ParseDoubleField(const char* p, const char* name, double& value)
+    {
+        size_t len = strlen(name);
+        if (0 != strncmp(p, name, len))
+        {
+            return NULL;
+        }
+        char* end = NULL;
+        value = strtod(p + len, &end);
+        return (end == p + len) ? NULL : end;
+    }
+
+    /**
+       Skips blanks within a line.
+
+       \param p Current position
+       \returns First position that is not a space or tab
+    */
+    const char* SkipBlanks(const char* p)
+    {
+        while (' ' == *p || '\t' == *p)
+        {
+            ++p;
+        }
+        return p;
+    }
+}
+
+namespace SCXSystemLib
+{
+    /*----------------------------------------------------------------------------*/
+    /**
+       Gets the directory holding the pressure files.
+
+       \returns Path without trailing slash
+    */
+    const std::string& PressurePALDependencies::GetRoot() const
+    {
+        return m_root;
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Reads a pressure file.
+
+       \param[in]  path    Absolute path of the file
+       \param[out] content Contents of the file
+       \returns    false if the file could not be read
+
+       Kernels built without PSI have no /proc/pressure, and kernels booted
+       with psi=0 fail the open with EOPNOTSUPP; both are reported as false.
+    */
+    bool PressurePALDependencies::ReadFile(const std::string& path, std::string& content) const
+    {
+        content.clear();
+#if defined(linux)
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            return false;
+        }
+
+        char buf[PRESSURE_MAX_FILE_SIZE];
+        ssize_t r = read(fd, buf, sizeof(buf));
+        close(fd);
+        if (r <= 0)
+        {
+            return false;
+        }
+        content.assign(buf, static_cast<size_t>(r));
+        return true;
+#else
+        (void) path;
+        return false;
+#endif
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Gets the time that samples are stamped with.
+
+       The monotonic clock is used so that a step of the wall clock does
+       not distort the stall percentages.
+
+       \returns Microseconds since an arbitrary fixed point
+    */
+    scxulong PressurePALDependencies::GetTimeMicroseconds() const
+    {
+#if defined(linux)
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return static_cast<scxulong>(ts.tv_sec) * 1000000 + static_cast<scxulong>(ts.tv_nsec) / 1000;
+#else
+        return 0;
+#endif
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Class that represents values passed between the threads of the PSI enumeration.
+    */
+    class PressureEnumerationThreadParam : public SCXThreadParam
+    {
+    public:
+        /*----------------------------------------------------------------------------*/
+        /**
+           Constructor
+
+           \param[in] pressureenum Pointer to PSI enumeration associated with the thread.
+        */
+        PressureEnumerationThreadParam(PressureEnumeration* pressureenum)
+            : SCXThreadParam(), m_pressureenum(pressureenum)
+        {}
+
+        /*----------------------------------------------------------------------------*/
+        /**
+           Retrieves the PSI enumeration parameter.
+
+           \returns Pointer to PSI enumeration associated with the thread.
+        */
+        PressureEnumeration* GetPressureEnumeration()
+        {
+            return m_pressureenum;
+        }
+    private:
+        PressureEnumeration* m_pressureenum; //!< Pointer to PSI enumeration associated with the thread.
+    };
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Default constructor
+
+       \param[in] deps Dependencies for the PSI enumeration.
+    */
+    PressureEnumeration::PressureEnumeration(SCXCoreLib::SCXHandle<PressurePALDependencies> deps) :
+        EntityEnumeration<PressureInstance>(),
+        m_deps(deps),
+        m_lock(SCXCoreLib::ThreadLockHandleGet()),
+        m_dataAquisitionThread(NULL)
+    {
+        m_log = SCXLogHandleFactory::GetLogHandle(L"scx.core.common.pal.system.pressure.pressureenumeration");
+
+        SCX_LOGTRACE(m_log, L"PressureEnumeration default constructor");
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Destructor
+    */
+    PressureEnumeration::~PressureEnumeration()
+    {
+        SCX_LOGTRACE(m_log, L"PressureEnumeration destructor");
+        if (NULL != m_dataAquisitionThread)
+        {
+            if (m_dataAquisitionThread->IsAlive())
+            {
+                CleanUp();
+            }
+            m_dataAquisitionThread = NULL;
+        }
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Detects the resources with pressure stall information and starts sampling.
+    */
+    void PressureEnumeration::Init()
+    {
+        SCX_LOGTRACE(m_log, L"PressureEnumeration Init()");
+
+        for (size_t i = 0; i < sizeof(PRESSURE_RESOURCES) / sizeof(PRESSURE_RESOURCES[0]); ++i)
+        {
+            string content;
+            if (m_deps->ReadFile(m_deps->GetRoot() + "/" + PRESSURE_RESOURCES[i], content))
+            {
+                AddInstance(SCXCoreLib::SCXHandle<PressureInstance>(new PressureInstance(PRESSURE_RESOURCES[i])));
+            }
+        }
+
+        if (0 == Size())
+        {
+            SCX_LOGINFO(m_log, StrFromMultibyte(m_deps->GetRoot()).append(L" is not readable, pressure stall information is not supported on this system"));
+            return;
+        }
+
+        SampleData();
+
+        if (NULL == m_dataAquisitionThread)
+        {
+            PressureEnumerationThreadParam* params = new PressureEnumerationThreadParam(this);
+            m_dataAquisitionThread = new SCXCoreLib::SCXThread(PressureEnumeration::DataAquisitionThreadBody, params);
+        }
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Update all instances
+
+       \param updateInstances Compute stall percentages from the latest samples
+    */
+    void PressureEnumeration::Update(bool updateInstances)
+    {
+        SCXCoreLib::SCXThreadLock lock(m_lock);
+        UpdateNoLock(lock, updateInstances);
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Update all instances without taking the enumeration lock
+
+       \param lck             A previously taken lock that belongs to this PAL
+       \param updateInstances Compute stall percentages from the latest samples
+
+       The sampling thread writes the samples of the instances, so a caller
+       that reads instance values must hold the lock from GetLockHandle()
+       for the duration and supply it here as "proof" that it was taken.
+    */
+    void PressureEnumeration::UpdateNoLock(SCXCoreLib::SCXThreadLock&, bool updateInstances)
+    {
+        SCX_LOGTRACE(m_log, StrAppend(L"PressureEnumeration Update() - ", updateInstances));
+
+        if (updateInstances)
+        {
+            UpdateInstances();
+        }
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Get the lock handle of the enumeration
+
+       \returns Handle to the lock protecting the samples of the instances
+    */
+    const SCXCoreLib::SCXThreadLockHandle& PressureEnumeration::GetLockHandle() const
+    {
+        return m_lock;
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Cleanup
+    */
+    void PressureEnumeration::CleanUp()
+    {
+        SCX_LOGTRACE(m_log, L"PressureEnumeration CleanUp()");
+        if (NULL != m_dataAquisitionThread)
+        {
+            m_dataAquisitionThread->RequestTerminate();
+            m_dataAquisitionThread->Wait();
+        }
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Tells if pressure stall information is available on this system.
+
+       \returns true if at least one resource is reported
+    */
+    bool PressureEnumeration::IsSupported() const
+    {
+        return Size() > 0;
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Parses one line of a pressure file.
+
+       \param[in]  content Contents of the pressure file
+       \param[in]  kind    Line to parse, "some" or "full"
+       \param[out] avg10   Kernel average over 10 seconds, in percent
+       \param[out] avg60   Kernel average over 60 seconds, in percent
+       \param[out] avg300  Kernel average over 300 seconds, in percent
+       \param[out] total   Cumulative stall time in microseconds
+       \returns    false if the line is missing or malformed
+
+       A line looks like "some avg10=0.12 avg60=0.05 avg300=0.01 total=123456".
+    */
+    bool PressureEnumeration::ParseLine(const std::string& content, const char* kind,
+                                        double& avg10, double& avg60, double& avg300, scxulong& total)
+    {
+        size_t kindLen = strlen(kind);
+        const char* p = content.c_str();
+
+        while (*p != '\0')
+        {
+            if (0 == strncmp(p, kind, kindLen) && (' ' == p[kindLen] || '\t' == p[kindLen]))
+            {
+                p = SkipBlanks(p + kindLen);
+                if (NULL == (p = ParseDoubleField(p, "avg10=", avg10)))
+                {
+                    return false;
+                }
+                if (NULL == (p = ParseDoubleField(SkipBlanks(p), "avg60=", avg60)))
+                {
+                    return false;
+                }
+                if (NULL == (p = ParseDoubleField(SkipBlanks(p), "avg300=", avg300)))
+                {
+                    return false;
+                }
+                p = SkipBlanks(p);
+                if (0 != strncmp(p, "total=", 6))
+                {
+                    return false;
+                }
+                char* end = NULL;
+                total = strtoull(p + 6, &end, 10);
+                return end != p + 6;
+            }
+
+            const char* eol = strchr(p, '\n');
+            if (NULL == eol)
+            {
+                break;
+            }
+            p = eol + 1;
+        }
+        return false;
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Store new data for all instances
+    */
+    void PressureEnumeration::SampleData()
+    {
+        SCX_LOGTRACE(m_log, L"PressureEnumeration - Start SampleData");
+
+        SCXCoreLib::SCXThreadLock lock(m_lock);
+
+        scxulong now = m_deps->GetTimeMicroseconds();
+        for (EntityIterator iter = Begin(); iter != End(); ++iter)
+        {
+            SCXCoreLib::SCXHandle<PressureInstance> inst = *iter;
+
+            string content;
+            if (!m_deps->ReadFile(m_deps->GetRoot() + "/" + inst->GetResource(), content))
+            {
+                SCX_LOGHYSTERICAL(m_log, wstring(L"PressureEnumeration - Unable to read ").append(inst->GetId()));
+                inst->m_hasSome = inst->m_hasFull = false;
+                continue;
+            }
+
+            scxulong total = 0;
+            inst->m_hasSome = ParseLine(content, "some", inst->m_someAvg10, inst->m_someAvg60, inst->m_someAvg300, total);
+            if (inst->m_hasSome)
+            {
+                PressureInstance::AddCounterSample(inst->m_someTotal, total);
+            }
+            inst->m_hasFull = ParseLine(content, "full", inst->m_fullAvg10, inst->m_fullAvg60, inst->m_fullAvg300, total);
+            if (inst->m_hasFull)
+            {
+                PressureInstance::AddCounterSample(inst->m_fullTotal, total);
+            }
+            inst->m_time_usec.AddSample(now);
+        }
+
+        SCX_LOGTRACE(m_log, L"PressureEnumeration - End SampleData");
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Thread body that updates all values
+
+       \param  param Must contain a parameter of type PressureEnumerationThreadParam*
+
+       The thread stores new values in all instances once every PRESSURE_SECONDS_PER_SAMPLE seconds.
+    */
+    void PressureEnumeration::DataAquisitionThreadBody(SCXCoreLib::SCXThreadParamHandle& param)
+    {
+        SCXLogHandle log = SCXLogHandleFactory::GetLogHandle(L"scx.core.common.pal.system.pressure.pressureenumeration");
+        SCX_LOGTRACE(log, L"PressureEnumeration::DataAquisitionThreadBody()");
+
+        if (0 == param)
+        {
+            SCXASSERT( ! "No parameters to DataAquisitionThreadBody");
+            return;
+        }
+
+        PressureEnumerationThreadParam* params = static_cast<PressureEnumerationThreadParam*>(param.GetData());
+        if (0 == params)
+        {
+            SCXASSERT( ! "Invalid parameters to DataAquisitionThreadBody");
+            return;
+        }
+
+        PressureEnumeration* pressureenum = params->GetPressureEnumeration();
+        if (0 == pressureenum)
+        {
+            SCXASSERT( ! "Pressure Enumeration not set");
+            return;
+        }
+
+        // Init() took the first sample
+        bool bUpdate = false;
+        params->m_cond.SetSleep(PRESSURE_SECONDS_PER_SAMPLE * 1000);
+        {
+            SCXConditionHandle h(params->m_cond);
+
+            while ( ! params->GetTerminateFlag())
+            {
+                if (bUpdate)
+                {
+                    try
+                    {
+                        pressureenum->SampleData();
+                    }
+                    catch (const SCXException& e)
+                    {
+                        SCX_LOGWARNING(log, std::wstring(L"PressureEnumeration DataAquisition - ").append(e.What()).append(L" - ").append(e.Where()));
+                    }
+                    bUpdate = false;
+                }
+
+                SCX_LOGHYSTERICAL(log, L"PressureEnumeration DataAquisition - Sleep ");
+                enum SCXCondition::eConditionResult r = h.Wait();
+                if (SCXCondition::eCondTimeout == r)
+                {
+                    bUpdate = true;
+                }
+            }
+        }
+
+        SCX_LOGHYSTERICAL(log, L"PressureEnumeration DataAquisition - Ending ");
+    }
+}
+
+/*----------------------------E-N-D---O-F---F-I-L-E---------------------------*/
@@ -0,0 +1,260 @@
+/*----------------------------------------------------------------------------
+    Copyright (c) Microsoft Corporation.  All rights reserved.
+
+*/
+/**
+    \file
+
+    \brief       PAL representation of Linux pressure stall information for one resource
+
+    \date        2026-10-18 15:00:00
+
+*/
+/*----------------------------------------------------------------------------*/
+
+#include <scxcorelib/scxcmn.h>
+#include <scxcorelib/stringaid.h>
+
+#include <scxsystemlib/pressureinstance.h>
+
+using namespace std;
+using namespace SCXCoreLib;
+
+namespace SCXSystemLib
+{
+    /*----------------------------------------------------------------------------*/
+    /**
+        Constructor
+
+        \param resource Name of the pressure file, "cpu", "memory" or "io"
+    */
+    PressureInstance::PressureInstance(const std::string& resource) :
+        EntityInstance(false),
+        m_resource(resource),
+        m_hasSome(false),
+        m_hasFull(false),
+        m_someAvg10(0),
+        m_someAvg60(0),
+        m_someAvg300(0),
+        m_fullAvg10(0),
+        m_fullAvg60(0),
+        m_fullAvg300(0),
+        m_percentSomeStalled(0),
+        m_percentFullStalled(0)
+    {
+        m_log = SCXLogHandleFactory::GetLogHandle(L"scx.core.common.pal.system.pressure.pressureinstance");
+
+        SetId(StrFromMultibyte(resource));
+
+        SCX_LOGTRACE(m_log, wstring(L"PressureInstance constructor - ").append(GetId()));
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+        Destructor
+    */
+    PressureInstance::~PressureInstance()
+    {
+        SCX_LOGTRACE(m_log, wstring(L"PressureInstance destructor - ").append(GetId()));
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+        Adds a sample of a stall time counter.
+
+        \param sampler Sampler to add to
+        \param value   Latest counter value
+
+        The counters only go backwards if the kernel was replaced under us
+        (checkpoint/restore), in which case the history is discarded.
+    */
+    void PressureInstance::AddCounterSample(PressureInstanceDataSampler& sampler, scxulong value)
+    {
+        if (sampler.GetNumberOfSamples() > 0 && value < sampler[0])
+        {
+            sampler.Clear();
+        }
+        sampler.AddSample(value);
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+        Computes the share of time spent stalled over the sampled window.
+
+        \param sampler Stall time sampler
+        \returns       Percentage of the window where tasks were stalled
+    */
+    double PressureInstance::GetPercentStalled(const PressureInstanceDataSampler& sampler) const
+    {
+        size_t samples = sampler.GetNumberOfSamples();
+        if (samples > m_time_usec.GetNumberOfSamples())
+        {
+            samples = m_time_usec.GetNumberOfSamples();
+        }
+
+        scxulong elapsed = m_time_usec.GetDelta(samples);
+        if (0 == elapsed)
+        {
+            return 0;
+        }
+
+        // Both the counter and the sample times are in microseconds
+        double percent = 100.0 * static_cast<double>(sampler.GetDelta(samples)) / static_cast<double>(elapsed);
+        return (percent > 100.0) ? 100.0 : percent;
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+        Computes the stall percentages from the sampled counters.
+    */
+    void PressureInstance::Update()
+    {
+        SCX_LOGHYSTERICAL(m_log, wstring(L"PressureInstance Update() - ").append(GetId()));
+
+        m_percentSomeStalled = GetPercentStalled(m_someTotal);
+        m_percentFullStalled = GetPercentStalled(m_fullTotal);
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+        Get the resource name
+
+        \returns     Name of the pressure file, "cpu", "memory" or "io"
+    */
+    const std::string& PressureInstance::GetResource() const
+    {
+        return m_resource;
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+        Get the kernel average of the "some" line over 10 seconds
+
+        \param[out]  percent Percentage of time at least one task was stalled
+        \returns     true if the value is available
+    */
+    bool PressureInstance::GetSomeAverage10(double& percent) const
+    {
+        percent = m_someAvg10;
+        return m_hasSome;
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+        Get the kernel average of the "some" line over 60 seconds
+
+        \param[out]  percent Percentage of time at least one task was stalled
+        \returns     true if the value is available
+    */
+    bool PressureInstance::GetSomeAverage60(double& percent) const
+    {
+        percent = m_someAvg60;
+        return m_hasSome;
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+        Get the kernel average of the "some" line over 300 seconds
+
+        \param[out]  percent Percentage of time at least one task was stalled
+        \returns     true if the value is available
+    */
+    bool PressureInstance::GetSomeAverage300(double& percent) const
+    {
+        percent = m_someAvg300;
+        return m_hasSome;
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+        Get the cumulative "some" stall time
+
+        \param[out]  usec Microseconds where at least one task was stalled since boot
+        \returns     true if the value is available
+    */
+    bool PressureInstance::GetSomeTotal(scxulong& usec) const
+    {
+        usec = (m_someTotal.GetNumberOfSamples() > 0) ? m_someTotal[0] : 0;
+        return m_hasSome;
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+        Get the "some" stall percentage over the sampled window
+
+        \param[out]  percent Percentage of time at least one task was stalled
+        \returns     true if the value is available
+    */
+    bool PressureInstance::GetPercentSomeStalled(double& percent) const
+    {
+        percent = m_percentSomeStalled;
+        return m_hasSome;
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+        Get the kernel average of the "full" line over 10 seconds
+
+        \param[out]  percent Percentage of time all non-idle tasks were stalled
+        \returns     true if the value is available
+    */
+    bool PressureInstance::GetFullAverage10(double& percent) const
+    {
+        percent = m_fullAvg10;
+        return m_hasFull;
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+        Get the kernel average of the "full" line over 60 seconds
+
+        \param[out]  percent Percentage of time all non-idle tasks were stalled
+        \returns     true if the value is available
+    */
+    bool PressureInstance::GetFullAverage60(double& percent) const
+    {
+        percent = m_fullAvg60;
+        return m_hasFull;
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+        Get the kernel average of the "full" line over 300 seconds
+
+        \param[out]  percent Percentage of time all non-idle tasks were stalled
+        \returns     true if the value is available
+    */
+    bool PressureInstance::GetFullAverage300(double& percent) const
+    {
+        percent = m_fullAvg300;
+        return m_hasFull;
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+        Get the cumulative "full" stall time
+
+        \param[out]  usec Microseconds where all non-idle tasks were stalled since boot
+        \returns     true if the value is available
+    */
+    bool PressureInstance::GetFullTotal(scxulong& usec) const
+    {
+        usec = (m_fullTotal.GetNumberOfSamples() > 0) ? m_fullTotal[0] : 0;
+        return m_hasFull;
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+        Get the "full" stall percentage over the sampled window
+
+        \param[out]  percent Percentage of time all non-idle tasks were stalled
+        \returns     true if the value is available
+    */
+    bool PressureInstance::GetPercentFullStalled(double& percent) const
+    {
+        percent = m_percentFullStalled;
+        return m_hasFull;
+    }
+}
+
+/*----------------------------E-N-D---O-F---F-I-L-E---------------------------*/
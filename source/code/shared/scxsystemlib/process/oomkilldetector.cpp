@@ -0,0 +1,444 @@
+/*----------------------------------------------------------------------------
+    Copyright (c) Microsoft Corporation.  All rights reserved.
+
+*/
+/**
+    \file
+
+    \brief       Detection of processes killed by the out of memory killer
+
+    \date        2026-10-18 18:00:00
+
+*/
+/*----------------------------------------------------------------------------*/
+
+#include <scxcorelib/scxcmn.h>
+#include <scxcorelib/scxexception.h>
+#include <scxcorelib/scxlog.h>
+#include <scxcorelib/stringaid.h>
+
+#include <scxsystemlib/oomkilldetector.h>
+
+#include <algorithm>
+
+using namespace std;
+using namespace SCXCoreLib;
+
+namespace
+{
+    /**
+       Orders departed processes by resident set size, largest first.
+    */
+    template <class T>
+    struct LargerResidentSet
+    {
+        /**
+           Compares two candidates.
+           \param[in] a First candidate
+           \param[in] b Second candidate
+           \returns   true if a has the larger resident set
+        */
+        bool operator()(const T* a, const T* b) const
+        {
+            return a->residentSetSize > b->residentSetSize;
+        }
+    };
+}
+
+namespace SCXSystemLib
+{
+    /*----------------------------------------------------------------------------*/
+    /**
+       Constructor
+
+       \param[in] memDeps    Dependencies for reading /proc/vmstat
+       \param[in] cgroupDeps Dependencies for reading control group files
+    */
+    OOMKillDetector::OOMKillDetector(SCXCoreLib::SCXHandle<MemoryDependencies> memDeps,
+                                     SCXCoreLib::SCXHandle<CGroupPALDependencies> cgroupDeps) :
+        m_memDeps(memDeps),
+        m_cgroupDeps(cgroupDeps),
+        m_disabled(false),
+        m_readFailed(false),
+        m_hasBaseline(false),
+        m_killCount(0),
+        m_killsSeen(0),
+        m_pending(0),
+        m_pendingSamples(0),
+        m_departedCount(0),
+        m_attributions(0),
+        m_eventCount(OOMKILL_DEFAULT_EVENT_COUNT),
+        m_next(0),
+        m_sequence(0)
+    {
+        m_log = SCXLogHandleFactory::GetLogHandle(L"scx.core.common.pal.system.process.oomkilldetector");
+        m_keys.Add("oom_kill", 0);
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Sets the number of events kept. Events already kept are dropped.
+
+       \param[in] count Number of events, at least one
+    */
+    void OOMKillDetector::SetEventCount(size_t count)
+    {
+        m_eventCount = (0 == count) ? 1 : count;
+        m_events.clear();
+        m_next = 0;
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Gets the number of events kept.
+
+       \returns Capacity of the event ring
+    */
+    size_t OOMKillDetector::GetEventCount() const
+    {
+        return m_eventCount;
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Starts a sample by reading the system wide kill counter.
+
+       \returns true if there are kills waiting for their victims, in which
+                case the departed processes are to be added
+    */
+    bool OOMKillDetector::BeginSample()
+    {
+        m_departedCount = 0;
+
+        scxulong count = 0;
+        if (m_disabled || ! ReadKillCount(count))
+        {
+            return false;
+        }
+
+        if (m_hasBaseline && count > m_killCount)
+        {
+            scxulong kills = count - m_killCount;
+            SCX_LOGINFO(m_log, StrAppend(L"OOM kills detected: ", kills));
+            m_pending += kills;
+            m_killsSeen += kills;
+        }
+        m_killCount = count;
+        m_hasBaseline = true;
+
+        return m_pending > 0;
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Adds a process that disappeared during the current sample.
+
+       \param[in] proc Instance of the process, still holding its last values
+    */
+    void OOMKillDetector::AddDeparted(const ProcessInstance& proc)
+    {
+        if (m_departedCount == m_departed.size())
+        {
+            m_departed.push_back(Candidate());
+        }
+        Candidate& c = m_departed[m_departedCount++];
+
+        scxulong pid = 0;
+        proc.GetPID(pid);
+        c.pid = static_cast<scxpid_t>(pid);
+        if ( ! proc.GetName(c.name))
+        {
+            c.name.clear();
+        }
+        if ( ! proc.GetUsedMemory(c.residentSetSize))
+        {
+            c.residentSetSize = 0;
+        }
+        if ( ! proc.GetCGroupPath(c.cgroup))
+        {
+            c.cgroup.clear();
+        }
+        if ( ! proc.GetMemoryCGroupPath(c.memoryCGroup))
+        {
+            c.memoryCGroup.clear();
+        }
+        c.taken = false;
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Ends a sample, recording the kills that could be attributed.
+    */
+    void OOMKillDetector::EndSample()
+    {
+        if (0 == m_pending)
+        {
+            m_pendingSamples = 0;
+            m_departedCount = 0;
+            return;
+        }
+
+        Attribute();
+        m_departedCount = 0;
+
+        if (0 == m_pending)
+        {
+            m_pendingSamples = 0;
+        }
+        else if (++m_pendingSamples >= OOMKILL_MAX_PENDING_SAMPLES)
+        {
+            SCX_LOGINFO(m_log, StrAppend(L"No victim found for OOM kills: ", m_pending));
+            for ( ; m_pending > 0; m_pending--)
+            {
+                Record(NULL, false);
+            }
+            m_pendingSamples = 0;
+        }
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Matches the pending kills with the departed processes.
+
+       The oom_kill counter of each control group that lost a process is
+       compared with its value at the previous kill. The counter of a control
+       group seen for the first time is only taken as a baseline, since the
+       kills it holds may be of any age.
+    */
+    void OOMKillDetector::Attribute()
+    {
+        m_attributions++;
+
+        vector<Candidate*> candidates;
+        candidates.reserve(m_departedCount);
+        for (size_t i = 0; i < m_departedCount; i++)
+        {
+            candidates.push_back(&m_departed[i]);
+        }
+        sort(candidates.begin(), candidates.end(), LargerResidentSet<Candidate>());
+
+        // Kills counted by each control group since its counter was last read
+        map<string, scxulong> cgroupKills;
+        for (size_t i = 0; i < candidates.size(); i++)
+        {
+            const string& cgroup = candidates[i]->memoryCGroup;
+            scxulong count = 0;
+            if (cgroup.empty() || cgroupKills.find(cgroup) != cgroupKills.end() || ! ReadCGroupKillCount(cgroup, count))
+            {
+                continue;
+            }
+
+            map<string, CGroupKillCount>::iterator known = m_cgroupKills.find(cgroup);
+            if (known != m_cgroupKills.end())
+            {
+                cgroupKills[cgroup] = (count > known->second.count) ? count - known->second.count : 0;
+            }
+            else
+            {
+                cgroupKills[cgroup] = 0;
+                if (m_cgroupKills.size() >= OOMKILL_MAX_TRACKED_CGROUPS)
+                {
+                    EvictCGroupKillCount();
+                }
+                known = m_cgroupKills.insert(make_pair(cgroup, CGroupKillCount())).first;
+            }
+            known->second.count = count;
+            known->second.lastRead = m_attributions;
+        }
+
+        for (size_t i = 0; i < candidates.size() && m_pending > 0; i++)
+        {
+            map<string, scxulong>::iterator kills = cgroupKills.find(candidates[i]->memoryCGroup);
+            if (kills != cgroupKills.end() && kills->second > 0)
+            {
+                kills->second--;
+                candidates[i]->taken = true;
+                Record(candidates[i], true);
+                m_pending--;
+            }
+        }
+
+        for (size_t i = 0; i < candidates.size() && m_pending > 0; i++)
+        {
+            if ( ! candidates[i]->taken)
+            {
+                candidates[i]->taken = true;
+                Record(candidates[i], false);
+                m_pending--;
+            }
+        }
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Forgets the control group whose counter was read the longest time ago.
+
+       Only called when a new control group is to be remembered and
+       OOMKILL_MAX_TRACKED_CGROUPS are already, so the linear search is rare.
+    */
+    void OOMKillDetector::EvictCGroupKillCount()
+    {
+        map<string, CGroupKillCount>::iterator oldest = m_cgroupKills.begin();
+        for (map<string, CGroupKillCount>::iterator it = m_cgroupKills.begin(); it != m_cgroupKills.end(); ++it)
+        {
+            if (it->second.lastRead < oldest->second.lastRead)
+            {
+                oldest = it;
+            }
+        }
+        if (oldest != m_cgroupKills.end())
+        {
+            m_cgroupKills.erase(oldest);
+        }
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Adds an event to the ring.
+
+       \param[in] victim            Killed process, or NULL if not known
+       \param[in] cgroupConstrained The kill was counted by the control group of the victim
+    */
+    void OOMKillDetector::Record(const Candidate* victim, bool cgroupConstrained)
+    {
+        if (m_events.size() < m_eventCount)
+        {
+            m_events.push_back(OOMKillEvent());
+            m_next = m_events.size() - 1;
+        }
+        OOMKillEvent& event = m_events[m_next];
+        m_next = (m_next + 1) % m_eventCount;
+
+        event.sequence = ++m_sequence;
+        event.time = SCXCalendarTime::CurrentUTC();
+        event.attributed = (NULL != victim);
+        event.cgroupConstrained = cgroupConstrained;
+        if (NULL != victim)
+        {
+            event.pid = victim->pid;
+            event.name = victim->name;
+            event.residentSetSize = victim->residentSetSize;
+            event.cgroup = victim->cgroup;
+
+            SCX_LOGINFO(m_log, StrAppend(StrAppend(StrAppend(L"OOM kill of process ", StrFromMultibyte(event.name)),
+                                                   L", pid "), event.pid));
+        }
+        else
+        {
+            event.pid = 0;
+            event.name.clear();
+            event.residentSetSize = 0;
+            event.cgroup.clear();
+        }
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Gets the events kept.
+
+       \param[out] events Events, oldest first
+    */
+    void OOMKillDetector::GetEvents(std::vector<OOMKillEvent>& events) const
+    {
+        events.clear();
+        events.reserve(m_events.size());
+
+        size_t first = (m_events.size() < m_eventCount) ? 0 : m_next;
+        for (size_t i = 0; i < m_events.size(); i++)
+        {
+            events.push_back(m_events[(first + i) % m_events.size()]);
+        }
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Gets the number of kills counted since the agent started.
+
+       \returns Number of kills, including those still waiting for their victims
+    */
+    scxulong OOMKillDetector::GetKillCount() const
+    {
+        return m_killsSeen;
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Reads the oom_kill counter of /proc/vmstat.
+
+       \param[out] count Value of the counter
+       \returns    false if the counter can not be read
+
+       A /proc/vmstat without the counter disables the detector. A failed
+       read does not; the kills in between are counted by the next read
+       that succeeds.
+    */
+    bool OOMKillDetector::ReadKillCount(scxulong& count)
+    {
+#if defined(linux)
+        try
+        {
+            if (m_buffer.empty())
+            {
+                m_buffer.resize(MEMORY_PROC_INITIAL_BUFFER_SIZE);
+            }
+
+            size_t len = m_memDeps->ReadVMStat(&m_buffer[0], m_buffer.size());
+            while (len >= m_buffer.size())
+            {
+                m_buffer.resize(m_buffer.size() * 2);
+                len = m_memDeps->ReadVMStat(&m_buffer[0], m_buffer.size());
+            }
+
+            m_readFailed = false;
+
+            bool found = false;
+            const char* p = &m_buffer[0];
+            if (1 == m_keys.Parse(p, p + len, &count, &found))
+            {
+                return true;
+            }
+            SCX_LOGINFO(m_log, L"No oom_kill counter in /proc/vmstat, OOM kills are not detected");
+            m_disabled = true;
+        }
+        catch (const SCXException& e)
+        {
+            if ( ! m_readFailed)
+            {
+                SCX_LOGWARNING(m_log, wstring(L"/proc/vmstat is not readable, retrying at the next sample - ").append(e.What()));
+            }
+            m_readFailed = true;
+        }
+#else
+        m_disabled = true;
+#endif
+        return false;
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Reads the oom_kill counter of a control group.
+
+       \param[in]  memoryCGroup Path in the memory controller hierarchy, as in /proc/#/cgroup
+       \param[out] count        Value of the counter
+       \returns    false if the control group is gone or has no memory controller
+
+       The unified hierarchy has the counter in memory.events, the legacy
+       memory controller (kernel 4.13 and later) in memory.oom_control.
+    */
+    bool OOMKillDetector::ReadCGroupKillCount(const std::string& memoryCGroup, scxulong& count) const
+    {
+        const string& root = m_cgroupDeps->GetRoot();
+        string dir = ("/" == memoryCGroup) ? string() : memoryCGroup;
+        string content;
+
+        if (m_cgroupDeps->ReadFile(root + dir + "/memory.events", content) &&
+            CGroupEnumeration::ParseKeyValue(content, "oom_kill", count))
+        {
+            return true;
+        }
+        return m_cgroupDeps->ReadFile(root + "/memory" + dir + "/memory.oom_control", content) &&
+            CGroupEnumeration::ParseKeyValue(content, "oom_kill", count);
+    }
+}
+
+/*----------------------------E-N-D---O-F---F-I-L-E---------------------------*/
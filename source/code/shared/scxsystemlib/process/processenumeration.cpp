@@ -12,6 +12,8 @@
 */
 /*----------------------------------------------------------------------------*/
 #include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
 #include <sys/time.h>
 
 #if defined(linux) || defined(sun) || defined(aix)
@@ -24,6 +26,12 @@
 #endif
 
 #include <unistd.h>
+#include <signal.h>
+
+#if defined(linux)
+#include <fcntl.h>
+#include <string.h>
+#endif
 
 #include <scxcorelib/scxcmn.h>
 #include <scxcorelib/scxcondition.h>
@@ -223,6 +231,9 @@ namespace SCXSystemLib
         : EntityEnumeration<ProcessInstance>(),
           m_lock(SCXCoreLib::ThreadLockHandleGet()),
           m_dataAquisitionThread(0),
+          m_allocations(0),
+          m_reuses(0),
+          m_ioAccounting(true),
           m_EnumErrorCount(0),
           m_EnumGoodCount(0),
           m_EnumLogLevel(eError)
@@ -254,6 +265,10 @@ namespace SCXSystemLib
         // Remove these pointers so that we don't try to delete them twice
         Clear();
 
+        m_groups.clear();
+        m_threads.clear();
+        m_nameIndex.clear();
+        m_pool.clear();
         m_procs.clear();
     }
 
@@ -495,6 +510,9 @@ namespace SCXSystemLib
         /* Compute real time once to save some time. */
         gettimeofday(&realtime, 0);
 
+        m_allocations = 0;
+        m_reuses = 0;
+
         /* Walk through process iterator to see all live processes */
         while (pl.nextProc()) {
 
@@ -508,12 +526,18 @@ namespace SCXSystemLib
                     /* If it was found, update it and mark it as found. */
                     bool stillExists = pos->second->UpdateInstance(pl.getHandle(), false);
                     if (!stillExists) { continue; } // Died before or during UpdateInstance()
+#if defined(linux)
+                    pos->second->UpdateIOAccounting(m_ioAccounting);
+#endif
                     pos->second->UpdateDataSampler(realtime);
                 } else {
                     /* If it wasn't found, add it. */
-                    SCXCoreLib::SCXHandle<ProcessInstance> inst( new ProcessInstance(pid, pl.getHandle()) );
+                    SCXCoreLib::SCXHandle<ProcessInstance> inst = NewInstance(pid, pl.getHandle());
                     bool stillExists = inst->UpdateInstance(pl.getHandle(), true);
-                    if (!stillExists) { continue; } // Already gone. Not added.
+                    if (!stillExists) { RetireInstance(inst); continue; } // Already gone. Not added.
+#if defined(linux)
+                    inst->UpdateIOAccounting(m_ioAccounting);
+#endif
                     inst->UpdateDataSampler(realtime);
                     m_procs.insert(std::make_pair(pid, inst));
                 }
@@ -554,15 +578,334 @@ namespace SCXSystemLib
         /* Iterate over known processes and delete those who weren't
            present in "external list".
            That procedure will also reset the found-flag.
+           The OOM kill counter is read after the walk, so a process killed
+           before the walk has already been counted when it is found missing.
         */
+        bool oomKillsPending = m_oomKills.BeginSample();
         ProcMap::iterator pi;
         for (pi = m_procs.begin(); pi != m_procs.end(); ) {
             if (!pi->second->WasFound()) {             
+                if (oomKillsPending) {
+                    m_oomKills.AddDeparted(*pi->second);
+                }
+                UnindexName(pi->first, *pi->second);
+                RetireInstance(pi->second);
                 m_procs.erase(pi++); // Don't saw off branch!
             } else {
                 ++pi;
             }
         }
+
+        // Allocations past the first sample mean the pool is too small for the churn
+        if (m_allocations > 0)
+        {
+            SCX_LOGTRACE(m_log, StrAppend(StrAppend(StrAppend(L"SampleData(): process instances allocated : ", m_allocations)
+                                                    .append(L", reused : "), m_reuses)
+                                          .append(L", pooled : "), m_pool.size()));
+        }
+
+        m_oomKills.EndSample();
+
+        UpdateProcessGroups();
+        SampleThreads(realtime);
+    }
+
+    /**
+       Gets an instance for a newly discovered process.
+
+       \param pid      Process id
+       \param basename Handle of the process from the process iterator
+       \returns        An instance representing the process, not yet updated
+
+       On Linux an instance of a dead process is taken from the pool and
+       reinitialized in place if there is one, which avoids allocating the
+       instance and its data samplers. Otherwise a new instance is allocated.
+    */
+#if defined(hpux)
+    SCXCoreLib::SCXHandle<ProcessInstance> ProcessEnumeration::NewInstance(scxpid_t pid, struct pst_status* basename)
+#else
+    SCXCoreLib::SCXHandle<ProcessInstance> ProcessEnumeration::NewInstance(scxpid_t pid, const char* basename)
+#endif
+    {
+#if defined(linux)
+        if ( ! m_pool.empty()) {
+            SCXCoreLib::SCXHandle<ProcessInstance> inst = m_pool.back();
+            m_pool.pop_back();
+            inst->Recycle(pid, basename);
+            ++m_reuses;
+            return inst;
+        }
+#endif
+        ++m_allocations;
+        return SCXCoreLib::SCXHandle<ProcessInstance>( new ProcessInstance(pid, basename) );
+    }
+
+    /**
+       Hands an instance of a dead process back for reuse.
+
+       \param inst Instance no longer in the process map
+
+       The pool is bounded by MAX_POOLED_PROCESSINSTANCES; beyond that, or on
+       platforms without in place reinitialization, the instance is released.
+       As documented for Find(), instances are only valid until the next
+       SampleData(), so a pooled instance may later represent another process.
+    */
+    void ProcessEnumeration::RetireInstance(SCXCoreLib::SCXHandle<ProcessInstance> inst)
+    {
+#if defined(linux)
+        if (m_pool.size() < MAX_POOLED_PROCESSINSTANCES) {
+            m_pool.push_back(inst);
+        }
+#else
+        (void) inst;
+#endif
+    }
+
+    /**
+       Recomputes the process group aggregates from the live processes.
+
+       Called at the end of SampleData() with the enumeration lock held, so the
+       groups always reflect the same snapshot as the process instances. Group
+       instances that still have members are kept (and thus keep their handles),
+       groups that have become empty are dropped.
+    */
+    void ProcessEnumeration::UpdateProcessGroups()
+    {
+        ProcGroupMap::iterator gi;
+        for (gi = m_groups.begin(); gi != m_groups.end(); ++gi) {
+            gi->second->Reset();
+        }
+
+        ProcessGroupKey key;
+        ProcMap::iterator pi;
+        for (pi = m_procs.begin(); pi != m_procs.end(); ++pi) {
+            ProcessInstance& proc = *pi->second;
+            proc.UpdateTimedValues();
+
+            key.euid = 0;
+            if ( ! proc.GetName(key.name)) { key.name.clear(); }
+            IndexName(pi->first, proc, key.name);
+            proc.GetEffectiveUserID(key.euid);
+            proc.GetCGroupPath(key.cgroup);
+
+            gi = m_groups.find(key);
+            if (gi == m_groups.end()) {
+                SCXCoreLib::SCXHandle<ProcessGroupInstance> group( new ProcessGroupInstance(key) );
+                gi = m_groups.insert(std::make_pair(key, group)).first;
+            }
+            gi->second->Accumulate(proc);
+        }
+
+        for (gi = m_groups.begin(); gi != m_groups.end(); ) {
+            scxulong count = 0;
+            gi->second->GetProcessCount(count);
+            if (0 == count) {
+                m_groups.erase(gi++);
+            } else {
+                ++gi;
+            }
+        }
+
+        SCX_LOGHYSTERICAL(m_log, StrAppend(L"UpdateProcessGroups(): Number of process groups : ", m_groups.size()));
+    }
+
+    /**
+       Files a process under its current name in the name index.
+
+       \param pid  Process id
+       \param proc The process instance
+       \param name Current name of the process
+
+       Only touches the index when the process is new or has changed name
+       (exec, or turned defunct), so a stable process table costs one string
+       compare per process.
+    */
+    void ProcessEnumeration::IndexName(scxpid_t pid, ProcessInstance& proc, const std::string& name)
+    {
+        if ( ! proc.m_indexedName.empty() && proc.m_indexedName == name) {
+            return;
+        }
+        UnindexName(pid, proc);
+        m_nameIndex[name].insert(pid);
+        proc.m_indexedName = name;
+    }
+
+    /**
+       Removes a process from the name index.
+
+       \param pid  Process id
+       \param proc The process instance
+    */
+    void ProcessEnumeration::UnindexName(scxpid_t pid, ProcessInstance& proc)
+    {
+        ProcNameIndex::iterator ni = m_nameIndex.find(proc.m_indexedName);
+        if (ni != m_nameIndex.end()) {
+            ni->second.erase(pid);
+            if (ni->second.empty()) {
+                m_nameIndex.erase(ni);
+            }
+        }
+        proc.m_indexedName.clear();
+    }
+
+    /**
+       Samples the threads of the processes selected with SetThreadSampling().
+
+       \param realtime Time stamp of the current sample
+
+       Called at the end of SampleData() with the enumeration lock held. The
+       task directory is only read for selected processes, so when nothing is
+       selected this costs nothing. At most MAX_SAMPLED_THREADS threads are
+       tracked.
+    */
+    void ProcessEnumeration::SampleThreads(struct timeval& realtime)
+    {
+        if (m_threadNames.empty() && m_threadPids.empty())
+        {
+            m_threads.clear();
+            return;
+        }
+
+#if defined(linux)
+        std::string pname;
+        char taskdir[2 * PROCPATH_LEN];
+
+        ProcMap::iterator pi;
+        for (pi = m_procs.begin(); pi != m_procs.end(); ++pi) {
+            if ( ! pi->second->GetName(pname)) { pname.clear(); }
+            if (m_threadPids.find(pi->first) == m_threadPids.end() &&
+                m_threadNames.find(pname) == m_threadNames.end()) {
+                continue;
+            }
+
+            snprintf(taskdir, sizeof(taskdir), "/proc/%lu/task", static_cast<unsigned long>(pi->first));
+            DIR* d = opendir(taskdir);
+            if (0 == d) { continue; }   // Process exited since it was sampled
+
+            struct dirent* ent;
+            while ((ent = readdir(d)) != 0) {
+                if ( ! isdigit(ent->d_name[0])) { continue; }
+
+                scxpid_t tid = strtoul(ent->d_name, 0, 10);
+                ThreadMap::iterator ti = m_threads.find(tid);
+                try
+                {
+                    if (ti == m_threads.end()) {
+                        if (m_threads.size() >= MAX_SAMPLED_THREADS) { continue; }
+                        SCXCoreLib::SCXHandle<ThreadInstance> inst( new ThreadInstance(pi->first, tid, pname) );
+                        if ( ! inst->UpdateInstance()) { continue; }
+                        ti = m_threads.insert(std::make_pair(tid, inst)).first;
+                    } else if ( ! ti->second->UpdateInstance()) {
+                        continue;
+                    }
+                    ti->second->UpdateDataSampler(realtime);
+                } catch (SCXException& e) {
+                    SCX_LOG(m_log, m_EnumLogLevel, e.Where() + L" : " + e.What());
+                }
+            }
+            closedir(d);
+        }
+#else
+        (void) realtime;
+#endif
+
+        ThreadMap::iterator ti;
+        for (ti = m_threads.begin(); ti != m_threads.end(); ) {
+            if ( ! ti->second->WasFound()) {
+                m_threads.erase(ti++);
+            } else {
+                ti->second->UpdateTimedValues();
+                ++ti;
+            }
+        }
+
+        SCX_LOGHYSTERICAL(m_log, StrAppend(L"SampleThreads(): Number of sampled threads : ", m_threads.size()));
+    }
+
+    /**
+       Selects the processes whose threads are sampled.
+
+       \param names Process names (as returned by ProcessInstance::GetName())
+       \param pids  Process ids
+
+       Thread sampling is off by default. Passing two empty lists turns it off
+       again. Takes effect at the next sample.
+    */
+    void ProcessEnumeration::SetThreadSampling(const std::vector<std::wstring>& names, const std::vector<scxpid_t>& pids)
+    {
+        SCXCoreLib::SCXThreadLock lock(m_lock);
+
+        m_threadNames.clear();
+        for (std::vector<std::wstring>::const_iterator ni = names.begin(); ni != names.end(); ++ni) {
+            m_threadNames.insert(SCXCoreLib::StrToMultibyte(*ni));
+        }
+        m_threadPids.clear();
+        m_threadPids.insert(pids.begin(), pids.end());
+
+        SCX_LOGTRACE(m_log, StrAppend(StrAppend(L"SetThreadSampling(): names : ", m_threadNames.size()).append(L", pids : "), m_threadPids.size()));
+    }
+
+    /**
+       Returns the threads sampled at the latest sample.
+
+       \returns A vector with one entry per thread of the selected processes.
+
+       \note As with Find(), the caller should hold the enumeration lock (see
+       GetLockHandle()) while using the returned instances.
+     */
+    std::vector<SCXCoreLib::SCXHandle<ThreadInstance> > ProcessEnumeration::GetThreads() const
+    {
+        std::vector<SCXCoreLib::SCXHandle<ThreadInstance> > retval;
+        retval.reserve(m_threads.size());
+
+        ThreadMap::const_iterator ti;
+        for (ti = m_threads.begin(); ti != m_threads.end(); ++ti) {
+            retval.push_back(ti->second);
+        }
+        return retval;
+    }
+
+    /**
+       Turns the reading of /proc/#/io for every process on or off.
+
+       \param enabled true to read the I/O accounting of the processes
+
+       On by default. It costs one more open() per process and sample, so it
+       can be turned off where the I/O rates are not wanted. Only Linux has
+       per-process I/O accounting. Takes effect at the next sample.
+    */
+    void ProcessEnumeration::SetIOAccounting(bool enabled)
+    {
+        SCXCoreLib::SCXThreadLock lock(m_lock);
+        m_ioAccounting = enabled;
+    }
+
+    /**
+       Sets the number of OOM kill events kept.
+
+       \param count Number of events, the oldest are dropped beyond that
+
+       Events already kept are dropped.
+    */
+    void ProcessEnumeration::SetOOMKillEventCount(size_t count)
+    {
+        SCXCoreLib::SCXThreadLock lock(m_lock);
+        m_oomKills.SetEventCount(count);
+    }
+
+    /**
+       Returns the latest OOM kill events.
+
+       \returns Events, oldest first
+
+       \note The caller should hold the enumeration lock (see GetLockHandle())
+       during the call, since the events are recorded by the sampler thread.
+    */
+    std::vector<OOMKillEvent> ProcessEnumeration::GetOOMKillEvents() const
+    {
+        std::vector<OOMKillEvent> events;
+        m_oomKills.GetEvents(events);
+        return events;
     }
 
     /**
@@ -600,16 +943,21 @@ namespace SCXSystemLib
      */
     std::vector<SCXCoreLib::SCXHandle<ProcessInstance> > ProcessEnumeration::Find(const std::wstring& name)
     {
-        ProcMap::iterator pi;
         std::vector<SCXCoreLib::SCXHandle<ProcessInstance> > retval;
         const unsigned short Terminated = 7;
         unsigned short state;
-        std::string pname;
-        const std::string fname(SCXCoreLib::StrToMultibyte(name));
 
-        for (pi = m_procs.begin(); pi != m_procs.end(); ++pi) {
-            if (pi->second->GetExecutionState(state) && (state != Terminated) &&
-                pi->second->GetName(pname) && (pname == fname)) 
+        // The name index is maintained by SampleData(), so no process name is read here
+        ProcNameIndex::const_iterator ni = m_nameIndex.find(SCXCoreLib::StrToMultibyte(name));
+        if (ni == m_nameIndex.end()) {
+            return retval;
+        }
+
+        std::set<scxpid_t>::const_iterator pidi;
+        for (pidi = ni->second.begin(); pidi != ni->second.end(); ++pidi) {
+            ProcMap::iterator pi = m_procs.find(*pidi);
+            if (pi != m_procs.end() &&
+                pi->second->GetExecutionState(state) && (state != Terminated))
             {
                 retval.push_back(pi->second);
             }
@@ -617,6 +965,28 @@ namespace SCXSystemLib
         return retval;
     }
 
+    /**
+       Returns the process group aggregates computed at the latest sample.
+
+       \returns A vector with one entry per group of processes sharing name,
+       effective user id and control group.
+
+       \note As with Find(), the caller should hold the enumeration lock (see
+       GetLockHandle()) while using the returned instances, since the values
+       are rewritten by the next SampleData().
+     */
+    std::vector<SCXCoreLib::SCXHandle<ProcessGroupInstance> > ProcessEnumeration::GetProcessGroups() const
+    {
+        std::vector<SCXCoreLib::SCXHandle<ProcessGroupInstance> > retval;
+        retval.reserve(m_groups.size());
+
+        ProcGroupMap::const_iterator gi;
+        for (gi = m_groups.begin(); gi != m_groups.end(); ++gi) {
+            retval.push_back(gi->second);
+        }
+        return retval;
+    }
+
     /**
        Sends a signal (i.e. the POSIX kill() call) to one or more processes
        that has a certain name.
@@ -626,6 +996,25 @@ namespace SCXSystemLib
     */
     bool ProcessEnumeration::SendSignalByName(const std::wstring& name, int sig)
     {
+        std::vector<scxpid_t> pids;
+        if (FindPidsByName(name, pids))
+        {
+            bool found = false;
+            for (std::vector<scxpid_t>::const_iterator pos = pids.begin(); pos != pids.end(); ++pos) {
+                // Same semantics as ProcessInstance::SendSignal()
+                if (::kill(static_cast<pid_t>(*pos), sig) < 0) {
+                    if (ESRCH == errno) { continue; } // Process gone. That's ok
+                    if (EPERM == errno) {
+                        throw SCXAccessViolationException(L"Attempt to signal a privileged process",
+                                                          SCXSRCLOCATION); }
+                    throw SCXErrnoException(L"kill", errno, SCXSRCLOCATION);
+                }
+                found = true;
+            }
+            return found;
+        }
+
+        // No lightweight lookup on this platform; take a full snapshot
         SCXCoreLib::SCXHandle<ProcessEnumeration> procEnum( new ProcessEnumeration() );
         /* No Init(), we do manual updates. */
         procEnum->SampleData();
@@ -642,6 +1031,94 @@ namespace SCXSystemLib
         return found;
     }
 
+    /**
+       Finds the live processes that have a certain name, without setting up
+       a sampled enumeration.
+
+       \param  name     The process name without parameters or path.
+       \returns A vector with process instance pointers, empty if no
+       process with a matching name was found.
+
+       On Linux only the processes with a matching name are instantiated. On
+       other platforms this takes a full process snapshot.
+    */
+    std::vector<SCXCoreLib::SCXHandle<ProcessInstance> > ProcessEnumeration::FindByName(const std::wstring& name)
+    {
+        std::vector<SCXCoreLib::SCXHandle<ProcessInstance> > retval;
+
+#if defined(linux)
+        std::vector<scxpid_t> pids;
+        if (FindPidsByName(name, pids))
+        {
+            char basename[PROCPATH_LEN];
+            for (std::vector<scxpid_t>::const_iterator pos = pids.begin(); pos != pids.end(); ++pos) {
+                snprintf(basename, sizeof(basename), "%lu", static_cast<unsigned long>(*pos));
+                SCXCoreLib::SCXHandle<ProcessInstance> inst( new ProcessInstance(*pos, basename) );
+                if (inst->UpdateInstance(basename, true)) {
+                    retval.push_back(inst);
+                }
+            }
+            return retval;
+        }
+#endif
+
+        SCXCoreLib::SCXHandle<ProcessEnumeration> procEnum( new ProcessEnumeration() );
+        /* No Init(), we do manual updates. */
+        procEnum->SampleData();
+        retval = procEnum->Find(name);
+        return retval;
+    }
+
+    /**
+       Lists the pids of the live processes that have a certain name.
+
+       \param[in]  name     The process name without parameters or path.
+       \param[out] pids     Pids of matching processes that are not defunct.
+       \returns true if the lookup is supported on this platform.
+
+       On Linux this reads only /proc/#/stat, which holds both the name
+       (the same one ProcessInstance::GetName() returns) and the state
+       needed to skip defunct processes. No process instances or samplers
+       are created.
+    */
+    bool ProcessEnumeration::FindPidsByName(const std::wstring& name, std::vector<scxpid_t>& pids)
+    {
+        pids.clear();
+
+#if defined(linux)
+        const std::string fname(SCXCoreLib::StrToMultibyte(name));
+        char path[PROCPATH_LEN];
+        char buf[512];
+
+        ProcLister pl;
+        while (pl.nextProc()) {
+            int n = snprintf(path, sizeof(path), "/proc/%s/stat", pl.getHandle());
+            if (n < 0 || static_cast<size_t>(n) >= sizeof(path)) { continue; }  // Not a pid directory
+            int fd = open(path, O_RDONLY);
+            if (fd < 0) { continue; }   // Process exited since it was listed
+            ssize_t len = read(fd, buf, sizeof(buf) - 1);
+            close(fd);
+            if (len <= 0) { continue; }
+            buf[len] = '\0';
+
+            // Format is "pid (name) state ...", and the name may itself hold parentheses
+            char* start = strchr(buf, '(');
+            char* end = strrchr(buf, ')');
+            if (0 == start || 0 == end || end < start || end[1] != ' ' || end[2] == '\0') { continue; }
+            if ('Z' == end[2]) { continue; }  // Defunct
+            ++start;
+            if (static_cast<size_t>(end - start) == fname.size() &&
+                0 == fname.compare(0, fname.size(), start, end - start)) {
+                pids.push_back(pl.getPid());
+            }
+        }
+        return true;
+#else
+        (void) name;
+        return false;
+#endif
+    }
+
     /**
        Static method that retrievs the number of processes running on the system.
        \param[out]  numberOfProcesses   Number of processes running.
@@ -676,6 +1153,28 @@ namespace SCXSystemLib
 
 #endif
     }
+
+    /**
+       Returns the number of process instances allocated by the latest sample.
+       \returns Number of instances allocated, i.e. not taken from the pool.
+
+       A steady state above zero means the pool is too small for the process
+       churn on the host. Reported by the process provider as
+       InstancesAllocated.
+    */
+    size_t ProcessEnumeration::GetAllocationsLastSample() const
+    {
+        return m_allocations;
+    }
+
+    /**
+       Returns the number of process instances reused by the latest sample.
+       \returns Number of instances taken from the pool.
+    */
+    size_t ProcessEnumeration::GetReusesLastSample() const
+    {
+        return m_reuses;
+    }
 }
 
 /*----------------------------E-N-D---O-F---F-I-L-E---------------------------*/
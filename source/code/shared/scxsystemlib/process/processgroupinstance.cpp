@@ -0,0 +1,253 @@
+/*----------------------------------------------------------------------------
+  Copyright (c) Microsoft Corporation.  All rights reserved.
+
+*/
+/**
+   \file
+
+   \brief       PAL representation of an aggregated group of processes
+
+   \date        2026-10-18 09:00:00
+
+*/
+/*----------------------------------------------------------------------------*/
+
+#include <scxcorelib/scxcmn.h>
+#include <scxcorelib/stringaid.h>
+
+#include <scxsystemlib/processgroupinstance.h>
+
+using namespace SCXCoreLib;
+
+namespace SCXSystemLib
+{
+    /*----------------------------------------------------------------------------*/
+    /**
+       Constructor
+
+       \param key Name, effective user and control group of the group
+
+       The instance id is "<name>:<euid>:<cgroup>". Process names may contain
+       ':', as in "kworker/0:1", so the id can not be split back into the key
+       from the left. Since a cgroup path is empty or starts with a '/', two
+       groups only share an id if one name contains ":<number>:/" and a
+       cgroup path contains a ':'. A lookup by id then finds the first of them.
+    */
+    ProcessGroupInstance::ProcessGroupInstance(const ProcessGroupKey& key) :
+        EntityInstance(false), m_key(key)
+    {
+        SetId(StrFromMultibyte(key.name) + L":" + StrFrom(key.euid) + L":" + StrFromMultibyte(key.cgroup));
+        Reset();
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Destructor
+    */
+    ProcessGroupInstance::~ProcessGroupInstance()
+    {
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Clears all accumulated values. Called before each aggregation pass.
+    */
+    void ProcessGroupInstance::Reset()
+    {
+        m_processCount = 0;
+        m_cpuTime = 0;
+        m_userTime = 0;
+        m_privilegedTime = 0;
+        m_usedMemory = 0;
+        m_blockReads = 0;
+        m_blockWrites = 0;
+        m_pagesRead = 0;
+        m_hasBlockIO = false;
+        m_hasPagesRead = false;
+    }
+
+    /*----------------------------------------------------------------------------*/
+    /**
+       Adds the values of one process to the group.
+
+       \param proc A process that belongs to this group. Its timed values must
+                   have been updated, see ProcessInstance::UpdateTimedValues().
+    */
+    void ProcessGroupInstance::Accumulate(const ProcessInstance& proc)
+    {
+        unsigned int cpu = 0;
+        scxulong value = 0;
+
+        ++m_processCount;
+
+        if (proc.GetCPUTime(cpu))               { m_cpuTime += cpu; }
+        if (proc.GetPercentUserTime(value))     { m_userTime += value; }
+        if (proc.GetPercentPrivilegedTime(value)) { m_privilegedTime += value; }
+        if (proc.GetUsedMemory(value))          { m_usedMemory += value; }
+        if (proc.GetBlockReadsPerSecond(value))
+        {
+            m_blockReads += value;
+            m_hasBlockIO = true;
+        }
+        if (proc.GetBlockWritesPerSecond(value))
+        {
+            m_blockWrites += value;
+            m_hasBlockIO = true;
+        }
+        if (proc.GetPagesReadPerSec(value))
+        {
+            m_pagesRead += value;
+            m_hasPagesRead = true;
+        }
+    }
+
+    /**
+       Gets the process name shared by all processes in the group.
+
+       \param[out]  name Return parameter
+       \returns     true if a value is supported by the implementation
+    */
+    bool ProcessGroupInstance::GetProcessName(std::string& name) const
+    {
+        name = m_key.name;
+        return true;
+    }
+
+    /**
+       Gets the effective user id shared by all processes in the group.
+
+       \param[out]  euid Return parameter
+       \returns     true if a value is supported by the implementation
+    */
+    bool ProcessGroupInstance::GetEffectiveUserID(scxulong& euid) const
+    {
+        euid = m_key.euid;
+        return true;
+    }
+
+    /**
+       Gets the control group path shared by all processes in the group.
+
+       \param[out]  cgroup Return parameter
+       \returns     true if a value is supported by the implementation
+    */
+    bool ProcessGroupInstance::GetCGroupPath(std::string& cgroup) const
+    {
+        cgroup = m_key.cgroup;
+#if defined(linux)
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    /**
+       Gets the number of live processes in the group.
+
+       \param[out]  count Return parameter
+       \returns     true if a value is supported by the implementation
+    */
+    bool ProcessGroupInstance::GetProcessCount(scxulong& count) const
+    {
+        count = m_processCount;
+        return true;
+    }
+
+    /**
+       Gets the summed CPU percentage of the group.
+
+       \param[out]  cpu Return parameter
+       \returns     true if a value is supported by the implementation
+    */
+    bool ProcessGroupInstance::GetCPUTime(scxulong& cpu) const
+    {
+        cpu = m_cpuTime;
+        return true;
+    }
+
+    /**
+       Gets the summed percentage of time in user mode.
+
+       \param[out]  put Return parameter
+       \returns     true if a value is supported by the implementation
+    */
+    bool ProcessGroupInstance::GetPercentUserTime(scxulong& put) const
+    {
+        put = m_userTime;
+        return true;
+    }
+
+    /**
+       Gets the summed percentage of time in privileged mode.
+
+       \param[out]  ppt Return parameter
+       \returns     true if a value is supported by the implementation
+    */
+    bool ProcessGroupInstance::GetPercentPrivilegedTime(scxulong& ppt) const
+    {
+        ppt = m_privilegedTime;
+        return true;
+    }
+
+    /**
+       Gets the summed resident set size of the group in kilobytes.
+
+       \param[out]  um Return parameter
+       \returns     true if a value is supported by the implementation
+    */
+    bool ProcessGroupInstance::GetUsedMemory(scxulong& um) const
+    {
+        um = m_usedMemory;
+        return true;
+    }
+
+    /**
+       Gets the summed block reads per second of the group.
+
+       \param[out]  brs Return parameter
+       \returns     true if any process in the group reported block I/O
+    */
+    bool ProcessGroupInstance::GetBlockReadsPerSecond(scxulong& brs) const
+    {
+        brs = m_blockReads;
+        return m_hasBlockIO;
+    }
+
+    /**
+       Gets the summed block writes per second of the group.
+
+       \param[out]  bws Return parameter
+       \returns     true if any process in the group reported block I/O
+    */
+    bool ProcessGroupInstance::GetBlockWritesPerSecond(scxulong& bws) const
+    {
+        bws = m_blockWrites;
+        return m_hasBlockIO;
+    }
+
+    /**
+       Gets the summed block transfers per second of the group.
+
+       \param[out]  bts Return parameter
+       \returns     true if any process in the group reported block I/O
+    */
+    bool ProcessGroupInstance::GetBlockTransfersPerSecond(scxulong& bts) const
+    {
+        bts = m_blockReads + m_blockWrites;
+        return m_hasBlockIO;
+    }
+
+    /**
+       Gets the summed hard page faults per second of the group.
+
+       \param[out]  prs Return parameter
+       \returns     true if any process in the group reported page faults
+    */
+    bool ProcessGroupInstance::GetPagesReadPerSec(scxulong& prs) const
+    {
+        prs = m_pagesRead;
+        return m_hasPagesRead;
+    }
+}
+
+/*----------------------------E-N-D---O-F---F-I-L-E---------------------------*/
@@ -21,6 +21,7 @@
 
 #if defined(linux)
 #include <stdio.h>
+#include <string.h>
 #include <sys/stat.h>
 #endif
 
@@ -107,6 +108,83 @@ namespace SCXSystemLib
         }
     }
 
+    /**
+       Reads the control group of the process from /proc/#/cgroup.
+
+       \param basename Directory name in /proc where this instance resides
+
+       Each line of the file has the format "hierarchy-ID:controller-list:path".
+       The unified (v2) hierarchy has the id 0 and an empty controller list and
+       is preferred when present. On a pure v1 host we use the hierarchy that
+       holds the cpu controller, since that is what CPU accounting follows.
+       A missing or unreadable file leaves the path empty, which is what we
+       get on kernels built without control groups.
+
+       The path in the hierarchy of the v1 memory controller is kept apart,
+       since it often differs from the cpu one, e.g. on systemd hosts that do
+       not delegate the memory controller. Without a v1 memory controller the
+       memory path is the unified one.
+
+       The path is read only when the process is discovered. A process is
+       rarely moved between control groups, and rereading the file every
+       sample would cost one more open() per process and tick.
+    */
+    void ProcessInstance::ReadCGroupFile(const char* basename)
+    {
+        char procCGroupName[PROCPATH_LEN];
+        snprintf(procCGroupName, sizeof(procCGroupName), "/proc/%s/cgroup", basename);
+
+        m_cgroup.clear();
+        m_memoryCGroup.clear();
+        SCXFileHandle f(fopen(procCGroupName, "r"));
+        if (!f.GetFile()) { return; }   // No cgroup support, or process already gone
+
+        char line[512];
+        bool gotCpu = false;
+        bool gotUnified = false;
+        bool gotMemory = false;
+        while (fgets(line, sizeof(line), f.GetFile()) != NULL)
+        {
+            char *controllers = strchr(line, ':');
+            if (controllers == NULL) { continue; }
+            char *path = strchr(++controllers, ':');
+            if (path == NULL) { continue; }
+            *path++ = '\0';
+            path[strcspn(path, "\n")] = '\0';
+
+            if (strncmp(line, "0:", 2) == 0 && *controllers == '\0')
+            {
+                m_cgroup = path;                // Unified hierarchy wins
+                gotUnified = true;
+                if (!gotMemory)
+                {
+                    m_memoryCGroup = path;
+                }
+                continue;
+            }
+
+            // Look for "cpu" and "memory" as whole words in the comma-separated controller list
+            bool isCpu = false;
+            bool isMemory = false;
+            char *save = NULL;
+            for (char *c = strtok_r(controllers, ",", &save); c != NULL; c = strtok_r(NULL, ",", &save))
+            {
+                if (strcmp(c, "cpu") == 0) { isCpu = true; }
+                if (strcmp(c, "memory") == 0) { isMemory = true; }
+            }
+            if (isMemory)
+            {
+                m_memoryCGroup = path;
+                gotMemory = true;
+            }
+            if (!gotUnified && ((isCpu && !gotCpu) || m_cgroup.empty()))
+            {
+                m_cgroup = path;
+                gotCpu = gotCpu || isCpu;
+            }
+        }
+    }
+
     /** Format for scanf() when reading /proc/#/stat. */
     const char *LinuxProcStat::scanstring =
     " %c %d %d %d %d %d %lu %lu "                        // 3 to 10
@@ -242,6 +320,36 @@ namespace SCXSystemLib
         return true;
     }
 
+    /**
+     * Reads the /proc/#/io file.
+     *
+     * \param filePointer File pointer to an open file.
+     * \returns true if all fields were read, false if the file could not be read
+     *
+     * The file holds one "name: value" line per counter. Access is checked
+     * when the file is read rather than when it is opened, so a process owned
+     * by another user gives EACCES at the first fgets() unless we run as root.
+     */
+    bool LinuxProcIO::ReadIOFile(FILE *filePointer)
+    {
+        char line[64];
+        int fields = 0;
+        while (fgets(line, sizeof(line), filePointer) != NULL)
+        {
+            char *colon = strchr(line, ':');
+            if (colon == NULL) { continue; }
+            *colon++ = '\0';
+            scxulong value = strtoull(colon, NULL, 10);
+
+            if (strcmp(line, "syscr") == 0)                      { readSyscalls = value; ++fields; }
+            else if (strcmp(line, "syscw") == 0)                 { writeSyscalls = value; ++fields; }
+            else if (strcmp(line, "read_bytes") == 0)            { readBytes = value; ++fields; }
+            else if (strcmp(line, "write_bytes") == 0)           { writeBytes = value; ++fields; }
+            else if (strcmp(line, "cancelled_write_bytes") == 0) { cancelledWriteBytes = value; ++fields; }
+        }
+        return ! ferror(filePointer) && fields == 5;
+    }
+
     /**
      * Constructor for Linux.
      *
@@ -254,8 +362,10 @@ namespace SCXSystemLib
      */
     ProcessInstance::ProcessInstance(scxpid_t pid, const char* basename) :
         EntityInstance(false), m_pid(pid), m_found(true), m_accessViolationEncountered(false),
-        m_uid(0), m_gid(0), m_delta_UserTime(0), m_delta_SystemTime(0),
-        m_delta_HardPageFaults(0)
+        m_uid(0), m_gid(0), m_hasIO(false), m_ioRead(false), m_ioUnavailable(false),
+        m_delta_UserTime(0), m_delta_SystemTime(0), m_delta_HardPageFaults(0),
+        m_delta_ReadSyscalls(0), m_delta_WriteSyscalls(0), m_delta_ReadBytes(0),
+        m_delta_WriteBytes(0)
     {
         m_log = SCXLogHandleFactory::GetLogHandle(moduleIdentifier);
         SCX_LOGHYSTERICAL(m_log, L"ProcessInstance constructor");
@@ -263,6 +373,7 @@ namespace SCXSystemLib
         /* Rememeber files that we read regularly */
         snprintf(m_procStatName,  sizeof(m_procStatName),  "/proc/%s/stat",  basename);
         snprintf(m_procStatMName, sizeof(m_procStatMName), "/proc/%s/statm", basename);
+        snprintf(m_procIOName,    sizeof(m_procIOName),    "/proc/%s/io",    basename);
 
         // The instance id m_Id is of type wstring. (Old relic, I'm told)
         SetId(StrFrom(m_pid));
@@ -292,12 +403,68 @@ namespace SCXSystemLib
 
         m_timeOfDeath.tv_sec = 0; m_timeOfDeath.tv_usec = 0;
         m_delta_RealTime.tv_sec = 0; m_delta_RealTime.tv_usec = 0;
+        m_delta_IORealTime.tv_sec = 0; m_delta_IORealTime.tv_usec = 0;
+    }
+
+    /**
+     * Reinitializes an instance of a dead process to represent a new one.
+     *
+     * \param pid Process number for this process
+     * \param basename Directory name in /proc where this instance resides
+     *
+     * Leaves the instance in the same state as the constructor does, but keeps
+     * the data samplers (and their locks) allocated. Used by ProcessEnumeration
+     * to reuse instances from its pool instead of allocating new ones.
+     */
+    void ProcessInstance::Recycle(scxpid_t pid, const char* basename)
+    {
+        m_pid = pid;
+        m_found = true;
+        m_accessViolationEncountered = false;
+        m_indexedName.clear();
+        m_uid = 0;
+        m_gid = 0;
+        m_cgroup.clear();
+        m_memoryCGroup.clear();
+
+        snprintf(m_procStatName,  sizeof(m_procStatName),  "/proc/%s/stat",  basename);
+        snprintf(m_procStatMName, sizeof(m_procStatMName), "/proc/%s/statm", basename);
+        snprintf(m_procIOName,    sizeof(m_procIOName),    "/proc/%s/io",    basename);
+        SetId(StrFrom(m_pid));
+
+        m = LinuxProcStat();
+        n = LinuxProcStatM();
+        m_io = LinuxProcIO();
+        m_hasIO = false;
+        m_ioRead = false;
+        m_ioUnavailable = false;
+
+        m_RealTime_tics.Clear();
+        m_UserTime_tics.Clear();
+        m_SystemTime_tics.Clear();
+        m_HardPageFaults_tics.Clear();
+        m_ReadSyscalls_tics.Clear();
+        m_WriteSyscalls_tics.Clear();
+        m_ReadBytes_tics.Clear();
+        m_WriteBytes_tics.Clear();
+        m_CancelledWriteBytes_tics.Clear();
+
+        m_delta_UserTime = 0;
+        m_delta_SystemTime = 0;
+        m_delta_HardPageFaults = 0;
+        m_delta_ReadSyscalls = 0;
+        m_delta_WriteSyscalls = 0;
+        m_delta_ReadBytes = 0;
+        m_delta_WriteBytes = 0;
+        m_timeOfDeath.tv_sec = 0; m_timeOfDeath.tv_usec = 0;
+        m_delta_RealTime.tv_sec = 0; m_delta_RealTime.tv_usec = 0;
+        m_delta_IORealTime.tv_sec = 0; m_delta_IORealTime.tv_usec = 0;
     }
 
     /**
      * Updates instance to reflect current status.
      *
-     * \param basename Not needed but yet required
+     * \param basename Directory name in /proc where this instance resides
      * \param initial If this is a newly discovered process
      *
      * \returns true If successful, or false if it was deleted during update
@@ -307,7 +474,7 @@ namespace SCXSystemLib
      * case this is various files under /proc/#/.
      *
      */
-    bool ProcessInstance::UpdateInstance(const char*, bool initial)
+    bool ProcessInstance::UpdateInstance(const char* basename, bool initial)
     {
         struct stat statbuf;
         bool found = false;
@@ -352,12 +519,74 @@ namespace SCXSystemLib
 
         if (initial) {
             SetBootTime();                      // Executed only once
+            ReadCGroupFile(basename);
         }
 
         m_found = true;                         // Mark as processed
         return true;
     }
 
+    /**
+     * Reads the I/O accounting of the process from /proc/#/io.
+     *
+     * \param enabled false if I/O accounting is turned off
+     *
+     * Called after UpdateInstance() when the process is sampled. The file is
+     * unreadable (EACCES) for processes of other users unless we run as root,
+     * and missing (ENOENT) on kernels built without task I/O accounting. In
+     * those cases the process is not tried again and its I/O rates are
+     * reported as not available. ENOENT only counts before the first
+     * successful read; afterwards it means the process is exiting. Other
+     * failures are retried at the next sample. Whenever a sample is missed
+     * the I/O samplers are cleared, so they always hold the latest
+     * consecutive samples.
+     */
+    void ProcessInstance::UpdateIOAccounting(bool enabled)
+    {
+        bool hadIO = m_hasIO;
+        m_hasIO = false;
+        if (enabled && ! m_ioUnavailable && m.state != 'Z')
+        {
+            int err = 0;
+            SCXFileHandle f(fopen(m_procIOName, "r"));
+            if (f.GetFile())
+            {
+                errno = 0;
+                if (m_io.ReadIOFile(f.GetFile()))
+                {
+                    m_hasIO = true;
+                    m_ioRead = true;
+                }
+                else
+                {
+                    err = errno;
+                }
+            }
+            else
+            {
+                err = errno;
+            }
+
+            if ( ! m_hasIO)
+            {
+                SCX_LOGHYSTERICAL(m_log, StrAppend(L"I/O accounting not available, errno: ", err) + L" for " + DumpString());
+                if (EACCES == err || (ENOENT == err && ! m_ioRead))
+                {
+                    m_ioUnavailable = true;
+                }
+            }
+        }
+
+        if (hadIO && ! m_hasIO)
+        {
+            m_ReadSyscalls_tics.Clear();
+            m_WriteSyscalls_tics.Clear();
+            m_ReadBytes_tics.Clear();
+            m_WriteBytes_tics.Clear();
+            m_CancelledWriteBytes_tics.Clear();
+        }
+    }
+
     /**
      * Updates all those values that should be sampled at regualar intervals.
      *
@@ -377,6 +606,14 @@ namespace SCXSystemLib
         m_SystemTime_tics.AddSample(m.systemTime);         // Data sampler for system time.
         m_HardPageFaults_tics.AddSample(m.majorFaults);    // Data sampler for hard page faults.
 
+        if (m_hasIO) {
+            m_ReadSyscalls_tics.AddSample(m_io.readSyscalls);
+            m_WriteSyscalls_tics.AddSample(m_io.writeSyscalls);
+            m_ReadBytes_tics.AddSample(m_io.readBytes);
+            m_WriteBytes_tics.AddSample(m_io.writeBytes);
+            m_CancelledWriteBytes_tics.AddSample(m_io.cancelledWriteBytes);
+        }
+
         /* If process has become a zombie, record time of death. */
         if (m_timeOfDeath.tv_sec == 0 && m.state == 'Z') { m_timeOfDeath = realtime; }
     }
@@ -397,6 +634,18 @@ namespace SCXSystemLib
         m_delta_UserTime = m_UserTime_tics.GetDelta(go_back);
         m_delta_SystemTime = m_SystemTime_tics.GetDelta(go_back);
         m_delta_HardPageFaults = m_HardPageFaults_tics.GetDelta(go_back);
+
+        // The I/O samplers may hold fewer samples than the others, see UpdateIOAccounting()
+        size_t io_go_back = m_ReadBytes_tics.GetNumberOfSamples();
+        m_delta_IORealTime = m_RealTime_tics.GetDelta(io_go_back);
+        m_delta_ReadSyscalls = m_ReadSyscalls_tics.GetDelta(io_go_back);
+        m_delta_WriteSyscalls = m_WriteSyscalls_tics.GetDelta(io_go_back);
+        m_delta_ReadBytes = m_ReadBytes_tics.GetDelta(io_go_back);
+
+        // Dirty pages truncated before writeback were counted in write_bytes but never written
+        scxulong written = m_WriteBytes_tics.GetDelta(io_go_back);
+        scxulong cancelled = m_CancelledWriteBytes_tics.GetDelta(io_go_back);
+        m_delta_WriteBytes = written > cancelled ? written - cancelled : 0;
     }
 
 #endif /* linux */
@@ -1533,6 +1782,36 @@ namespace SCXSystemLib
     }
 
 
+    /**
+       Gets the effective user id of this process instance.
+
+       \param[out]  euid Return parameter
+       \returns     true if this value is supported by the implementation
+
+       This is what you would get if you executed the system call geteuid()
+       on the current process. It is not part of the CIM model, but is used as
+       one of the grouping keys for SCX_ProcessGroupStatisticalInformation.
+
+       On Linux the /proc/#/ directory is owned by the effective user of the
+       process, so the owner we pick up with fstat() is the effective user id.
+    */
+    bool ProcessInstance::GetEffectiveUserID(scxulong& euid) const
+    {
+#if defined(linux)
+        euid = m_uid;
+        return true;
+#elif defined(sun) || defined(aix)
+        euid = m_psinfo.pr_euid;
+        return true;
+#elif defined(hpux)
+        euid = m_pstatus.pst_euid;
+        return true;
+#else
+        return false;
+#endif
+    }
+
+
     /**
        Gets the process group id of this process instance.
 
@@ -2316,11 +2595,18 @@ namespace SCXSystemLib
        Those platforms that support this parameter report an cumulative
        number of block writes. We sample that number and divide by
        the interval.
+
+       Linux only counts bytes in /proc/#/io. Blocks are 512 bytes of
+       write_bytes less cancelled_write_bytes, which is how the kernel
+       computes ru_oublock for getrusage().
     */
     bool ProcessInstance::GetBlockWritesPerSecond(scxulong &bws) const
     {
-#if defined(linux) || defined(aix)
-        /* This is not available on Linux or AIX */
+#if defined(linux)
+        bws = ComputeItemsPerSecond(m_delta_WriteBytes / 512, m_delta_IORealTime);
+        return m_hasIO;
+#elif defined(aix)
+        /* This is not available on AIX */
         bws = 0;
         return false;
 #elif defined(sun) || defined(hpux)
@@ -2343,11 +2629,17 @@ namespace SCXSystemLib
        Those platforms that support this parameter report an cumulative
        number of block reads. We sample that number and divide by
        the interval.
+
+       On Linux blocks are 512 bytes of read_bytes in /proc/#/io, as for
+       ru_inblock of getrusage().
     */
     bool ProcessInstance::GetBlockReadsPerSecond(scxulong &bwr) const
     {
-#if defined(linux) || defined(aix)
-        /* This is not available on Linux or AIX */
+#if defined(linux)
+        bwr = ComputeItemsPerSecond(m_delta_ReadBytes / 512, m_delta_IORealTime);
+        return m_hasIO;
+#elif defined(aix)
+        /* This is not available on AIX */
         bwr = 0;
         return false;
 #elif defined(sun) || defined(hpux)
@@ -2375,8 +2667,11 @@ namespace SCXSystemLib
     */
     bool ProcessInstance::GetBlockTransfersPerSecond(scxulong &bts) const
     {
-#if defined(linux) || defined(aix)
-        /* This is not available on Linux or AIX */
+#if defined(linux)
+        bts = ComputeItemsPerSecond((m_delta_ReadBytes + m_delta_WriteBytes) / 512, m_delta_IORealTime);
+        return m_hasIO;
+#elif defined(aix)
+        /* This is not available on AIX */
         bts = 0;
         return false;
 #elif defined(sun) || defined(hpux)
@@ -2522,6 +2817,89 @@ namespace SCXSystemLib
 #endif
     }
 
+    /**
+       Gets the recent number of bytes per second this process caused to be
+       read from storage.
+
+       \param[out]  rbs Return parameter for the bytes per second
+       \returns     true if a value is supported by the implementation
+
+       Reads served from the page cache are not counted. Only Linux has
+       this, from read_bytes of /proc/#/io.
+    */
+    bool ProcessInstance::GetReadBytesPerSecond(scxulong &rbs) const
+    {
+#if defined(linux)
+        rbs = ComputeItemsPerSecond(m_delta_ReadBytes, m_delta_IORealTime);
+        return m_hasIO;
+#else
+        rbs = 0;
+        return false;
+#endif
+    }
+
+    /**
+       Gets the recent number of bytes per second this process caused to be
+       written to storage.
+
+       \param[out]  wbs Return parameter for the bytes per second
+       \returns     true if a value is supported by the implementation
+
+       Dirty pages that were truncated before writeback are not counted.
+       Only Linux has this, from write_bytes less cancelled_write_bytes of
+       /proc/#/io.
+    */
+    bool ProcessInstance::GetWriteBytesPerSecond(scxulong &wbs) const
+    {
+#if defined(linux)
+        wbs = ComputeItemsPerSecond(m_delta_WriteBytes, m_delta_IORealTime);
+        return m_hasIO;
+#else
+        wbs = 0;
+        return false;
+#endif
+    }
+
+    /**
+       Gets the recent number of read system calls per second made by this process.
+
+       \param[out]  ros Return parameter for the calls per second
+       \returns     true if a value is supported by the implementation
+
+       This counts all reads, including those of pipes, sockets and the page
+       cache. Only Linux has this, from syscr of /proc/#/io.
+    */
+    bool ProcessInstance::GetReadOperationsPerSecond(scxulong &ros) const
+    {
+#if defined(linux)
+        ros = ComputeItemsPerSecond(m_delta_ReadSyscalls, m_delta_IORealTime);
+        return m_hasIO;
+#else
+        ros = 0;
+        return false;
+#endif
+    }
+
+    /**
+       Gets the recent number of write system calls per second made by this process.
+
+       \param[out]  wos Return parameter for the calls per second
+       \returns     true if a value is supported by the implementation
+
+       This counts all writes, including those of pipes and sockets. Only
+       Linux has this, from syscw of /proc/#/io.
+    */
+    bool ProcessInstance::GetWriteOperationsPerSecond(scxulong &wos) const
+    {
+#if defined(linux)
+        wos = ComputeItemsPerSecond(m_delta_WriteSyscalls, m_delta_IORealTime);
+        return m_hasIO;
+#else
+        wos = 0;
+        return false;
+#endif
+    }
+
     /*====================================================================================*/
     /* Properties of SCX_UnixProcessStatisticalInformation, Phase 2                       */
     /*====================================================================================*/
@@ -2876,6 +3254,46 @@ namespace SCXSystemLib
 #endif
     }
 
+    /**
+       Gets the control group path of the process.
+
+       \param[out]  cgroup Return parameter, e.g. "/system.slice/sshd.service"
+       \returns     true if this value is supported by the implementation
+
+       Only Linux has control groups. The path is empty when the kernel has no
+       cgroup support or the process died before /proc/#/cgroup could be read.
+    */
+    bool ProcessInstance::GetCGroupPath(std::string& cgroup) const
+    {
+#if defined(linux)
+        cgroup = m_cgroup;
+        return true;
+#else
+        cgroup.clear();
+        return false;
+#endif
+    }
+
+    /**
+       Gets the path of the process in the hierarchy of the memory controller.
+
+       \param[out]  cgroup Return parameter, e.g. "/user.slice"
+       \returns     true if this value is supported by the implementation
+
+       Equal to GetCGroupPath() on the unified hierarchy. On a v1 host it is
+       the path from the line of /proc/#/cgroup with the memory controller.
+    */
+    bool ProcessInstance::GetMemoryCGroupPath(std::string& cgroup) const
+    {
+#if defined(linux)
+        cgroup = m_memoryCGroup;
+        return true;
+#else
+        cgroup.clear();
+        return false;
+#endif
+    }
+
     /**************************************************************************/
 
     /**
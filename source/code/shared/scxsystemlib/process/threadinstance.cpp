@@ -0,0 +1,273 @@
+/*----------------------------------------------------------------------------
+    Copyright (c) Microsoft Corporation.  All rights reserved.
+
+*/
+/**
+    \file
+
+    \brief       PAL representation of a thread of a Unix process
+
+    \date        2026-10-18 11:00:00
+
+*/
+/*----------------------------------------------------------------------------*/
+#include <stdlib.h>
+#include <unistd.h>
+#include <errno.h>
+
+#if defined(linux)
+#include <stdio.h>
+#include <sys/time.h>
+#endif
+
+#include <scxcorelib/scxcmn.h>
+#include <scxcorelib/scxexception.h>
+#include <scxcorelib/scxfile.h>
+#include <scxcorelib/stringaid.h>
+
+#include <scxsystemlib/threadinstance.h>
+
+using namespace std;
+using namespace SCXCoreLib;
+
+namespace SCXSystemLib
+{
+    /**
+       Constructor
+
+       \param pid         Process number of the owning process
+       \param tid         Thread number
+       \param processName Name of the owning process
+
+       The instance id is "<pid>:<tid>". This constructor is private since it
+       can only be used by the ProcessEnumeration class.
+    */
+    ThreadInstance::ThreadInstance(scxpid_t pid, scxpid_t tid, const std::string& processName) :
+        EntityInstance(false), m_pid(pid), m_tid(tid), m_processName(processName), m_found(true),
+        m_percentUserTime(0), m_percentPrivilegedTime(0)
+    {
+        m_log = SCXLogHandleFactory::GetLogHandle(L"scx.core.common.pal.system.process.threadinstance");
+
+        SetId(StrFrom(pid) + L":" + StrFrom(tid));
+
+#if defined(linux)
+        snprintf(m_taskStatName, sizeof(m_taskStatName), "/proc/%lu/task/%lu/stat",
+                 static_cast<unsigned long>(pid), static_cast<unsigned long>(tid));
+
+        m.command[0] = '\0';
+        m.processId = 0;
+        m.processorNum = 0;
+
+        long retval = sysconf(_SC_CLK_TCK);
+        m_jiffies_per_second = (retval > 0) ? static_cast<unsigned int>(retval) : 100;
+#endif
+    }
+
+    /**
+       Destructor
+    */
+    ThreadInstance::~ThreadInstance()
+    {
+    }
+
+#if defined(linux)
+    /**
+       Reads the stat file of the thread.
+
+       \returns true If successful, or false if the thread is gone
+
+       The task stat file has the same format as the process stat file, so
+       the reader used for processes is reused.
+    */
+    bool ThreadInstance::UpdateInstance()
+    {
+        SCXFileHandle f(fopen(m_taskStatName, "r"));
+        if (!f.GetFile()) {
+            // Thread exited since the task directory was read
+            if (ENOENT == errno || ESRCH == errno || EBADF == errno || EINVAL == errno) { m_found = false; return false; }
+            throw SCXErrnoException(L"fopen", errno, SCXSRCLOCATION);
+        }
+
+        m_found = m.ReadStatFile(f.GetFile(), m_taskStatName);
+        return m_found;
+    }
+
+    /**
+       Adds the latest values to the data samplers.
+
+       \param realtime Current time
+    */
+    void ThreadInstance::UpdateDataSampler(struct timeval& realtime)
+    {
+        m_RealTime_tics.AddSample(realtime);
+        m_UserTime_tics.AddSample(m.userTime);
+        m_SystemTime_tics.AddSample(m.systemTime);
+    }
+
+    /**
+       Computes the percentages over the sampled window.
+    */
+    void ThreadInstance::UpdateTimedValues()
+    {
+        const size_t go_back = MAX_THREADINSTANCE_DATASAMPLER_SAMPLES;
+
+        struct timeval elapsed = m_RealTime_tics.GetDelta(go_back);
+
+        // Convert both to milliseconds to get a resonable resolution WO overflow
+        scxulong el = 1000 * static_cast<scxulong>(elapsed.tv_sec) + static_cast<scxulong>(elapsed.tv_usec) / 1000;
+        if (0 == el)
+        {
+            m_percentUserTime = m_percentPrivilegedTime = 0;
+            return;
+        }
+
+        m_percentUserTime = 100 * (1000 * m_UserTime_tics.GetDelta(go_back) / m_jiffies_per_second) / el;
+        m_percentPrivilegedTime = 100 * (1000 * m_SystemTime_tics.GetDelta(go_back) / m_jiffies_per_second) / el;
+    }
+#else
+    /**
+       Threads are not sampled on this platform.
+
+       \returns false
+    */
+    bool ThreadInstance::UpdateInstance()
+    {
+        m_found = false;
+        return false;
+    }
+
+    /**
+       Threads are not sampled on this platform.
+    */
+    void ThreadInstance::UpdateDataSampler(struct timeval&)
+    {
+    }
+
+    /**
+       Threads are not sampled on this platform.
+    */
+    void ThreadInstance::UpdateTimedValues()
+    {
+    }
+#endif
+
+    /**
+       Gets the process id of the owning process.
+
+       \param[out]  pid Return parameter
+       \returns     true if a value is supported by the implementation
+    */
+    bool ThreadInstance::GetPID(scxulong& pid) const
+    {
+        pid = m_pid;
+        return true;
+    }
+
+    /**
+       Gets the thread id.
+
+       \param[out]  tid Return parameter
+       \returns     true if a value is supported by the implementation
+    */
+    bool ThreadInstance::GetTID(scxulong& tid) const
+    {
+        tid = m_tid;
+        return true;
+    }
+
+    /**
+       Gets the name of the owning process.
+
+       \param[out]  name Return parameter
+       \returns     true if a value is supported by the implementation
+    */
+    bool ThreadInstance::GetProcessName(std::string& name) const
+    {
+        name = m_processName;
+        return true;
+    }
+
+    /**
+       Gets the name of the thread, as set with prctl(PR_SET_NAME).
+
+       \param[out]  name Return parameter
+       \returns     true if a value is supported by the implementation
+    */
+    bool ThreadInstance::GetName(std::string& name) const
+    {
+#if defined(linux)
+        name = m.command;
+        return true;
+#else
+        name.clear();
+        return false;
+#endif
+    }
+
+    /**
+       Gets the processor the thread last ran on.
+
+       \param[out]  cpu Return parameter
+       \returns     true if a value is supported by the implementation
+    */
+    bool ThreadInstance::GetLastProcessor(unsigned int& cpu) const
+    {
+#if defined(linux)
+        cpu = static_cast<unsigned int>(m.processorNum);
+        return true;
+#else
+        cpu = 0;
+        return false;
+#endif
+    }
+
+    /**
+       Gets the percentage of a CPU's time consumed by the thread.
+
+       \param[out]  cpu Return parameter
+       \returns     true if a value is supported by the implementation
+    */
+    bool ThreadInstance::GetCPUTime(scxulong& cpu) const
+    {
+        cpu = m_percentUserTime + m_percentPrivilegedTime;
+#if defined(linux)
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    /**
+       Gets the percentage of time the thread spent in user mode.
+
+       \param[out]  put Return parameter
+       \returns     true if a value is supported by the implementation
+    */
+    bool ThreadInstance::GetPercentUserTime(scxulong& put) const
+    {
+        put = m_percentUserTime;
+#if defined(linux)
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    /**
+       Gets the percentage of time the thread spent in privileged mode.
+
+       \param[out]  ppt Return parameter
+       \returns     true if a value is supported by the implementation
+    */
+    bool ThreadInstance::GetPercentPrivilegedTime(scxulong& ppt) const
+    {
+        ppt = m_percentPrivilegedTime;
+#if defined(linux)
+        return true;
+#else
+        return false;
+#endif
+    }
+}
+
+/*----------------------------E-N-D---O-F---F-I-L-E---------------------------*/
@@ -0,0 +1,153 @@
+/*--------------------------------------------------------------------------------
+    Copyright (c) Microsoft Corporation.  All rights reserved.
+
+*/
+/**
+    \file
+
+    \brief       Tests for the parsers of the cgroup control files
+
+    \date        2026-10-18 23:45:00
+
+*/
+/*----------------------------------------------------------------------------*/
+
+#include <scxcorelib/scxcmn.h>
+#include <scxsystemlib/cgroupenumeration.h>
+#include <testutils/scxunit.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+using namespace SCXSystemLib;
+
+namespace
+{
+    /** cpu.stat of the unified hierarchy */
+    const char* const s_cpuStat =
+        "usage_usec 1893471\n"
+        "user_usec 1251102\n"
+        "system_usec 642369\n"
+        "nr_periods 0\n"
+        "nr_throttled 0\n"
+        "throttled_usec 0\n";
+
+    /** cpuacct.stat of the legacy hierarchy, in clock ticks */
+    const char* const s_cpuacctStat =
+        "user 4520\n"
+        "system 1873";
+}
+
+class CGroupEnumerationTest : public CPPUNIT_NS::TestFixture
+{
+    CPPUNIT_TEST_SUITE( CGroupEnumerationTest );
+    CPPUNIT_TEST( TestParseValue );
+    CPPUNIT_TEST( TestParseValueMax );
+    CPPUNIT_TEST( TestParseKeyValue );
+    CPPUNIT_TEST( TestParseKeyValueLastLineWithoutNewline );
+    CPPUNIT_TEST( TestParseKeyValueMissingKey );
+    CPPUNIT_TEST( TestParseKeyValueNeedsWholeKey );
+    CPPUNIT_TEST( TestParseIOStat );
+    CPPUNIT_TEST( TestParseIOStatEmpty );
+    CPPUNIT_TEST( TestParseBlkio );
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    void TestParseValue()
+    {
+        scxulong value = 0;
+        CPPUNIT_ASSERT(CGroupEnumeration::ParseValue("268435456\n", value));
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(268435456), value);
+        CPPUNIT_ASSERT(CGroupEnumeration::ParseValue("  17", value));
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(17), value);
+        CPPUNIT_ASSERT( ! CGroupEnumeration::ParseValue("", value));
+    }
+
+    void TestParseValueMax()
+    {
+        // memory.max and pids.max hold "max" when there is no limit
+        scxulong value = 42;
+        CPPUNIT_ASSERT( ! CGroupEnumeration::ParseValue("max\n", value));
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(42), value);
+    }
+
+    void TestParseKeyValue()
+    {
+        scxulong value = 0;
+        CPPUNIT_ASSERT(CGroupEnumeration::ParseKeyValue(s_cpuStat, "usage_usec", value));
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(1893471), value);
+        CPPUNIT_ASSERT(CGroupEnumeration::ParseKeyValue(s_cpuStat, "user_usec", value));
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(1251102), value);
+        CPPUNIT_ASSERT(CGroupEnumeration::ParseKeyValue(s_cpuStat, "system_usec", value));
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(642369), value);
+        CPPUNIT_ASSERT(CGroupEnumeration::ParseKeyValue(s_cpuStat, "throttled_usec", value));
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(0), value);
+    }
+
+    void TestParseKeyValueLastLineWithoutNewline()
+    {
+        scxulong value = 0;
+        CPPUNIT_ASSERT(CGroupEnumeration::ParseKeyValue(s_cpuacctStat, "user", value));
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(4520), value);
+        CPPUNIT_ASSERT(CGroupEnumeration::ParseKeyValue(s_cpuacctStat, "system", value));
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(1873), value);
+    }
+
+    void TestParseKeyValueMissingKey()
+    {
+        scxulong value = 0;
+        CPPUNIT_ASSERT( ! CGroupEnumeration::ParseKeyValue(s_cpuStat, "nr_bursts", value));
+        CPPUNIT_ASSERT( ! CGroupEnumeration::ParseKeyValue("", "usage_usec", value));
+    }
+
+    void TestParseKeyValueNeedsWholeKey()
+    {
+        // "user" must not match the user_usec row, nor "usec" the end of a key
+        scxulong value = 0;
+        CPPUNIT_ASSERT( ! CGroupEnumeration::ParseKeyValue(s_cpuStat, "user", value));
+        CPPUNIT_ASSERT( ! CGroupEnumeration::ParseKeyValue(s_cpuStat, "usec", value));
+        CPPUNIT_ASSERT( ! CGroupEnumeration::ParseKeyValue(s_cpuStat, "nr", value));
+    }
+
+    void TestParseIOStat()
+    {
+        const char* ioStat =
+            "8:16 rbytes=1459200 wbytes=314773504 rios=192 wios=353 dbytes=0 dios=0\n"
+            "8:0 rbytes=90430464 wbytes=299008000 rios=8950 wios=1252 dbytes=50331648 dios=3021\n";
+
+        scxulong rbytes = 1, wbytes = 1, rios = 1, wios = 1;
+        CPPUNIT_ASSERT(CGroupEnumeration::ParseIOStat(ioStat, rbytes, wbytes, rios, wios));
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(1459200 + 90430464), rbytes);
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(314773504 + 299008000), wbytes);
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(192 + 8950), rios);
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(353 + 1252), wios);
+    }
+
+    void TestParseIOStatEmpty()
+    {
+        scxulong rbytes = 1, wbytes = 1, rios = 1, wios = 1;
+        CPPUNIT_ASSERT(CGroupEnumeration::ParseIOStat("", rbytes, wbytes, rios, wios));
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(0), rbytes);
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(0), wbytes);
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(0), rios);
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(0), wios);
+    }
+
+    void TestParseBlkio()
+    {
+        const char* blkio =
+            "8:0 Read 90430464\n"
+            "8:0 Write 299008000\n"
+            "8:0 Sync 312340480\n"
+            "8:0 Async 77097984\n"
+            "8:0 Total 389438464\n"
+            "8:16 Read 1459200\n"
+            "8:16 Write 314773504\n"
+            "Total 705671168\n";
+
+        scxulong read = 1, write = 1;
+        CPPUNIT_ASSERT(CGroupEnumeration::ParseBlkio(blkio, read, write));
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(90430464 + 1459200), read);
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(299008000 + 314773504), write);
+    }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION( CGroupEnumerationTest );
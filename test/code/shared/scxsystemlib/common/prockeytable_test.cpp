@@ -0,0 +1,262 @@
+/*--------------------------------------------------------------------------------
+    Copyright (c) Microsoft Corporation.  All rights reserved.
+
+*/
+/**
+    \file
+
+    \brief       Tests for the key table used to parse /proc/meminfo and /proc/vmstat
+
+    \date        2026-10-18 23:45:00
+
+*/
+/*----------------------------------------------------------------------------*/
+
+#include <scxcorelib/scxcmn.h>
+#include <scxcorelib/stringaid.h>
+#include <scxsystemlib/prockeytable.h>
+#include <testutils/scxunit.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <string.h>
+
+using namespace SCXSystemLib;
+
+namespace
+{
+    /** Part of /proc/meminfo of a 3.14 kernel, which added MemAvailable */
+    const char* const s_memInfo =
+        "MemTotal:        8047124 kB\n"
+        "MemFree:          257668 kB\n"
+        "MemAvailable:    5174084 kB\n"
+        "Buffers:          363592 kB\n"
+        "Cached:          4520580 kB\n"
+        "SwapCached:            0 kB\n"
+        "Active(file):    2093784 kB\n"
+        "HugePages_Total:       0\n"
+        "SwapTotal:       2097148 kB\n"
+        "SwapFree:        2097148 kB\n";
+
+    /** Part of /sys/devices/system/node/node1/meminfo */
+    const char* const s_nodeMemInfo =
+        "Node 1 MemTotal:       16777216 kB\n"
+        "Node 1 MemFree:         1048576 kB\n"
+        "Node 1 MemUsed:        15728640 kB\n";
+
+    /** Part of /proc/vmstat */
+    const char* const s_vmStat =
+        "nr_free_pages 64417\n"
+        "pgpgin 1633392\n"
+        "pgpgout 9284504\n"
+        "pswpin 0\n"
+        "pswpout 12\n"
+        "pgmajfault 4807\n"
+        "oom_kill 3";
+}
+
+class ProcKeyTableTest : public CPPUNIT_NS::TestFixture
+{
+    CPPUNIT_TEST_SUITE( ProcKeyTableTest );
+    CPPUNIT_TEST( TestFindAddedKeys );
+    CPPUNIT_TEST( TestAddRejectsEmptyAndDuplicateKeys );
+    CPPUNIT_TEST( TestFindDoesNotMatchPrefixes );
+    CPPUNIT_TEST( TestManyKeysStayFindable );
+    CPPUNIT_TEST( TestClear );
+    CPPUNIT_TEST( TestParseMemInfo );
+    CPPUNIT_TEST( TestParseMemInfoWithoutMemAvailable );
+    CPPUNIT_TEST( TestParseNodeMemInfo );
+    CPPUNIT_TEST( TestParseVmStatWithoutTrailingNewline );
+    CPPUNIT_TEST( TestParseKeepsFirstValue );
+    CPPUNIT_TEST( TestParseSkipsLinesWithoutValue );
+    CPPUNIT_TEST_SUITE_END();
+
+private:
+    /** Parses a string with a table, clearing found first the way the callers do */
+    size_t Parse(const ProcKeyTable& table, const char* text, scxulong* values, bool* found, size_t count, size_t skipWords = 0)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            found[i] = false;
+            values[i] = 0;
+        }
+        return table.Parse(text, text + strlen(text), values, found, skipWords);
+    }
+
+public:
+    void TestFindAddedKeys()
+    {
+        ProcKeyTable table;
+        CPPUNIT_ASSERT(table.Add("MemTotal", 0));
+        CPPUNIT_ASSERT(table.Add("MemFree", 1));
+        CPPUNIT_ASSERT(table.Add("Active(file)", 2));
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), table.Size());
+        CPPUNIT_ASSERT(table.IsPerfect());
+
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), table.Find("MemTotal", 8));
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), table.Find("MemFree", 7));
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), table.Find("Active(file)", 12));
+        CPPUNIT_ASSERT_EQUAL(ProcKeyTable::npos, table.Find("Cached", 6));
+    }
+
+    void TestAddRejectsEmptyAndDuplicateKeys()
+    {
+        ProcKeyTable table;
+        CPPUNIT_ASSERT( ! table.Add("", 0));
+        CPPUNIT_ASSERT(table.Add("pgmajfault", 0));
+        CPPUNIT_ASSERT( ! table.Add("pgmajfault", 1));
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), table.Size());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), table.Find("pgmajfault", 10));
+    }
+
+    void TestFindDoesNotMatchPrefixes()
+    {
+        ProcKeyTable table;
+        CPPUNIT_ASSERT(table.Add("SwapCached", 0));
+
+        // The key is not null terminated in the buffer, only its length counts
+        const char* line = "SwapCachedX";
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), table.Find(line, 10));
+        CPPUNIT_ASSERT_EQUAL(ProcKeyTable::npos, table.Find(line, 11));
+        CPPUNIT_ASSERT_EQUAL(ProcKeyTable::npos, table.Find(line, 4));
+    }
+
+    void TestManyKeysStayFindable()
+    {
+        // More keys than the smallest table has slots, so the table is rehashed while growing
+        ProcKeyTable table;
+        for (size_t i = 0; i < 100; i++)
+        {
+            CPPUNIT_ASSERT(table.Add(SCXCoreLib::StrToMultibyte(SCXCoreLib::StrAppend(L"nr_counter_", i)), i));
+        }
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(100), table.Size());
+        for (size_t i = 0; i < 100; i++)
+        {
+            std::string key = SCXCoreLib::StrToMultibyte(SCXCoreLib::StrAppend(L"nr_counter_", i));
+            CPPUNIT_ASSERT_EQUAL(i, table.Find(key.data(), key.size()));
+        }
+        CPPUNIT_ASSERT_EQUAL(ProcKeyTable::npos, table.Find("nr_counter_100", 14));
+    }
+
+    void TestClear()
+    {
+        ProcKeyTable table;
+        CPPUNIT_ASSERT(table.Add("MemTotal", 0));
+        table.Clear();
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), table.Size());
+        CPPUNIT_ASSERT_EQUAL(ProcKeyTable::npos, table.Find("MemTotal", 8));
+        CPPUNIT_ASSERT(table.Add("MemTotal", 1));
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), table.Find("MemTotal", 8));
+    }
+
+    void TestParseMemInfo()
+    {
+        ProcKeyTable table;
+        table.Add("MemTotal", 0);
+        table.Add("MemAvailable", 1);
+        table.Add("SwapFree", 2);
+        table.Add("HugePages_Total", 3);
+
+        scxulong values[4];
+        bool found[4];
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(4), Parse(table, s_memInfo, values, found, 4));
+        CPPUNIT_ASSERT(found[0] && found[1] && found[2] && found[3]);
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(8047124), values[0]);
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(5174084), values[1]);
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(2097148), values[2]);
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(0), values[3]);
+    }
+
+    void TestParseMemInfoWithoutMemAvailable()
+    {
+        // Kernels before 3.14 have no MemAvailable line; the caller falls back on the other keys
+        const char* oldMemInfo =
+            "MemTotal:        8047124 kB\n"
+            "MemFree:          257668 kB\n"
+            "Buffers:          363592 kB\n"
+            "Cached:          4520580 kB\n";
+
+        ProcKeyTable table;
+        table.Add("MemAvailable", 0);
+        table.Add("MemFree", 1);
+        table.Add("Cached", 2);
+
+        scxulong values[3];
+        bool found[3];
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), Parse(table, oldMemInfo, values, found, 3));
+        CPPUNIT_ASSERT( ! found[0]);
+        CPPUNIT_ASSERT(found[1]);
+        CPPUNIT_ASSERT(found[2]);
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(257668), values[1]);
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(4520580), values[2]);
+    }
+
+    void TestParseNodeMemInfo()
+    {
+        ProcKeyTable table;
+        table.Add("MemTotal", 0);
+        table.Add("MemFree", 1);
+
+        scxulong values[2];
+        bool found[2];
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), Parse(table, s_nodeMemInfo, values, found, 2, 2));
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(16777216), values[0]);
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(1048576), values[1]);
+
+        // Without skipping "Node 1" no key matches
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), Parse(table, s_nodeMemInfo, values, found, 2));
+    }
+
+    void TestParseVmStatWithoutTrailingNewline()
+    {
+        ProcKeyTable table;
+        table.Add("pgmajfault", 0);
+        table.Add("oom_kill", 1);
+        table.Add("pswpout", 2);
+
+        scxulong values[3];
+        bool found[3];
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), Parse(table, s_vmStat, values, found, 3));
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(4807), values[0]);
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(3), values[1]);
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(12), values[2]);
+    }
+
+    void TestParseKeepsFirstValue()
+    {
+        const char* text =
+            "pgpgin 10\n"
+            "pgpgin 20\n";
+
+        ProcKeyTable table;
+        table.Add("pgpgin", 0);
+        table.Add("pgpgout", 1);
+
+        scxulong values[2];
+        bool found[2];
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), Parse(table, text, values, found, 2));
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(10), values[0]);
+        CPPUNIT_ASSERT( ! found[1]);
+    }
+
+    void TestParseSkipsLinesWithoutValue()
+    {
+        const char* text =
+            "MemTotal:\n"
+            "\n"
+            "MemFree: none\n"
+            "MemTotal: 42 kB\n";
+
+        ProcKeyTable table;
+        table.Add("MemTotal", 0);
+        table.Add("MemFree", 1);
+
+        scxulong values[2];
+        bool found[2];
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), Parse(table, text, values, found, 2));
+        CPPUNIT_ASSERT(found[0]);
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(42), values[0]);
+        CPPUNIT_ASSERT( ! found[1]);
+    }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION( ProcKeyTableTest );
@@ -0,0 +1,244 @@
+/*--------------------------------------------------------------------------------
+    Copyright (c) Microsoft Corporation.  All rights reserved.
+
+*/
+/**
+    \file
+
+    \brief       Tests for the parser of the counter rows of /proc/stat and the
+                 steal and guest times computed from them
+
+    \date        2026-10-18 23:45:00
+
+*/
+/*----------------------------------------------------------------------------*/
+
+#include <scxcorelib/scxcmn.h>
+#include <scxsystemlib/cpuenumeration.h>
+#include <testutils/scxunit.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <string.h>
+
+using namespace SCXSystemLib;
+
+namespace
+{
+    /** Number of counters in a cpu row of a current kernel */
+    const size_t s_columns = 10;
+}
+
+/** Two online processors, with /proc/stat contents set by the test */
+class ProcStatTestDependencies : public CPUPALDependencies
+{
+public:
+    virtual size_t ReadStatFile(char* buf, size_t size) const
+    {
+        size_t len = m_stat.size() < size ? m_stat.size() : size;
+        memcpy(buf, m_stat.data(), len);
+        return len;
+    }
+
+    virtual bool ReadSysFile(const std::string& path, std::string& content) const
+    {
+        if ("/sys/devices/system/cpu/online" == path)
+        {
+            content = "0-1\n";
+            return true;
+        }
+        return false;
+    }
+
+    void SetStat(const std::string& stat) { m_stat = stat; }
+
+private:
+    std::string m_stat;
+};
+
+class ProcStatTest : public CPPUNIT_NS::TestFixture
+{
+    CPPUNIT_TEST_SUITE( ProcStatTest );
+    CPPUNIT_TEST( TestParseCurrentKernel );
+    CPPUNIT_TEST( TestParseOldKernels );
+    CPPUNIT_TEST( TestParseStopsAtMaxValues );
+    CPPUNIT_TEST( TestParseTabsAndTrailingSpace );
+    CPPUNIT_TEST( TestParseStopsAtNonDigit );
+    CPPUNIT_TEST( TestParseEmpty );
+    CPPUNIT_TEST( TestParseStopsAtEnd );
+    CPPUNIT_TEST( TestParseFirstColumnOnly );
+    CPPUNIT_TEST( TestStealAndGuestTime );
+    CPPUNIT_TEST( TestStealAndGuestTimeOnOldKernel );
+    CPPUNIT_TEST_SUITE_END();
+
+private:
+    /**
+        Takes two samples of /proc/stat and returns the updated instance of a processor.
+        Init() is not called, so there is no sampler thread racing the test.
+    */
+    SCXCoreLib::SCXHandle<CPUInstance> Sample(SCXCoreLib::SCXHandle<ProcStatTestDependencies> deps,
+                                              const std::string& first, const std::string& second,
+                                              size_t pos)
+    {
+        CPUEnumeration cpus(deps);
+        cpus.Update(false);
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), cpus.Size());
+
+        deps->SetStat(first);
+        cpus.SampleData();
+        deps->SetStat(second);
+        cpus.SampleData();
+        cpus.Update(true);
+
+        return cpus.GetInstance(pos);
+    }
+
+    /** Parses the counters of a row, after its label */
+    size_t Parse(const char* row, scxulong* values, size_t maxValues = s_columns)
+    {
+        const char* p = strchr(row, ' ');
+        CPPUNIT_ASSERT(NULL != p);
+        return CPUEnumeration::ParseStatCounters(p, row + strlen(row), values, maxValues);
+    }
+
+public:
+    void TestParseCurrentKernel()
+    {
+        // user nice system idle iowait irq softirq steal guest guest_nice
+        scxulong values[s_columns];
+        CPPUNIT_ASSERT_EQUAL(s_columns, Parse("cpu0 74608 2520 24433 1117073 6176 4054 0 3071 1207 12", values));
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(74608), values[0]);
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(2520), values[1]);
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(24433), values[2]);
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(1117073), values[3]);
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(6176), values[4]);
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(4054), values[5]);
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(0), values[6]);
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(3071), values[7]);
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(1207), values[8]);
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(12), values[9]);
+    }
+
+    void TestParseOldKernels()
+    {
+        scxulong values[s_columns];
+
+        // 2.4 kernels have user, nice, system and idle only
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(4), Parse("cpu  1139 3 5632 1247431", values));
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(1247431), values[3]);
+
+        // 2.6.0 added iowait, irq and softirq
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(7), Parse("cpu1 1139 3 5632 1247431 5181 136 342", values));
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(342), values[6]);
+
+        // 2.6.11 added steal, 2.6.24 guest
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(9), Parse("cpu1 1139 3 5632 1247431 5181 136 342 17 4", values));
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(17), values[7]);
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(4), values[8]);
+    }
+
+    void TestParseStopsAtMaxValues()
+    {
+        // A future kernel with an eleventh column
+        scxulong values[s_columns + 1];
+        values[s_columns] = 99;
+        CPPUNIT_ASSERT_EQUAL(s_columns, Parse("cpu2 1 2 3 4 5 6 7 8 9 10 11", values));
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(10), values[9]);
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(99), values[s_columns]);
+    }
+
+    void TestParseTabsAndTrailingSpace()
+    {
+        scxulong values[s_columns];
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(4), Parse("cpu3 \t12\t 34 56  78  ", values));
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(12), values[0]);
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(34), values[1]);
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(56), values[2]);
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(78), values[3]);
+    }
+
+    void TestParseStopsAtNonDigit()
+    {
+        scxulong values[s_columns];
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), Parse("cpu4 100 200 -300 400", values));
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(200), values[1]);
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), Parse("cpu4 x 1 2 3", values));
+    }
+
+    void TestParseEmpty()
+    {
+        scxulong values[s_columns];
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), Parse("cpu5 ", values));
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), CPUEnumeration::ParseStatCounters("", "", values, s_columns));
+    }
+
+    void TestParseStopsAtEnd()
+    {
+        // The buffer is not null terminated; rows end where the next begins
+        const char* text = "cpu6 10 20 30 40\ncpu7 50 60 70 80\n";
+        const char* eol = strchr(text, '\n');
+
+        scxulong values[s_columns];
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(4), CPUEnumeration::ParseStatCounters(text + 4, eol, values, s_columns));
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(40), values[3]);
+
+        // A value cut by the end of the buffer: " 10 20 3"
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), CPUEnumeration::ParseStatCounters(text + 4, text + 12, values, s_columns));
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(3), values[2]);
+    }
+
+    void TestParseFirstColumnOnly()
+    {
+        // Only the total of the intr row is used
+        scxulong intr = 0;
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), Parse("intr 20183923 9 0 0 0 0 0 0 0 1 0 0 0 4 0 0", &intr, 1));
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(20183923), intr);
+
+        scxulong ctxt = 0;
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), Parse("ctxt 38014093", &ctxt, 1));
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(38014093), ctxt);
+    }
+
+    void TestStealAndGuestTime()
+    {
+        // Between the samples cpu0 spends 100 ticks: user 40 (of which guest 15 and
+        // guest nice 5), system 10, idle 30 and steal 20
+        SCXCoreLib::SCXHandle<ProcStatTestDependencies> deps(new ProcStatTestDependencies());
+        SCXCoreLib::SCXHandle<CPUInstance> cpu0 = Sample(deps,
+            "cpu0 100 0 50 800 10 0 0 0 0 0\n",
+            "cpu0 140 0 60 830 10 0 0 20 15 5\n", 0);
+
+        scxulong value = 0;
+        CPPUNIT_ASSERT(cpu0->GetStealTime(value));
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(20), value);
+        CPPUNIT_ASSERT(cpu0->GetGuestTime(value));
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(20), value);
+        CPPUNIT_ASSERT(cpu0->GetUserTime(value));
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(40), value);
+        CPPUNIT_ASSERT(cpu0->GetIdleTime(value));
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(30), value);
+
+        // Stolen time is not time spent on our behalf
+        CPPUNIT_ASSERT(cpu0->GetProcessorTime(value));
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(50), value);
+    }
+
+    void TestStealAndGuestTimeOnOldKernel()
+    {
+        // Rows of a 2.4 kernel have no steal or guest column
+        SCXCoreLib::SCXHandle<ProcStatTestDependencies> deps(new ProcStatTestDependencies());
+        SCXCoreLib::SCXHandle<CPUInstance> cpu1 = Sample(deps,
+            "cpu1 10 0 10 80\n",
+            "cpu1 30 0 30 140\n", 1);
+
+        scxulong value = 1;
+        CPPUNIT_ASSERT(cpu1->GetStealTime(value));
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(0), value);
+        value = 1;
+        CPPUNIT_ASSERT(cpu1->GetGuestTime(value));
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(0), value);
+        CPPUNIT_ASSERT(cpu1->GetProcessorTime(value));
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(40), value);
+    }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION( ProcStatTest );
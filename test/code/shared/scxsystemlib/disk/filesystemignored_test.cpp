@@ -0,0 +1,116 @@
+/*--------------------------------------------------------------------------------
+    Copyright (c) Microsoft Corporation.  All rights reserved.
+
+*/
+/**
+    \file
+
+    \brief       Tests for the lookup of ignored file system types and its cache
+
+    \date        2026-10-18 23:45:00
+
+*/
+/*----------------------------------------------------------------------------*/
+
+#include <scxcorelib/scxcmn.h>
+#include <scxcorelib/stringaid.h>
+#include <scxsystemlib/diskdepend.h>
+#include <testutils/scxunit.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+using namespace SCXSystemLib;
+
+class FileSystemIgnoredTest : public CPPUNIT_NS::TestFixture
+{
+    CPPUNIT_TEST_SUITE( FileSystemIgnoredTest );
+    CPPUNIT_TEST( TestExactNames );
+    CPPUNIT_TEST( TestNotIgnored );
+    CPPUNIT_TEST( TestCaseInsensitive );
+    CPPUNIT_TEST( TestPrefix );
+    CPPUNIT_TEST( TestSubstring );
+    CPPUNIT_TEST( TestRepeatedLookups );
+    CPPUNIT_TEST( TestMoreTypesThanCached );
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    void TestExactNames()
+    {
+        DiskDependDefault deps;
+        CPPUNIT_ASSERT(deps.FileSystemIgnored(L"proc"));
+        CPPUNIT_ASSERT(deps.FileSystemIgnored(L"sysfs"));
+        CPPUNIT_ASSERT(deps.FileSystemIgnored(L"tmpfs"));
+        CPPUNIT_ASSERT(deps.FileSystemIgnored(L"devtmpfs"));
+        CPPUNIT_ASSERT(deps.FileSystemIgnored(L"cifs"));
+        CPPUNIT_ASSERT(deps.FileSystemIgnored(L"none"));
+        CPPUNIT_ASSERT(deps.FileSystemIgnored(L"autofs"));
+    }
+
+    void TestNotIgnored()
+    {
+        DiskDependDefault deps;
+        CPPUNIT_ASSERT( ! deps.FileSystemIgnored(L"ext4"));
+        CPPUNIT_ASSERT( ! deps.FileSystemIgnored(L"xfs"));
+        CPPUNIT_ASSERT( ! deps.FileSystemIgnored(L"btrfs"));
+        CPPUNIT_ASSERT( ! deps.FileSystemIgnored(L"overlay"));
+
+        // Names of the list are matched whole, not as prefixes
+        CPPUNIT_ASSERT( ! deps.FileSystemIgnored(L"pro"));
+        CPPUNIT_ASSERT( ! deps.FileSystemIgnored(L"tmpfs2"));
+        CPPUNIT_ASSERT( ! deps.FileSystemIgnored(L""));
+    }
+
+    void TestCaseInsensitive()
+    {
+        DiskDependDefault deps;
+        CPPUNIT_ASSERT(deps.FileSystemIgnored(L"PROC"));
+        CPPUNIT_ASSERT(deps.FileSystemIgnored(L"SysFs"));
+        CPPUNIT_ASSERT(deps.FileSystemIgnored(L"NFS4"));
+        CPPUNIT_ASSERT(deps.FileSystemIgnored(L"Fuse.GVFS-Fuse-Daemon"));
+        CPPUNIT_ASSERT( ! deps.FileSystemIgnored(L"EXT4"));
+    }
+
+    void TestPrefix()
+    {
+        DiskDependDefault deps;
+        CPPUNIT_ASSERT(deps.FileSystemIgnored(L"nfs"));
+        CPPUNIT_ASSERT(deps.FileSystemIgnored(L"nfs4"));
+        CPPUNIT_ASSERT(deps.FileSystemIgnored(L"nfsd"));
+        CPPUNIT_ASSERT( ! deps.FileSystemIgnored(L"xnfs"));
+    }
+
+    void TestSubstring()
+    {
+        DiskDependDefault deps;
+        CPPUNIT_ASSERT(deps.FileSystemIgnored(L"gvfs"));
+        CPPUNIT_ASSERT(deps.FileSystemIgnored(L"fuse.gvfsd-fuse"));
+        CPPUNIT_ASSERT(deps.FileSystemIgnored(L"fuse.gvfs-fuse-daemon"));
+    }
+
+    void TestRepeatedLookups()
+    {
+        // The second lookup of a type is answered from the cache
+        DiskDependDefault deps;
+        for (int i = 0; i < 3; i++)
+        {
+            CPPUNIT_ASSERT(deps.FileSystemIgnored(L"tmpfs"));
+            CPPUNIT_ASSERT(deps.FileSystemIgnored(L"TMPFS"));
+            CPPUNIT_ASSERT( ! deps.FileSystemIgnored(L"ext4"));
+            CPPUNIT_ASSERT(deps.FileSystemIgnored(L"nfs4"));
+        }
+    }
+
+    void TestMoreTypesThanCached()
+    {
+        // The cache is emptied when full; decisions stay the same
+        DiskDependDefault deps;
+        for (size_t i = 0; i < 2 * MAX_CACHED_FILESYSTEM_TYPES + 1; i++)
+        {
+            CPPUNIT_ASSERT( ! deps.FileSystemIgnored(SCXCoreLib::StrAppend(L"ext", i)));
+            CPPUNIT_ASSERT(deps.FileSystemIgnored(SCXCoreLib::StrAppend(L"nfs", i)));
+            CPPUNIT_ASSERT(deps.FileSystemIgnored(L"proc"));
+            CPPUNIT_ASSERT( ! deps.FileSystemIgnored(L"xfs"));
+        }
+    }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION( FileSystemIgnoredTest );
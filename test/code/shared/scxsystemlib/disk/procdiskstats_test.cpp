@@ -0,0 +1,230 @@
+/*--------------------------------------------------------------------------------
+    Copyright (c) Microsoft Corporation.  All rights reserved.
+
+*/
+/**
+    \file
+
+    \brief       Tests for the /proc/diskstats parser and its device number index
+
+    \date        2026-10-18 23:45:00
+
+*/
+/*----------------------------------------------------------------------------*/
+
+#include <scxcorelib/scxcmn.h>
+#include <scxcorelib/scxfile.h>
+#include <scxcorelib/stringaid.h>
+#include <scxsystemlib/diskdepend.h>
+#include <testutils/scxunit.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <fstream>
+#include <sstream>
+#include <string.h>
+
+using namespace SCXSystemLib;
+
+namespace
+{
+    /** /proc/diskstats of a 4.18 kernel: disks and partitions with 15 fields, dm with 15 */
+    const char* const s_diskStats =
+        "   8       0 sda 104713 3402 6904458 72716 282370 237436 13372354 497428 0 213348 571312 0 0 0 0\n"
+        "   8       1 sda1 1803 0 148114 1060 1038 9 83448 1180 0 1320 2240 0 0 0 0\n"
+        " 253       0 dm-0 98311 0 6514178 71956 519614 0 13288904 1196064 0 213576 1268020 0 0 0 0\n"
+        " 259       0 nvme0n1 5110 2 297264 1236 1466 1190 215936 7392 0 2160 8628 0 0 0 0\n";
+
+    /** Lines of a 2.6.18 kernel, where partitions have four fields */
+    const char* const s_oldDiskStats =
+        "   3    0 hda 446216 784926 9550688 4382310 424847 312726 5922052 19310380 0 3376340 23705160\n"
+        "   3    1 hda1 35486 38030 38030 38030\n";
+
+    /** Name of the file the index tests read */
+    const wchar_t* const s_diskStatsFile = L"./procdiskstats_test.txt";
+}
+
+/** Reads /proc/diskstats from a test file instead */
+class ProcDiskStatsTestDepend : public DiskDependDefault
+{
+public:
+    ProcDiskStatsTestDepend() : m_path(s_diskStatsFile) {}
+    virtual const SCXCoreLib::SCXFilePath& LocateProcDiskStats() { return m_path; }
+
+private:
+    SCXCoreLib::SCXFilePath m_path;
+};
+
+class ProcDiskStatsTest : public CPPUNIT_NS::TestFixture
+{
+    CPPUNIT_TEST_SUITE( ProcDiskStatsTest );
+    CPPUNIT_TEST( TestParseCurrentKernel );
+    CPPUNIT_TEST( TestParseOldPartition );
+    CPPUNIT_TEST( TestParseSkipsShortAndEmptyLines );
+    CPPUNIT_TEST( TestParseReusesRows );
+    CPPUNIT_TEST( TestIndexFindsDeviceNumbers );
+    CPPUNIT_TEST( TestIndexWithManyDevices );
+    CPPUNIT_TEST( TestIndexFollowsFileChanges );
+    CPPUNIT_TEST_SUITE_END();
+
+private:
+    /** Writes the test file, overwriting it in place so an open descriptor sees the new contents */
+    void WriteDiskStats(const std::string& contents)
+    {
+        std::ofstream out(SCXCoreLib::StrToMultibyte(s_diskStatsFile).c_str(), std::ios::out | std::ios::trunc);
+        out << contents;
+    }
+
+    size_t Parse(const char* text, std::vector<ProcDiskStats>& rows)
+    {
+        return DiskDependDefault::ParseProcDiskStats(text, text + strlen(text), rows);
+    }
+
+public:
+    void tearDown(void)
+    {
+        SCXCoreLib::SCXFile::Delete(s_diskStatsFile);
+    }
+
+    void TestParseCurrentKernel()
+    {
+        std::vector<ProcDiskStats> rows;
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(4), Parse(s_diskStats, rows));
+
+        const ProcDiskStats& sda = rows[0];
+        CPPUNIT_ASSERT_EQUAL(8u, sda.major);
+        CPPUNIT_ASSERT_EQUAL(0u, sda.minor);
+        CPPUNIT_ASSERT_EQUAL(std::string("sda"), sda.name);
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(15), sda.fieldCount);
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(104713), sda.readsCompleted);
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(3402), sda.readsMerged);
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(6904458), sda.sectorsRead);
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(72716), sda.msReading);
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(282370), sda.writesCompleted);
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(237436), sda.writesMerged);
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(13372354), sda.sectorsWritten);
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(497428), sda.msWriting);
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(0), sda.ioInProgress);
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(213348), sda.msIO);
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(571312), sda.weightedMsIO);
+
+        CPPUNIT_ASSERT_EQUAL(253u, rows[2].major);
+        CPPUNIT_ASSERT_EQUAL(std::string("dm-0"), rows[2].name);
+        CPPUNIT_ASSERT_EQUAL(std::string("nvme0n1"), rows[3].name);
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(8628), rows[3].weightedMsIO);
+    }
+
+    void TestParseOldPartition()
+    {
+        std::vector<ProcDiskStats> rows;
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), Parse(s_oldDiskStats, rows));
+
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(11), rows[0].fieldCount);
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(23705160), rows[0].weightedMsIO);
+
+        // reads, sectors read, writes, sectors written
+        const ProcDiskStats& hda1 = rows[1];
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(4), hda1.fieldCount);
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(35486), hda1.readsCompleted);
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(38030), hda1.sectorsRead);
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(38030), hda1.writesCompleted);
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(38030), hda1.sectorsWritten);
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(0), hda1.readsMerged);
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(0), hda1.msIO);
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(0), hda1.weightedMsIO);
+    }
+
+    void TestParseSkipsShortAndEmptyLines()
+    {
+        const char* text =
+            "\n"
+            "   7       0 loop0 1 2 3\n"
+            "   8      16 sdb 1 2 3 4 5 6 7 8 9 10 11";
+
+        std::vector<ProcDiskStats> rows;
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), Parse(text, rows));
+        CPPUNIT_ASSERT_EQUAL(std::string("sdb"), rows[0].name);
+        CPPUNIT_ASSERT_EQUAL(16u, rows[0].minor);
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(11), rows[0].weightedMsIO);
+    }
+
+    void TestParseReusesRows()
+    {
+        std::vector<ProcDiskStats> rows;
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(4), Parse(s_diskStats, rows));
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), Parse(s_oldDiskStats, rows));
+
+        // Rows past the count are left in place for the next parse
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(4), rows.size());
+        CPPUNIT_ASSERT_EQUAL(std::string("hda"), rows[0].name);
+        CPPUNIT_ASSERT_EQUAL(std::string("hda1"), rows[1].name);
+    }
+
+    void TestIndexFindsDeviceNumbers()
+    {
+        WriteDiskStats(s_diskStats);
+        ProcDiskStatsTestDepend deps;
+        deps.RefreshProcDiskStats();
+
+        const ProcDiskStats* row = deps.GetProcDiskStats(8, 1);
+        CPPUNIT_ASSERT(NULL != row);
+        CPPUNIT_ASSERT_EQUAL(std::string("sda1"), row->name);
+
+        row = deps.GetProcDiskStats(253, 0);
+        CPPUNIT_ASSERT(NULL != row);
+        CPPUNIT_ASSERT_EQUAL(std::string("dm-0"), row->name);
+
+        CPPUNIT_ASSERT(NULL == deps.GetProcDiskStats(8, 2));
+        CPPUNIT_ASSERT(NULL == deps.GetProcDiskStats(0, 8));
+
+        row = deps.FindProcDiskStats(L"/dev/nvme0n1");
+        CPPUNIT_ASSERT(NULL != row);
+        CPPUNIT_ASSERT_EQUAL(259u, row->major);
+        CPPUNIT_ASSERT(NULL == deps.FindProcDiskStats(L"/dev/sdz"));
+    }
+
+    void TestIndexWithManyDevices()
+    {
+        // More rows than the initial index has slots, with device numbers that differ in one part only
+        std::ostringstream text;
+        for (unsigned int i = 0; i < 200; i++)
+        {
+            text << "   7 " << i << " loop" << i << " " << i << " 0 0 0 0 0 0 0 0 0 0\n";
+            text << " " << (1000 + i) << " 0 disk" << i << " " << (1000 + i) << " 0 0 0 0 0 0 0 0 0 0\n";
+        }
+        WriteDiskStats(text.str());
+        ProcDiskStatsTestDepend deps;
+        deps.RefreshProcDiskStats();
+
+        for (unsigned int i = 0; i < 200; i++)
+        {
+            const ProcDiskStats* row = deps.GetProcDiskStats(7, i);
+            CPPUNIT_ASSERT(NULL != row);
+            CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(i), row->readsCompleted);
+
+            row = deps.GetProcDiskStats(1000 + i, 0);
+            CPPUNIT_ASSERT(NULL != row);
+            CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(1000 + i), row->readsCompleted);
+        }
+        CPPUNIT_ASSERT(NULL == deps.GetProcDiskStats(7, 200));
+    }
+
+    void TestIndexFollowsFileChanges()
+    {
+        WriteDiskStats(s_diskStats);
+        ProcDiskStatsTestDepend deps;
+        deps.RefreshProcDiskStats();
+        CPPUNIT_ASSERT(NULL != deps.GetProcDiskStats(8, 0));
+
+        // The file stays open between refreshes, as /proc/diskstats does
+        WriteDiskStats(s_oldDiskStats);
+        deps.RefreshProcDiskStats();
+        CPPUNIT_ASSERT(NULL == deps.GetProcDiskStats(8, 0));
+        CPPUNIT_ASSERT(NULL == deps.FindProcDiskStats(L"/dev/sda"));
+
+        const ProcDiskStats* row = deps.GetProcDiskStats(3, 1);
+        CPPUNIT_ASSERT(NULL != row);
+        CPPUNIT_ASSERT_EQUAL(std::string("hda1"), row->name);
+    }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION( ProcDiskStatsTest );
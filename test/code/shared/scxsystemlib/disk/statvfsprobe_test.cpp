@@ -0,0 +1,234 @@
+/*--------------------------------------------------------------------------------
+    Copyright (c) Microsoft Corporation.  All rights reserved.
+
+*/
+/**
+    \file
+
+    \brief       Tests for the timeout bounded statvfs() and its quarantine
+
+    \date        2026-10-18 23:45:00
+
+*/
+/*----------------------------------------------------------------------------*/
+
+#include <scxcorelib/scxcmn.h>
+#include <scxcorelib/scxcondition.h>
+#include <scxsystemlib/statvfsprobe.h>
+#include <testutils/scxunit.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <errno.h>
+#include <string.h>
+
+using namespace SCXSystemLib;
+
+namespace
+{
+    /** Time the tests wait for statvfs() in milliseconds */
+    const unsigned int s_timeoutMsec = 50;
+}
+
+/** statvfs() that answers with a set value, fails, or hangs until released */
+class StatVfsProbeTestDepend : public DiskDependDefault
+{
+public:
+    StatVfsProbeTestDepend() : m_blocks(0), m_errno(0), m_hang(false), m_calls(0), m_returned(0)
+    {
+        m_cond.SetSleep(10);
+    }
+
+    virtual int statvfs(const char*, SCXStatVfs* buf)
+    {
+        SCXCoreLib::SCXConditionHandle h(m_cond);
+        m_calls++;
+        while (m_hang)
+        {
+            h.Wait();
+        }
+        m_returned++;
+        if (0 != m_errno)
+        {
+            errno = m_errno;
+            return -1;
+        }
+        buf->f_blocks = m_blocks;
+        return 0;
+    }
+
+    void Answer(unsigned long blocks)
+    {
+        SCXCoreLib::SCXConditionHandle h(m_cond);
+        m_blocks = blocks;
+        m_errno = 0;
+    }
+
+    void Fail(int err)
+    {
+        SCXCoreLib::SCXConditionHandle h(m_cond);
+        m_errno = err;
+    }
+
+    void Hang(bool hang)
+    {
+        SCXCoreLib::SCXConditionHandle h(m_cond);
+        m_hang = hang;
+        h.Signal();
+    }
+
+    unsigned int Calls()
+    {
+        SCXCoreLib::SCXConditionHandle h(m_cond);
+        return m_calls;
+    }
+
+    /** Waits until as many calls have returned as were made */
+    void WaitForReturns()
+    {
+        SCXCoreLib::SCXConditionHandle h(m_cond);
+        while (m_returned < m_calls)
+        {
+            h.Wait();
+        }
+    }
+
+private:
+    SCXCoreLib::SCXCondition m_cond;
+    unsigned long m_blocks;
+    int m_errno;
+    bool m_hang;
+    unsigned int m_calls;
+    unsigned int m_returned;
+};
+
+class StatVfsProbeTest : public CPPUNIT_NS::TestFixture
+{
+    CPPUNIT_TEST_SUITE( StatVfsProbeTest );
+    CPPUNIT_TEST( TestMayBlock );
+    CPPUNIT_TEST( TestLocalAnswers );
+    CPPUNIT_TEST( TestRemoteAnswers );
+    CPPUNIT_TEST( TestFailure );
+    CPPUNIT_TEST( TestHangWithoutValue );
+    CPPUNIT_TEST( TestHangIsQuarantined );
+    CPPUNIT_TEST_SUITE_END();
+
+private:
+    SCXCoreLib::SCXHandle<StatVfsProbeTestDepend> m_deps;
+
+public:
+    void setUp(void)
+    {
+        m_deps = new StatVfsProbeTestDepend();
+    }
+
+    void tearDown(void)
+    {
+        // Hung workers hold the dependencies; let them finish
+        m_deps->Hang(false);
+        m_deps->WaitForReturns();
+        m_deps = 0;
+    }
+
+    void TestMayBlock()
+    {
+        CPPUNIT_ASSERT(StatVfsProbe::MayBlock(L"nfs"));
+        CPPUNIT_ASSERT(StatVfsProbe::MayBlock(L"nfs4"));
+        CPPUNIT_ASSERT(StatVfsProbe::MayBlock(L"NFS"));
+        CPPUNIT_ASSERT(StatVfsProbe::MayBlock(L"cifs"));
+        CPPUNIT_ASSERT(StatVfsProbe::MayBlock(L"fuse.sshfs"));
+        CPPUNIT_ASSERT(StatVfsProbe::MayBlock(L""));
+        CPPUNIT_ASSERT( ! StatVfsProbe::MayBlock(L"ext4"));
+        CPPUNIT_ASSERT( ! StatVfsProbe::MayBlock(L"xfs"));
+        CPPUNIT_ASSERT( ! StatVfsProbe::MayBlock(L"tmpfs"));
+    }
+
+    void TestLocalAnswers()
+    {
+        StatVfsProbe probe(m_deps, s_timeoutMsec);
+        SCXStatVfs buf;
+        int err = 0;
+
+        m_deps->Answer(4711);
+        CPPUNIT_ASSERT_EQUAL(eStatVfsOk, probe.StatVfs(L"/", L"ext4", buf, err));
+        CPPUNIT_ASSERT_EQUAL(4711ul, static_cast<unsigned long>(buf.f_blocks));
+        CPPUNIT_ASSERT_EQUAL(1u, m_deps->Calls());
+    }
+
+    void TestRemoteAnswers()
+    {
+        StatVfsProbe probe(m_deps, s_timeoutMsec);
+        SCXStatVfs buf;
+        int err = 0;
+
+        m_deps->Answer(1234);
+        CPPUNIT_ASSERT_EQUAL(eStatVfsOk, probe.StatVfs(L"/mnt/nfs", L"nfs4", buf, err));
+        CPPUNIT_ASSERT_EQUAL(1234ul, static_cast<unsigned long>(buf.f_blocks));
+
+        m_deps->Answer(1235);
+        CPPUNIT_ASSERT_EQUAL(eStatVfsOk, probe.StatVfs(L"/mnt/nfs", L"nfs4", buf, err));
+        CPPUNIT_ASSERT_EQUAL(1235ul, static_cast<unsigned long>(buf.f_blocks));
+        CPPUNIT_ASSERT_EQUAL(2u, m_deps->Calls());
+    }
+
+    void TestFailure()
+    {
+        StatVfsProbe probe(m_deps, s_timeoutMsec);
+        SCXStatVfs buf;
+        int err = 0;
+
+        m_deps->Fail(EACCES);
+        CPPUNIT_ASSERT_EQUAL(eStatVfsFailed, probe.StatVfs(L"/mnt/nfs", L"nfs", buf, err));
+        CPPUNIT_ASSERT_EQUAL(EACCES, err);
+        CPPUNIT_ASSERT_EQUAL(eStatVfsFailed, probe.StatVfs(L"/", L"ext4", buf, err));
+        CPPUNIT_ASSERT_EQUAL(EACCES, err);
+        CPPUNIT_ASSERT( ! probe.IsQuarantined());
+    }
+
+    void TestHangWithoutValue()
+    {
+        StatVfsProbe probe(m_deps, s_timeoutMsec);
+        SCXStatVfs buf;
+        int err = 0;
+
+        m_deps->Hang(true);
+        CPPUNIT_ASSERT_EQUAL(eStatVfsNoValue, probe.StatVfs(L"/mnt/cifs", L"cifs", buf, err));
+        CPPUNIT_ASSERT( ! probe.IsQuarantined());
+    }
+
+    void TestHangIsQuarantined()
+    {
+        StatVfsProbe probe(m_deps, s_timeoutMsec);
+        SCXStatVfs buf;
+        int err = 0;
+
+        m_deps->Answer(100);
+        CPPUNIT_ASSERT_EQUAL(eStatVfsOk, probe.StatVfs(L"/mnt/nfs", L"nfs", buf, err));
+
+        // The first call times out, the following ones find the worker still hanging
+        // and start no other
+        m_deps->Hang(true);
+        for (unsigned int i = 0; i < STATVFS_QUARANTINE_TIMEOUTS; i++)
+        {
+            memset(&buf, 0, sizeof(buf));
+            CPPUNIT_ASSERT_EQUAL(eStatVfsStale, probe.StatVfs(L"/mnt/nfs", L"nfs", buf, err));
+            CPPUNIT_ASSERT_EQUAL(100ul, static_cast<unsigned long>(buf.f_blocks));
+        }
+        CPPUNIT_ASSERT_EQUAL(2u, m_deps->Calls());
+        CPPUNIT_ASSERT(probe.IsQuarantined());
+
+        // No calls are made while quarantined
+        CPPUNIT_ASSERT_EQUAL(eStatVfsStale, probe.StatVfs(L"/mnt/nfs", L"nfs", buf, err));
+        CPPUNIT_ASSERT_EQUAL(2u, m_deps->Calls());
+
+        // Once the hung call returns its answer lifts the quarantine
+        m_deps->Answer(200);
+        m_deps->Hang(false);
+        m_deps->WaitForReturns();
+        CPPUNIT_ASSERT_EQUAL(eStatVfsOk, probe.StatVfs(L"/mnt/nfs", L"nfs", buf, err));
+        CPPUNIT_ASSERT_EQUAL(200ul, static_cast<unsigned long>(buf.f_blocks));
+        CPPUNIT_ASSERT( ! probe.IsQuarantined());
+        CPPUNIT_ASSERT_EQUAL(3u, m_deps->Calls());
+    }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION( StatVfsProbeTest );
@@ -0,0 +1,111 @@
+/*--------------------------------------------------------------------------------
+    Copyright (c) Microsoft Corporation.  All rights reserved.
+
+*/
+/**
+    \file
+
+    \brief       Tests for the parser of the pressure stall information files
+
+    \date        2026-10-18 23:45:00
+
+*/
+/*----------------------------------------------------------------------------*/
+
+#include <scxcorelib/scxcmn.h>
+#include <scxsystemlib/pressureenumeration.h>
+#include <testutils/scxunit.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+using namespace SCXSystemLib;
+
+namespace
+{
+    /** /proc/pressure/memory */
+    const char* const s_memory =
+        "some avg10=1.53 avg60=0.87 avg300=0.22 total=10512394\n"
+        "full avg10=0.41 avg60=0.20 avg300=0.05 total=4209718\n";
+
+    /** /proc/pressure/cpu of a kernel before 5.13, which has no full line */
+    const char* const s_cpu =
+        "some avg10=12.00 avg60=8.50 avg300=3.25 total=987654321\n";
+}
+
+class PressureEnumerationTest : public CPPUNIT_NS::TestFixture
+{
+    CPPUNIT_TEST_SUITE( PressureEnumerationTest );
+    CPPUNIT_TEST( TestParseSome );
+    CPPUNIT_TEST( TestParseFull );
+    CPPUNIT_TEST( TestParseMissingFull );
+    CPPUNIT_TEST( TestParseLastLineWithoutNewline );
+    CPPUNIT_TEST( TestParseMalformed );
+    CPPUNIT_TEST( TestParseNeedsWholeKind );
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    void TestParseSome()
+    {
+        double avg10 = 0, avg60 = 0, avg300 = 0;
+        scxulong total = 0;
+        CPPUNIT_ASSERT(PressureEnumeration::ParseLine(s_memory, "some", avg10, avg60, avg300, total));
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(1.53, avg10, 0.001);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(0.87, avg60, 0.001);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(0.22, avg300, 0.001);
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(10512394), total);
+    }
+
+    void TestParseFull()
+    {
+        double avg10 = 0, avg60 = 0, avg300 = 0;
+        scxulong total = 0;
+        CPPUNIT_ASSERT(PressureEnumeration::ParseLine(s_memory, "full", avg10, avg60, avg300, total));
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(0.41, avg10, 0.001);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(0.20, avg60, 0.001);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(0.05, avg300, 0.001);
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(4209718), total);
+    }
+
+    void TestParseMissingFull()
+    {
+        double avg10 = 0, avg60 = 0, avg300 = 0;
+        scxulong total = 0;
+        CPPUNIT_ASSERT( ! PressureEnumeration::ParseLine(s_cpu, "full", avg10, avg60, avg300, total));
+        CPPUNIT_ASSERT( ! PressureEnumeration::ParseLine("", "some", avg10, avg60, avg300, total));
+
+        CPPUNIT_ASSERT(PressureEnumeration::ParseLine(s_cpu, "some", avg10, avg60, avg300, total));
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(12.0, avg10, 0.001);
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(987654321), total);
+    }
+
+    void TestParseLastLineWithoutNewline()
+    {
+        const char* io =
+            "some avg10=0.00 avg60=0.00 avg300=0.00 total=0\n"
+            "full avg10=0.00 avg60=0.00 avg300=0.00 total=31337";
+
+        double avg10 = 1, avg60 = 1, avg300 = 1;
+        scxulong total = 0;
+        CPPUNIT_ASSERT(PressureEnumeration::ParseLine(io, "full", avg10, avg60, avg300, total));
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0, avg10, 0.001);
+        CPPUNIT_ASSERT_EQUAL(static_cast<scxulong>(31337), total);
+    }
+
+    void TestParseMalformed()
+    {
+        double avg10 = 0, avg60 = 0, avg300 = 0;
+        scxulong total = 0;
+        CPPUNIT_ASSERT( ! PressureEnumeration::ParseLine("some avg10=0.10 avg300=0.01 total=5\n", "some", avg10, avg60, avg300, total));
+        CPPUNIT_ASSERT( ! PressureEnumeration::ParseLine("some avg10=x avg60=0.05 avg300=0.01 total=5\n", "some", avg10, avg60, avg300, total));
+        CPPUNIT_ASSERT( ! PressureEnumeration::ParseLine("some avg10=0.10 avg60=0.05 avg300=0.01\n", "some", avg10, avg60, avg300, total));
+        CPPUNIT_ASSERT( ! PressureEnumeration::ParseLine("some avg10=0.10 avg60=0.05 avg300=0.01 total=\n", "some", avg10, avg60, avg300, total));
+    }
+
+    void TestParseNeedsWholeKind()
+    {
+        double avg10 = 0, avg60 = 0, avg300 = 0;
+        scxulong total = 0;
+        CPPUNIT_ASSERT( ! PressureEnumeration::ParseLine("something avg10=0.10 avg60=0.05 avg300=0.01 total=5\n", "some", avg10, avg60, avg300, total));
+    }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION( PressureEnumerationTest );